@@ -32,6 +32,7 @@
 #include "a_star.compat.inc"
 
 #include "core/math/geometry_3d.h"
+#include "core/object/worker_thread_pool.h"
 
 int64_t AStar3D::get_available_point_id() const {
 	if (points.has(last_free_id)) {
@@ -56,10 +57,13 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
-		pt->prev_point = nullptr;
-		pt->open_pass = 0;
-		pt->closed_pass = 0;
 		pt->enabled = true;
+		if (free_indices.is_empty()) {
+			pt->index = index_count++;
+		} else {
+			pt->index = free_indices[free_indices.size() - 1];
+			free_indices.remove_at(free_indices.size() - 1);
+		}
 		points.insert_new(p_id, pt);
 	} else {
 		Point *found_pt = *point_entry;
@@ -118,6 +122,7 @@ void AStar3D::remove_point(int64_t p_id) {
 		kv.value->unlinked_neighbours.erase(p->id);
 	}
 
+	free_indices.push_back(p->index);
 	memdelete(p);
 	points.erase(p_id);
 	last_free_id = p_id;
@@ -243,6 +248,8 @@ void AStar3D::clear() {
 	}
 	segments.clear();
 	points.clear();
+	free_indices.clear();
+	index_count = 0;
 }
 
 int64_t AStar3D::get_point_count() const {
@@ -306,9 +313,53 @@ Vector3 AStar3D::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar3D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path) {
-	last_closest_point = nullptr;
-	pass++;
+AStar3D::SearchState *AStar3D::_alloc_search_state() {
+	SearchState *state = nullptr;
+	{
+		MutexLock lock(search_states_mutex);
+		if (!free_search_states.is_empty()) {
+			state = free_search_states[free_search_states.size() - 1];
+			free_search_states.remove_at(free_search_states.size() - 1);
+		}
+	}
+
+	if (!state) {
+		state = memnew(SearchState);
+	}
+	if (state->points.size() < index_count) {
+		state->points.resize(index_count);
+	}
+	return state;
+}
+
+void AStar3D::_free_search_state(SearchState *p_state) {
+	MutexLock lock(search_states_mutex);
+	free_search_states.push_back(p_state);
+}
+
+bool AStar3D::_get_solved_path(const SearchState &p_state, Point *p_begin_point, Point *p_end_point, bool p_found_route, bool p_allow_partial_path, LocalVector<Point *> &r_path) {
+	Point *end_point = p_end_point;
+	if (!p_found_route) {
+		if (!p_allow_partial_path || p_state.last_closest_point == nullptr) {
+			return false;
+		}
+
+		// Use closest point instead.
+		end_point = p_state.last_closest_point;
+	}
+
+	r_path.clear();
+	for (Point *p = end_point; p != p_begin_point; p = p_state.points[p->index].prev_point) {
+		r_path.push_back(p);
+	}
+	r_path.push_back(p_begin_point);
+	r_path.reverse();
+	return true;
+}
+
+bool AStar3D::_solve(SearchState &r_state, Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path) {
+	r_state.last_closest_point = nullptr;
+	const uint64_t pass = ++r_state.pass;
 
 	if (!p_begin_point->enabled) {
 		return false;
@@ -322,21 +373,29 @@ bool AStar3D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_part
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	SearchPoint *search_points = r_state.points.ptr();
+	LocalVector<OpenPoint> &open_list = r_state.open_list;
+	open_list.clear();
+	SortArray<OpenPoint, SortPoints> sorter;
 
-	p_begin_point->g_score = 0;
-	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	p_begin_point->abs_g_score = 0;
-	p_begin_point->abs_f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	open_list.push_back(p_begin_point);
+	SearchPoint &begin = search_points[p_begin_point->index];
+	begin.g_score = 0;
+	begin.f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
+	begin.abs_g_score = 0;
+	begin.abs_f_score = begin.f_score;
+	begin.open_pass = pass;
+	open_list.push_back({ p_begin_point, begin.f_score, begin.g_score });
+
+	const SearchPoint *closest = nullptr;
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+		Point *p = open_list[0].point; // The currently processed point.
+		SearchPoint &sp = search_points[p->index];
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (last_closest_point == nullptr || last_closest_point->abs_f_score > p->abs_f_score || (last_closest_point->abs_f_score >= p->abs_f_score && last_closest_point->abs_g_score > p->abs_g_score)) {
-			last_closest_point = p;
+		if (closest == nullptr || closest->abs_f_score > sp.abs_f_score || (closest->abs_f_score >= sp.abs_f_score && closest->abs_g_score > sp.abs_g_score)) {
+			r_state.last_closest_point = p;
+			closest = &sp;
 		}
 
 		if (p == p_end_point) {
@@ -346,12 +405,13 @@ bool AStar3D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_part
 
 		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
 		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		sp.closed_pass = pass; // Mark the point as closed.
 
 		for (const KeyValue<int64_t, Point *> &kv : p->neighbors) {
 			Point *e = kv.value; // The neighbor point.
+			SearchPoint &se = search_points[e->index];
 
-			if (!e->enabled || e->closed_pass == pass) {
+			if (!e->enabled || se.closed_pass == pass) {
 				continue;
 			}
 
@@ -362,35 +422,42 @@ bool AStar3D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_part
 				}
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			real_t tentative_g_score = sp.g_score + _compute_cost(p->id, e->id) * e->weight_scale;
 
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
+			if (se.open_pass != pass) { // The point wasn't inside the open list.
+				se.open_pass = pass;
+				open_list.push_back({ e });
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= se.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, p_end_point->id);
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			se.prev_point = p;
+			se.g_score = tentative_g_score;
+			se.f_score = se.g_score + _estimate_cost(e->id, p_end_point->id);
+			se.abs_g_score = tentative_g_score;
+			se.abs_f_score = se.f_score - se.g_score;
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+			int64_t open_index = open_list.size() - 1; // The position of the new points is already known.
+			if (!new_point) {
+				while (open_list[open_index].point != e) {
+					open_index--;
+				}
 			}
+			sorter.push_heap(0, open_index, 0, { e, se.f_score, se.g_score }, open_list.ptr());
 		}
 	}
 
 	return found_route;
 }
 
+bool AStar3D::_can_solve_on_threads() {
+	// Scripts can't be called from worker threads, scripted costs keep the queries on the calling thread.
+	return !GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost) && !(neighbor_filter_enabled && GDVIRTUAL_IS_OVERRIDDEN(_filter_neighbor));
+}
+
 real_t AStar3D::_estimate_cost(int64_t p_from_id, int64_t p_end_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_end_id, scost)) {
@@ -434,40 +501,21 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 	ERR_FAIL_COND_V_MSG(!b_entry, Vector<Vector3>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_to_id));
 	Point *b = *b_entry;
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	SearchState *state = _alloc_search_state();
+	LocalVector<Point *> path_points;
+	bool found_route = _solve(*state, a, b, p_allow_partial_path);
+	found_route = _get_solved_path(*state, a, b, found_route, p_allow_partial_path, path_points);
+	_free_search_state(state);
 
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
+	Vector<Vector3> path;
 	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<Vector3>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
-	}
-
-	Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+		return path;
 	}
 
-	Vector<Vector3> path;
-	path.resize(pc);
-
-	{
-		Vector3 *w = path.ptrw();
-
-		Point *p2 = end_point;
-		int64_t idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
-		}
-
-		w[0] = p2->pos; // Assign first
+	path.resize(path_points.size());
+	Vector3 *w = path.ptrw();
+	for (uint32_t i = 0; i < path_points.size(); i++) {
+		w[i] = path_points[i]->pos;
 	}
 
 	return path;
@@ -482,43 +530,69 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 	ERR_FAIL_COND_V_MSG(!b_entry, Vector<int64_t>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_to_id));
 	Point *b = *b_entry;
 
-	Point *begin_point = a;
-	Point *end_point = b;
+	SearchState *state = _alloc_search_state();
+	LocalVector<Point *> path_points;
+	bool found_route = _solve(*state, a, b, p_allow_partial_path);
+	found_route = _get_solved_path(*state, a, b, found_route, p_allow_partial_path, path_points);
+	_free_search_state(state);
 
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
+	Vector<int64_t> path;
 	if (!found_route) {
-		if (!p_allow_partial_path || last_closest_point == nullptr) {
-			return Vector<int64_t>();
-		}
-
-		// Use closest point instead.
-		end_point = last_closest_point;
+		return path;
 	}
 
-	Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	path.resize(path_points.size());
+	int64_t *w = path.ptrw();
+	for (uint32_t i = 0; i < path_points.size(); i++) {
+		w[i] = path_points[i]->id;
 	}
 
-	Vector<int64_t> path;
-	path.resize(pc);
+	return path;
+}
 
-	{
-		int64_t *w = path.ptrw();
+void AStar3D::_get_id_path_task(uint32_t p_index, IdPathBatch *p_batch) {
+	p_batch->paths[p_index] = get_id_path(p_batch->from_ids[p_index], p_batch->to_ids[p_index], p_batch->allow_partial_path);
+}
+
+PackedInt64Array AStar3D::_pack_id_paths(const IdPathBatch &p_batch) {
+	// Each path is stored as its length followed by its ids.
+	int64_t size = p_batch.paths.size();
+	for (const Vector<int64_t> &path : p_batch.paths) {
+		size += path.size();
+	}
 
-		p = end_point;
-		int64_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
+	PackedInt64Array packed;
+	packed.resize(size);
+	int64_t *w = packed.ptrw();
+	for (const Vector<int64_t> &path : p_batch.paths) {
+		*w++ = path.size();
+		for (int64_t id : path) {
+			*w++ = id;
 		}
+	}
 
-		w[0] = p->id; // Assign first
+	return packed;
+}
+
+PackedInt64Array AStar3D::get_id_paths(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path) {
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), PackedInt64Array(), vformat("Can't get id paths. The number of begin points (%d) and end points (%d) doesn't match.", p_from_ids.size(), p_to_ids.size()));
+
+	IdPathBatch batch;
+	batch.from_ids = p_from_ids.ptr();
+	batch.to_ids = p_to_ids.ptr();
+	batch.allow_partial_path = p_allow_partial_path;
+	batch.paths.resize(p_from_ids.size());
+
+	if (batch.paths.size() > 1 && _can_solve_on_threads()) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStar3D::_get_id_path_task, &batch, batch.paths.size(), -1, true, SNAME("AStar3DGetIdPaths"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < batch.paths.size(); i++) {
+			_get_id_path_task(i, &batch);
+		}
 	}
 
-	return path;
+	return _pack_id_paths(batch);
 }
 
 bool AStar3D::is_neighbor_filter_enabled() const {
@@ -577,6 +651,7 @@ void AStar3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStar3D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStar3D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids", "allow_partial_path"), &AStar3D::get_id_paths, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_filter_neighbor, "from_id", "neighbor_id")
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
@@ -587,6 +662,9 @@ void AStar3D::_bind_methods() {
 
 AStar3D::~AStar3D() {
 	clear();
+	for (SearchState *state : free_search_states) {
+		memdelete(state);
+	}
 }
 
 /////////////////////////////////////////////////////////////
@@ -728,40 +806,21 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id, bool
 	ERR_FAIL_COND_V_MSG(!b_entry, Vector<Vector2>(), vformat("Can't get point path. Point with id: %d doesn't exist.", p_to_id));
 	AStar3D::Point *b = *b_entry;
 
-	AStar3D::Point *begin_point = a;
-	AStar3D::Point *end_point = b;
+	AStar3D::SearchState *state = astar._alloc_search_state();
+	LocalVector<AStar3D::Point *> path_points;
+	bool found_route = _solve(*state, a, b, p_allow_partial_path);
+	found_route = AStar3D::_get_solved_path(*state, a, b, found_route, p_allow_partial_path, path_points);
+	astar._free_search_state(state);
 
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
+	Vector<Vector2> path;
 	if (!found_route) {
-		if (!p_allow_partial_path || astar.last_closest_point == nullptr) {
-			return Vector<Vector2>();
-		}
-
-		// Use closest point instead.
-		end_point = astar.last_closest_point;
+		return path;
 	}
 
-	AStar3D::Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
-
-	Vector<Vector2> path;
-	path.resize(pc);
-
-	{
-		Vector2 *w = path.ptrw();
-
-		AStar3D::Point *p2 = end_point;
-		int64_t idx = pc - 1;
-		while (p2 != begin_point) {
-			w[idx--] = Vector2(p2->pos.x, p2->pos.y);
-			p2 = p2->prev_point;
-		}
-
-		w[0] = Vector2(p2->pos.x, p2->pos.y); // Assign first
+	path.resize(path_points.size());
+	Vector2 *w = path.ptrw();
+	for (uint32_t i = 0; i < path_points.size(); i++) {
+		w[i] = Vector2(path_points[i]->pos.x, path_points[i]->pos.y);
 	}
 
 	return path;
@@ -776,48 +835,54 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_
 	ERR_FAIL_COND_V_MSG(!to_entry, Vector<int64_t>(), vformat("Can't get id path. Point with id: %d doesn't exist.", p_to_id));
 	AStar3D::Point *b = *to_entry;
 
-	AStar3D::Point *begin_point = a;
-	AStar3D::Point *end_point = b;
+	AStar3D::SearchState *state = astar._alloc_search_state();
+	LocalVector<AStar3D::Point *> path_points;
+	bool found_route = _solve(*state, a, b, p_allow_partial_path);
+	found_route = AStar3D::_get_solved_path(*state, a, b, found_route, p_allow_partial_path, path_points);
+	astar._free_search_state(state);
 
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
+	Vector<int64_t> path;
 	if (!found_route) {
-		if (!p_allow_partial_path || astar.last_closest_point == nullptr) {
-			return Vector<int64_t>();
-		}
-
-		// Use closest point instead.
-		end_point = astar.last_closest_point;
+		return path;
 	}
 
-	AStar3D::Point *p = end_point;
-	int64_t pc = 1; // Begin point
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
+	path.resize(path_points.size());
+	int64_t *w = path.ptrw();
+	for (uint32_t i = 0; i < path_points.size(); i++) {
+		w[i] = path_points[i]->id;
 	}
 
-	Vector<int64_t> path;
-	path.resize(pc);
+	return path;
+}
 
-	{
-		int64_t *w = path.ptrw();
+void AStar2D::_get_id_path_task(uint32_t p_index, AStar3D::IdPathBatch *p_batch) {
+	p_batch->paths[p_index] = get_id_path(p_batch->from_ids[p_index], p_batch->to_ids[p_index], p_batch->allow_partial_path);
+}
 
-		p = end_point;
-		int64_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->id;
-			p = p->prev_point;
-		}
+PackedInt64Array AStar2D::get_id_paths(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path) {
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), PackedInt64Array(), vformat("Can't get id paths. The number of begin points (%d) and end points (%d) doesn't match.", p_from_ids.size(), p_to_ids.size()));
+
+	AStar3D::IdPathBatch batch;
+	batch.from_ids = p_from_ids.ptr();
+	batch.to_ids = p_to_ids.ptr();
+	batch.allow_partial_path = p_allow_partial_path;
+	batch.paths.resize(p_from_ids.size());
 
-		w[0] = p->id; // Assign first
+	if (batch.paths.size() > 1 && _can_solve_on_threads()) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStar2D::_get_id_path_task, &batch, batch.paths.size(), -1, true, SNAME("AStar2DGetIdPaths"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < batch.paths.size(); i++) {
+			_get_id_path_task(i, &batch);
+		}
 	}
 
-	return path;
+	return AStar3D::_pack_id_paths(batch);
 }
 
-bool AStar2D::_solve(AStar3D::Point *p_begin_point, AStar3D::Point *p_end_point, bool p_allow_partial_path) {
-	astar.last_closest_point = nullptr;
-	astar.pass++;
+bool AStar2D::_solve(AStar3D::SearchState &r_state, AStar3D::Point *p_begin_point, AStar3D::Point *p_end_point, bool p_allow_partial_path) {
+	r_state.last_closest_point = nullptr;
+	const uint64_t pass = ++r_state.pass;
 
 	if (!p_begin_point->enabled) {
 		return false;
@@ -831,21 +896,29 @@ bool AStar2D::_solve(AStar3D::Point *p_begin_point, AStar3D::Point *p_end_point,
 
 	bool found_route = false;
 
-	LocalVector<AStar3D::Point *> open_list;
-	SortArray<AStar3D::Point *, AStar3D::SortPoints> sorter;
+	AStar3D::SearchPoint *search_points = r_state.points.ptr();
+	LocalVector<AStar3D::OpenPoint> &open_list = r_state.open_list;
+	open_list.clear();
+	SortArray<AStar3D::OpenPoint, AStar3D::SortPoints> sorter;
 
-	p_begin_point->g_score = 0;
-	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	p_begin_point->abs_g_score = 0;
-	p_begin_point->abs_f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	open_list.push_back(p_begin_point);
+	AStar3D::SearchPoint &begin = search_points[p_begin_point->index];
+	begin.g_score = 0;
+	begin.f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
+	begin.abs_g_score = 0;
+	begin.abs_f_score = begin.f_score;
+	begin.open_pass = pass;
+	open_list.push_back({ p_begin_point, begin.f_score, begin.g_score });
+
+	const AStar3D::SearchPoint *closest = nullptr;
 
 	while (!open_list.is_empty()) {
-		AStar3D::Point *p = open_list[0]; // The currently processed point.
+		AStar3D::Point *p = open_list[0].point; // The currently processed point.
+		AStar3D::SearchPoint &sp = search_points[p->index];
 
 		// Find point closer to end_point, or same distance to end_point but closer to begin_point.
-		if (astar.last_closest_point == nullptr || astar.last_closest_point->abs_f_score > p->abs_f_score || (astar.last_closest_point->abs_f_score >= p->abs_f_score && astar.last_closest_point->abs_g_score > p->abs_g_score)) {
-			astar.last_closest_point = p;
+		if (closest == nullptr || closest->abs_f_score > sp.abs_f_score || (closest->abs_f_score >= sp.abs_f_score && closest->abs_g_score > sp.abs_g_score)) {
+			r_state.last_closest_point = p;
+			closest = &sp;
 		}
 
 		if (p == p_end_point) {
@@ -855,12 +928,13 @@ bool AStar2D::_solve(AStar3D::Point *p_begin_point, AStar3D::Point *p_end_point,
 
 		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
 		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = astar.pass; // Mark the point as closed.
+		sp.closed_pass = pass; // Mark the point as closed.
 
 		for (KeyValue<int64_t, AStar3D::Point *> &kv : p->neighbors) {
 			AStar3D::Point *e = kv.value; // The neighbor point.
+			AStar3D::SearchPoint &se = search_points[e->index];
 
-			if (!e->enabled || e->closed_pass == astar.pass) {
+			if (!e->enabled || se.closed_pass == pass) {
 				continue;
 			}
 
@@ -871,35 +945,42 @@ bool AStar2D::_solve(AStar3D::Point *p_begin_point, AStar3D::Point *p_end_point,
 				}
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			real_t tentative_g_score = sp.g_score + _compute_cost(p->id, e->id) * e->weight_scale;
 
 			bool new_point = false;
 
-			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
-				e->open_pass = astar.pass;
-				open_list.push_back(e);
+			if (se.open_pass != pass) { // The point wasn't inside the open list.
+				se.open_pass = pass;
+				open_list.push_back({ e });
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= se.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, p_end_point->id);
-			e->abs_g_score = tentative_g_score;
-			e->abs_f_score = e->f_score - e->g_score;
+			se.prev_point = p;
+			se.g_score = tentative_g_score;
+			se.f_score = se.g_score + _estimate_cost(e->id, p_end_point->id);
+			se.abs_g_score = tentative_g_score;
+			se.abs_f_score = se.f_score - se.g_score;
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+			int64_t open_index = open_list.size() - 1; // The position of the new points is already known.
+			if (!new_point) {
+				while (open_list[open_index].point != e) {
+					open_index--;
+				}
 			}
+			sorter.push_heap(0, open_index, 0, { e, se.f_score, se.g_score }, open_list.ptr());
 		}
 	}
 
 	return found_route;
 }
 
+bool AStar2D::_can_solve_on_threads() {
+	// Scripts can't be called from worker threads, scripted costs keep the queries on the calling thread.
+	return !GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost) && !(astar.neighbor_filter_enabled && GDVIRTUAL_IS_OVERRIDDEN(_filter_neighbor));
+}
+
 void AStar2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_available_point_id"), &AStar2D::get_available_point_id);
 	ClassDB::bind_method(D_METHOD("add_point", "id", "position", "weight_scale"), &AStar2D::add_point, DEFVAL(1.0));
@@ -932,6 +1013,7 @@ void AStar2D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id", "allow_partial_path"), &AStar2D::get_point_path, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id", "allow_partial_path"), &AStar2D::get_id_path, DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids", "allow_partial_path"), &AStar2D::get_id_paths, DEFVAL(false));
 
 	GDVIRTUAL_BIND(_filter_neighbor, "from_id", "neighbor_id")
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "end_id")
@@ -32,6 +32,7 @@
 
 #include "core/object/gdvirtual.gen.h"
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
 #include "core/templates/a_hash_map.h"
 
 /**
@@ -44,14 +45,17 @@ class AStar3D : public RefCounted {
 
 	struct Point {
 		int64_t id = 0;
+		uint32_t index = 0; // Slot of the point in the search states.
 		Vector3 pos;
 		real_t weight_scale = 0;
 		bool enabled = false;
 
 		AHashMap<int64_t, Point *> neighbors = 4u;
 		AHashMap<int64_t, Point *> unlinked_neighbours = 4u;
+	};
 
-		// Used for pathfinding.
+	// Pathfinding data of a point, kept outside of the graph so queries don't write to it.
+	struct SearchPoint {
 		Point *prev_point = nullptr;
 		real_t g_score = 0;
 		real_t f_score = 0;
@@ -63,14 +67,29 @@ class AStar3D : public RefCounted {
 		real_t abs_f_score = 0;
 	};
 
+	// Open list entry, with a copy of the scores so the heap doesn't have to look them up.
+	struct OpenPoint {
+		Point *point = nullptr;
+		real_t f_score = 0;
+		real_t g_score = 0;
+	};
+
+	// Everything a single query writes to. Each running query owns one, so queries can run concurrently.
+	struct SearchState {
+		LocalVector<SearchPoint> points; // Indexed by Point::index.
+		LocalVector<OpenPoint> open_list;
+		uint64_t pass = 0;
+		Point *last_closest_point = nullptr;
+	};
+
 	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+		_FORCE_INLINE_ bool operator()(const OpenPoint &A, const OpenPoint &B) const { // Returns true when the Point A is worse than Point B.
+			if (A.f_score > B.f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (A.f_score < B.f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return A.g_score < B.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
 	};
@@ -106,14 +125,34 @@ class AStar3D : public RefCounted {
 	};
 
 	mutable int64_t last_free_id = 0;
-	uint64_t pass = 1;
 
 	AHashMap<int64_t, Point *> points;
 	HashSet<Segment, Segment> segments;
-	Point *last_closest_point = nullptr;
 	bool neighbor_filter_enabled = false;
 
-	bool _solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
+	// Slots of removed points are reused, so search states stay as small as the graph.
+	LocalVector<uint32_t> free_indices;
+	uint32_t index_count = 0;
+
+	BinaryMutex search_states_mutex;
+	LocalVector<SearchState *> free_search_states;
+
+	SearchState *_alloc_search_state();
+	void _free_search_state(SearchState *p_state);
+	static bool _get_solved_path(const SearchState &p_state, Point *p_begin_point, Point *p_end_point, bool p_found_route, bool p_allow_partial_path, LocalVector<Point *> &r_path);
+
+	bool _solve(SearchState &r_state, Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
+	bool _can_solve_on_threads();
+
+	struct IdPathBatch {
+		const int64_t *from_ids = nullptr;
+		const int64_t *to_ids = nullptr;
+		bool allow_partial_path = false;
+		LocalVector<Vector<int64_t>> paths;
+	};
+
+	void _get_id_path_task(uint32_t p_index, IdPathBatch *p_batch);
+	static PackedInt64Array _pack_id_paths(const IdPathBatch &p_batch);
 
 protected:
 	static void _bind_methods();
@@ -164,6 +203,7 @@ public:
 
 	Vector<Vector3> get_point_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
 	Vector<int64_t> get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
+	PackedInt64Array get_id_paths(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path = false);
 
 	~AStar3D();
 };
@@ -172,7 +212,9 @@ class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
 	AStar3D astar;
 
-	bool _solve(AStar3D::Point *p_begin_point, AStar3D::Point *p_end_point, bool p_allow_partial_path);
+	bool _solve(AStar3D::SearchState &r_state, AStar3D::Point *p_begin_point, AStar3D::Point *p_end_point, bool p_allow_partial_path);
+	bool _can_solve_on_threads();
+	void _get_id_path_task(uint32_t p_index, AStar3D::IdPathBatch *p_batch);
 
 protected:
 	static void _bind_methods();
@@ -223,4 +265,5 @@ public:
 
 	Vector<Vector2> get_point_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
 	Vector<int64_t> get_id_path(int64_t p_from_id, int64_t p_to_id, bool p_allow_partial_path = false);
+	PackedInt64Array get_id_paths(const PackedInt64Array &p_from_ids, const PackedInt64Array &p_to_ids, bool p_allow_partial_path = false);
 };
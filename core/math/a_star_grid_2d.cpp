@@ -31,6 +31,7 @@
 #include "a_star_grid_2d.h"
 #include "a_star_grid_2d.compat.inc"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/variant/typed_array.h"
 
 static real_t heuristic_euclidean(const Vector2i &p_from, const Vector2i &p_to) {
@@ -60,6 +61,16 @@ static real_t heuristic_chebyshev(const Vector2i &p_from, const Vector2i &p_to)
 
 static real_t (*heuristics[AStarGrid2D::HEURISTIC_MAX])(const Vector2i &, const Vector2i &) = { heuristic_euclidean, heuristic_manhattan, heuristic_octile, heuristic_chebyshev };
 
+// Building fewer clusters isn't worth the threading overhead.
+static constexpr uint32_t THREADED_MIN_CLUSTERS = 64;
+
+// Cluster border openings at least this long get a transition at both ends, shorter ones a single one in the middle.
+static constexpr int32_t LONG_ENTRANCE_LENGTH = 6;
+
+static _FORCE_INLINE_ uint32_t cluster_cell_index(const Rect2i &p_rect, const Vector2i &p_id) {
+	return (p_id.y - p_rect.position.y) * p_rect.size.x + p_id.x - p_rect.position.x;
+}
+
 void AStarGrid2D::set_region(const Rect2i &p_region) {
 	ERR_FAIL_COND(p_region.size.x < 0 || p_region.size.y < 0);
 	if (p_region != region) {
@@ -165,6 +176,7 @@ void AStarGrid2D::update() {
 		solid_mask.push_back(true);
 	}
 
+	clusters_dirty = true;
 	dirty = false;
 }
 
@@ -188,9 +200,40 @@ bool AStarGrid2D::is_jumping_enabled() const {
 	return jumping_enabled;
 }
 
+void AStarGrid2D::set_hierarchical_enabled(bool p_enabled) {
+	if (hierarchical_enabled == p_enabled) {
+		return;
+	}
+
+	hierarchical_enabled = p_enabled;
+	// Clusters are built by the next path query.
+	clusters.clear();
+	dirty_clusters.clear();
+	clusters_dirty = true;
+}
+
+bool AStarGrid2D::is_hierarchical_enabled() const {
+	return hierarchical_enabled;
+}
+
+void AStarGrid2D::set_cluster_size(int32_t p_cluster_size) {
+	ERR_FAIL_COND_MSG(p_cluster_size < 2, vformat("Can't set cluster size less than 2: %d.", p_cluster_size));
+	if (cluster_size != p_cluster_size) {
+		cluster_size = p_cluster_size;
+		clusters_dirty = true;
+	}
+}
+
+int32_t AStarGrid2D::get_cluster_size() const {
+	return cluster_size;
+}
+
 void AStarGrid2D::set_diagonal_mode(DiagonalMode p_diagonal_mode) {
 	ERR_FAIL_INDEX((int)p_diagonal_mode, (int)DIAGONAL_MODE_MAX);
-	diagonal_mode = p_diagonal_mode;
+	if (diagonal_mode != p_diagonal_mode) {
+		diagonal_mode = p_diagonal_mode;
+		clusters_dirty = true;
+	}
 }
 
 AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
@@ -199,7 +242,10 @@ AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
 
 void AStarGrid2D::set_default_compute_heuristic(Heuristic p_heuristic) {
 	ERR_FAIL_INDEX((int)p_heuristic, (int)HEURISTIC_MAX);
-	default_compute_heuristic = p_heuristic;
+	if (default_compute_heuristic != p_heuristic) {
+		default_compute_heuristic = p_heuristic;
+		clusters_dirty = true;
+	}
 }
 
 AStarGrid2D::Heuristic AStarGrid2D::get_default_compute_heuristic() const {
@@ -218,7 +264,11 @@ AStarGrid2D::Heuristic AStarGrid2D::get_default_estimate_heuristic() const {
 void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set if point is disabled. Point %s out of bounds %s.", p_id, region));
-	_set_solid_unchecked(p_id, p_solid);
+	if (_get_solid_unchecked(p_id) != p_solid) {
+		_set_solid_unchecked(p_id, p_solid);
+		// Transitions of the neighboring clusters depend on the points next to their borders.
+		_mark_clusters_dirty(Rect2i(p_id - Vector2i(1, 1), Size2i(3, 3)));
+	}
 }
 
 bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
@@ -232,6 +282,7 @@ void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_s
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set point's weight scale. Point %s out of bounds %s.", p_id, region));
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
 	_get_point_unchecked(p_id)->weight_scale = p_weight_scale;
+	_mark_clusters_dirty(Rect2i(p_id, Size2i(1, 1)));
 }
 
 real_t AStarGrid2D::get_point_weight_scale(const Vector2i &p_id) const {
@@ -252,6 +303,7 @@ void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
 			_set_solid_unchecked(x, y, p_solid);
 		}
 	}
+	_mark_clusters_dirty(safe_region.grow(1));
 }
 
 void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weight_scale) {
@@ -267,6 +319,7 @@ void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weig
 			_get_point_unchecked(x, y)->weight_scale = p_weight_scale;
 		}
 	}
+	_mark_clusters_dirty(safe_region);
 }
 
 AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
@@ -491,7 +544,7 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 	}
 }
 
-bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path) {
+bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path, const Rect2i *p_bounds) {
 	last_closest_point = nullptr;
 	pass++;
 
@@ -541,7 +594,11 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point, bool p_allow_
 		for (Point *e : nbors) {
 			real_t weight_scale = 1.0;
 
-			if (jumping_enabled) {
+			if (p_bounds && !p_bounds->has_point(e->id)) {
+				continue;
+			}
+
+			if (jumping_enabled && !p_bounds) { // Jumps could leave the bounds.
 				// TODO: Make it works with weight_scale.
 				e = _jump(p, e);
 				if (!e || e->closed_pass == pass) {
@@ -599,9 +656,415 @@ real_t AStarGrid2D::_compute_cost(const Vector2i &p_from_id, const Vector2i &p_t
 	return heuristics[default_compute_heuristic](p_from_id, p_to_id);
 }
 
+void AStarGrid2D::_mark_clusters_dirty(const Rect2i &p_region) {
+	if (clusters_dirty) {
+		return; // Everything is rebuilt anyway.
+	}
+
+	const Rect2i safe_region = p_region.intersection(region);
+	if (!safe_region.has_area()) {
+		return;
+	}
+
+	const Vector2i from = (safe_region.position - region.position) / cluster_size;
+	const Vector2i to = (safe_region.get_end() - Vector2i(1, 1) - region.position) / cluster_size;
+	for (int32_t y = from.y; y <= to.y; y++) {
+		for (int32_t x = from.x; x <= to.x; x++) {
+			const uint32_t index = y * cluster_count.x + x;
+			if (!clusters[index].dirty) {
+				clusters[index].dirty = true;
+				dirty_clusters.push_back(index);
+			}
+		}
+	}
+}
+
+void AStarGrid2D::_update_clusters() {
+	if (clusters_dirty) {
+		cluster_count = Vector2i((region.size.x + cluster_size - 1) / cluster_size, (region.size.y + cluster_size - 1) / cluster_size);
+		clusters.clear();
+		clusters.resize(cluster_count.x * cluster_count.y);
+		dirty_clusters.clear();
+		for (int32_t y = 0; y < cluster_count.y; y++) {
+			for (int32_t x = 0; x < cluster_count.x; x++) {
+				const uint32_t index = y * cluster_count.x + x;
+				clusters[index].rect = Rect2i(region.position + Vector2i(x, y) * cluster_size, Size2i(cluster_size, cluster_size)).intersection(region);
+				dirty_clusters.push_back(index);
+			}
+		}
+		clusters_dirty = false;
+	}
+
+	// Scripts can't run on worker threads, so costs they compute can't either.
+	if (dirty_clusters.size() >= THREADED_MIN_CLUSTERS && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost) && WorkerThreadPool::get_singleton()) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStarGrid2D::_build_dirty_cluster, dirty_clusters.ptr(), dirty_clusters.size(), -1, true, SNAME("AStarGrid2DBuildClusters"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (const uint32_t index : dirty_clusters) {
+			_build_cluster(index);
+		}
+	}
+	dirty_clusters.clear();
+}
+
+void AStarGrid2D::_build_dirty_cluster(uint32_t p_index, const uint32_t *p_dirty_clusters) {
+	_build_cluster(p_dirty_clusters[p_index]);
+}
+
+void AStarGrid2D::_get_transitions(const Vector2i &p_cluster, LocalVector<Pair<Vector2i, Vector2i>> &r_transitions) {
+	// Openings between two rows of points, one on each side of a border.
+	auto add_entrances = [&](const Vector2i &p_start, const Vector2i &p_along, const Vector2i &p_across, int32_t p_length) {
+		int32_t run_start = -1;
+		for (int32_t i = 0; i <= p_length; i++) {
+			const Vector2i a = p_start + p_along * i;
+			const bool open = i < p_length && _is_walkable(a.x, a.y) && _is_walkable(a.x + p_across.x, a.y + p_across.y);
+			if (open && run_start < 0) {
+				run_start = i;
+			} else if (!open && run_start >= 0) {
+				if (i - run_start >= LONG_ENTRANCE_LENGTH) {
+					r_transitions.push_back(Pair<Vector2i, Vector2i>(p_start + p_along * run_start, p_start + p_along * run_start + p_across));
+					r_transitions.push_back(Pair<Vector2i, Vector2i>(p_start + p_along * (i - 1), p_start + p_along * (i - 1) + p_across));
+				} else {
+					const Vector2i middle = p_start + p_along * ((run_start + i - 1) / 2);
+					r_transitions.push_back(Pair<Vector2i, Vector2i>(middle, middle + p_across));
+				}
+				run_start = -1;
+			}
+		}
+	};
+
+	// Diagonal steps squeezing between two solid points, which no opening covers.
+	auto add_diagonals = [&](const Vector2i &p_a, const Vector2i &p_along, const Vector2i &p_across) {
+		const Vector2i a_next = p_a + p_along;
+		const Vector2i b = p_a + p_across;
+		const Vector2i b_next = a_next + p_across;
+		if (_is_walkable(p_a.x, p_a.y) && _is_walkable(b_next.x, b_next.y) && !_is_walkable(a_next.x, a_next.y) && !_is_walkable(b.x, b.y)) {
+			r_transitions.push_back(Pair<Vector2i, Vector2i>(p_a, b_next));
+		}
+		if (_is_walkable(a_next.x, a_next.y) && _is_walkable(b.x, b.y) && !_is_walkable(p_a.x, p_a.y) && !_is_walkable(b_next.x, b_next.y)) {
+			r_transitions.push_back(Pair<Vector2i, Vector2i>(a_next, b));
+		}
+	};
+
+	const Rect2i &rect = clusters[p_cluster.y * cluster_count.x + p_cluster.x].rect;
+	const bool has_right = p_cluster.x + 1 < cluster_count.x;
+	const bool has_bottom = p_cluster.y + 1 < cluster_count.y;
+
+	if (has_right) {
+		const Vector2i start = Vector2i(rect.get_end().x - 1, rect.position.y);
+		add_entrances(start, Vector2i(0, 1), Vector2i(1, 0), rect.size.y);
+		if (diagonal_mode == DIAGONAL_MODE_ALWAYS) {
+			// Includes the corner shared with the three clusters to the right and bottom.
+			const int32_t length = has_bottom ? rect.size.y : rect.size.y - 1;
+			for (int32_t i = 0; i < length; i++) {
+				add_diagonals(start + Vector2i(0, i), Vector2i(0, 1), Vector2i(1, 0));
+			}
+		}
+	}
+	if (has_bottom) {
+		const Vector2i start = Vector2i(rect.position.x, rect.get_end().y - 1);
+		add_entrances(start, Vector2i(1, 0), Vector2i(0, 1), rect.size.x);
+		if (diagonal_mode == DIAGONAL_MODE_ALWAYS) {
+			for (int32_t i = 0; i < rect.size.x - 1; i++) {
+				add_diagonals(start + Vector2i(i, 0), Vector2i(1, 0), Vector2i(0, 1));
+			}
+		}
+	}
+}
+
+void AStarGrid2D::_build_cluster(uint32_t p_index) {
+	Cluster &cluster = clusters[p_index];
+	cluster.nodes.clear();
+	cluster.costs.clear();
+	cluster.paths.clear();
+	cluster.dirty = false;
+
+	// Transitions are found from the cluster above or to the left of a border, so both sides agree on them.
+	LocalVector<Pair<Vector2i, Vector2i>> transitions;
+	const Vector2i coords = Vector2i(p_index % cluster_count.x, p_index / cluster_count.x);
+	for (int32_t y = MAX(coords.y - 1, 0); y <= coords.y; y++) {
+		for (int32_t x = MAX(coords.x - 1, 0); x <= coords.x; x++) {
+			_get_transitions(Vector2i(x, y), transitions);
+		}
+	}
+
+	for (const Pair<Vector2i, Vector2i> &E : transitions) {
+		Vector2i id = E.first;
+		Vector2i partner = E.second;
+		if (!cluster.rect.has_point(id)) {
+			SWAP(id, partner);
+			if (!cluster.rect.has_point(id)) {
+				continue;
+			}
+		}
+
+		ClusterNode *node = nullptr;
+		for (ClusterNode &existing : cluster.nodes) {
+			if (existing.id == id) {
+				node = &existing;
+				break;
+			}
+		}
+		if (!node) {
+			cluster.nodes.push_back(ClusterNode());
+			node = &cluster.nodes[cluster.nodes.size() - 1];
+			node->id = id;
+			node->cluster = p_index;
+		}
+		node->partners.push_back(partner);
+	}
+
+	const uint32_t count = cluster.nodes.size();
+	cluster.costs.resize(count * count);
+	cluster.paths.resize(count * count);
+	LocalVector<real_t> costs;
+	for (uint32_t i = 0; i < count; i++) {
+		_get_cluster_costs(cluster.rect, cluster.nodes[i].id, costs);
+		for (uint32_t j = 0; j < count; j++) {
+			cluster.costs[i * count + j] = costs[cluster_cell_index(cluster.rect, cluster.nodes[j].id)];
+		}
+	}
+}
+
+void AStarGrid2D::_get_cluster_costs(const Rect2i &p_rect, const Vector2i &p_from_id, LocalVector<real_t> &r_costs) {
+	struct Entry {
+		real_t cost = 0;
+		Point *point = nullptr;
+	};
+
+	struct SortEntries {
+		_FORCE_INLINE_ bool operator()(const Entry &A, const Entry &B) const {
+			return A.cost > B.cost;
+		}
+	};
+
+	// Dijkstra limited to the cluster, entries are left in the open list when a shorter path is found.
+	r_costs.resize(p_rect.size.x * p_rect.size.y);
+	for (real_t &cost : r_costs) {
+		cost = Math::INF;
+	}
+	r_costs[cluster_cell_index(p_rect, p_from_id)] = 0;
+
+	LocalVector<Entry> open_list;
+	SortArray<Entry, SortEntries> sorter;
+	LocalVector<Point *> nbors;
+	open_list.push_back({ 0, _get_point_unchecked(p_from_id) });
+
+	while (!open_list.is_empty()) {
+		const Entry entry = open_list[0];
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.remove_at(open_list.size() - 1);
+		if (entry.cost > r_costs[cluster_cell_index(p_rect, entry.point->id)]) {
+			continue;
+		}
+
+		nbors.clear();
+		_get_nbors(entry.point, nbors);
+		for (Point *e : nbors) {
+			if (!p_rect.has_point(e->id)) {
+				continue;
+			}
+
+			const real_t cost = entry.cost + _compute_cost(entry.point->id, e->id) * e->weight_scale;
+			real_t &e_cost = r_costs[cluster_cell_index(p_rect, e->id)];
+			if (cost < e_cost) {
+				e_cost = cost;
+				open_list.push_back({ cost, e });
+				sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+			}
+		}
+	}
+}
+
+AStarGrid2D::ClusterNode *AStarGrid2D::_get_cluster_node(const Vector2i &p_id) {
+	for (ClusterNode &node : clusters[_get_cluster_index(p_id)].nodes) {
+		if (node.id == p_id) {
+			return &node;
+		}
+	}
+	return nullptr;
+}
+
+bool AStarGrid2D::_append_local_path(Point *p_begin_point, Point *p_end_point, const Rect2i &p_rect, LocalVector<Vector2i> &r_path) {
+	if (p_begin_point == p_end_point) {
+		return true;
+	}
+	if (!_solve(p_begin_point, p_end_point, false, &p_rect)) {
+		return false;
+	}
+
+	const uint32_t start = r_path.size();
+	for (Point *p = p_end_point; p != p_begin_point; p = p->prev_point) {
+		r_path.push_back(p->id);
+	}
+	for (uint32_t i = start, j = r_path.size() - 1; i < j; i++, j--) {
+		SWAP(r_path[i], r_path[j]);
+	}
+	return true;
+}
+
+bool AStarGrid2D::_solve_hierarchical(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path) {
+	if (p_begin_point == p_end_point || _get_solid_unchecked(p_begin_point->id) || _get_solid_unchecked(p_end_point->id)) {
+		return _solve(p_begin_point, p_end_point, p_allow_partial_path);
+	}
+
+	_update_clusters();
+
+	const uint32_t begin_cluster_index = _get_cluster_index(p_begin_point->id);
+	const uint32_t end_cluster_index = _get_cluster_index(p_end_point->id);
+	Cluster &begin_cluster = clusters[begin_cluster_index];
+	Cluster &end_cluster = clusters[end_cluster_index];
+
+	// Close points are usually connected without leaving their cluster.
+	if (begin_cluster_index == end_cluster_index && _solve(p_begin_point, p_end_point, false, &begin_cluster.rect)) {
+		return true;
+	}
+
+	// Links the begin and end points to the nodes of their clusters.
+	LocalVector<real_t> begin_costs;
+	LocalVector<real_t> end_costs;
+	_get_cluster_costs(begin_cluster.rect, p_begin_point->id, begin_costs);
+	_get_cluster_costs(end_cluster.rect, p_end_point->id, end_costs);
+
+	pass++;
+
+	ClusterNode end_node;
+	end_node.id = p_end_point->id;
+	end_node.cluster = end_cluster_index;
+
+	LocalVector<ClusterNode *> open_list;
+	SortArray<ClusterNode *, SortPoints> sorter;
+
+	auto relax = [&](ClusterNode *p_node, ClusterNode *p_prev_node, real_t p_g_score) {
+		if (p_node->closed_pass == pass) {
+			return;
+		}
+
+		bool new_node = false;
+		if (p_node->open_pass != pass) { // The node wasn't inside the open list.
+			p_node->open_pass = pass;
+			open_list.push_back(p_node);
+			new_node = true;
+		} else if (p_g_score >= p_node->g_score) { // The new path is worse than the previous.
+			return;
+		}
+
+		p_node->prev_node = p_prev_node;
+		p_node->g_score = p_g_score;
+		p_node->f_score = p_g_score + _estimate_cost(p_node->id, p_end_point->id);
+
+		if (new_node) {
+			sorter.push_heap(0, open_list.size() - 1, 0, p_node, open_list.ptr());
+		} else {
+			sorter.push_heap(0, open_list.find(p_node), 0, p_node, open_list.ptr());
+		}
+	};
+
+	for (ClusterNode &node : begin_cluster.nodes) {
+		const real_t cost = begin_costs[cluster_cell_index(begin_cluster.rect, node.id)];
+		if (cost < Math::INF) {
+			relax(&node, nullptr, cost);
+		}
+	}
+
+	bool found_route = false;
+	while (!open_list.is_empty()) {
+		ClusterNode *n = open_list[0];
+		if (n == &end_node) {
+			found_route = true;
+			break;
+		}
+
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		open_list.remove_at(open_list.size() - 1);
+		n->closed_pass = pass;
+
+		Cluster &cluster = clusters[n->cluster];
+		const uint32_t count = cluster.nodes.size();
+		const uint32_t i = n - cluster.nodes.ptr();
+		for (uint32_t j = 0; j < count; j++) {
+			const real_t cost = cluster.costs[i * count + j];
+			if (j != i && cost < Math::INF) {
+				relax(&cluster.nodes[j], n, n->g_score + cost);
+			}
+		}
+
+		for (const Vector2i &partner : n->partners) {
+			ClusterNode *e = _get_cluster_node(partner);
+			ERR_CONTINUE(!e);
+			relax(e, n, n->g_score + _compute_cost(n->id, partner) * _get_point_unchecked(partner)->weight_scale);
+		}
+
+		if (n->cluster == end_cluster_index) {
+			const real_t cost = end_costs[cluster_cell_index(end_cluster.rect, n->id)];
+			if (cost < Math::INF) {
+				relax(&end_node, n, n->g_score + cost);
+			}
+		}
+	}
+
+	if (!found_route) {
+		// The clusters only tell whether the end is reachable, partial paths come from a full search.
+		last_closest_point = nullptr;
+		return p_allow_partial_path && _solve(p_begin_point, p_end_point, true);
+	}
+
+	LocalVector<ClusterNode *> nodes;
+	for (ClusterNode *n = end_node.prev_node; n != nullptr; n = n->prev_node) {
+		nodes.push_back(n);
+	}
+	nodes.reverse();
+
+	// Turns the nodes into a path, using the cached paths between nodes of the same cluster.
+	LocalVector<Vector2i> path;
+	path.push_back(p_begin_point->id);
+	bool refined = _append_local_path(p_begin_point, _get_point_unchecked(nodes[0]->id), begin_cluster.rect, path);
+	for (uint32_t i = 1; refined && i < nodes.size(); i++) {
+		const ClusterNode *from = nodes[i - 1];
+		const ClusterNode *to = nodes[i];
+		if (from->cluster != to->cluster) {
+			path.push_back(to->id);
+			continue;
+		}
+
+		Cluster &cluster = clusters[from->cluster];
+		LocalVector<Vector2i> &cached = cluster.paths[(from - cluster.nodes.ptr()) * cluster.nodes.size() + (to - cluster.nodes.ptr())];
+		if (cached.is_empty()) {
+			cached.push_back(from->id);
+			refined = _append_local_path(_get_point_unchecked(from->id), _get_point_unchecked(to->id), cluster.rect, cached);
+			if (!refined) {
+				cached.clear();
+				break;
+			}
+		}
+		for (uint32_t j = 1; j < cached.size(); j++) {
+			path.push_back(cached[j]);
+		}
+	}
+	refined = refined && _append_local_path(_get_point_unchecked(nodes[nodes.size() - 1]->id), p_end_point, end_cluster.rect, path);
+	last_closest_point = nullptr;
+	ERR_FAIL_COND_V_MSG(!refined, false, "Couldn't turn the cluster nodes into a path.");
+
+	// The pieces may cross each other, linking each point to where it was first reached drops the loops.
+	pass++;
+	p_begin_point->closed_pass = pass;
+	for (uint32_t i = 1; i < path.size(); i++) {
+		Point *p = _get_point_unchecked(path[i]);
+		if (p->closed_pass != pass) {
+			p->closed_pass = pass;
+			p->prev_point = _get_point_unchecked(path[i - 1]);
+		}
+	}
+
+	return true;
+}
+
 void AStarGrid2D::clear() {
 	points.clear();
 	region = Rect2i();
+	clusters.clear();
+	dirty_clusters.clear();
+	clusters_dirty = true;
 }
 
 Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
@@ -645,7 +1108,7 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 	Point *begin_point = _get_point(p_from_id.x, p_from_id.y);
 	Point *end_point = _get_point(p_to_id.x, p_to_id.y);
 
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
+	bool found_route = hierarchical_enabled ? _solve_hierarchical(begin_point, end_point, p_allow_partial_path) : _solve(begin_point, end_point, p_allow_partial_path);
 	if (!found_route) {
 		if (!p_allow_partial_path || last_closest_point == nullptr) {
 			return Vector<Vector2>();
@@ -689,7 +1152,7 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	Point *begin_point = _get_point(p_from_id.x, p_from_id.y);
 	Point *end_point = _get_point(p_to_id.x, p_to_id.y);
 
-	bool found_route = _solve(begin_point, end_point, p_allow_partial_path);
+	bool found_route = hierarchical_enabled ? _solve_hierarchical(begin_point, end_point, p_allow_partial_path) : _solve(begin_point, end_point, p_allow_partial_path);
 	if (!found_route) {
 		if (!p_allow_partial_path || last_closest_point == nullptr) {
 			return TypedArray<Vector2i>();
@@ -740,6 +1203,10 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("update"), &AStarGrid2D::update);
 	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
 	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("set_hierarchical_enabled", "enabled"), &AStarGrid2D::set_hierarchical_enabled);
+	ClassDB::bind_method(D_METHOD("is_hierarchical_enabled"), &AStarGrid2D::is_hierarchical_enabled);
+	ClassDB::bind_method(D_METHOD("set_cluster_size", "cluster_size"), &AStarGrid2D::set_cluster_size);
+	ClassDB::bind_method(D_METHOD("get_cluster_size"), &AStarGrid2D::get_cluster_size);
 	ClassDB::bind_method(D_METHOD("set_diagonal_mode", "mode"), &AStarGrid2D::set_diagonal_mode);
 	ClassDB::bind_method(D_METHOD("get_diagonal_mode"), &AStarGrid2D::get_diagonal_mode);
 	ClassDB::bind_method(D_METHOD("set_default_compute_heuristic", "heuristic"), &AStarGrid2D::set_default_compute_heuristic);
@@ -769,6 +1236,8 @@ void AStarGrid2D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "cell_shape", PROPERTY_HINT_ENUM, "Square,IsometricRight,IsometricDown"), "set_cell_shape", "get_cell_shape");
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "hierarchical_enabled"), "set_hierarchical_enabled", "is_hierarchical_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "cluster_size", PROPERTY_HINT_RANGE, "2,128,1,or_greater"), "set_cluster_size", "get_cluster_size");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_compute_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_compute_heuristic", "get_default_compute_heuristic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_estimate_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_estimate_heuristic", "get_default_estimate_heuristic");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "diagonal_mode", PROPERTY_HINT_ENUM, "Always,Never,At Least One Walkable,Only If No Obstacles"), "set_diagonal_mode", "get_diagonal_mode");
@@ -33,6 +33,7 @@
 #include "core/object/gdvirtual.gen.h"
 #include "core/object/ref_counted.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/pair.h"
 
 class AStarGrid2D : public RefCounted {
 	GDCLASS(AStarGrid2D, RefCounted);
@@ -97,7 +98,8 @@ private:
 	};
 
 	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
+		template <typename T>
+		_FORCE_INLINE_ bool operator()(const T *A, const T *B) const { // Returns true when the Point A is worse than Point B.
 			if (A->f_score > B->f_score) {
 				return true;
 			} else if (A->f_score < B->f_score) {
@@ -115,6 +117,39 @@ private:
 
 	uint64_t pass = 1;
 
+	// Hierarchical pathfinding splits the grid in clusters, linked by the points on their borders.
+	bool hierarchical_enabled = false;
+	int32_t cluster_size = 16;
+
+	struct ClusterNode {
+		Vector2i id;
+		uint32_t cluster = 0;
+		// Points of neighboring clusters reachable in one step.
+		LocalVector<Vector2i> partners;
+
+		// Used for pathfinding.
+		ClusterNode *prev_node = nullptr;
+		real_t g_score = 0;
+		real_t f_score = 0;
+		uint64_t open_pass = 0;
+		uint64_t closed_pass = 0;
+	};
+
+	struct Cluster {
+		Rect2i rect;
+		LocalVector<ClusterNode> nodes;
+		// Cost between each pair of nodes without leaving the cluster, INF when there is no such path.
+		LocalVector<real_t> costs;
+		// Paths between pairs of nodes, cached on first use.
+		LocalVector<LocalVector<Vector2i>> paths;
+		bool dirty = true;
+	};
+
+	LocalVector<Cluster> clusters;
+	LocalVector<uint32_t> dirty_clusters;
+	Vector2i cluster_count;
+	bool clusters_dirty = true;
+
 private: // Internal routines.
 	_FORCE_INLINE_ size_t _to_mask_index(int32_t p_x, int32_t p_y) const {
 		return ((p_y - region.position.y + 1) * (region.size.x + 2)) + p_x - region.position.x + 1;
@@ -155,11 +190,25 @@ private: // Internal routines.
 		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
 	}
 
+	_FORCE_INLINE_ uint32_t _get_cluster_index(const Vector2i &p_id) const {
+		return ((p_id.y - region.position.y) / cluster_size) * cluster_count.x + (p_id.x - region.position.x) / cluster_size;
+	}
+
 	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
 	Point *_jump(Point *p_from, Point *p_to);
-	bool _solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
+	bool _solve(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path, const Rect2i *p_bounds = nullptr);
 	Point *_forced_successor(int32_t p_x, int32_t p_y, int32_t p_dx, int32_t p_dy, bool p_inclusive = false);
 
+	void _mark_clusters_dirty(const Rect2i &p_region);
+	void _update_clusters();
+	void _get_transitions(const Vector2i &p_cluster, LocalVector<Pair<Vector2i, Vector2i>> &r_transitions);
+	void _build_cluster(uint32_t p_index);
+	void _build_dirty_cluster(uint32_t p_index, const uint32_t *p_dirty_clusters);
+	void _get_cluster_costs(const Rect2i &p_rect, const Vector2i &p_from_id, LocalVector<real_t> &r_costs);
+	ClusterNode *_get_cluster_node(const Vector2i &p_id);
+	bool _append_local_path(Point *p_begin_point, Point *p_end_point, const Rect2i &p_rect, LocalVector<Vector2i> &r_path);
+	bool _solve_hierarchical(Point *p_begin_point, Point *p_end_point, bool p_allow_partial_path);
+
 protected:
 	static void _bind_methods();
 
@@ -200,6 +249,12 @@ public:
 	void set_jumping_enabled(bool p_enabled);
 	bool is_jumping_enabled() const;
 
+	void set_hierarchical_enabled(bool p_enabled);
+	bool is_hierarchical_enabled() const;
+
+	void set_cluster_size(int32_t p_cluster_size);
+	int32_t get_cluster_size() const;
+
 	void set_diagonal_mode(DiagonalMode p_diagonal_mode);
 	DiagonalMode get_diagonal_mode() const;
 
@@ -31,6 +31,7 @@
 #include "basis.h"
 
 #include "core/math/math_funcs.h"
+#include "core/math/transform_batch.h"
 #include "core/string/ustring.h"
 
 #define cofac(row1, col1, row2, col2) \
@@ -705,6 +706,20 @@ bool Basis::is_finite() const {
 	return rows[0].is_finite() && rows[1].is_finite() && rows[2].is_finite();
 }
 
+Vector<Vector3> Basis::xform(const Vector<Vector3> &p_array) const {
+	Vector<Vector3> array;
+	array.resize(p_array.size());
+	TransformBatch::basis_xform(*this, p_array.ptr(), array.ptrw(), p_array.size());
+	return array;
+}
+
+Vector<Vector3> Basis::xform_inv(const Vector<Vector3> &p_array) const {
+	Vector<Vector3> array;
+	array.resize(p_array.size());
+	TransformBatch::basis_xform_inv(*this, p_array.ptr(), array.ptrw(), p_array.size());
+	return array;
+}
+
 Basis::operator String() const {
 	return "[X: " + get_column(0).operator String() +
 			", Y: " + get_column(1).operator String() +
@@ -33,6 +33,9 @@
 #include "core/math/quaternion.h"
 #include "core/math/vector3.h"
 
+template <typename T>
+class Vector;
+
 struct [[nodiscard]] Basis {
 	static const Basis FLIP_X;
 	static const Basis FLIP_Y;
@@ -132,6 +135,8 @@ struct [[nodiscard]] Basis {
 
 	_FORCE_INLINE_ Vector3 xform(const Vector3 &p_vector) const;
 	_FORCE_INLINE_ Vector3 xform_inv(const Vector3 &p_vector) const;
+	Vector<Vector3> xform(const Vector<Vector3> &p_array) const;
+	Vector<Vector3> xform_inv(const Vector<Vector3> &p_array) const;
 	_FORCE_INLINE_ void operator*=(const Basis &p_matrix);
 	_FORCE_INLINE_ Basis operator*(const Basis &p_matrix) const;
 	constexpr void operator+=(const Basis &p_matrix);
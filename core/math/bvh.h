@@ -89,6 +89,13 @@ public:
 		tree.params_set_pairing_expansion(p_value);
 	}
 
+	// Large trees can use the worker threads to refit and to find the new pairs.
+	// The callbacks are still only called from the thread calling update().
+	void params_set_use_threads(bool p_enable) {
+		BVH_LOCKED_FUNCTION
+		tree._use_threads = p_enable;
+	}
+
 	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
 		BVH_LOCKED_FUNCTION
 		pair_callback = p_callback;
@@ -443,7 +450,19 @@ private:
 		params.result_array = nullptr;
 		params.subindex_array = nullptr;
 
-		for (const BVHHandle &h : changed_items) {
+		// The culls only read the tree, so when there are many changed items they are all
+		// done up front on the worker threads. The pairing itself calls the callbacks,
+		// so it is always done here, in the same order.
+		bool threaded = tree._use_threads && changed_items.size() >= PAIRING_THREADED_MIN_ITEMS;
+		if (threaded) {
+			_pairing_hits.resize(changed_items.size());
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &BVH_Manager::_pairing_cull_task, nullptr, changed_items.size(), -1, true, SNAME("BVHPairingCull"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		}
+
+		for (uint32_t i = 0; i < changed_items.size(); i++) {
+			const BVHHandle &h = changed_items[i];
+
 			// use the expanded aabb for pairing
 			const BOUNDS &expanded_aabb = tree._pairs[h.id()].expanded_aabb;
 			BVHABB_CLASS abb;
@@ -457,12 +476,17 @@ private:
 
 			uint32_t changed_item_ref_id = h.id();
 
-			params.abb = abb;
+			const LocalVector<uint32_t> *hits = &tree._cull_hits;
+			if (threaded) {
+				hits = &_pairing_hits[i];
+			} else {
+				params.abb = abb;
 
-			params.result_count_overall = 0; // might not be needed
-			tree.cull_aabb(params, false);
+				params.result_count_overall = 0; // might not be needed
+				tree.cull_aabb(params, false);
+			}
 
-			for (const uint32_t ref_id : tree._cull_hits) {
+			for (const uint32_t ref_id : *hits) {
 				// don't collide against ourself
 				if (ref_id == changed_item_ref_id) {
 					continue;
@@ -479,6 +503,20 @@ private:
 		_reset();
 	}
 
+	void _pairing_cull_task(uint32_t p_index, void *p_userdata) {
+		const BVHHandle &h = changed_items[p_index];
+
+		typename BVHTREE_CLASS::CullParams params;
+		params.result_count_overall = 0;
+		params.result_max = INT_MAX;
+		params.result_array = nullptr;
+		params.subindex_array = nullptr;
+		tree.item_fill_cullparams(h, params);
+		params.abb.from(tree._pairs[h.id()].expanded_aabb);
+
+		tree.cull_aabb_hits(params, _pairing_hits[p_index]);
+	}
+
 public:
 	void item_get_AABB(BVHHandle p_handle, BOUNDS &r_aabb) {
 		DEV_ASSERT(!p_handle.is_invalid());
@@ -772,6 +810,10 @@ private:
 	LocalVector<BVHHandle> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	// hits for each of the changed items, when culled on the worker threads
+	static const uint32_t PAIRING_THREADED_MIN_ITEMS = 128;
+	LocalVector<LocalVector<uint32_t>> _pairing_hits;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
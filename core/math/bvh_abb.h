@@ -32,6 +32,17 @@
 
 #include "core/math/aabb.h"
 
+// The corner tests can compare all the components of both corners at once.
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BVH_ABB_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define BVH_ABB_NEON
+#include <arm_neon.h>
+#endif
+#endif // REAL_T_IS_DOUBLE
+
 // special optimized version of axis aligned bounding box
 template <typename BOUNDS = AABB, typename POINT = Vector3>
 struct BVH_ABB {
@@ -204,13 +215,10 @@ struct BVH_ABB {
 	}
 
 	bool intersects_point(const POINT &p_pt) const {
-		if (_any_lessthan(-p_pt, neg_max)) {
-			return false;
-		}
-		if (_any_lessthan(p_pt, min)) {
-			return false;
-		}
-		return true;
+		BVH_ABB point;
+		point.min = p_pt;
+		point.neg_max = -p_pt;
+		return !_any_corner_lessthan(point, *this);
 	}
 
 	// Very hot in profiling, make sure optimized
@@ -224,25 +232,22 @@ struct BVH_ABB {
 		return true;
 	}
 
+	// Swizzling the tester lets intersects() be done as a single corner test,
+	// this is worth it when the same tester is used many times.
+	BVH_ABB swizzled() const {
+		BVH_ABB r;
+		r.min = -neg_max;
+		r.neg_max = -min;
+		return r;
+	}
+
 	// for pre-swizzled tester (this object)
 	bool intersects_swizzled(const BVH_ABB &p_o) const {
-		if (_any_lessthan(min, p_o.min)) {
-			return false;
-		}
-		if (_any_lessthan(neg_max, p_o.neg_max)) {
-			return false;
-		}
-		return true;
+		return !_any_corner_lessthan(*this, p_o);
 	}
 
 	bool is_other_within(const BVH_ABB &p_o) const {
-		if (_any_lessthan(p_o.neg_max, neg_max)) {
-			return false;
-		}
-		if (_any_lessthan(p_o.min, min)) {
-			return false;
-		}
-		return true;
+		return !_any_corner_lessthan(p_o, *this);
 	}
 
 	void grow(const POINT &p_change) {
@@ -288,4 +293,36 @@ struct BVH_ABB {
 		}
 		return false;
 	}
+
+	// Same as _any_lessthan() on both min and neg_max, but without branching on each component.
+	static bool _any_corner_lessthan(const BVH_ABB &p_a, const BVH_ABB &p_b) {
+#if defined(BVH_ABB_SSE2)
+		if constexpr (sizeof(BVH_ABB) == 4 * sizeof(float)) {
+			const __m128 lt = _mm_cmplt_ps(_mm_loadu_ps(&p_a.min.x), _mm_loadu_ps(&p_b.min.x));
+			return _mm_movemask_ps(lt) != 0;
+		} else if constexpr (sizeof(BVH_ABB) == 6 * sizeof(float)) {
+			// The last two components are loaded as a pair, the upper lanes are zero on both sides.
+			const __m128 lt_lo = _mm_cmplt_ps(_mm_loadu_ps(&p_a.min.x), _mm_loadu_ps(&p_b.min.x));
+			const __m128 lt_hi = _mm_cmplt_ps(_mm_castpd_ps(_mm_load_sd((const double *)&p_a.neg_max.y)), _mm_castpd_ps(_mm_load_sd((const double *)&p_b.neg_max.y)));
+			return _mm_movemask_ps(_mm_or_ps(lt_lo, lt_hi)) != 0;
+		}
+#elif defined(BVH_ABB_NEON)
+		if constexpr (sizeof(BVH_ABB) == 4 * sizeof(float)) {
+			const uint32x4_t lt = vcltq_f32(vld1q_f32(&p_a.min.x), vld1q_f32(&p_b.min.x));
+			const uint32x2_t any = vorr_u32(vget_low_u32(lt), vget_high_u32(lt));
+			return vget_lane_u64(vreinterpret_u64_u32(any), 0) != 0;
+		} else if constexpr (sizeof(BVH_ABB) == 6 * sizeof(float)) {
+			const uint32x4_t lt_lo = vcltq_f32(vld1q_f32(&p_a.min.x), vld1q_f32(&p_b.min.x));
+			const uint32x2_t lt_hi = vclt_f32(vld1_f32(&p_a.neg_max.y), vld1_f32(&p_b.neg_max.y));
+			const uint32x2_t any = vorr_u32(vorr_u32(vget_low_u32(lt_lo), vget_high_u32(lt_lo)), lt_hi);
+			return vget_lane_u64(vreinterpret_u64_u32(any), 0) != 0;
+		}
+#endif
+		for (int axis = 0; axis < POINT::AXIS_COUNT; ++axis) {
+			if (p_a.min[axis] < p_b.min[axis] || p_a.neg_max[axis] < p_b.neg_max[axis]) {
+				return true;
+			}
+		}
+		return false;
+	}
 };
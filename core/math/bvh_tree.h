@@ -41,6 +41,7 @@
 #include "core/math/aabb.h"
 #include "core/math/bvh_abb.h"
 #include "core/math/vector3.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/pooled_list.h"
 
@@ -152,7 +153,7 @@ public:
 template <typename T>
 class BVH_DummyPairTestFunction {
 public:
-	static bool user_collision_check(T *p_a, T *p_b) {
+	static bool user_pair_check(const T *p_a, const T *p_b) {
 		// return false if no collision, decided by masks etc
 		return true;
 	}
@@ -161,7 +162,7 @@ public:
 template <typename T>
 class BVH_DummyCullTestFunction {
 public:
-	static bool user_cull_check(T *p_a, T *p_b) {
+	static bool user_cull_check(const T *p_a, const T *p_b) {
 		// return false if no collision
 		return true;
 	}
@@ -31,6 +31,10 @@
 #include "expression.h"
 
 #include "core/object/class_db.h"
+#include "core/variant/variant_internal.h"
+
+BinaryMutex Expression::program_cache_mutex;
+HashMap<Expression::ProgramKey, Expression::Program *, Expression::ProgramKey> Expression::program_cache;
 
 Error Expression::_get_token(Token &r_token) {
 	while (true) {
@@ -1206,270 +1210,544 @@ Expression::ENode *Expression::_parse_expression() {
 	return expression_nodes[0].node;
 }
 
-bool Expression::_compile_expression() {
-	if (!expression_dirty) {
-		return error_set;
-	}
-
-	if (nodes) {
-		memdelete(nodes);
-		nodes = nullptr;
-		root = nullptr;
-	}
-
-	error_str = String();
-	error_set = false;
-	str_ofs = 0;
-
-	root = _parse_expression();
+// Only values that are copied on assignment can be folded, a folded Array or Object would be shared by every execution.
+static _FORCE_INLINE_ bool _is_foldable(const Variant &p_value) {
+	return p_value.get_type() < Variant::OBJECT;
+}
 
-	if (error_set) {
-		root = nullptr;
-		if (nodes) {
-			memdelete(nodes);
+void Expression::_compile(const ENode *p_node, Program &r_program, int32_t &r_stack) {
+	const uint32_t code_start = r_program.code.size();
+	const uint32_t constant_start = r_program.constants.size();
+
+	// Pushing a constant is also how folded nodes end up.
+	auto push_constant = [&](const Variant &p_value) {
+		r_program.code.resize(code_start);
+		r_program.constants.resize(constant_start);
+		r_program.code.push_back(OPCODE_CONSTANT);
+		r_program.code.push_back(r_program.constants.size());
+		r_program.constants.push_back(p_value);
+	};
+	// True if the node's operands were all compiled to constants, which are stored in r_values.
+	auto get_constant_operands = [&](uint32_t p_count, const Variant **r_values) {
+		if (r_program.code.size() - code_start != p_count * 2) {
+			return false;
+		}
+		for (uint32_t i = 0; i < p_count; i++) {
+			if (r_program.code[code_start + i * 2] != OPCODE_CONSTANT) {
+				return false;
+			}
+			r_values[i] = &r_program.constants[r_program.code[code_start + i * 2 + 1]];
 		}
-		nodes = nullptr;
 		return true;
-	}
-
-	expression_dirty = false;
-	return false;
-}
+	};
+	auto push_name = [&](const StringName &p_name) {
+		int64_t index = r_program.names.find(p_name);
+		if (index == -1) {
+			index = r_program.names.size();
+			r_program.names.push_back(p_name);
+		}
+		r_program.code.push_back(index);
+	};
 
-bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, bool p_const_calls_only, String &r_error_str) {
 	switch (p_node->type) {
 		case Expression::ENode::TYPE_INPUT: {
 			const Expression::InputNode *in = static_cast<const Expression::InputNode *>(p_node);
-			if (in->index < 0 || in->index >= p_inputs.size()) {
-				r_error_str = vformat(RTR("Invalid input %d (not passed) in expression"), in->index);
-				return true;
-			}
-			r_ret = p_inputs[in->index];
+			r_program.code.push_back(OPCODE_INPUT);
+			r_program.code.push_back(in->index);
 		} break;
 		case Expression::ENode::TYPE_CONSTANT: {
 			const Expression::ConstantNode *c = static_cast<const Expression::ConstantNode *>(p_node);
-			r_ret = c->value;
-
+			push_constant(c->value);
 		} break;
 		case Expression::ENode::TYPE_SELF: {
-			if (!p_instance) {
-				r_error_str = RTR("self can't be used because instance is null (not passed)");
-				return true;
-			}
-			r_ret = p_instance;
+			r_program.code.push_back(OPCODE_SELF);
 		} break;
 		case Expression::ENode::TYPE_OPERATOR: {
 			const Expression::OperatorNode *op = static_cast<const Expression::OperatorNode *>(p_node);
-
-			Variant a;
-			bool ret = _execute(p_inputs, p_instance, op->nodes[0], a, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
+			const bool unary = op->nodes[1] == nullptr;
+			_compile(op->nodes[0], r_program, r_stack);
+			if (!unary) {
+				_compile(op->nodes[1], r_program, r_stack);
 			}
 
-			Variant b;
-
-			if (op->nodes[1]) {
-				ret = _execute(p_inputs, p_instance, op->nodes[1], b, p_const_calls_only, r_error_str);
-				if (ret) {
-					return true;
+			const Variant *args[2] = { nullptr, nullptr };
+			if (get_constant_operands(unary ? 1 : 2, args)) {
+				Variant value;
+				bool valid = true;
+				Variant::evaluate(op->op, *args[0], unary ? Variant() : *args[1], value, valid);
+				if (valid && _is_foldable(value)) {
+					r_stack -= unary ? 1 : 2;
+					push_constant(value);
+					break;
 				}
 			}
 
-			bool valid = true;
-			Variant::evaluate(op->op, a, b, r_ret, valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(op->op), Variant::get_type_name(a.get_type()), Variant::get_type_name(b.get_type()));
-				return true;
-			}
-
+			r_program.code.push_back(unary ? OPCODE_OPERATOR_UNARY : OPCODE_OPERATOR);
+			r_program.code.push_back(op->op);
+			r_stack -= unary ? 1 : 2;
 		} break;
 		case Expression::ENode::TYPE_INDEX: {
 			const Expression::IndexNode *index = static_cast<const Expression::IndexNode *>(p_node);
-
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, index->base, base, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
-			}
-
-			Variant idx;
-
-			ret = _execute(p_inputs, p_instance, index->index, idx, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
-			}
-
-			bool valid;
-			r_ret = base.get(idx, &valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(idx.get_type()), Variant::get_type_name(base.get_type()));
-				return true;
+			_compile(index->base, r_program, r_stack);
+			_compile(index->index, r_program, r_stack);
+			r_stack -= 2;
+
+			const Variant *args[2] = { nullptr, nullptr };
+			if (get_constant_operands(2, args)) {
+				bool valid = false;
+				Variant value = args[0]->get(*args[1], &valid);
+				if (valid && _is_foldable(value)) {
+					push_constant(value);
+					break;
+				}
 			}
 
+			r_program.code.push_back(OPCODE_INDEX);
 		} break;
 		case Expression::ENode::TYPE_NAMED_INDEX: {
 			const Expression::NamedIndexNode *index = static_cast<const Expression::NamedIndexNode *>(p_node);
-
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, index->base, base, p_const_calls_only, r_error_str);
-			if (ret) {
-				return true;
-			}
-
-			bool valid;
-			r_ret = base.get_named(index->name, valid);
-			if (!valid) {
-				r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(index->name), Variant::get_type_name(base.get_type()));
-				return true;
+			_compile(index->base, r_program, r_stack);
+			r_stack -= 1;
+
+			const Variant *base = nullptr;
+			if (get_constant_operands(1, &base)) {
+				bool valid = false;
+				Variant value = base->get_named(index->name, valid);
+				if (valid && _is_foldable(value)) {
+					push_constant(value);
+					break;
+				}
 			}
 
+			r_program.code.push_back(OPCODE_NAMED_INDEX);
+			push_name(index->name);
 		} break;
 		case Expression::ENode::TYPE_ARRAY: {
 			const Expression::ArrayNode *array = static_cast<const Expression::ArrayNode *>(p_node);
-
-			Array arr;
-			arr.resize(array->array.size());
 			for (int i = 0; i < array->array.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, array->array[i], value, p_const_calls_only, r_error_str);
-
-				if (ret) {
-					return true;
-				}
-				arr[i] = value;
+				_compile(array->array[i], r_program, r_stack);
 			}
+			r_stack -= array->array.size();
 
-			r_ret = arr;
-
+			r_program.code.push_back(OPCODE_ARRAY);
+			r_program.code.push_back(array->array.size());
 		} break;
 		case Expression::ENode::TYPE_DICTIONARY: {
 			const Expression::DictionaryNode *dictionary = static_cast<const Expression::DictionaryNode *>(p_node);
-
-			Dictionary d;
-			for (int i = 0; i < dictionary->dict.size(); i += 2) {
-				Variant key;
-				bool ret = _execute(p_inputs, p_instance, dictionary->dict[i + 0], key, p_const_calls_only, r_error_str);
-
-				if (ret) {
-					return true;
-				}
-
-				Variant value;
-				ret = _execute(p_inputs, p_instance, dictionary->dict[i + 1], value, p_const_calls_only, r_error_str);
-				if (ret) {
-					return true;
-				}
-
-				d[key] = value;
+			for (int i = 0; i < dictionary->dict.size(); i++) {
+				_compile(dictionary->dict[i], r_program, r_stack);
 			}
+			r_stack -= dictionary->dict.size();
 
-			r_ret = d;
+			r_program.code.push_back(OPCODE_DICTIONARY);
+			r_program.code.push_back(dictionary->dict.size() / 2);
 		} break;
 		case Expression::ENode::TYPE_CONSTRUCTOR: {
 			const Expression::ConstructorNode *constructor = static_cast<const Expression::ConstructorNode *>(p_node);
-
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(constructor->arguments.size());
-			argp.resize(constructor->arguments.size());
-
 			for (int i = 0; i < constructor->arguments.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, constructor->arguments[i], value, p_const_calls_only, r_error_str);
-
-				if (ret) {
-					return true;
-				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
+				_compile(constructor->arguments[i], r_program, r_stack);
 			}
+			r_stack -= constructor->arguments.size();
 
-			Callable::CallError ce;
-			Variant::construct(constructor->data_type, r_ret, (const Variant **)argp.ptr(), argp.size(), ce);
-
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(constructor->data_type));
-				return true;
+			const Variant **argp = (const Variant **)alloca(sizeof(Variant *) * (constructor->arguments.size() + 1));
+			if (constructor->data_type < Variant::OBJECT && get_constant_operands(constructor->arguments.size(), argp)) {
+				Variant value;
+				Callable::CallError ce;
+				Variant::construct(constructor->data_type, value, argp, constructor->arguments.size(), ce);
+				if (ce.error == Callable::CallError::CALL_OK) {
+					push_constant(value);
+					break;
+				}
 			}
 
+			r_program.code.push_back(OPCODE_CONSTRUCT);
+			r_program.code.push_back(constructor->data_type);
+			r_program.code.push_back(constructor->arguments.size());
 		} break;
 		case Expression::ENode::TYPE_BUILTIN_FUNC: {
+			// Not folded, some utility functions aren't pure (like randf()).
 			const Expression::BuiltinFuncNode *bifunc = static_cast<const Expression::BuiltinFuncNode *>(p_node);
-
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(bifunc->arguments.size());
-			argp.resize(bifunc->arguments.size());
-
 			for (int i = 0; i < bifunc->arguments.size(); i++) {
-				Variant value;
-				bool ret = _execute(p_inputs, p_instance, bifunc->arguments[i], value, p_const_calls_only, r_error_str);
-				if (ret) {
-					return true;
-				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
-			}
-
-			r_ret = Variant(); //may not return anything
-			Callable::CallError ce;
-			Variant::call_utility_function(bifunc->func, &r_ret, (const Variant **)argp.ptr(), argp.size(), ce);
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = "Builtin call failed: " + Variant::get_call_error_text(bifunc->func, (const Variant **)argp.ptr(), argp.size(), ce);
-				return true;
+				_compile(bifunc->arguments[i], r_program, r_stack);
 			}
+			r_stack -= bifunc->arguments.size();
 
+			r_program.code.push_back(OPCODE_BUILTIN_FUNC);
+			push_name(bifunc->func);
+			r_program.code.push_back(bifunc->arguments.size());
 		} break;
 		case Expression::ENode::TYPE_CALL: {
 			const Expression::CallNode *call = static_cast<const Expression::CallNode *>(p_node);
+			_compile(call->base, r_program, r_stack);
+			for (int i = 0; i < call->arguments.size(); i++) {
+				_compile(call->arguments[i], r_program, r_stack);
+			}
+			r_stack -= call->arguments.size() + 1;
 
-			Variant base;
-			bool ret = _execute(p_inputs, p_instance, call->base, base, p_const_calls_only, r_error_str);
+			r_program.code.push_back(OPCODE_CALL);
+			push_name(call->method);
+			r_program.code.push_back(call->arguments.size());
+		} break;
+	}
+
+	// Every node leaves its value on the stack.
+	r_stack++;
+	r_program.stack_size = MAX(r_program.stack_size, r_stack);
+}
 
-			if (ret) {
+// Common int, float and bool operations, done in place without going through the operator tables.
+static _FORCE_INLINE_ bool _evaluate_numeric(Variant::Operator p_op, Variant &r_left, const Variant &p_right) {
+	const Variant::Type left_type = r_left.get_type();
+	const Variant::Type right_type = p_right.get_type();
+	if (left_type == Variant::BOOL && right_type == Variant::BOOL) {
+		bool &a = *VariantInternal::get_bool(&r_left);
+		const bool b = *VariantInternal::get_bool(&p_right);
+		switch (p_op) {
+			case Variant::OP_AND: {
+				a = a && b;
+				return true;
+			}
+			case Variant::OP_OR: {
+				a = a || b;
 				return true;
 			}
+			default: {
+				return false;
+			}
+		}
+	}
+	if ((left_type != Variant::INT && left_type != Variant::FLOAT) || (right_type != Variant::INT && right_type != Variant::FLOAT)) {
+		return false;
+	}
 
-			Vector<Variant> arr;
-			Vector<const Variant *> argp;
-			arr.resize(call->arguments.size());
-			argp.resize(call->arguments.size());
+	bool comparison = false;
+	if (left_type == Variant::INT && right_type == Variant::INT) {
+		int64_t &a = *VariantInternal::get_int(&r_left);
+		const int64_t b = *VariantInternal::get_int(&p_right);
+		switch (p_op) {
+			case Variant::OP_ADD: {
+				a = a + b;
+				return true;
+			}
+			case Variant::OP_SUBTRACT: {
+				a = a - b;
+				return true;
+			}
+			case Variant::OP_MULTIPLY: {
+				a = a * b;
+				return true;
+			}
+			case Variant::OP_EQUAL: {
+				comparison = a == b;
+			} break;
+			case Variant::OP_NOT_EQUAL: {
+				comparison = a != b;
+			} break;
+			case Variant::OP_LESS: {
+				comparison = a < b;
+			} break;
+			case Variant::OP_LESS_EQUAL: {
+				comparison = a <= b;
+			} break;
+			case Variant::OP_GREATER: {
+				comparison = a > b;
+			} break;
+			case Variant::OP_GREATER_EQUAL: {
+				comparison = a >= b;
+			} break;
+			default: {
+				return false; // Division and modulo need the zero checks of the generic path.
+			}
+		}
+	} else {
+		const double a = left_type == Variant::FLOAT ? *VariantInternal::get_float(&r_left) : double(*VariantInternal::get_int(&r_left));
+		const double b = right_type == Variant::FLOAT ? *VariantInternal::get_float(&p_right) : double(*VariantInternal::get_int(&p_right));
+		double result = 0.0;
+		bool is_comparison = true;
+		switch (p_op) {
+			case Variant::OP_ADD: {
+				result = a + b;
+				is_comparison = false;
+			} break;
+			case Variant::OP_SUBTRACT: {
+				result = a - b;
+				is_comparison = false;
+			} break;
+			case Variant::OP_MULTIPLY: {
+				result = a * b;
+				is_comparison = false;
+			} break;
+			case Variant::OP_DIVIDE: {
+				result = a / b;
+				is_comparison = false;
+			} break;
+			case Variant::OP_EQUAL: {
+				comparison = a == b;
+			} break;
+			case Variant::OP_NOT_EQUAL: {
+				comparison = a != b;
+			} break;
+			case Variant::OP_LESS: {
+				comparison = a < b;
+			} break;
+			case Variant::OP_LESS_EQUAL: {
+				comparison = a <= b;
+			} break;
+			case Variant::OP_GREATER: {
+				comparison = a > b;
+			} break;
+			case Variant::OP_GREATER_EQUAL: {
+				comparison = a >= b;
+			} break;
+			default: {
+				return false;
+			}
+		}
 
-			for (int i = 0; i < call->arguments.size(); i++) {
-				Variant value;
-				ret = _execute(p_inputs, p_instance, call->arguments[i], value, p_const_calls_only, r_error_str);
+		if (!is_comparison) {
+			VariantTypeChanger<double>::change(&r_left);
+			*VariantInternal::get_float(&r_left) = result;
+			return true;
+		}
+	}
 
-				if (ret) {
-					return true;
+	VariantTypeChanger<bool>::change(&r_left);
+	*VariantInternal::get_bool(&r_left) = comparison;
+	return true;
+}
+
+bool Expression::_execute(const Program &p_program, const Array &p_inputs, Object *p_instance, Variant &r_ret, bool p_const_calls_only, String &r_error_str) {
+	Variant *stack = (Variant *)alloca(sizeof(Variant) * p_program.stack_size);
+	for (int32_t i = 0; i < p_program.stack_size; i++) {
+		memnew_placement(&stack[i], Variant);
+	}
+
+	const int32_t *code = p_program.code.ptr();
+	int32_t ip = 0;
+	int32_t sp = 0; // First free stack slot.
+	bool error = false;
+	const Variant nil;
+
+	while (!error && code[ip] != OPCODE_END) {
+		switch (code[ip]) {
+			case OPCODE_CONSTANT: {
+				stack[sp++] = p_program.constants[code[ip + 1]];
+				ip += 2;
+			} break;
+			case OPCODE_INPUT: {
+				const int32_t index = code[ip + 1];
+				if (index < 0 || index >= p_inputs.size()) {
+					r_error_str = vformat(RTR("Invalid input %d (not passed) in expression"), index);
+					error = true;
+					break;
+				}
+				stack[sp++] = p_inputs[index];
+				ip += 2;
+			} break;
+			case OPCODE_SELF: {
+				if (!p_instance) {
+					r_error_str = RTR("self can't be used because instance is null (not passed)");
+					error = true;
+					break;
+				}
+				stack[sp++] = p_instance;
+				ip += 1;
+			} break;
+			case OPCODE_OPERATOR:
+			case OPCODE_OPERATOR_UNARY: {
+				const Variant::Operator op = Variant::Operator(code[ip + 1]);
+				const bool unary = code[ip] == OPCODE_OPERATOR_UNARY;
+				Variant &a = stack[sp - (unary ? 1 : 2)];
+				const Variant &b = unary ? nil : stack[sp - 1];
+
+				if (unary && op == Variant::OP_NEGATE && a.get_type() == Variant::INT) {
+					*VariantInternal::get_int(&a) = -*VariantInternal::get_int(&a);
+				} else if (unary && op == Variant::OP_NEGATE && a.get_type() == Variant::FLOAT) {
+					*VariantInternal::get_float(&a) = -*VariantInternal::get_float(&a);
+				} else if (unary && op == Variant::OP_NOT && a.get_type() == Variant::BOOL) {
+					*VariantInternal::get_bool(&a) = !*VariantInternal::get_bool(&a);
+				} else if (unary || !_evaluate_numeric(op, a, b)) {
+					Variant ret;
+					bool valid = true;
+					Variant::evaluate(op, a, b, ret, valid);
+					if (!valid) {
+						r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(op), Variant::get_type_name(a.get_type()), Variant::get_type_name(b.get_type()));
+						if (code[ip + 2] == OPCODE_END) {
+							// The tree walker evaluated the root straight into the result, keep returning what the operator left there.
+							r_ret = ret;
+						}
+						error = true;
+						break;
+					}
+					a = ret;
 				}
-				arr.write[i] = value;
-				argp.write[i] = &arr[i];
-			}
 
-			Callable::CallError ce;
-			if (p_const_calls_only) {
-				base.call_const(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
-			} else {
-				base.callp(call->method, (const Variant **)argp.ptr(), argp.size(), r_ret, ce);
-			}
+				if (!unary) {
+					sp--;
+				}
+				ip += 2;
+			} break;
+			case OPCODE_INDEX: {
+				Variant &base = stack[sp - 2];
+				const Variant &idx = stack[sp - 1];
+
+				bool valid;
+				Variant ret = base.get(idx, &valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(idx.get_type()), Variant::get_type_name(base.get_type()));
+					error = true;
+					break;
+				}
+				base = ret;
+				sp--;
+				ip += 1;
+			} break;
+			case OPCODE_NAMED_INDEX: {
+				Variant &base = stack[sp - 1];
+				const StringName &name = p_program.names[code[ip + 1]];
+
+				bool valid;
+				Variant ret = base.get_named(name, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(name), Variant::get_type_name(base.get_type()));
+					error = true;
+					break;
+				}
+				base = ret;
+				ip += 2;
+			} break;
+			case OPCODE_ARRAY: {
+				const int32_t count = code[ip + 1];
+				sp -= count;
+
+				Array arr;
+				arr.resize(count);
+				for (int32_t i = 0; i < count; i++) {
+					arr[i] = stack[sp + i];
+				}
+				stack[sp++] = arr;
+				ip += 2;
+			} break;
+			case OPCODE_DICTIONARY: {
+				const int32_t count = code[ip + 1];
+				sp -= count * 2;
 
-			if (ce.error != Callable::CallError::CALL_OK) {
-				r_error_str = vformat(RTR("On call to '%s':"), String(call->method));
-				return true;
-			}
+				Dictionary d;
+				for (int32_t i = 0; i < count; i++) {
+					d[stack[sp + i * 2 + 0]] = stack[sp + i * 2 + 1];
+				}
+				stack[sp++] = d;
+				ip += 2;
+			} break;
+			case OPCODE_CONSTRUCT: {
+				const Variant::Type data_type = Variant::Type(code[ip + 1]);
+				const int32_t argc = code[ip + 2];
+				sp -= argc;
+
+				const Variant **argp = (const Variant **)alloca(sizeof(Variant *) * (argc + 1));
+				for (int32_t i = 0; i < argc; i++) {
+					argp[i] = &stack[sp + i];
+				}
 
-		} break;
+				Variant ret;
+				Callable::CallError ce;
+				Variant::construct(data_type, ret, argp, argc, ce);
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(data_type));
+					error = true;
+					break;
+				}
+				stack[sp++] = ret;
+				ip += 3;
+			} break;
+			case OPCODE_BUILTIN_FUNC: {
+				const StringName &func = p_program.names[code[ip + 1]];
+				const int32_t argc = code[ip + 2];
+				sp -= argc;
+
+				const Variant **argp = (const Variant **)alloca(sizeof(Variant *) * (argc + 1));
+				for (int32_t i = 0; i < argc; i++) {
+					argp[i] = &stack[sp + i];
+				}
+
+				Variant ret; // May not return anything.
+				Callable::CallError ce;
+				Variant::call_utility_function(func, &ret, argp, argc, ce);
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = "Builtin call failed: " + Variant::get_call_error_text(func, argp, argc, ce);
+					error = true;
+					break;
+				}
+				stack[sp++] = ret;
+				ip += 3;
+			} break;
+			case OPCODE_CALL: {
+				const StringName &method = p_program.names[code[ip + 1]];
+				const int32_t argc = code[ip + 2];
+				sp -= argc;
+				Variant &base = stack[sp - 1];
+
+				const Variant **argp = (const Variant **)alloca(sizeof(Variant *) * (argc + 1));
+				for (int32_t i = 0; i < argc; i++) {
+					argp[i] = &stack[sp + i];
+				}
+
+				Variant ret;
+				Callable::CallError ce;
+				if (p_const_calls_only) {
+					base.call_const(method, argp, argc, ret, ce);
+				} else {
+					base.callp(method, argp, argc, ret, ce);
+				}
+
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("On call to '%s':"), String(method));
+					error = true;
+					break;
+				}
+				base = ret;
+				ip += 3;
+			} break;
+		}
+	}
+
+	if (!error) {
+		r_ret = stack[0];
 	}
-	return false;
+	for (int32_t i = 0; i < p_program.stack_size; i++) {
+		stack[i].~Variant();
+	}
+	return error;
 }
 
-Error Expression::parse(const String &p_expression, const Vector<String> &p_input_names) {
+void Expression::_unref_program(Program *p_program) {
+	if (p_program->refcount.unref()) {
+		memdelete(p_program);
+	}
+}
+
+void Expression::_clear() {
 	if (nodes) {
 		memdelete(nodes);
 		nodes = nullptr;
-		root = nullptr;
 	}
+	root = nullptr;
+	if (program) {
+		_unref_program(program);
+		program = nullptr;
+	}
+}
+
+void Expression::clear_cache() {
+	MutexLock lock(program_cache_mutex);
+	for (KeyValue<ProgramKey, Program *> &E : program_cache) {
+		_unref_program(E.value);
+	}
+	program_cache.clear();
+}
+
+Error Expression::parse(const String &p_expression, const Vector<String> &p_input_names) {
+	_clear();
 
 	error_str = String();
 	error_set = false;
@@ -1477,17 +1755,52 @@ Error Expression::parse(const String &p_expression, const Vector<String> &p_inpu
 	input_names = p_input_names;
 
 	expression = p_expression;
+
+	// Formulas are often parsed again and again, reuse their code when possible.
+	ProgramKey key;
+	key.expression = p_expression;
+	key.input_names = p_input_names;
+	{
+		MutexLock lock(program_cache_mutex);
+		Program *const *cached = program_cache.getptr(key);
+		if (cached) {
+			program = *cached;
+			program->refcount.ref();
+			return OK;
+		}
+	}
+
 	root = _parse_expression();
 
 	if (error_set) {
-		root = nullptr;
-		if (nodes) {
-			memdelete(nodes);
-		}
-		nodes = nullptr;
+		_clear();
 		return ERR_INVALID_PARAMETER;
 	}
 
+	program = memnew(Program);
+	program->refcount.init();
+	int32_t stack = 0;
+	_compile(root, *program, stack);
+	program->code.push_back(OPCODE_END);
+
+	// The tree isn't needed to execute.
+	memdelete(nodes);
+	nodes = nullptr;
+	root = nullptr;
+
+	MutexLock lock(program_cache_mutex);
+	if (!program_cache.has(key)) {
+		if (program_cache.size() >= PROGRAM_CACHE_MAX_SIZE) {
+			// Rarely reached, formulas tend to come from a small set of strings.
+			for (KeyValue<ProgramKey, Program *> &E : program_cache) {
+				_unref_program(E.value);
+			}
+			program_cache.clear();
+		}
+		program->refcount.ref();
+		program_cache.insert(key, program);
+	}
+
 	return OK;
 }
 
@@ -1497,7 +1810,7 @@ Variant Expression::execute(const Array &p_inputs, Object *p_base, bool p_show_e
 	execution_error = false;
 	Variant output;
 	String error_txt;
-	bool err = _execute(p_inputs, p_base, root, output, p_const_calls_only, error_txt);
+	bool err = _execute(*program, p_inputs, p_base, output, p_const_calls_only, error_txt);
 	if (err) {
 		execution_error = true;
 		error_str = error_txt;
@@ -1523,7 +1836,5 @@ void Expression::_bind_methods() {
 }
 
 Expression::~Expression() {
-	if (nodes) {
-		memdelete(nodes);
-	}
+	_clear();
 }
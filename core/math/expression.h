@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/object/ref_counted.h"
+#include "core/os/mutex.h"
 
 class Expression : public RefCounted {
 	GDCLASS(Expression, RefCounted);
@@ -39,9 +40,6 @@ private:
 	String expression;
 
 	int str_ofs = 0;
-	bool expression_dirty = false;
-
-	bool _compile_expression();
 
 	enum TokenType {
 		TK_CURLY_BRACKET_OPEN,
@@ -243,8 +241,60 @@ private:
 
 	Vector<String> input_names;
 
+	// The tree is compiled to flat postfix code, run on a stack of Variants.
+	// Operands follow their opcode in the code.
+	enum Opcode {
+		OPCODE_CONSTANT, // Constant index.
+		OPCODE_INPUT, // Input index.
+		OPCODE_SELF,
+		OPCODE_OPERATOR, // Operator.
+		OPCODE_OPERATOR_UNARY, // Operator.
+		OPCODE_INDEX,
+		OPCODE_NAMED_INDEX, // Name index.
+		OPCODE_ARRAY, // Element count.
+		OPCODE_DICTIONARY, // Pair count.
+		OPCODE_CONSTRUCT, // Type, argument count.
+		OPCODE_BUILTIN_FUNC, // Name index, argument count.
+		OPCODE_CALL, // Name index, argument count.
+		OPCODE_END,
+	};
+
+	// Never modified once compiled, so it can be shared by every expression parsed from the same text.
+	struct Program {
+		SafeRefCount refcount;
+		LocalVector<int32_t> code;
+		LocalVector<Variant> constants;
+		LocalVector<StringName> names;
+		int32_t stack_size = 0;
+	};
+
+	struct ProgramKey {
+		String expression;
+		Vector<String> input_names;
+
+		static uint32_t hash(const ProgramKey &p_key) {
+			uint32_t h = p_key.expression.hash();
+			for (const String &name : p_key.input_names) {
+				h = hash_murmur3_one_32(name.hash(), h);
+			}
+			return hash_fmix32(h);
+		}
+		bool operator==(const ProgramKey &p_key) const { return expression == p_key.expression && input_names == p_key.input_names; }
+	};
+
+	static void _unref_program(Program *p_program);
+
+	static constexpr uint32_t PROGRAM_CACHE_MAX_SIZE = 1024;
+	static BinaryMutex program_cache_mutex;
+	static HashMap<ProgramKey, Program *, ProgramKey> program_cache;
+
+	Program *program = nullptr;
+
+	void _compile(const ENode *p_node, Program &r_program, int32_t &r_stack);
+	void _clear();
+
 	bool execution_error = false;
-	bool _execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, bool p_const_calls_only, String &r_error_str);
+	bool _execute(const Program &p_program, const Array &p_inputs, Object *p_instance, Variant &r_ret, bool p_const_calls_only, String &r_error_str);
 
 protected:
 	static void _bind_methods();
@@ -255,5 +305,7 @@ public:
 	bool has_execute_failed() const;
 	String get_error_text() const;
 
+	static void clear_cache();
+
 	~Expression();
 };
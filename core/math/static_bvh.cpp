@@ -0,0 +1,334 @@
+/**************************************************************************/
+/*  static_bvh.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "static_bvh.h"
+
+#include "core/object/worker_thread_pool.h"
+
+namespace {
+
+// Binary tree node, a leaf while count is not zero.
+struct BuildNode {
+	StaticBVH::Bounds bounds;
+	int32_t left = -1;
+	int32_t right = -1;
+	uint32_t first = 0;
+	uint32_t count = 0;
+};
+
+struct BuildData {
+	const StaticBVH::Bounds *bounds = nullptr;
+	const Vector3 *centers = nullptr;
+	uint32_t *order = nullptr;
+};
+
+constexpr int SAH_BIN_COUNT = 16;
+// Below this, building on a single thread is faster than dispatching tasks.
+constexpr uint32_t THREADED_MIN_PRIMITIVES = 32768;
+constexpr uint32_t THREADED_MIN_SUBTREE_PRIMITIVES = 4096;
+
+_FORCE_INLINE_ int _get_sah_bin(const Vector3 &p_center, int p_axis, const StaticBVH::Bounds &p_centers, real_t p_scale) {
+	return MIN(int((p_center[p_axis] - p_centers.min[p_axis]) * p_scale), SAH_BIN_COUNT - 1);
+}
+
+// Binned surface area heuristic, reorders the range and returns how many primitives go to the left child.
+uint32_t _split_sah(const BuildData &p_data, uint32_t *p_order, uint32_t p_count, const StaticBVH::Bounds &p_center_bounds) {
+	real_t best_cost = Math::INF;
+	int best_axis = -1;
+	int best_bin = 0;
+
+	for (int axis = 0; axis < 3; axis++) {
+		const real_t extent = p_center_bounds.max[axis] - p_center_bounds.min[axis];
+		if (extent <= 0) {
+			continue;
+		}
+		const real_t scale = SAH_BIN_COUNT / extent;
+
+		StaticBVH::Bounds bins[SAH_BIN_COUNT];
+		uint32_t counts[SAH_BIN_COUNT] = {};
+		for (uint32_t i = 0; i < p_count; i++) {
+			const uint32_t primitive = p_order[i];
+			const int bin = _get_sah_bin(p_data.centers[primitive], axis, p_center_bounds, scale);
+			bins[bin].merge_with(p_data.bounds[primitive]);
+			counts[bin]++;
+		}
+
+		real_t right_area[SAH_BIN_COUNT];
+		uint32_t right_count[SAH_BIN_COUNT];
+		StaticBVH::Bounds accum;
+		uint32_t accum_count = 0;
+		for (int bin = SAH_BIN_COUNT - 1; bin > 0; bin--) {
+			accum.merge_with(bins[bin]);
+			accum_count += counts[bin];
+			right_area[bin] = accum.get_half_area();
+			right_count[bin] = accum_count;
+		}
+
+		accum = StaticBVH::Bounds();
+		accum_count = 0;
+		for (int bin = 0; bin < SAH_BIN_COUNT - 1; bin++) {
+			accum.merge_with(bins[bin]);
+			accum_count += counts[bin];
+			if (accum_count == 0 || right_count[bin + 1] == 0) {
+				continue;
+			}
+			const real_t cost = accum.get_half_area() * accum_count + right_area[bin + 1] * right_count[bin + 1];
+			if (cost < best_cost) {
+				best_cost = cost;
+				best_axis = axis;
+				best_bin = bin;
+			}
+		}
+	}
+
+	if (best_axis == -1) {
+		// All the centers are in the same spot, any split is as good as another.
+		return p_count / 2;
+	}
+
+	const real_t scale = SAH_BIN_COUNT / (p_center_bounds.max[best_axis] - p_center_bounds.min[best_axis]);
+	uint32_t left = 0;
+	uint32_t right = p_count;
+	while (left < right) {
+		if (_get_sah_bin(p_data.centers[p_order[left]], best_axis, p_center_bounds, scale) <= best_bin) {
+			left++;
+		} else {
+			right--;
+			SWAP(p_order[left], p_order[right]);
+		}
+	}
+	return left;
+}
+
+// Splits p_root until its leaves fit in a node. When r_deferred is given, ranges of up to p_defer_count
+// primitives are not split but added to it, so they can be built separately.
+void _build_binary(const BuildData &p_data, LocalVector<BuildNode> &r_nodes, uint32_t p_root, uint32_t p_defer_count = 0, LocalVector<uint32_t> *r_deferred = nullptr) {
+	LocalVector<uint32_t> stack;
+	stack.push_back(p_root);
+	while (stack.size()) {
+		const uint32_t index = stack[stack.size() - 1];
+		stack.resize(stack.size() - 1);
+
+		const uint32_t first = r_nodes[index].first;
+		const uint32_t count = r_nodes[index].count;
+		StaticBVH::Bounds bounds;
+		StaticBVH::Bounds center_bounds;
+		for (uint32_t i = first; i < first + count; i++) {
+			bounds.merge_with(p_data.bounds[p_data.order[i]]);
+			center_bounds.expand_to(p_data.centers[p_data.order[i]]);
+		}
+		r_nodes[index].bounds = bounds;
+
+		if (count <= StaticBVH::WIDTH) {
+			continue;
+		}
+		if (r_deferred && count <= p_defer_count) {
+			r_deferred->push_back(index);
+			continue;
+		}
+
+		const uint32_t left_count = _split_sah(p_data, &p_data.order[first], count, center_bounds);
+
+		BuildNode left;
+		left.first = first;
+		left.count = left_count;
+		BuildNode right;
+		right.first = first + left_count;
+		right.count = count - left_count;
+
+		r_nodes[index].left = r_nodes.size();
+		r_nodes[index].right = r_nodes.size() + 1;
+		r_nodes[index].count = 0;
+		r_nodes.push_back(left);
+		r_nodes.push_back(right);
+		stack.push_back(r_nodes[index].left);
+		stack.push_back(r_nodes[index].right);
+	}
+}
+
+struct SubtreeBuild {
+	BuildData data;
+	const LocalVector<BuildNode> *nodes = nullptr;
+	const LocalVector<uint32_t> *roots = nullptr;
+	LocalVector<LocalVector<BuildNode>> subtrees;
+};
+
+void _build_subtree(void *p_userdata, uint32_t p_index) {
+	SubtreeBuild *build = (SubtreeBuild *)p_userdata;
+	LocalVector<BuildNode> &subtree = build->subtrees[p_index];
+	subtree.push_back((*build->nodes)[(*build->roots)[p_index]]);
+	_build_binary(build->data, subtree, 0);
+}
+
+} // namespace
+
+void StaticBVH::build(const Bounds *p_bounds, uint32_t p_count, bool p_use_threads) {
+	clear();
+	if (p_count == 0) {
+		return;
+	}
+
+	LocalVector<Vector3> centers;
+	centers.resize(p_count);
+	primitives.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		centers[i] = (p_bounds[i].min + p_bounds[i].max) * 0.5;
+		primitives[i] = i;
+	}
+
+	BuildData data;
+	data.bounds = p_bounds;
+	data.centers = centers.ptr();
+	data.order = primitives.ptr();
+
+	// Build a binary tree first, splitting until every leaf fits in a node.
+	LocalVector<BuildNode> build_nodes;
+	build_nodes.reserve(p_count / 2 + 1);
+	build_nodes.push_back(BuildNode());
+	build_nodes[0].count = p_count;
+
+	WorkerThreadPool *thread_pool = WorkerThreadPool::get_singleton();
+	if (p_use_threads && thread_pool && p_count >= THREADED_MIN_PRIMITIVES) {
+		// Split the top of the tree on this thread, then build the subtrees below in parallel,
+		// they cover disjoint ranges of the primitives.
+		const uint32_t defer_count = MAX(p_count / (uint32_t)(thread_pool->get_thread_count() * 8), THREADED_MIN_SUBTREE_PRIMITIVES);
+		LocalVector<uint32_t> roots;
+		_build_binary(data, build_nodes, 0, defer_count, &roots);
+
+		SubtreeBuild subtree_build;
+		subtree_build.data = data;
+		subtree_build.nodes = &build_nodes;
+		subtree_build.roots = &roots;
+		subtree_build.subtrees.resize(roots.size());
+		WorkerThreadPool::GroupID group_task = thread_pool->add_native_group_task(&_build_subtree, &subtree_build, roots.size(), -1, true, SNAME("StaticBVHBuild"));
+		thread_pool->wait_for_group_task_completion(group_task);
+
+		// Append the subtrees, their root replaces the deferred node.
+		for (uint32_t i = 0; i < roots.size(); i++) {
+			const LocalVector<BuildNode> &subtree = subtree_build.subtrees[i];
+			const int32_t offset = int32_t(build_nodes.size()) - 1;
+			for (uint32_t j = 0; j < subtree.size(); j++) {
+				BuildNode node = subtree[j];
+				if (node.count == 0) {
+					node.left += offset;
+					node.right += offset;
+				}
+				if (j == 0) {
+					build_nodes[roots[i]] = node;
+				} else {
+					build_nodes.push_back(node);
+				}
+			}
+		}
+	} else {
+		_build_binary(data, build_nodes, 0);
+	}
+
+	// Then collapse it into a four-wide tree, opening the largest children first.
+	struct CollapseItem {
+		uint32_t build_node = 0;
+		int32_t parent = -1;
+		uint32_t slot = 0;
+		uint32_t depth = 1;
+	};
+
+	LocalVector<CollapseItem> stack;
+	stack.push_back(CollapseItem());
+	while (stack.size()) {
+		const CollapseItem item = stack[stack.size() - 1];
+		stack.resize(stack.size() - 1);
+
+		uint32_t children[WIDTH];
+		uint32_t child_count = 0;
+		const BuildNode &build_node = build_nodes[item.build_node];
+		if (build_node.count) {
+			children[child_count++] = item.build_node;
+		} else {
+			children[child_count++] = build_node.left;
+			children[child_count++] = build_node.right;
+			while (child_count < WIDTH) {
+				int largest = -1;
+				real_t largest_area = -1;
+				for (uint32_t i = 0; i < child_count; i++) {
+					const BuildNode &child = build_nodes[children[i]];
+					if (child.count == 0 && child.bounds.get_half_area() > largest_area) {
+						largest = i;
+						largest_area = child.bounds.get_half_area();
+					}
+				}
+				if (largest == -1) {
+					break;
+				}
+				const BuildNode &opened = build_nodes[children[largest]];
+				children[largest] = opened.left;
+				children[child_count++] = opened.right;
+			}
+		}
+
+		const int32_t node_index = nodes.size();
+		nodes.push_back(Node());
+		if (item.parent >= 0) {
+			nodes[item.parent].children[item.slot] = node_index;
+		}
+		max_depth = MAX(max_depth, item.depth);
+
+		Node &node = nodes[node_index];
+		node.child_count = child_count;
+		for (uint32_t i = 0; i < child_count; i++) {
+			const BuildNode &child = build_nodes[children[i]];
+			for (int axis = 0; axis < 3; axis++) {
+				node.min[axis][i] = child.bounds.min[axis];
+				node.max[axis][i] = child.bounds.max[axis];
+			}
+
+			if (child.count == 0) {
+				CollapseItem child_item;
+				child_item.build_node = children[i];
+				child_item.parent = node_index;
+				child_item.slot = i;
+				child_item.depth = item.depth + 1;
+				stack.push_back(child_item);
+			} else {
+				node.children[i] = ~int32_t(leaves.size());
+				Leaf leaf;
+				leaf.first = child.first;
+				leaf.count = child.count;
+				leaves.push_back(leaf);
+			}
+		}
+	}
+}
+
+void StaticBVH::clear() {
+	nodes.clear();
+	leaves.clear();
+	primitives.clear();
+	max_depth = 0;
+}
@@ -0,0 +1,419 @@
+/**************************************************************************/
+/*  static_bvh.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/vector3.h"
+#include "core/templates/local_vector.h"
+
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STATIC_BVH_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define STATIC_BVH_NEON
+#include <arm_neon.h>
+#endif
+#endif // REAL_T_IS_DOUBLE
+
+// Four-wide bounding volume hierarchy over a fixed set of primitives, built with a binned
+// surface area heuristic. Nodes store the bounds of their four children per axis, so a ray
+// can be tested against all of them at once. Leaves hold up to four primitives.
+class StaticBVH {
+public:
+	enum {
+		WIDTH = 4,
+	};
+
+	// Four lanes of real_t. Kernels are written once against these types, lanes either hold
+	// four primitives tested against one ray, or one primitive tested against four rays.
+#if defined(STATIC_BVH_SSE2)
+	struct Mask4 {
+		__m128 v;
+
+		_FORCE_INLINE_ Mask4 operator&(const Mask4 &p_other) const { return { _mm_and_ps(v, p_other.v) }; }
+		_FORCE_INLINE_ uint32_t bits() const { return (uint32_t)_mm_movemask_ps(v); }
+	};
+
+	struct Real4 {
+		__m128 v;
+
+		static _FORCE_INLINE_ Real4 load(const real_t *p_ptr) { return { _mm_loadu_ps(p_ptr) }; }
+		static _FORCE_INLINE_ Real4 splat(real_t p_value) { return { _mm_set1_ps(p_value) }; }
+		static _FORCE_INLINE_ Real4 min(const Real4 &p_a, const Real4 &p_b) { return { _mm_min_ps(p_a.v, p_b.v) }; }
+		static _FORCE_INLINE_ Real4 max(const Real4 &p_a, const Real4 &p_b) { return { _mm_max_ps(p_a.v, p_b.v) }; }
+		// Lanes of p_b where the mask is set, p_a elsewhere.
+		static _FORCE_INLINE_ Real4 select(const Mask4 &p_mask, const Real4 &p_a, const Real4 &p_b) { return { _mm_or_ps(_mm_and_ps(p_mask.v, p_b.v), _mm_andnot_ps(p_mask.v, p_a.v)) }; }
+		_FORCE_INLINE_ void store(real_t *r_ptr) const { _mm_storeu_ps(r_ptr, v); }
+		_FORCE_INLINE_ Real4 abs() const { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), v) }; }
+
+		_FORCE_INLINE_ Real4 operator+(const Real4 &p_other) const { return { _mm_add_ps(v, p_other.v) }; }
+		_FORCE_INLINE_ Real4 operator-(const Real4 &p_other) const { return { _mm_sub_ps(v, p_other.v) }; }
+		_FORCE_INLINE_ Real4 operator*(const Real4 &p_other) const { return { _mm_mul_ps(v, p_other.v) }; }
+		_FORCE_INLINE_ Real4 operator/(const Real4 &p_other) const { return { _mm_div_ps(v, p_other.v) }; }
+		_FORCE_INLINE_ Mask4 operator<=(const Real4 &p_other) const { return { _mm_cmple_ps(v, p_other.v) }; }
+		_FORCE_INLINE_ Mask4 operator>=(const Real4 &p_other) const { return { _mm_cmpge_ps(v, p_other.v) }; }
+		_FORCE_INLINE_ Mask4 operator>(const Real4 &p_other) const { return { _mm_cmpgt_ps(v, p_other.v) }; }
+		_FORCE_INLINE_ Mask4 operator!=(const Real4 &p_other) const { return { _mm_cmpneq_ps(v, p_other.v) }; }
+	};
+#elif defined(STATIC_BVH_NEON)
+	struct Mask4 {
+		uint32x4_t v;
+
+		_FORCE_INLINE_ Mask4 operator&(const Mask4 &p_other) const { return { vandq_u32(v, p_other.v) }; }
+		_FORCE_INLINE_ uint32_t bits() const {
+			static const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+			return vaddvq_u32(vandq_u32(v, vld1q_u32(lane_bits)));
+		}
+	};
+
+	struct Real4 {
+		float32x4_t v;
+
+		static _FORCE_INLINE_ Real4 load(const real_t *p_ptr) { return { vld1q_f32(p_ptr) }; }
+		static _FORCE_INLINE_ Real4 splat(real_t p_value) { return { vdupq_n_f32(p_value) }; }
+		static _FORCE_INLINE_ Real4 min(const Real4 &p_a, const Real4 &p_b) { return { vminq_f32(p_a.v, p_b.v) }; }
+		static _FORCE_INLINE_ Real4 max(const Real4 &p_a, const Real4 &p_b) { return { vmaxq_f32(p_a.v, p_b.v) }; }
+		static _FORCE_INLINE_ Real4 select(const Mask4 &p_mask, const Real4 &p_a, const Real4 &p_b) { return { vbslq_f32(p_mask.v, p_b.v, p_a.v) }; }
+		_FORCE_INLINE_ void store(real_t *r_ptr) const { vst1q_f32(r_ptr, v); }
+		_FORCE_INLINE_ Real4 abs() const { return { vabsq_f32(v) }; }
+
+		_FORCE_INLINE_ Real4 operator+(const Real4 &p_other) const { return { vaddq_f32(v, p_other.v) }; }
+		_FORCE_INLINE_ Real4 operator-(const Real4 &p_other) const { return { vsubq_f32(v, p_other.v) }; }
+		_FORCE_INLINE_ Real4 operator*(const Real4 &p_other) const { return { vmulq_f32(v, p_other.v) }; }
+		_FORCE_INLINE_ Real4 operator/(const Real4 &p_other) const { return { vdivq_f32(v, p_other.v) }; }
+		_FORCE_INLINE_ Mask4 operator<=(const Real4 &p_other) const { return { vcleq_f32(v, p_other.v) }; }
+		_FORCE_INLINE_ Mask4 operator>=(const Real4 &p_other) const { return { vcgeq_f32(v, p_other.v) }; }
+		_FORCE_INLINE_ Mask4 operator>(const Real4 &p_other) const { return { vcgtq_f32(v, p_other.v) }; }
+		_FORCE_INLINE_ Mask4 operator!=(const Real4 &p_other) const { return { vmvnq_u32(vceqq_f32(v, p_other.v)) }; }
+	};
+#else
+	struct Mask4 {
+		uint32_t v;
+
+		_FORCE_INLINE_ Mask4 operator&(const Mask4 &p_other) const { return { v & p_other.v }; }
+		_FORCE_INLINE_ uint32_t bits() const { return v; }
+	};
+
+	struct Real4 {
+		real_t v[4];
+
+		static _FORCE_INLINE_ Real4 load(const real_t *p_ptr) { return { { p_ptr[0], p_ptr[1], p_ptr[2], p_ptr[3] } }; }
+		static _FORCE_INLINE_ Real4 splat(real_t p_value) { return { { p_value, p_value, p_value, p_value } }; }
+		static _FORCE_INLINE_ Real4 min(const Real4 &p_a, const Real4 &p_b) { return { { MIN(p_a.v[0], p_b.v[0]), MIN(p_a.v[1], p_b.v[1]), MIN(p_a.v[2], p_b.v[2]), MIN(p_a.v[3], p_b.v[3]) } }; }
+		static _FORCE_INLINE_ Real4 max(const Real4 &p_a, const Real4 &p_b) { return { { MAX(p_a.v[0], p_b.v[0]), MAX(p_a.v[1], p_b.v[1]), MAX(p_a.v[2], p_b.v[2]), MAX(p_a.v[3], p_b.v[3]) } }; }
+		static _FORCE_INLINE_ Real4 select(const Mask4 &p_mask, const Real4 &p_a, const Real4 &p_b) { return { { (p_mask.v & 1) ? p_b.v[0] : p_a.v[0], (p_mask.v & 2) ? p_b.v[1] : p_a.v[1], (p_mask.v & 4) ? p_b.v[2] : p_a.v[2], (p_mask.v & 8) ? p_b.v[3] : p_a.v[3] } }; }
+		_FORCE_INLINE_ void store(real_t *r_ptr) const {
+			for (int i = 0; i < 4; i++) {
+				r_ptr[i] = v[i];
+			}
+		}
+		_FORCE_INLINE_ Real4 abs() const { return { { Math::abs(v[0]), Math::abs(v[1]), Math::abs(v[2]), Math::abs(v[3]) } }; }
+
+		_FORCE_INLINE_ Real4 operator+(const Real4 &p_other) const { return { { v[0] + p_other.v[0], v[1] + p_other.v[1], v[2] + p_other.v[2], v[3] + p_other.v[3] } }; }
+		_FORCE_INLINE_ Real4 operator-(const Real4 &p_other) const { return { { v[0] - p_other.v[0], v[1] - p_other.v[1], v[2] - p_other.v[2], v[3] - p_other.v[3] } }; }
+		_FORCE_INLINE_ Real4 operator*(const Real4 &p_other) const { return { { v[0] * p_other.v[0], v[1] * p_other.v[1], v[2] * p_other.v[2], v[3] * p_other.v[3] } }; }
+		_FORCE_INLINE_ Real4 operator/(const Real4 &p_other) const { return { { v[0] / p_other.v[0], v[1] / p_other.v[1], v[2] / p_other.v[2], v[3] / p_other.v[3] } }; }
+		_FORCE_INLINE_ Mask4 operator<=(const Real4 &p_other) const { return { uint32_t(v[0] <= p_other.v[0]) | uint32_t(v[1] <= p_other.v[1]) << 1 | uint32_t(v[2] <= p_other.v[2]) << 2 | uint32_t(v[3] <= p_other.v[3]) << 3 }; }
+		_FORCE_INLINE_ Mask4 operator>=(const Real4 &p_other) const { return { uint32_t(v[0] >= p_other.v[0]) | uint32_t(v[1] >= p_other.v[1]) << 1 | uint32_t(v[2] >= p_other.v[2]) << 2 | uint32_t(v[3] >= p_other.v[3]) << 3 }; }
+		_FORCE_INLINE_ Mask4 operator>(const Real4 &p_other) const { return { uint32_t(v[0] > p_other.v[0]) | uint32_t(v[1] > p_other.v[1]) << 1 | uint32_t(v[2] > p_other.v[2]) << 2 | uint32_t(v[3] > p_other.v[3]) << 3 }; }
+		_FORCE_INLINE_ Mask4 operator!=(const Real4 &p_other) const { return { uint32_t(v[0] != p_other.v[0]) | uint32_t(v[1] != p_other.v[1]) << 1 | uint32_t(v[2] != p_other.v[2]) << 2 | uint32_t(v[3] != p_other.v[3]) << 3 }; }
+	};
+#endif
+
+	// Unlike AABB, stores the corners themselves, so they are exact.
+	struct Bounds {
+		Vector3 min = Vector3(Math::INF, Math::INF, Math::INF);
+		Vector3 max = Vector3(-Math::INF, -Math::INF, -Math::INF);
+
+		_FORCE_INLINE_ void expand_to(const Vector3 &p_point) {
+			min = min.min(p_point);
+			max = max.max(p_point);
+		}
+
+		_FORCE_INLINE_ void merge_with(const Bounds &p_bounds) {
+			min = min.min(p_bounds.min);
+			max = max.max(p_bounds.max);
+		}
+
+		_FORCE_INLINE_ real_t get_half_area() const {
+			if (min.x > max.x) {
+				return 0;
+			}
+			const Vector3 size = max - min;
+			return size.x * size.y + size.y * size.z + size.z * size.x;
+		}
+	};
+
+	// A child >= 0 is another node, a negative child `c` is the leaf `~c`.
+	struct Node {
+		real_t min[3][WIDTH] = {};
+		real_t max[3][WIDTH] = {};
+		int32_t children[WIDTH] = {};
+		uint32_t child_count = 0;
+	};
+
+	// A range of get_primitives(), holding at most WIDTH primitives.
+	struct Leaf {
+		uint32_t first = 0;
+		uint32_t count = 0;
+	};
+
+	// Triangle test results per lane, see intersect_triangles().
+	struct TriangleHits {
+		Real4 a;
+		Real4 u;
+		Real4 v;
+		Real4 t;
+	};
+
+	// Box distances are rounded differently from primitive tests, so the far bound of boxes is slightly widened.
+	static constexpr real_t BOX_T_TOLERANCE = 1.0 + 1e-4;
+
+private:
+	LocalVector<Node> nodes;
+	LocalVector<Leaf> leaves;
+	LocalVector<uint32_t> primitives;
+	uint32_t max_depth = 0;
+
+public:
+	// Keeps the reciprocal finite, so slab distances never become `0 * inf`.
+	static _FORCE_INLINE_ real_t safe_inverse(real_t p_value) {
+		if (Math::abs(p_value) < (real_t)1e-20) {
+			return p_value < 0 ? (real_t)-1e20 : (real_t)1e20;
+		}
+		return (real_t)1.0 / p_value;
+	}
+
+	// Slab test, returns the lanes where the box overlaps [p_t_min, p_t_max], with the entry distances in r_t_near.
+	static _FORCE_INLINE_ Mask4 intersect_boxes(const Real4 p_from[3], const Real4 p_inv_dir[3], const Real4 p_min[3], const Real4 p_max[3], const Real4 &p_t_min, const Real4 &p_t_max, Real4 &r_t_near) {
+		Real4 t_near = p_t_min;
+		Real4 t_far = p_t_max;
+		for (int i = 0; i < 3; i++) {
+			const Real4 t0 = (p_min[i] - p_from[i]) * p_inv_dir[i];
+			const Real4 t1 = (p_max[i] - p_from[i]) * p_inv_dir[i];
+			t_near = Real4::max(t_near, Real4::min(t0, t1));
+			t_far = Real4::min(t_far, Real4::max(t0, t1));
+		}
+		r_t_near = t_near;
+		return t_near <= t_far * Real4::splat(BOX_T_TOLERANCE);
+	}
+
+	// Möller–Trumbore, performing the same operations as Geometry3D::ray_intersects_triangle(), so lanes
+	// give the same results as the scalar test. Callers decide which lanes hit from `a`, `u`, `v` and `t`.
+	static _FORCE_INLINE_ void intersect_triangles(const Real4 p_from[3], const Real4 p_dir[3], const Real4 p_v0[3], const Real4 p_e1[3], const Real4 p_e2[3], TriangleHits &r_hits) {
+		const Real4 hx = (p_dir[1] * p_e2[2]) - (p_dir[2] * p_e2[1]);
+		const Real4 hy = (p_dir[2] * p_e2[0]) - (p_dir[0] * p_e2[2]);
+		const Real4 hz = (p_dir[0] * p_e2[1]) - (p_dir[1] * p_e2[0]);
+		r_hits.a = p_e1[0] * hx + p_e1[1] * hy + p_e1[2] * hz;
+		const Real4 f = Real4::splat(1.0f) / r_hits.a;
+
+		const Real4 sx = p_from[0] - p_v0[0];
+		const Real4 sy = p_from[1] - p_v0[1];
+		const Real4 sz = p_from[2] - p_v0[2];
+		r_hits.u = f * (sx * hx + sy * hy + sz * hz);
+
+		const Real4 qx = (sy * p_e1[2]) - (sz * p_e1[1]);
+		const Real4 qy = (sz * p_e1[0]) - (sx * p_e1[2]);
+		const Real4 qz = (sx * p_e1[1]) - (sy * p_e1[0]);
+		r_hits.v = f * (p_dir[0] * qx + p_dir[1] * qy + p_dir[2] * qz);
+		r_hits.t = f * (p_e2[0] * qx + p_e2[1] * qy + p_e2[2] * qz);
+	}
+
+	// Calls `p_leaf_func(leaf_index, t_max)` for the leaves crossed by the ray between p_t_min and r_t_max, nearest
+	// first. The callback can shorten t_max as it finds hits, so farther subtrees are skipped.
+	template <typename F>
+	_FORCE_INLINE_ void ray_query(const Vector3 &p_from, const Vector3 &p_dir, real_t p_t_min, real_t &r_t_max, F &p_leaf_func) const;
+
+	// Same for four rays at once, which pays off when they are coherent. Calls `p_leaf_func(leaf_index, ray_mask, t_max)`,
+	// with a bit set in the mask for every ray crossing the leaf. Only the rays set in p_ray_mask are traced.
+	template <typename F>
+	_FORCE_INLINE_ void ray_packet_query(const Real4 p_from[3], const Real4 p_dir[3], const Real4 &p_t_min, Real4 &r_t_max, uint32_t p_ray_mask, F &p_leaf_func) const;
+
+	// Builds the tree over primitives with the given bounds, splitting the work over the WorkerThreadPool for large sets.
+	void build(const Bounds *p_bounds, uint32_t p_count, bool p_use_threads = false);
+	void clear();
+
+	_FORCE_INLINE_ bool is_empty() const { return nodes.is_empty(); }
+	_FORCE_INLINE_ const LocalVector<Node> &get_nodes() const { return nodes; }
+	_FORCE_INLINE_ const LocalVector<Leaf> &get_leaves() const { return leaves; }
+	_FORCE_INLINE_ const LocalVector<uint32_t> &get_primitives() const { return primitives; }
+	_FORCE_INLINE_ uint32_t get_max_depth() const { return max_depth; }
+	// Every visited node replaces itself with at most WIDTH children on the traversal stack.
+	_FORCE_INLINE_ uint32_t get_stack_size() const { return max_depth * (WIDTH - 1) + 1; }
+};
+
+template <typename F>
+void StaticBVH::ray_query(const Vector3 &p_from, const Vector3 &p_dir, real_t p_t_min, real_t &r_t_max, F &p_leaf_func) const {
+	if (nodes.is_empty()) {
+		return;
+	}
+
+	struct StackEntry {
+		int32_t node;
+		real_t t_near;
+	};
+
+	StackEntry *stack = (StackEntry *)alloca(sizeof(StackEntry) * get_stack_size());
+	uint32_t stack_size = 0;
+	stack[stack_size++] = { 0, p_t_min };
+
+	Real4 from[3];
+	Real4 inv_dir[3];
+	for (int i = 0; i < 3; i++) {
+		from[i] = Real4::splat(p_from[i]);
+		inv_dir[i] = Real4::splat(safe_inverse(p_dir[i]));
+	}
+	const Real4 t_min = Real4::splat(p_t_min);
+	// Kept local, so it isn't reloaded after every write to the stack.
+	real_t t_max = r_t_max;
+
+	while (stack_size) {
+		const StackEntry entry = stack[--stack_size];
+		if (entry.t_near > t_max * BOX_T_TOLERANCE) {
+			continue;
+		}
+
+		if (entry.node < 0) {
+			p_leaf_func(uint32_t(~entry.node), t_max);
+			continue;
+		}
+
+		const Node &node = nodes[entry.node];
+		const Real4 min[3] = { Real4::load(node.min[0]), Real4::load(node.min[1]), Real4::load(node.min[2]) };
+		const Real4 max[3] = { Real4::load(node.max[0]), Real4::load(node.max[1]), Real4::load(node.max[2]) };
+		Real4 t_near4;
+		const uint32_t hits = intersect_boxes(from, inv_dir, min, max, t_min, Real4::splat(t_max), t_near4).bits() & ((1 << node.child_count) - 1);
+		if (!hits) {
+			continue;
+		}
+		real_t t_near[WIDTH];
+		t_near4.store(t_near);
+
+		// Push the farthest children first, so the nearest ones are visited first and can prune the rest.
+		uint32_t order[WIDTH];
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < node.child_count; i++) {
+			if (!(hits & (1 << i))) {
+				continue;
+			}
+			uint32_t j = count++;
+			while (j > 0 && t_near[order[j - 1]] < t_near[i]) {
+				order[j] = order[j - 1];
+				j--;
+			}
+			order[j] = i;
+		}
+		for (uint32_t i = 0; i < count; i++) {
+			stack[stack_size++] = { node.children[order[i]], t_near[order[i]] };
+		}
+	}
+
+	r_t_max = t_max;
+}
+
+template <typename F>
+void StaticBVH::ray_packet_query(const Real4 p_from[3], const Real4 p_dir[3], const Real4 &p_t_min, Real4 &r_t_max, uint32_t p_ray_mask, F &p_leaf_func) const {
+	if (nodes.is_empty() || !p_ray_mask) {
+		return;
+	}
+
+	struct StackEntry {
+		Real4 t_near;
+		int32_t node;
+		uint32_t ray_mask;
+	};
+
+	StackEntry *stack = (StackEntry *)alloca(sizeof(StackEntry) * get_stack_size());
+	uint32_t stack_size = 0;
+	stack[stack_size++] = { p_t_min, 0, p_ray_mask };
+
+	Real4 inv_dir[3];
+	for (int i = 0; i < 3; i++) {
+		real_t dir[WIDTH];
+		p_dir[i].store(dir);
+		for (int j = 0; j < WIDTH; j++) {
+			dir[j] = safe_inverse(dir[j]);
+		}
+		inv_dir[i] = Real4::load(dir);
+	}
+
+	Real4 t_max = r_t_max;
+
+	while (stack_size) {
+		const StackEntry entry = stack[--stack_size];
+		const uint32_t entry_mask = entry.ray_mask & (entry.t_near <= t_max * Real4::splat(BOX_T_TOLERANCE)).bits();
+		if (!entry_mask) {
+			continue;
+		}
+
+		if (entry.node < 0) {
+			p_leaf_func(uint32_t(~entry.node), entry_mask, t_max);
+			continue;
+		}
+
+		const Node &node = nodes[entry.node];
+		Real4 child_t_near[WIDTH];
+		uint32_t child_mask[WIDTH];
+		real_t child_order_t[WIDTH];
+		uint32_t order[WIDTH];
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < node.child_count; i++) {
+			const Real4 min[3] = { Real4::splat(node.min[0][i]), Real4::splat(node.min[1][i]), Real4::splat(node.min[2][i]) };
+			const Real4 max[3] = { Real4::splat(node.max[0][i]), Real4::splat(node.max[1][i]), Real4::splat(node.max[2][i]) };
+			child_mask[i] = intersect_boxes(p_from, inv_dir, min, max, p_t_min, t_max, child_t_near[i]).bits() & entry_mask;
+			if (!child_mask[i]) {
+				continue;
+			}
+
+			// Order children by the nearest entry among the rays crossing them.
+			real_t t_near[WIDTH];
+			child_t_near[i].store(t_near);
+			child_order_t[i] = Math::INF;
+			for (int j = 0; j < WIDTH; j++) {
+				if (child_mask[i] & (1 << j)) {
+					child_order_t[i] = MIN(child_order_t[i], t_near[j]);
+				}
+			}
+
+			uint32_t j = count++;
+			while (j > 0 && child_order_t[order[j - 1]] < child_order_t[i]) {
+				order[j] = order[j - 1];
+				j--;
+			}
+			order[j] = i;
+		}
+		for (uint32_t i = 0; i < count; i++) {
+			stack[stack_size++] = { child_t_near[order[i]], node.children[order[i]], child_mask[order[i]] };
+		}
+	}
+
+	r_t_max = t_max;
+}
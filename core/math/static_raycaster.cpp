@@ -30,11 +30,13 @@
 
 #include "static_raycaster.h"
 
+#include "core/math/static_raycaster_bvh.h"
+
 StaticRaycaster *(*StaticRaycaster::create_function)() = nullptr;
 
 Ref<StaticRaycaster> StaticRaycaster::create() {
 	if (create_function) {
 		return Ref<StaticRaycaster>(create_function());
 	}
-	return Ref<StaticRaycaster>();
+	return Ref<StaticRaycaster>(StaticRaycasterBVH::create_bvh_raycaster());
 }
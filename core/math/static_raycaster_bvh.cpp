@@ -0,0 +1,343 @@
+/**************************************************************************/
+/*  static_raycaster_bvh.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "static_raycaster_bvh.h"
+
+#include "core/object/worker_thread_pool.h"
+
+typedef StaticBVH::Real4 Real4;
+
+StaticRaycaster *StaticRaycasterBVH::create_bvh_raycaster() {
+	return memnew(StaticRaycasterBVH);
+}
+
+void StaticRaycasterBVH::_set_hit(Ray &r_ray, const TrianglePacket &p_packet, int p_lane, real_t p_t, real_t p_u, real_t p_v) const {
+	const Vector3 e1 = Vector3(p_packet.e1[0][p_lane], p_packet.e1[1][p_lane], p_packet.e1[2][p_lane]);
+	const Vector3 e2 = Vector3(p_packet.e2[0][p_lane], p_packet.e2[1][p_lane], p_packet.e2[2][p_lane]);
+	r_ray.tfar = p_t;
+	r_ray.u = p_u;
+	r_ray.v = p_v;
+	r_ray.normal = e1.cross(e2);
+	r_ray.primID = p_packet.primitive[p_lane];
+	r_ray.geomID = meshes[p_packet.mesh[p_lane]].id;
+}
+
+bool StaticRaycasterBVH::intersect(Ray &r_ray) {
+	// Four triangles against one ray, keeping the closest hit. Ties go to the triangle added first.
+	struct LeafTest {
+		const StaticRaycasterBVH *raycaster = nullptr;
+		Real4 from[3];
+		Real4 dir[3];
+		Real4 t_min;
+		const TrianglePacket *best_packet = nullptr;
+		int best_lane = 0;
+		real_t best_u = 0;
+		real_t best_v = 0;
+
+		_FORCE_INLINE_ void operator()(uint32_t p_leaf, real_t &r_t_max) {
+			const TrianglePacket &packet = raycaster->packets[p_leaf];
+			const Real4 v0[3] = { Real4::load(packet.v0[0]), Real4::load(packet.v0[1]), Real4::load(packet.v0[2]) };
+			const Real4 e1[3] = { Real4::load(packet.e1[0]), Real4::load(packet.e1[1]), Real4::load(packet.e1[2]) };
+			const Real4 e2[3] = { Real4::load(packet.e2[0]), Real4::load(packet.e2[1]), Real4::load(packet.e2[2]) };
+			StaticBVH::TriangleHits hits;
+			StaticBVH::intersect_triangles(from, dir, v0, e1, e2, hits);
+
+			const Real4 zero = Real4::splat(0.0f);
+			const uint32_t bits = ((hits.a != zero) & (hits.u >= zero) & (hits.v >= zero) & ((hits.u + hits.v) <= Real4::splat(1.0f)) & (hits.t >= t_min) & (hits.t <= Real4::splat(r_t_max))).bits();
+			if (!bits) {
+				return;
+			}
+
+			real_t t[StaticBVH::WIDTH];
+			real_t u[StaticBVH::WIDTH];
+			real_t v[StaticBVH::WIDTH];
+			hits.t.store(t);
+			hits.u.store(u);
+			hits.v.store(v);
+			for (int i = 0; i < StaticBVH::WIDTH; i++) {
+				if (!(bits & (1 << i)) || t[i] > r_t_max || !raycaster->meshes[packet.mesh[i]].enabled) {
+					continue;
+				}
+				if (!best_packet || t[i] < r_t_max || packet.index[i] < best_packet->index[best_lane]) {
+					r_t_max = t[i];
+					best_packet = &packet;
+					best_lane = i;
+					best_u = u[i];
+					best_v = v[i];
+				}
+			}
+		}
+	};
+
+	if (bvh.is_empty() || !(r_ray.tnear <= r_ray.tfar)) {
+		return false;
+	}
+
+	LeafTest test;
+	test.raycaster = this;
+	for (int i = 0; i < 3; i++) {
+		test.from[i] = Real4::splat(r_ray.org[i]);
+		test.dir[i] = Real4::splat(r_ray.dir[i]);
+	}
+	test.t_min = Real4::splat(r_ray.tnear);
+
+	real_t t_max = r_ray.tfar;
+	bvh.ray_query(r_ray.org, r_ray.dir, r_ray.tnear, t_max, test);
+
+	if (!test.best_packet) {
+		return false;
+	}
+	_set_hit(r_ray, *test.best_packet, test.best_lane, t_max, test.best_u, test.best_v);
+	return true;
+}
+
+void StaticRaycasterBVH::_intersect_packet(Ray *p_rays) const {
+	// One triangle at a time against four rays.
+	struct LeafTest {
+		const StaticRaycasterBVH *raycaster = nullptr;
+		Real4 from[3];
+		Real4 dir[3];
+		Real4 t_min;
+		const TrianglePacket *best_packet[StaticBVH::WIDTH] = {};
+		int best_lane[StaticBVH::WIDTH] = {};
+		real_t best_u[StaticBVH::WIDTH] = {};
+		real_t best_v[StaticBVH::WIDTH] = {};
+
+		_FORCE_INLINE_ void operator()(uint32_t p_leaf, uint32_t p_ray_mask, Real4 &r_t_max) {
+			const TrianglePacket &packet = raycaster->packets[p_leaf];
+			real_t t_max[StaticBVH::WIDTH];
+			r_t_max.store(t_max);
+
+			for (int i = 0; i < StaticBVH::WIDTH; i++) {
+				if (!raycaster->meshes[packet.mesh[i]].enabled) {
+					continue;
+				}
+				const Real4 v0[3] = { Real4::splat(packet.v0[0][i]), Real4::splat(packet.v0[1][i]), Real4::splat(packet.v0[2][i]) };
+				const Real4 e1[3] = { Real4::splat(packet.e1[0][i]), Real4::splat(packet.e1[1][i]), Real4::splat(packet.e1[2][i]) };
+				const Real4 e2[3] = { Real4::splat(packet.e2[0][i]), Real4::splat(packet.e2[1][i]), Real4::splat(packet.e2[2][i]) };
+				StaticBVH::TriangleHits hits;
+				StaticBVH::intersect_triangles(from, dir, v0, e1, e2, hits);
+
+				const Real4 zero = Real4::splat(0.0f);
+				const uint32_t bits = p_ray_mask & ((hits.a != zero) & (hits.u >= zero) & (hits.v >= zero) & ((hits.u + hits.v) <= Real4::splat(1.0f)) & (hits.t >= t_min) & (hits.t <= r_t_max)).bits();
+				if (!bits) {
+					continue;
+				}
+
+				real_t t[StaticBVH::WIDTH];
+				real_t u[StaticBVH::WIDTH];
+				real_t v[StaticBVH::WIDTH];
+				hits.t.store(t);
+				hits.u.store(u);
+				hits.v.store(v);
+				for (int j = 0; j < StaticBVH::WIDTH; j++) {
+					if (!(bits & (1 << j))) {
+						continue;
+					}
+					if (!best_packet[j] || t[j] < t_max[j] || packet.index[i] < best_packet[j]->index[best_lane[j]]) {
+						t_max[j] = t[j];
+						best_packet[j] = &packet;
+						best_lane[j] = i;
+						best_u[j] = u[j];
+						best_v[j] = v[j];
+					}
+				}
+				r_t_max = Real4::load(t_max);
+			}
+		}
+	};
+
+	LeafTest test;
+	test.raycaster = this;
+	real_t values[3][StaticBVH::WIDTH];
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < StaticBVH::WIDTH; j++) {
+			values[i][j] = p_rays[j].org[i];
+		}
+		test.from[i] = Real4::load(values[i]);
+	}
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < StaticBVH::WIDTH; j++) {
+			values[i][j] = p_rays[j].dir[i];
+		}
+		test.dir[i] = Real4::load(values[i]);
+	}
+	for (int j = 0; j < StaticBVH::WIDTH; j++) {
+		values[0][j] = p_rays[j].tnear;
+		values[1][j] = p_rays[j].tfar;
+	}
+	test.t_min = Real4::load(values[0]);
+	Real4 t_max = Real4::load(values[1]);
+
+	bvh.ray_packet_query(test.from, test.dir, test.t_min, t_max, (1 << StaticBVH::WIDTH) - 1, test);
+
+	real_t t[StaticBVH::WIDTH];
+	t_max.store(t);
+	for (int j = 0; j < StaticBVH::WIDTH; j++) {
+		if (test.best_packet[j]) {
+			_set_hit(p_rays[j], *test.best_packet[j], test.best_lane[j], t[j], test.best_u[j], test.best_v[j]);
+		}
+	}
+}
+
+void StaticRaycasterBVH::_intersect_ray_group(uint32_t p_index, RayBatch *p_batch) {
+	const uint32_t from = p_index * RAY_GROUP_SIZE;
+	const uint32_t to = MIN(from + RAY_GROUP_SIZE, p_batch->count);
+	Ray *rays = p_batch->rays;
+
+	uint32_t i = from;
+	for (; i + StaticBVH::WIDTH <= to; i += StaticBVH::WIDTH) {
+		// Tracing rays together only pays off when they go the same way.
+		bool coherent = true;
+		for (int j = 0; j < StaticBVH::WIDTH; j++) {
+			const Ray &ray = rays[i + j];
+			const Ray &first = rays[i];
+			coherent = coherent && ray.tnear <= ray.tfar && (ray.dir.x < 0) == (first.dir.x < 0) && (ray.dir.y < 0) == (first.dir.y < 0) && (ray.dir.z < 0) == (first.dir.z < 0);
+		}
+		if (coherent) {
+			_intersect_packet(&rays[i]);
+		} else {
+			for (int j = 0; j < StaticBVH::WIDTH; j++) {
+				intersect(rays[i + j]);
+			}
+		}
+	}
+	for (; i < to; i++) {
+		intersect(rays[i]);
+	}
+}
+
+void StaticRaycasterBVH::intersect(Vector<Ray> &r_rays) {
+	RayBatch batch;
+	batch.rays = r_rays.ptrw();
+	batch.count = r_rays.size();
+
+	const uint32_t group_count = (batch.count + RAY_GROUP_SIZE - 1) / RAY_GROUP_SIZE;
+	if (group_count > 1 && WorkerThreadPool::get_singleton()) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &StaticRaycasterBVH::_intersect_ray_group, &batch, group_count, -1, true, SNAME("StaticRaycasterBVH"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < group_count; i++) {
+			_intersect_ray_group(i, &batch);
+		}
+	}
+}
+
+void StaticRaycasterBVH::add_mesh(const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, unsigned int p_id) {
+	ERR_FAIL_COND_MSG(mesh_slots.has(p_id), vformat("A mesh with ID %d was already added.", p_id));
+
+	if (p_indices.is_empty()) {
+		ERR_FAIL_COND(p_vertices.size() % 3 != 0);
+	} else {
+		ERR_FAIL_COND(p_indices.size() % 3 != 0);
+		for (const int32_t index : p_indices) {
+			ERR_FAIL_INDEX(index, p_vertices.size());
+		}
+	}
+
+	Mesh mesh;
+	mesh.vertices = p_vertices;
+	mesh.indices = p_indices;
+	mesh.id = p_id;
+	mesh_slots.insert(p_id, meshes.size());
+	meshes.push_back(mesh);
+}
+
+void StaticRaycasterBVH::commit() {
+	// Every triangle is referenced by the order it was added in.
+	LocalVector<uint32_t> triangle_meshes;
+	LocalVector<uint32_t> triangle_primitives;
+	LocalVector<StaticBVH::Bounds> bounds;
+	for (uint32_t i = 0; i < meshes.size(); i++) {
+		const Mesh &mesh = meshes[i];
+		const uint32_t count = (mesh.indices.is_empty() ? mesh.vertices.size() : mesh.indices.size()) / 3;
+		for (uint32_t j = 0; j < count; j++) {
+			triangle_meshes.push_back(i);
+			triangle_primitives.push_back(j);
+		}
+	}
+
+	auto get_vertices = [&](uint32_t p_triangle, Vector3 *r_vertices) {
+		const Mesh &mesh = meshes[triangle_meshes[p_triangle]];
+		const uint32_t primitive = triangle_primitives[p_triangle];
+		for (int i = 0; i < 3; i++) {
+			const uint32_t index = mesh.indices.is_empty() ? primitive * 3 + i : mesh.indices[primitive * 3 + i];
+			r_vertices[i] = mesh.vertices[index];
+		}
+	};
+
+	bounds.resize(triangle_meshes.size());
+	for (uint32_t i = 0; i < triangle_meshes.size(); i++) {
+		Vector3 vertices[3];
+		get_vertices(i, vertices);
+		for (int j = 0; j < 3; j++) {
+			bounds[i].expand_to(vertices[j]);
+		}
+	}
+	bvh.build(bounds.ptr(), bounds.size(), true);
+
+	const LocalVector<StaticBVH::Leaf> &leaves = bvh.get_leaves();
+	const uint32_t *triangles = bvh.get_primitives().ptr();
+	packets.resize(leaves.size());
+	for (uint32_t i = 0; i < leaves.size(); i++) {
+		TrianglePacket &packet = packets[i];
+		packet = TrianglePacket();
+		for (uint32_t j = 0; j < leaves[i].count; j++) {
+			const uint32_t triangle = triangles[leaves[i].first + j];
+			Vector3 vertices[3];
+			get_vertices(triangle, vertices);
+			const Vector3 e1 = vertices[1] - vertices[0];
+			const Vector3 e2 = vertices[2] - vertices[0];
+			for (int axis = 0; axis < 3; axis++) {
+				packet.v0[axis][j] = vertices[0][axis];
+				packet.e1[axis][j] = e1[axis];
+				packet.e2[axis][j] = e2[axis];
+			}
+			packet.mesh[j] = triangle_meshes[triangle];
+			packet.primitive[j] = triangle_primitives[triangle];
+			packet.index[j] = triangle;
+		}
+	}
+}
+
+void StaticRaycasterBVH::set_mesh_filter(const HashSet<int> &p_mesh_ids) {
+	for (const int &E : p_mesh_ids) {
+		HashMap<unsigned int, uint32_t>::ConstIterator slot = mesh_slots.find(E);
+		if (slot) {
+			meshes[slot->value].enabled = false;
+		}
+	}
+}
+
+void StaticRaycasterBVH::clear_mesh_filter() {
+	for (Mesh &mesh : meshes) {
+		mesh.enabled = true;
+	}
+}
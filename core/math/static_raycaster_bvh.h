@@ -0,0 +1,89 @@
+/**************************************************************************/
+/*  static_raycaster_bvh.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/static_bvh.h"
+#include "core/math/static_raycaster.h"
+#include "core/templates/hash_map.h"
+
+// Built-in StaticRaycaster, used when no other implementation is registered. Triangles of all the meshes
+// go in a single StaticBVH, rays that travel in the same direction are traced four at a time.
+class StaticRaycasterBVH : public StaticRaycaster {
+	GDCLASS(StaticRaycasterBVH, StaticRaycaster);
+
+	enum {
+		RAY_GROUP_SIZE = 64,
+	};
+
+	struct Mesh {
+		PackedVector3Array vertices;
+		PackedInt32Array indices;
+		unsigned int id = 0;
+		bool enabled = true;
+	};
+
+	// The triangles of a BVH leaf, stored per axis. Unused lanes are degenerate, so they are never hit.
+	struct TrianglePacket {
+		real_t v0[3][StaticBVH::WIDTH] = {};
+		real_t e1[3][StaticBVH::WIDTH] = {};
+		real_t e2[3][StaticBVH::WIDTH] = {};
+		uint32_t mesh[StaticBVH::WIDTH] = {};
+		uint32_t primitive[StaticBVH::WIDTH] = {};
+		// Order in which the triangle was added, used to break ties.
+		uint32_t index[StaticBVH::WIDTH] = {};
+	};
+
+	struct RayBatch {
+		Ray *rays = nullptr;
+		uint32_t count = 0;
+	};
+
+	LocalVector<Mesh> meshes;
+	HashMap<unsigned int, uint32_t> mesh_slots;
+	StaticBVH bvh;
+	LocalVector<TrianglePacket> packets;
+
+	void _set_hit(Ray &r_ray, const TrianglePacket &p_packet, int p_lane, real_t p_t, real_t p_u, real_t p_v) const;
+	void _intersect_packet(Ray *p_rays) const;
+	void _intersect_ray_group(uint32_t p_index, RayBatch *p_batch);
+
+public:
+	virtual bool intersect(Ray &r_ray) override;
+	virtual void intersect(Vector<Ray> &r_rays) override;
+
+	virtual void add_mesh(const PackedVector3Array &p_vertices, const PackedInt32Array &p_indices, unsigned int p_id) override;
+	virtual void commit() override;
+
+	virtual void set_mesh_filter(const HashSet<int> &p_mesh_ids) override;
+	virtual void clear_mesh_filter() override;
+
+	static StaticRaycaster *create_bvh_raycaster();
+};
@@ -30,6 +30,7 @@
 
 #include "transform_2d.h"
 
+#include "core/math/transform_batch.h"
 #include "core/string/ustring.h"
 
 void Transform2D::invert() {
@@ -267,6 +268,20 @@ Transform2D Transform2D::interpolate_with(const Transform2D &p_transform, real_t
 			get_origin().lerp(p_transform.get_origin(), p_weight));
 }
 
+Vector<Vector2> Transform2D::xform(const Vector<Vector2> &p_array) const {
+	Vector<Vector2> array;
+	array.resize(p_array.size());
+	TransformBatch::xform(*this, p_array.ptr(), array.ptrw(), p_array.size());
+	return array;
+}
+
+Vector<Vector2> Transform2D::xform_inv(const Vector<Vector2> &p_array) const {
+	Vector<Vector2> array;
+	array.resize(p_array.size());
+	TransformBatch::xform_inv(*this, p_array.ptr(), array.ptrw(), p_array.size());
+	return array;
+}
+
 Transform2D::operator String() const {
 	return "[X: " + columns[0].operator String() +
 			", Y: " + columns[1].operator String() +
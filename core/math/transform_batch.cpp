@@ -0,0 +1,347 @@
+/**************************************************************************/
+/*  transform_batch.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "transform_batch.h"
+
+#ifndef REAL_T_IS_DOUBLE
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRANSFORM_BATCH_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define TRANSFORM_BATCH_NEON
+#include <arm_neon.h>
+#endif
+#endif // REAL_T_IS_DOUBLE
+
+namespace TransformBatch {
+
+// All the operations are `m * (v - pre) + post`, computed in the same order as the per-vector methods.
+struct Affine3 {
+	real_t m[3][3] = {};
+	Vector3 pre;
+	Vector3 post;
+};
+
+struct Affine2 {
+	real_t m[2][2] = {};
+	Vector2 pre;
+	Vector2 post;
+};
+
+template <typename T>
+static _FORCE_INLINE_ const T &_at(const T *p_array, uint32_t p_index, uint32_t p_stride) {
+	return *(const T *)((const uint8_t *)p_array + (size_t)p_index * p_stride);
+}
+
+template <typename T>
+static _FORCE_INLINE_ T &_at(T *p_array, uint32_t p_index, uint32_t p_stride) {
+	return *(T *)((uint8_t *)p_array + (size_t)p_index * p_stride);
+}
+
+template <bool PRE, bool POST>
+static _FORCE_INLINE_ Vector3 _apply(const Affine3 &p_affine, const Vector3 &p_vector) {
+	const Vector3 v = PRE ? p_vector - p_affine.pre : p_vector;
+	Vector3 r = Vector3(
+			(p_affine.m[0][0] * v.x) + (p_affine.m[0][1] * v.y) + (p_affine.m[0][2] * v.z),
+			(p_affine.m[1][0] * v.x) + (p_affine.m[1][1] * v.y) + (p_affine.m[1][2] * v.z),
+			(p_affine.m[2][0] * v.x) + (p_affine.m[2][1] * v.y) + (p_affine.m[2][2] * v.z));
+	if (POST) {
+		r += p_affine.post;
+	}
+	return r;
+}
+
+static _FORCE_INLINE_ Vector2 _apply(const Affine2 &p_affine, const Vector2 &p_vector) {
+	const Vector2 v = p_vector - p_affine.pre;
+	return Vector2(
+			(p_affine.m[0][0] * v.x) + (p_affine.m[0][1] * v.y) + p_affine.post.x,
+			(p_affine.m[1][0] * v.x) + (p_affine.m[1][1] * v.y) + p_affine.post.y);
+}
+
+#if defined(TRANSFORM_BATCH_SSE2)
+struct Affine3SIMD {
+	__m128 m[3][3];
+	__m128 pre[3];
+	__m128 post[3];
+
+	explicit Affine3SIMD(const Affine3 &p_affine) {
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				m[i][j] = _mm_set1_ps(p_affine.m[i][j]);
+			}
+			pre[i] = _mm_set1_ps(p_affine.pre[i]);
+			post[i] = _mm_set1_ps(p_affine.post[i]);
+		}
+	}
+
+	template <bool PRE, bool POST>
+	_FORCE_INLINE_ void apply(__m128 &r_x, __m128 &r_y, __m128 &r_z) const {
+		const __m128 x = PRE ? _mm_sub_ps(r_x, pre[0]) : r_x;
+		const __m128 y = PRE ? _mm_sub_ps(r_y, pre[1]) : r_y;
+		const __m128 z = PRE ? _mm_sub_ps(r_z, pre[2]) : r_z;
+		r_x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0][0], x), _mm_mul_ps(m[0][1], y)), _mm_mul_ps(m[0][2], z));
+		r_y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[1][0], x), _mm_mul_ps(m[1][1], y)), _mm_mul_ps(m[1][2], z));
+		r_z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[2][0], x), _mm_mul_ps(m[2][1], y)), _mm_mul_ps(m[2][2], z));
+		if (POST) {
+			r_x = _mm_add_ps(r_x, post[0]);
+			r_y = _mm_add_ps(r_y, post[1]);
+			r_z = _mm_add_ps(r_z, post[2]);
+		}
+	}
+};
+#elif defined(TRANSFORM_BATCH_NEON)
+struct Affine3SIMD {
+	float32x4_t m[3][3];
+	float32x4_t pre[3];
+	float32x4_t post[3];
+
+	explicit Affine3SIMD(const Affine3 &p_affine) {
+		for (int i = 0; i < 3; i++) {
+			for (int j = 0; j < 3; j++) {
+				m[i][j] = vdupq_n_f32(p_affine.m[i][j]);
+			}
+			pre[i] = vdupq_n_f32(p_affine.pre[i]);
+			post[i] = vdupq_n_f32(p_affine.post[i]);
+		}
+	}
+
+	// Multiplications and additions are kept separate (no fused multiply-add) to match the scalar results.
+	template <bool PRE, bool POST>
+	_FORCE_INLINE_ void apply(float32x4_t &r_x, float32x4_t &r_y, float32x4_t &r_z) const {
+		const float32x4_t x = PRE ? vsubq_f32(r_x, pre[0]) : r_x;
+		const float32x4_t y = PRE ? vsubq_f32(r_y, pre[1]) : r_y;
+		const float32x4_t z = PRE ? vsubq_f32(r_z, pre[2]) : r_z;
+		r_x = vaddq_f32(vaddq_f32(vmulq_f32(m[0][0], x), vmulq_f32(m[0][1], y)), vmulq_f32(m[0][2], z));
+		r_y = vaddq_f32(vaddq_f32(vmulq_f32(m[1][0], x), vmulq_f32(m[1][1], y)), vmulq_f32(m[1][2], z));
+		r_z = vaddq_f32(vaddq_f32(vmulq_f32(m[2][0], x), vmulq_f32(m[2][1], y)), vmulq_f32(m[2][2], z));
+		if (POST) {
+			r_x = vaddq_f32(r_x, post[0]);
+			r_y = vaddq_f32(r_y, post[1]);
+			r_z = vaddq_f32(r_z, post[2]);
+		}
+	}
+};
+#endif
+
+// Only one of the translations is used by each operation, so they are compiled out when unused to save registers.
+template <bool PRE, bool POST>
+static void _transform(const Affine3 &p_affine, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	uint32_t i = 0;
+
+#if defined(TRANSFORM_BATCH_SSE2)
+	const Affine3SIMD affine(p_affine);
+	if (p_stride == sizeof(Vector3)) {
+		const float *src = (const float *)p_src;
+		float *dst = (float *)p_dst;
+		for (; i + 4 <= p_count; i += 4) {
+			// Four vectors are x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3, transpose them to one register per axis.
+			const __m128 a = _mm_loadu_ps(src + i * 3);
+			const __m128 b = _mm_loadu_ps(src + i * 3 + 4);
+			const __m128 c = _mm_loadu_ps(src + i * 3 + 8);
+			const __m128 x2y2x3y3 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+			const __m128 y0z0y1z1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+			__m128 x = _mm_shuffle_ps(a, x2y2x3y3, _MM_SHUFFLE(2, 0, 3, 0));
+			__m128 y = _mm_shuffle_ps(y0z0y1z1, x2y2x3y3, _MM_SHUFFLE(3, 1, 2, 0));
+			__m128 z = _mm_shuffle_ps(y0z0y1z1, c, _MM_SHUFFLE(3, 0, 3, 1));
+
+			affine.template apply<PRE, POST>(x, y, z);
+
+			const __m128 x0x2y0y2 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 0, 2, 0));
+			const __m128 z0z2x1x3 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 1, 2, 0));
+			const __m128 y1y3z1z3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 1, 3, 1));
+			_mm_storeu_ps(dst + i * 3, _mm_shuffle_ps(x0x2y0y2, z0z2x1x3, _MM_SHUFFLE(2, 0, 2, 0)));
+			_mm_storeu_ps(dst + i * 3 + 4, _mm_shuffle_ps(y1y3z1z3, x0x2y0y2, _MM_SHUFFLE(3, 1, 2, 0)));
+			_mm_storeu_ps(dst + i * 3 + 8, _mm_shuffle_ps(z0z2x1x3, y1y3z1z3, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+	} else {
+		for (; i + 4 <= p_count; i += 4) {
+			const Vector3 &v0 = _at(p_src, i, p_stride);
+			const Vector3 &v1 = _at(p_src, i + 1, p_stride);
+			const Vector3 &v2 = _at(p_src, i + 2, p_stride);
+			const Vector3 &v3 = _at(p_src, i + 3, p_stride);
+			__m128 x = _mm_setr_ps(v0.x, v1.x, v2.x, v3.x);
+			__m128 y = _mm_setr_ps(v0.y, v1.y, v2.y, v3.y);
+			__m128 z = _mm_setr_ps(v0.z, v1.z, v2.z, v3.z);
+
+			affine.template apply<PRE, POST>(x, y, z);
+
+			float rx[4], ry[4], rz[4];
+			_mm_storeu_ps(rx, x);
+			_mm_storeu_ps(ry, y);
+			_mm_storeu_ps(rz, z);
+			for (uint32_t j = 0; j < 4; j++) {
+				_at(p_dst, i + j, p_stride) = Vector3(rx[j], ry[j], rz[j]);
+			}
+		}
+	}
+#elif defined(TRANSFORM_BATCH_NEON)
+	if (p_stride == sizeof(Vector3)) {
+		const Affine3SIMD affine(p_affine);
+		const float *src = (const float *)p_src;
+		float *dst = (float *)p_dst;
+		for (; i + 4 <= p_count; i += 4) {
+			float32x4x3_t v = vld3q_f32(src + i * 3);
+			affine.template apply<PRE, POST>(v.val[0], v.val[1], v.val[2]);
+			vst3q_f32(dst + i * 3, v);
+		}
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		_at(p_dst, i, p_stride) = _apply<PRE, POST>(p_affine, _at(p_src, i, p_stride));
+	}
+}
+
+static void _transform(const Affine2 &p_affine, const Vector2 *p_src, Vector2 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	uint32_t i = 0;
+
+#if defined(TRANSFORM_BATCH_SSE2)
+	if (p_stride == sizeof(Vector2)) {
+		const __m128 m00 = _mm_set1_ps(p_affine.m[0][0]);
+		const __m128 m01 = _mm_set1_ps(p_affine.m[0][1]);
+		const __m128 m10 = _mm_set1_ps(p_affine.m[1][0]);
+		const __m128 m11 = _mm_set1_ps(p_affine.m[1][1]);
+		const __m128 pre_x = _mm_set1_ps(p_affine.pre.x);
+		const __m128 pre_y = _mm_set1_ps(p_affine.pre.y);
+		const __m128 post_x = _mm_set1_ps(p_affine.post.x);
+		const __m128 post_y = _mm_set1_ps(p_affine.post.y);
+		const float *src = (const float *)p_src;
+		float *dst = (float *)p_dst;
+		for (; i + 4 <= p_count; i += 4) {
+			const __m128 a = _mm_loadu_ps(src + i * 2);
+			const __m128 b = _mm_loadu_ps(src + i * 2 + 4);
+			const __m128 x = _mm_sub_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), pre_x);
+			const __m128 y = _mm_sub_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), pre_y);
+			const __m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), post_x);
+			const __m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), post_y);
+			_mm_storeu_ps(dst + i * 2, _mm_unpacklo_ps(rx, ry));
+			_mm_storeu_ps(dst + i * 2 + 4, _mm_unpackhi_ps(rx, ry));
+		}
+	}
+#elif defined(TRANSFORM_BATCH_NEON)
+	if (p_stride == sizeof(Vector2)) {
+		const float32x4_t m00 = vdupq_n_f32(p_affine.m[0][0]);
+		const float32x4_t m01 = vdupq_n_f32(p_affine.m[0][1]);
+		const float32x4_t m10 = vdupq_n_f32(p_affine.m[1][0]);
+		const float32x4_t m11 = vdupq_n_f32(p_affine.m[1][1]);
+		const float32x4_t pre_x = vdupq_n_f32(p_affine.pre.x);
+		const float32x4_t pre_y = vdupq_n_f32(p_affine.pre.y);
+		const float32x4_t post_x = vdupq_n_f32(p_affine.post.x);
+		const float32x4_t post_y = vdupq_n_f32(p_affine.post.y);
+		const float *src = (const float *)p_src;
+		float *dst = (float *)p_dst;
+		for (; i + 4 <= p_count; i += 4) {
+			float32x4x2_t v = vld2q_f32(src + i * 2);
+			const float32x4_t x = vsubq_f32(v.val[0], pre_x);
+			const float32x4_t y = vsubq_f32(v.val[1], pre_y);
+			v.val[0] = vaddq_f32(vaddq_f32(vmulq_f32(m00, x), vmulq_f32(m01, y)), post_x);
+			v.val[1] = vaddq_f32(vaddq_f32(vmulq_f32(m10, x), vmulq_f32(m11, y)), post_y);
+			vst2q_f32(dst + i * 2, v);
+		}
+	}
+#endif
+
+	for (; i < p_count; i++) {
+		_at(p_dst, i, p_stride) = _apply(p_affine, _at(p_src, i, p_stride));
+	}
+}
+
+void xform(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	Affine3 affine;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			affine.m[i][j] = p_transform.basis.rows[i][j];
+		}
+	}
+	affine.post = p_transform.origin;
+	_transform<false, true>(affine, p_src, p_dst, p_count, p_stride);
+}
+
+void xform_inv(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	Affine3 affine;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			affine.m[i][j] = p_transform.basis.rows[j][i];
+		}
+	}
+	affine.pre = p_transform.origin;
+	_transform<true, false>(affine, p_src, p_dst, p_count, p_stride);
+}
+
+void basis_xform(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	Affine3 affine;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			affine.m[i][j] = p_basis.rows[i][j];
+		}
+	}
+	_transform<false, false>(affine, p_src, p_dst, p_count, p_stride);
+}
+
+void basis_xform_inv(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	Affine3 affine;
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 3; j++) {
+			affine.m[i][j] = p_basis.rows[j][i];
+		}
+	}
+	_transform<false, false>(affine, p_src, p_dst, p_count, p_stride);
+}
+
+void xform(const Transform2D &p_transform, const Vector2 *p_src, Vector2 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	Affine2 affine;
+	affine.m[0][0] = p_transform.columns[0][0];
+	affine.m[0][1] = p_transform.columns[1][0];
+	affine.m[1][0] = p_transform.columns[0][1];
+	affine.m[1][1] = p_transform.columns[1][1];
+	affine.post = p_transform.columns[2];
+	_transform(affine, p_src, p_dst, p_count, p_stride);
+}
+
+void xform_inv(const Transform2D &p_transform, const Vector2 *p_src, Vector2 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	Affine2 affine;
+	affine.m[0][0] = p_transform.columns[0][0];
+	affine.m[0][1] = p_transform.columns[0][1];
+	affine.m[1][0] = p_transform.columns[1][0];
+	affine.m[1][1] = p_transform.columns[1][1];
+	affine.pre = p_transform.columns[2];
+	_transform(affine, p_src, p_dst, p_count, p_stride);
+}
+
+void basis_xform(const Transform2D &p_transform, const Vector2 *p_src, Vector2 *p_dst, uint32_t p_count, uint32_t p_stride) {
+	Affine2 affine;
+	affine.m[0][0] = p_transform.columns[0][0];
+	affine.m[0][1] = p_transform.columns[1][0];
+	affine.m[1][0] = p_transform.columns[0][1];
+	affine.m[1][1] = p_transform.columns[1][1];
+	_transform(affine, p_src, p_dst, p_count, p_stride);
+}
+
+} // namespace TransformBatch
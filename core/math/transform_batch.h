@@ -0,0 +1,58 @@
+/**************************************************************************/
+/*  transform_batch.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/transform_2d.h"
+#include "core/math/transform_3d.h"
+
+/**
+ * Kernels transforming many vectors at once, used for packed arrays and mesh data.
+ *
+ * With single precision, they transform four vectors per iteration using SSE2 (x86) or
+ * NEON (ARM64), converting them from arrays of structures to one register per axis.
+ * Other configurations use a scalar loop. All results match the per-vector methods.
+ *
+ * `p_src` and `p_dst` may be the same array. `p_stride` is the distance in bytes between
+ * consecutive vectors in both arrays, so a member of an array of structures can be
+ * transformed in place.
+ */
+namespace TransformBatch {
+
+void xform(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride = sizeof(Vector3));
+void xform_inv(const Transform3D &p_transform, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride = sizeof(Vector3));
+void basis_xform(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride = sizeof(Vector3));
+void basis_xform_inv(const Basis &p_basis, const Vector3 *p_src, Vector3 *p_dst, uint32_t p_count, uint32_t p_stride = sizeof(Vector3));
+
+void xform(const Transform2D &p_transform, const Vector2 *p_src, Vector2 *p_dst, uint32_t p_count, uint32_t p_stride = sizeof(Vector2));
+void xform_inv(const Transform2D &p_transform, const Vector2 *p_src, Vector2 *p_dst, uint32_t p_count, uint32_t p_stride = sizeof(Vector2));
+void basis_xform(const Transform2D &p_transform, const Vector2 *p_src, Vector2 *p_dst, uint32_t p_count, uint32_t p_stride = sizeof(Vector2));
+
+} // namespace TransformBatch
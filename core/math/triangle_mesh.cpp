@@ -30,58 +30,42 @@
 
 #include "triangle_mesh.h"
 
-#include "core/templates/sort_array.h"
+#include "core/object/worker_thread_pool.h"
 
-int TriangleMesh::_create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &r_max_depth, int &r_max_alloc) {
-	if (p_depth > r_max_depth) {
-		r_max_depth = p_depth;
-	}
-
-	if (p_size == 1) {
-		return p_bb[p_from] - p_bvh;
-	} else if (p_size == 0) {
-		return -1;
-	}
+void TriangleMesh::_create_bvh() {
+	const uint32_t face_count = triangles.size();
+	const Triangle *triangle_ptr = triangles.ptr();
+	const Vector3 *vertex_ptr = vertices.ptr();
 
-	AABB aabb;
-	aabb = p_bb[p_from]->aabb;
-	for (int i = 1; i < p_size; i++) {
-		aabb.merge_with(p_bb[p_from + i]->aabb);
+	LocalVector<StaticBVH::Bounds> face_bounds;
+	face_bounds.resize(face_count);
+	for (uint32_t i = 0; i < face_count; i++) {
+		for (int j = 0; j < 3; j++) {
+			face_bounds[i].expand_to(vertex_ptr[triangle_ptr[i].indices[j]]);
+		}
 	}
-
-	int li = aabb.get_longest_axis_index();
-
-	switch (li) {
-		case Vector3::AXIS_X: {
-			SortArray<BVH *, BVHCmpX> sort_x;
-			sort_x.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_x.sort(&p_bb[p_from],p_size);
-		} break;
-		case Vector3::AXIS_Y: {
-			SortArray<BVH *, BVHCmpY> sort_y;
-			sort_y.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_y.sort(&p_bb[p_from],p_size);
-		} break;
-		case Vector3::AXIS_Z: {
-			SortArray<BVH *, BVHCmpZ> sort_z;
-			sort_z.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_z.sort(&p_bb[p_from],p_size);
-
-		} break;
+	bvh.build(face_bounds.ptr(), face_count, true);
+
+	const LocalVector<StaticBVH::Leaf> &leaves = bvh.get_leaves();
+	const uint32_t *faces = bvh.get_primitives().ptr();
+	triangle_packets.resize(leaves.size());
+	for (uint32_t i = 0; i < leaves.size(); i++) {
+		TrianglePacket &packet = triangle_packets[i];
+		packet = TrianglePacket();
+		for (uint32_t j = 0; j < leaves[i].count; j++) {
+			const uint32_t face = faces[leaves[i].first + j];
+			const Triangle &t = triangle_ptr[face];
+			const Vector3 &v0 = vertex_ptr[t.indices[0]];
+			const Vector3 e1 = vertex_ptr[t.indices[1]] - v0;
+			const Vector3 e2 = vertex_ptr[t.indices[2]] - v0;
+			for (int axis = 0; axis < 3; axis++) {
+				packet.v0[axis][j] = v0[axis];
+				packet.e1[axis][j] = e1[axis];
+				packet.e2[axis][j] = e2[axis];
+			}
+			packet.face_index[j] = face;
+		}
 	}
-
-	int left = _create_bvh(p_bvh, p_bb, p_from, p_size / 2, p_depth + 1, r_max_depth, r_max_alloc);
-	int right = _create_bvh(p_bvh, p_bb, p_from + p_size / 2, p_size - p_size / 2, p_depth + 1, r_max_depth, r_max_alloc);
-
-	int index = r_max_alloc++;
-	BVH *_new = &p_bvh[index];
-	_new->aabb = aabb;
-	_new->center = aabb.get_center();
-	_new->face_index = -1;
-	_new->left = left;
-	_new->right = right;
-
-	return index;
 }
 
 void TriangleMesh::get_indices(Vector<int> *r_triangles_indices) const {
@@ -114,11 +98,8 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces, const Vector<int32_t>
 	fc /= 3;
 	triangles.resize(fc);
 
-	bvh.resize(fc * 3); //will never be larger than this (todo make better)
-	BVH *bw = bvh.ptrw();
-
 	{
-		//create faces and indices and base bvh
+		//create faces and indices
 		//except for the Set for repeated triangles, everything
 		//goes in-place.
 
@@ -143,20 +124,10 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces, const Vector<int32_t>
 				}
 
 				f.indices[j] = vidx;
-				if (j == 0) {
-					bw[i].aabb.position = vs;
-				} else {
-					bw[i].aabb.expand_to(vs);
-				}
 			}
 
 			f.normal = Face3(r[i * 3 + 0], r[i * 3 + 1], r[i * 3 + 2]).get_plane().get_normal();
 			f.surface_index = si ? si[i] : 0;
-
-			bw[i].left = -1;
-			bw[i].right = -1;
-			bw[i].face_index = i;
-			bw[i].center = bw[i].aabb.get_center();
 		}
 
 		vertices.resize(db.size());
@@ -166,236 +137,153 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces, const Vector<int32_t>
 		}
 	}
 
-	Vector<BVH *> bwptrs;
-	bwptrs.resize(fc);
-	BVH **bwp = bwptrs.ptrw();
-	for (int i = 0; i < fc; i++) {
-		bwp[i] = &bw[i];
-	}
-
-	max_depth = 0;
-	int max_alloc = fc;
-	_create_bvh(bw, bwp, 0, fc, 1, max_depth, max_alloc);
-
-	bvh.resize(max_alloc); //resize back
+	_create_bvh();
 
 	valid = true;
 }
 
-bool TriangleMesh::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index, int32_t *r_face_index) const {
-	if (!valid) {
-		return false;
-	}
-
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	Vector3 n = (p_end - p_begin).normalized();
-	real_t d = 1e10;
-	bool inters = false;
-
-	int level = 0;
-
-	const Triangle *triangleptr = triangles.ptr();
-	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
-
-	int pos = bvh.size() - 1;
-
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
-
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				if (!b.aabb.intersects_segment(p_begin, p_end)) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						Face3 f3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]);
-
-						Vector3 res;
-
-						if (f3.intersects_segment(p_begin, p_end, &res)) {
-							real_t nd = n.dot(res);
-							if (nd < d) {
-								d = nd;
-								r_point = res;
-								r_normal = f3.get_plane().get_normal();
-								if (r_surf_index) {
-									*r_surf_index = s.surface_index;
-								}
-								if (r_face_index) {
-									*r_face_index = b.face_index;
-								}
-								inters = true;
-							}
-						}
-
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
+template <bool SEGMENT>
+int32_t TriangleMesh::_intersect(const Vector3 &p_from, const Vector3 &p_rel, const Vector3 &p_n, real_t p_d, Vector3 &r_point) const {
+	typedef StaticBVH::Real4 Real4;
+
+	// Keeps the closest hit, the same way as testing every face with Face3::intersects_ray() or intersects_segment().
+	struct LeafTest {
+		const TrianglePacket *packets = nullptr;
+		Vector3 from;
+		Vector3 rel;
+		Vector3 n;
+		Real4 from4[3];
+		Real4 rel4[3];
+		real_t d = 0;
+		int32_t face_index = -1;
+		Vector3 point;
+
+		_FORCE_INLINE_ void operator()(uint32_t p_leaf, real_t &r_t_max) {
+			const TrianglePacket &packet = packets[p_leaf];
+			const Real4 v0[3] = { Real4::load(packet.v0[0]), Real4::load(packet.v0[1]), Real4::load(packet.v0[2]) };
+			const Real4 e1[3] = { Real4::load(packet.e1[0]), Real4::load(packet.e1[1]), Real4::load(packet.e1[2]) };
+			const Real4 e2[3] = { Real4::load(packet.e2[0]), Real4::load(packet.e2[1]), Real4::load(packet.e2[2]) };
+			StaticBVH::TriangleHits hits;
+			StaticBVH::intersect_triangles(from4, rel4, v0, e1, e2, hits);
+
+			// Same conditions as Geometry3D::ray_intersects_triangle() and segment_intersects_triangle().
+			const Real4 zero = Real4::splat(0.0f);
+			const Real4 one = Real4::splat(1.0f);
+			StaticBVH::Mask4 mask = (hits.a.abs() >= Real4::splat((real_t)CMP_EPSILON)) & (hits.u >= zero) & (hits.u <= one) & (hits.v >= zero) & ((hits.u + hits.v) <= one);
+			if constexpr (SEGMENT) {
+				mask = mask & (hits.t > Real4::splat((real_t)CMP_EPSILON)) & (hits.t <= one);
+			} else {
+				mask = mask & (hits.t > Real4::splat((real_t)0.00001f));
 			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.left | TEST_AABB_BIT;
-				continue;
+			const uint32_t bits = mask.bits();
+			if (!bits) {
+				return;
 			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.right | TEST_AABB_BIT;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
+
+			real_t t[StaticBVH::WIDTH];
+			hits.t.store(t);
+			for (int i = 0; i < StaticBVH::WIDTH; i++) {
+				if (!(bits & (1 << i))) {
+					continue;
+				}
+				const Vector3 res = from + rel * t[i];
+				const real_t nd = n.dot(res);
+				// Faces sharing an edge can be hit at the same spot, pick the lowest index so the result doesn't depend on the tree layout.
+				if (nd < d || (nd == d && packet.face_index[i] < face_index)) {
+					d = nd;
+					r_t_max = t[i];
+					face_index = packet.face_index[i];
+					point = res;
 				}
-				continue;
 			}
 		}
+	};
 
-		if (done) {
-			break;
-		}
+	LeafTest test;
+	test.packets = triangle_packets.ptr();
+	test.from = p_from;
+	test.rel = p_rel;
+	test.n = p_n;
+	test.d = p_d;
+	for (int i = 0; i < 3; i++) {
+		test.from4[i] = Real4::splat(p_from[i]);
+		test.rel4[i] = Real4::splat(p_rel[i]);
 	}
 
-	if (inters) {
-		if (n.dot(r_normal) > 0) {
-			r_normal = -r_normal;
-		}
-	}
+	real_t t_max = SEGMENT ? (real_t)1.0 : (real_t)Math::INF;
+	bvh.ray_query(p_from, p_rel, 0, t_max, test);
 
-	return inters;
+	if (test.face_index >= 0) {
+		r_point = test.point;
+	}
+	return test.face_index;
 }
 
-bool TriangleMesh::intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index, int32_t *r_face_index) const {
-	if (!valid) {
+bool TriangleMesh::_finish_intersection(int32_t p_face_index, const Vector3 &p_n, Vector3 &r_normal, int32_t *r_surf_index, int32_t *r_face_index) const {
+	if (p_face_index < 0) {
 		return false;
 	}
 
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	Vector3 n = p_dir;
-	real_t d = 1e20;
-	bool inters = false;
-
-	int level = 0;
-
-	const Triangle *triangleptr = triangles.ptr();
+	const Triangle &s = triangles.ptr()[p_face_index];
 	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
-
-	int pos = bvh.size() - 1;
+	r_normal = Face3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]).get_plane().get_normal();
+	if (p_n.dot(r_normal) > 0) {
+		r_normal = -r_normal;
+	}
+	if (r_surf_index) {
+		*r_surf_index = s.surface_index;
+	}
+	if (r_face_index) {
+		*r_face_index = p_face_index;
+	}
+	return true;
+}
 
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
+bool TriangleMesh::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index, int32_t *r_face_index) const {
+	if (!valid) {
+		return false;
+	}
 
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				if (!b.aabb.intersects_ray(p_begin, p_dir)) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						Face3 f3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]);
-
-						Vector3 res;
-
-						if (f3.intersects_ray(p_begin, p_dir, &res)) {
-							real_t nd = n.dot(res);
-							if (nd < d) {
-								d = nd;
-								r_point = res;
-								r_normal = f3.get_plane().get_normal();
-								if (r_surf_index) {
-									*r_surf_index = s.surface_index;
-								}
-								if (r_face_index) {
-									*r_face_index = b.face_index;
-								}
-								inters = true;
-							}
-						}
+	const Vector3 rel = p_end - p_begin;
+	const Vector3 n = rel.normalized();
+	const int32_t face_index = _intersect<true>(p_begin, rel, n, 1e10, r_point);
+	return _finish_intersection(face_index, n, r_normal, r_surf_index, r_face_index);
+}
 
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+bool TriangleMesh::intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index, int32_t *r_face_index) const {
+	if (!valid) {
+		return false;
+	}
 
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.left | TEST_AABB_BIT;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.right | TEST_AABB_BIT;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
-				}
-				continue;
-			}
-		}
+	const int32_t face_index = _intersect<false>(p_begin, p_dir, p_dir, 1e20, r_point);
+	return _finish_intersection(face_index, p_dir, r_normal, r_surf_index, r_face_index);
+}
 
-		if (done) {
-			break;
-		}
+void TriangleMesh::_intersect_ray_batch_packet(uint32_t p_index, const RayBatch *p_batch) const {
+	const uint32_t from = p_index * RAY_BATCH_PACKET_SIZE;
+	const uint32_t to = MIN(from + RAY_BATCH_PACKET_SIZE, p_batch->count);
+	for (uint32_t i = from; i < to; i++) {
+		RayResult &result = p_batch->results[i];
+		result.hit = intersect_ray(p_batch->from[i], p_batch->dir[i], result.point, result.normal, &result.surface_index, &result.face_index);
 	}
+}
 
-	if (inters) {
-		if (n.dot(r_normal) > 0) {
-			r_normal = -r_normal;
+void TriangleMesh::intersect_rays(const Vector3 *p_from, const Vector3 *p_dir, uint32_t p_count, RayResult *r_results, bool p_use_threads) const {
+	RayBatch batch;
+	batch.from = p_from;
+	batch.dir = p_dir;
+	batch.results = r_results;
+	batch.count = p_count;
+
+	const uint32_t packet_count = (p_count + RAY_BATCH_PACKET_SIZE - 1) / RAY_BATCH_PACKET_SIZE;
+	if (p_use_threads && packet_count > 1 && WorkerThreadPool::get_singleton()) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &TriangleMesh::_intersect_ray_batch_packet, (const RayBatch *)&batch, packet_count, -1, true, SNAME("TriangleMeshIntersectRays"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		for (uint32_t i = 0; i < packet_count; i++) {
+			_intersect_ray_batch_packet(i, &batch);
 		}
 	}
-
-	return inters;
 }
 
 bool TriangleMesh::inside_convex_shape(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, Vector3 p_scale) const {
@@ -403,93 +291,53 @@ bool TriangleMesh::inside_convex_shape(const Plane *p_planes, int p_plane_count,
 		return false;
 	}
 
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	int level = 0;
+	int32_t *stack = (int32_t *)alloca(sizeof(int32_t) * bvh.get_stack_size());
+	uint32_t stack_size = 0;
+	stack[stack_size++] = 0;
 
 	const Triangle *triangleptr = triangles.ptr();
 	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
+	const StaticBVH::Node *nodes = bvh.get_nodes().ptr();
+	const TrianglePacket *packets = triangle_packets.ptr();
 
 	Transform3D scale(Basis().scaled(p_scale));
 
-	int pos = bvh.size() - 1;
-
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
-
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				bool intersects = scale.xform(b.aabb).intersects_convex_shape(p_planes, p_plane_count, p_points, p_point_count);
-				if (!intersects) {
-					return false;
-				}
-
-				bool inside = scale.xform(b.aabb).inside_convex_shape(p_planes, p_plane_count);
-				if (inside) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						for (int j = 0; j < 3; ++j) {
-							Vector3 point = scale.xform(vertexptr[s.indices[j]]);
-							for (int i = 0; i < p_plane_count; i++) {
-								const Plane &p = p_planes[i];
-								if (p.is_point_over(point)) {
-									return false;
-								}
-							}
-						}
+	while (stack_size) {
+		const StaticBVH::Node &node = nodes[stack[--stack_size]];
+		for (uint32_t i = 0; i < node.child_count; i++) {
+			const Vector3 min = Vector3(node.min[0][i], node.min[1][i], node.min[2][i]);
+			const Vector3 max = Vector3(node.max[0][i], node.max[1][i], node.max[2][i]);
+			const AABB aabb = scale.xform(AABB(min, max - min));
 
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
+			if (!aabb.intersects_convex_shape(p_planes, p_plane_count, p_points, p_point_count)) {
+				return false;
 			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.left | TEST_AABB_BIT;
+			if (aabb.inside_convex_shape(p_planes, p_plane_count)) {
 				continue;
 			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				level++;
-				stack[level] = b.right | TEST_AABB_BIT;
+
+			if (node.children[i] >= 0) {
+				stack[stack_size++] = node.children[i];
 				continue;
 			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
+
+			const TrianglePacket &packet = packets[~node.children[i]];
+			for (int j = 0; j < StaticBVH::WIDTH; j++) {
+				if (packet.face_index[j] < 0) {
+					continue;
+				}
+				const Triangle &s = triangleptr[packet.face_index[j]];
+				for (int k = 0; k < 3; ++k) {
+					Vector3 point = scale.xform(vertexptr[s.indices[k]]);
+					for (int l = 0; l < p_plane_count; l++) {
+						const Plane &p = p_planes[l];
+						if (p.is_point_over(point)) {
+							return false;
+						}
+					}
 				}
-				continue;
 			}
 		}
-
-		if (done) {
-			break;
-		}
 	}
 
 	return true;
@@ -602,5 +450,4 @@ void TriangleMesh::_bind_methods() {
 
 TriangleMesh::TriangleMesh() {
 	valid = false;
-	max_depth = 0;
 }
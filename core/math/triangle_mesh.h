@@ -31,6 +31,7 @@
 #pragma once
 
 #include "core/math/face3.h"
+#include "core/math/static_bvh.h"
 #include "core/object/ref_counted.h"
 
 class TriangleMesh : public RefCounted {
@@ -43,6 +44,14 @@ public:
 		int32_t surface_index = 0;
 	};
 
+	struct RayResult {
+		Vector3 point;
+		Vector3 normal;
+		int32_t surface_index = 0;
+		int32_t face_index = -1;
+		bool hit = false;
+	};
+
 protected:
 	static void _bind_methods();
 
@@ -50,42 +59,45 @@ private:
 	Vector<Triangle> triangles;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		Vector3 center; //used for sorting
-		int left = -1;
-		int right = -1;
-
-		int32_t face_index = -1;
+	enum {
+		RAY_BATCH_PACKET_SIZE = 64,
 	};
 
-	struct BVHCmpX {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.x < p_right->center.x;
-		}
+	// The triangles of a BVH leaf, stored per axis so a ray can be tested against all of them at once.
+	// Unused lanes are degenerate and have a face index of -1.
+	struct TrianglePacket {
+		real_t v0[3][StaticBVH::WIDTH] = {};
+		real_t e1[3][StaticBVH::WIDTH] = {};
+		real_t e2[3][StaticBVH::WIDTH] = {};
+		int32_t face_index[StaticBVH::WIDTH] = { -1, -1, -1, -1 };
 	};
 
-	struct BVHCmpY {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.y < p_right->center.y;
-		}
-	};
-	struct BVHCmpZ {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.z < p_right->center.z;
-		}
-	};
+	StaticBVH bvh;
+	// One per BVH leaf.
+	LocalVector<TrianglePacket> triangle_packets;
+	bool valid = false;
 
-	int _create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int &max_alloc);
+	void _create_bvh();
 
-	Vector<BVH> bvh;
-	int max_depth = 0;
-	bool valid = false;
+	template <bool SEGMENT>
+	int32_t _intersect(const Vector3 &p_from, const Vector3 &p_rel, const Vector3 &p_n, real_t p_d, Vector3 &r_point) const;
+	bool _finish_intersection(int32_t p_face_index, const Vector3 &p_n, Vector3 &r_normal, int32_t *r_surf_index, int32_t *r_face_index) const;
+
+	struct RayBatch {
+		const Vector3 *from = nullptr;
+		const Vector3 *dir = nullptr;
+		RayResult *results = nullptr;
+		uint32_t count = 0;
+	};
+
+	void _intersect_ray_batch_packet(uint32_t p_index, const RayBatch *p_batch) const;
 
 public:
 	bool is_valid() const;
 	bool intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index = nullptr, int32_t *r_face_index = nullptr) const;
 	bool intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal, int32_t *r_surf_index = nullptr, int32_t *r_face_index = nullptr) const;
+	// Intersects many rays at once, splitting them in packets processed by the WorkerThreadPool.
+	void intersect_rays(const Vector3 *p_from, const Vector3 *p_dir, uint32_t p_count, RayResult *r_results, bool p_use_threads = true) const;
 	bool inside_convex_shape(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, Vector3 p_scale = Vector3(1, 1, 1)) const;
 	Vector<Face3> get_faces() const;
 
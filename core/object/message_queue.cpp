@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/object/class_db.h"
 #include "core/object/script_language.h"
+#include "core/object/worker_thread_pool.h"
 
 #include <cstdio>
 
@@ -58,13 +59,228 @@
 		mutex.unlock(); \
 	}
 
-void CallQueue::_add_page() {
-	if (pages_used == page_bytes.size()) {
-		pages.push_back(allocator->alloc());
-		page_bytes.push_back(0);
+uint8_t *CallQueue::_alloc_message(LocalVector<Page *> &r_pages, LocalVector<uint32_t> &r_page_bytes, uint32_t &r_pages_used, uint32_t p_room_needed) {
+	if (unlikely(r_pages.is_empty())) {
+		r_pages.push_back(allocator->alloc());
+		r_page_bytes.push_back(0);
+		r_pages_used = 1;
+	}
+
+	if ((r_page_bytes[r_pages_used - 1] + p_room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
+		if (r_pages_used == max_pages) {
+			return nullptr;
+		}
+		if (r_pages_used == r_page_bytes.size()) {
+			r_pages.push_back(allocator->alloc());
+			r_page_bytes.push_back(0);
+		}
+		r_page_bytes[r_pages_used] = 0;
+		r_pages_used++;
+	}
+
+	return &r_pages[r_pages_used - 1]->data[r_page_bytes[r_pages_used - 1]];
+}
+
+CallQueue::ThreadQueue *CallQueue::_get_thread_queue() {
+	if (this == MessageQueue::thread_singleton) {
+		return nullptr; // Thread singleton override, only used by this thread, no locking involved.
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	if (!pool) {
+		return nullptr;
+	}
+	int thread_index = pool->get_thread_index();
+	if (thread_index < 0) {
+		return nullptr;
+	}
+
+	uint32_t count = thread_queue_count.load(std::memory_order_acquire);
+	if (unlikely(count == 0)) {
+		// The pool threads are running, so their count is final.
+		MutexLock lock(mutex);
+		count = thread_queue_count.load(std::memory_order_relaxed);
+		if (count == 0) {
+			count = pool->get_thread_count();
+			thread_queues = memnew_arr(ThreadQueue, count);
+			thread_queue_count.store(count, std::memory_order_release);
+		}
+	}
+
+	return (uint32_t)thread_index < count ? &thread_queues[thread_index] : nullptr;
+}
+
+// Returns where to write a message, or nullptr if out of memory.
+// Either way, the queue is left locked until _end_push() is called.
+uint8_t *CallQueue::_begin_push(uint32_t p_room_needed, ThreadQueue *&r_thread_queue) {
+	r_thread_queue = _get_thread_queue();
+	if (r_thread_queue) {
+		r_thread_queue->mutex.lock();
+		return _alloc_message(r_thread_queue->pages, r_thread_queue->page_bytes, r_thread_queue->pages_used, p_room_needed);
+	}
+
+	LOCK_MUTEX;
+	// Messages pushed from pool threads before this one must go first.
+	_merge_thread_queues();
+	return _alloc_message(pages, page_bytes, pages_used, p_room_needed);
+}
+
+void CallQueue::_end_push(ThreadQueue *p_thread_queue, Message *p_message, uint32_t p_room_needed) {
+	if (p_thread_queue) {
+		if (p_message) {
+			p_message->order = push_order.postincrement();
+			p_thread_queue->page_bytes[p_thread_queue->pages_used - 1] += p_room_needed;
+			thread_queued_messages.increment();
+		}
+		p_thread_queue->mutex.unlock();
+		return;
+	}
+
+	if (p_message) {
+		_commit_message(p_message, p_room_needed);
+	}
+	UNLOCK_MUTEX;
+}
+
+// Must be called with the mutex locked, right after writing the message at the end of the last page.
+void CallQueue::_commit_message(Message *p_message, uint32_t p_room_needed) {
+	stats.pushed++;
+
+	if (coalesce_calls && (p_message->type & FLAG_MASK) == TYPE_CALL) {
+		Message **pending = pending_calls.getptr(p_message->callable);
+		if (!pending) {
+			pending_calls.insert(p_message->callable, p_message);
+		} else if ((*pending)->args == p_message->args) {
+			const Variant *args = (const Variant *)(p_message + 1);
+			const Variant *pending_args = (const Variant *)(*pending + 1);
+			bool identical = true;
+			for (int i = 0; i < p_message->args; i++) {
+				if (!args[i].hash_compare(pending_args[i])) {
+					identical = false;
+					break;
+				}
+			}
+			if (identical) {
+				stats.coalesced++;
+				_destroy_message(p_message);
+				return;
+			}
+		}
+	}
+
+	page_bytes[pages_used - 1] += p_room_needed;
+}
+
+// Must be called with the mutex locked.
+void CallQueue::_merge_thread_queues() {
+	if (likely(thread_queued_messages.get() == 0)) {
+		return;
+	}
+
+	// Lock all of them, so there are no pushes in progress and no message pushed after another can be merged before it.
+	uint32_t count = thread_queue_count.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < count; i++) {
+		thread_queues[i].mutex.lock();
+	}
+
+	struct Cursor {
+		uint32_t page = 0;
+		uint32_t offset = 0;
+	};
+	Cursor *cursors = (Cursor *)alloca(sizeof(Cursor) * count);
+	for (uint32_t i = 0; i < count; i++) {
+		cursors[i] = Cursor();
+	}
+
+	uint32_t merged = 0;
+	while (true) {
+		ThreadQueue *next_queue = nullptr;
+		Cursor *next_cursor = nullptr;
+		Message *next = nullptr;
+		for (uint32_t i = 0; i < count; i++) {
+			ThreadQueue &tq = thread_queues[i];
+			Cursor &cursor = cursors[i];
+			if (cursor.page == tq.pages_used || cursor.offset == tq.page_bytes[cursor.page]) {
+				continue;
+			}
+			Message *message = (Message *)&tq.pages[cursor.page]->data[cursor.offset];
+			// The order wraps around, compare the difference.
+			if (!next || int32_t(message->order - next->order) < 0) {
+				next_queue = &tq;
+				next_cursor = &cursor;
+				next = message;
+			}
+		}
+		if (!next) {
+			break;
+		}
+
+		uint32_t size = _get_message_size(next);
+		next_cursor->offset += size;
+		if (next_cursor->offset == next_queue->page_bytes[next_cursor->page]) {
+			next_cursor->page++;
+			next_cursor->offset = 0;
+		}
+		merged++;
+		stats.pushed_from_threads++;
+
+		uint8_t *buffer_end = _alloc_message(pages, page_bytes, pages_used, size);
+		if (unlikely(!buffer_end)) {
+			fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(next->callable).utf8().get_data(), error_text.utf8().get_data());
+			_destroy_message(next);
+			continue;
+		}
+		// Callables and Variants can be relocated.
+		memcpy(buffer_end, (void *)next, size);
+		_commit_message((Message *)buffer_end, size);
+	}
+
+	for (uint32_t i = 0; i < count; i++) {
+		ThreadQueue &tq = thread_queues[i];
+		if (tq.pages_used) {
+			tq.pages_used = 1;
+			tq.page_bytes[0] = 0;
+		}
+	}
+	thread_queued_messages.sub(merged);
+
+	for (uint32_t i = 0; i < count; i++) {
+		thread_queues[i].mutex.unlock();
+	}
+}
+
+void CallQueue::_clear_thread_queues() {
+	uint32_t count = thread_queue_count.load(std::memory_order_acquire);
+	for (uint32_t i = 0; i < count; i++) {
+		ThreadQueue &tq = thread_queues[i];
+		MutexLock lock(tq.mutex);
+		uint32_t cleared = 0;
+		for (uint32_t j = 0; j < tq.pages_used; j++) {
+			uint32_t offset = 0;
+			while (offset < tq.page_bytes[j]) {
+				Message *message = (Message *)&tq.pages[j]->data[offset];
+				offset += _get_message_size(message);
+				_destroy_message(message);
+				cleared++;
+			}
+		}
+		if (tq.pages_used) {
+			tq.pages_used = 1;
+			tq.page_bytes[0] = 0;
+		}
+		thread_queued_messages.sub(cleared);
 	}
-	page_bytes[pages_used] = 0;
-	pages_used++;
+}
+
+void CallQueue::_destroy_message(Message *p_message) {
+	if ((p_message->type & FLAG_MASK) != TYPE_NOTIFICATION) {
+		Variant *args = (Variant *)(p_message + 1);
+		for (int k = 0; k < p_message->args; k++) {
+			args[k].~Variant();
+		}
+	}
+
+	p_message->~Message();
 }
 
 Error CallQueue::push_callp(ObjectID p_id, const StringName &p_method, const Variant **p_args, int p_argcount, bool p_show_error) {
@@ -88,24 +304,15 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 
 	ERR_FAIL_COND_V_MSG(room_needed > uint32_t(PAGE_SIZE_BYTES), ERR_INVALID_PARAMETER, "Message is too large to fit on a page (" + itos(PAGE_SIZE_BYTES) + " bytes), consider passing less arguments.");
 
-	LOCK_MUTEX;
-
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(p_callable).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
-		}
-		_add_page();
+	ThreadQueue *thread_queue = nullptr;
+	uint8_t *buffer_end = _begin_push(room_needed, thread_queue);
+	if (!buffer_end) {
+		_end_push(thread_queue, nullptr, 0);
+		fprintf(stderr, "Failed method: %s. Message queue out of memory. %s\n", String(p_callable).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 	msg->args = p_argcount;
 	msg->callable = p_callable;
@@ -126,37 +333,27 @@ Error CallQueue::push_callablep(const Callable &p_callable, const Variant **p_ar
 		*v = *p_args[i];
 	}
 
-	page_bytes[pages_used - 1] += room_needed;
-
-	UNLOCK_MUTEX;
+	_end_push(thread_queue, msg, room_needed);
 
 	return OK;
 }
 
 Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant &p_value) {
-	LOCK_MUTEX;
 	uint32_t room_needed = sizeof(Message) + sizeof(Variant);
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			String type;
-			if (ObjectDB::get_instance(p_id)) {
-				type = ObjectDB::get_instance(p_id)->get_class();
-			}
-			fprintf(stderr, "Failed set: %s: %s target ID: %s. Message queue out of memory. %s\n", type.utf8().get_data(), String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
+	ThreadQueue *thread_queue = nullptr;
+	uint8_t *buffer_end = _begin_push(room_needed, thread_queue);
+	if (!buffer_end) {
+		_end_push(thread_queue, nullptr, 0);
+		String type;
+		if (ObjectDB::get_instance(p_id)) {
+			type = ObjectDB::get_instance(p_id)->get_class();
 		}
-		_add_page();
+		fprintf(stderr, "Failed set: %s: %s target ID: %s. Message queue out of memory. %s\n", type.utf8().get_data(), String(p_prop).utf8().get_data(), itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 	msg->args = 1;
 	msg->callable = Callable(p_id, p_prop);
@@ -167,32 +364,24 @@ Error CallQueue::push_set(ObjectID p_id, const StringName &p_prop, const Variant
 	Variant *v = memnew_placement(buffer_end, Variant);
 	*v = p_value;
 
-	page_bytes[pages_used - 1] += room_needed;
-	UNLOCK_MUTEX;
+	_end_push(thread_queue, msg, room_needed);
 
 	return OK;
 }
 
 Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	ERR_FAIL_COND_V(p_notification < 0, ERR_INVALID_PARAMETER);
-	LOCK_MUTEX;
 	uint32_t room_needed = sizeof(Message);
 
-	_ensure_first_page();
-
-	if ((page_bytes[pages_used - 1] + room_needed) > uint32_t(PAGE_SIZE_BYTES)) {
-		if (pages_used == max_pages) {
-			fprintf(stderr, "Failed notification: %d target ID: %s. Message queue out of memory. %s\n", p_notification, itos(p_id).utf8().get_data(), error_text.utf8().get_data());
-			statistics();
-			UNLOCK_MUTEX;
-			return ERR_OUT_OF_MEMORY;
-		}
-		_add_page();
+	ThreadQueue *thread_queue = nullptr;
+	uint8_t *buffer_end = _begin_push(room_needed, thread_queue);
+	if (!buffer_end) {
+		_end_push(thread_queue, nullptr, 0);
+		fprintf(stderr, "Failed notification: %d target ID: %s. Message queue out of memory. %s\n", p_notification, itos(p_id).utf8().get_data(), error_text.utf8().get_data());
+		statistics();
+		return ERR_OUT_OF_MEMORY;
 	}
 
-	Page *page = pages[pages_used - 1];
-	uint8_t *buffer_end = &page->data[page_bytes[pages_used - 1]];
-
 	Message *msg = memnew_placement(buffer_end, Message);
 
 	msg->type = TYPE_NOTIFICATION;
@@ -200,8 +389,7 @@ Error CallQueue::push_notification(ObjectID p_id, int p_notification) {
 	//msg->target;
 	msg->notification = p_notification;
 
-	page_bytes[pages_used - 1] += room_needed;
-	UNLOCK_MUTEX;
+	_end_push(thread_queue, msg, room_needed);
 
 	return OK;
 }
@@ -226,6 +414,8 @@ void CallQueue::_call_function(const Callable &p_callable, const Variant *p_args
 Error CallQueue::flush() {
 	LOCK_MUTEX;
 
+	_merge_thread_queues();
+
 	if (pages.is_empty()) {
 		// Never allocated
 		UNLOCK_MUTEX;
@@ -257,6 +447,14 @@ Error CallQueue::flush() {
 		//pre-advance so this function is reentrant
 		offset += advance;
 
+		if (coalesce_calls && (message->type & FLAG_MASK) == TYPE_CALL) {
+			// No longer pending, identical calls pushed from now on must run too.
+			HashMap<Callable, Message *>::Iterator E = pending_calls.find(message->callable);
+			if (E && E->value == message) {
+				pending_calls.remove(E);
+			}
+		}
+
 		Object *target = message->callable.get_object();
 
 		UNLOCK_MUTEX;
@@ -291,6 +489,8 @@ Error CallQueue::flush() {
 		message->~Message();
 
 		LOCK_MUTEX;
+		// Messages pushed from pool threads meanwhile are flushed too.
+		_merge_thread_queues();
 		if (offset == page_bytes[i]) {
 			i++;
 			offset = 0;
@@ -308,6 +508,9 @@ Error CallQueue::flush() {
 void CallQueue::clear() {
 	LOCK_MUTEX;
 
+	_clear_thread_queues();
+	pending_calls.clear();
+
 	if (pages.is_empty()) {
 		UNLOCK_MUTEX;
 		return; // Nothing to clear.
@@ -425,6 +628,7 @@ void CallQueue::statistics() {
 
 	fprintf(stdout, "TOTAL PAGES: %d (%d bytes).\n", pages_used, pages_used * PAGE_SIZE_BYTES);
 	fprintf(stdout, "NULL count: %d.\n", null_count);
+	fprintf(stdout, "PUSHED: %llu (%llu from pool threads, %llu coalesced).\n", (unsigned long long)stats.pushed, (unsigned long long)stats.pushed_from_threads, (unsigned long long)stats.coalesced);
 
 	for (const KeyValue<StringName, int> &E : set_count) {
 		fprintf(stdout, "SET %s: %d.\n", String(E.key).utf8().get_data(), E.value);
@@ -446,6 +650,9 @@ bool CallQueue::is_flushing() const {
 }
 
 bool CallQueue::has_messages() const {
+	if (thread_queued_messages.get() > 0) {
+		return true;
+	}
 	if (pages_used == 0) {
 		return false;
 	}
@@ -460,6 +667,31 @@ int CallQueue::get_max_buffer_usage() const {
 	return pages.size() * PAGE_SIZE_BYTES;
 }
 
+void CallQueue::set_coalesce_calls(bool p_enable) {
+	LOCK_MUTEX;
+	// Calls pushed before enabling it aren't tracked, so they are never coalesced.
+	coalesce_calls = p_enable;
+	pending_calls.clear();
+	UNLOCK_MUTEX;
+}
+
+bool CallQueue::is_coalescing_calls() const {
+	return coalesce_calls;
+}
+
+CallQueue::Stats CallQueue::get_stats() {
+	LOCK_MUTEX;
+	Stats ret = stats;
+	UNLOCK_MUTEX;
+	return ret;
+}
+
+void CallQueue::reset_stats() {
+	LOCK_MUTEX;
+	stats = Stats();
+	UNLOCK_MUTEX;
+}
+
 CallQueue::CallQueue(Allocator *p_custom_allocator, uint32_t p_max_pages, const String &p_error_text) {
 	if (p_custom_allocator) {
 		allocator = p_custom_allocator;
@@ -478,6 +710,14 @@ CallQueue::~CallQueue() {
 	for (uint32_t i = 0; i < pages.size(); i++) {
 		allocator->free(pages[i]);
 	}
+	for (uint32_t i = 0; i < thread_queue_count.load(); i++) {
+		for (Page *page : thread_queues[i].pages) {
+			allocator->free(page);
+		}
+	}
+	if (thread_queues) {
+		memdelete_arr(thread_queues);
+	}
 	if (!allocator_is_custom) {
 		memdelete(allocator);
 	}
@@ -32,8 +32,10 @@
 
 #include "core/object/object_id.h"
 #include "core/os/thread_safe.h"
+#include "core/templates/hash_map.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/paged_allocator.h"
+#include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 
 class Object;
@@ -54,6 +56,12 @@ public:
 	// Needs to lock because there can be multiple of these allocators in several threads.
 	typedef PagedAllocator<Page, true> Allocator;
 
+	struct Stats {
+		uint64_t pushed = 0; // Including coalesced calls.
+		uint64_t pushed_from_threads = 0; // Messages that went through the queue of a WorkerThreadPool thread.
+		uint64_t coalesced = 0; // Calls dropped because an identical one was pending.
+	};
+
 private:
 	enum {
 		TYPE_CALL,
@@ -87,17 +95,47 @@ private:
 			int16_t notification;
 			int16_t args;
 		};
+		uint32_t order; // Only used in thread queues, fits in the padding.
+	};
+
+	// WorkerThreadPool threads push to their own queue, so they don't contend for the mutex with each other.
+	// This includes the threads running threaded process groups, both for the main queue and the queue of
+	// their group, since pool tasks start without a thread singleton override.
+	// These queues are merged into the main one, in the order their messages were pushed in, when flushing
+	// and before any other push, so messages keep the order of the pushes that happened before each other.
+	// A queue set as the thread singleton override of a thread (such as by ResourceLoader) is only used by
+	// that thread, so it is pushed to directly instead.
+	struct ThreadQueue {
+		BinaryMutex mutex;
+		LocalVector<Page *> pages;
+		LocalVector<uint32_t> page_bytes;
+		uint32_t pages_used = 0;
 	};
 
-	_FORCE_INLINE_ void _ensure_first_page() {
-		if (unlikely(pages.is_empty())) {
-			pages.push_back(allocator->alloc());
-			page_bytes.push_back(0);
-			pages_used = 1;
+	ThreadQueue *thread_queues = nullptr;
+	std::atomic<uint32_t> thread_queue_count = { 0 };
+	SafeNumeric<uint32_t> thread_queued_messages;
+	SafeNumeric<uint32_t> push_order;
+
+	bool coalesce_calls = false;
+	HashMap<Callable, Message *> pending_calls;
+	Stats stats;
+
+	_FORCE_INLINE_ static uint32_t _get_message_size(const Message *p_message) {
+		if ((p_message->type & FLAG_MASK) == TYPE_NOTIFICATION) {
+			return sizeof(Message);
 		}
+		return sizeof(Message) + sizeof(Variant) * p_message->args;
 	}
 
-	void _add_page();
+	uint8_t *_alloc_message(LocalVector<Page *> &r_pages, LocalVector<uint32_t> &r_page_bytes, uint32_t &r_pages_used, uint32_t p_room_needed);
+	ThreadQueue *_get_thread_queue();
+	uint8_t *_begin_push(uint32_t p_room_needed, ThreadQueue *&r_thread_queue);
+	void _end_push(ThreadQueue *p_thread_queue, Message *p_message, uint32_t p_room_needed);
+	void _commit_message(Message *p_message, uint32_t p_room_needed);
+	void _merge_thread_queues();
+	void _clear_thread_queues();
+	static void _destroy_message(Message *p_message);
 
 	void _call_function(const Callable &p_callable, const Variant *p_args, int p_argcount, bool p_show_error);
 
@@ -143,6 +181,13 @@ public:
 	bool is_flushing() const;
 	int get_max_buffer_usage() const;
 
+	// When enabled, calls identical to one that is still pending (same callable and arguments) are dropped.
+	void set_coalesce_calls(bool p_enable);
+	bool is_coalescing_calls() const;
+
+	Stats get_stats();
+	void reset_stats();
+
 	CallQueue(Allocator *p_custom_allocator = nullptr, uint32_t p_max_pages = 8192, const String &p_error_text = String());
 	virtual ~CallQueue();
 };
@@ -38,6 +38,7 @@
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/string/translation_server.h"
+#include "core/templates/small_vector.h"
 #include "core/variant/typed_array.h"
 
 #ifdef DEBUG_ENABLED
@@ -1275,14 +1276,9 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		return ERR_CANT_ACQUIRE_RESOURCE; //no emit, signals blocked
 	}
 
-	constexpr int MAX_SLOTS_ON_STACK = 5;
-	// Don't default initialize the Callable objects on the stack, just reserve the space - we'll memnew_placement() them later.
-	alignas(Callable) uint8_t slot_callable_stack[sizeof(Callable) * MAX_SLOTS_ON_STACK];
-	uint32_t slot_flags_stack[MAX_SLOTS_ON_STACK];
-
-	Callable *slot_callables = (Callable *)slot_callable_stack;
-	uint32_t *slot_flags = slot_flags_stack;
-	uint32_t slot_count = 0;
+	// Shared with the signal data, disconnecting the signal or even deleting the object
+	// while emitting gives the signal data an array of its own.
+	Vector<SignalData::EmitSlot> slots;
 
 	{
 		OBJ_SIGNAL_LOCK
@@ -1298,32 +1294,31 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 			return ERR_UNAVAILABLE;
 		}
 
-		if (s->slot_map.size() > MAX_SLOTS_ON_STACK) {
-			slot_callables = (Callable *)memalloc(sizeof(Callable) * s->slot_map.size());
-			slot_flags = (uint32_t *)memalloc(sizeof(uint32_t) * s->slot_map.size());
-		}
-
-		// Ensure that disconnecting the signal or even deleting the object
-		// will not affect the signal calling.
-		for (const KeyValue<Callable, SignalData::Slot> &slot_kv : s->slot_map) {
-			memnew_placement(&slot_callables[slot_count], Callable(slot_kv.value.conn.callable));
-			slot_flags[slot_count] = slot_kv.value.conn.flags;
-			++slot_count;
+		if (unlikely(s->emit_slots_dirty)) {
+			// Dropped when the connections changed, so this doesn't modify an array emissions in progress may still use.
+			s->emit_slots.resize(s->slot_map.size());
+			SignalData::EmitSlot *w = s->emit_slots.ptrw();
+			for (const KeyValue<Callable, SignalData::Slot> &slot_kv : s->slot_map) {
+				w->callable = slot_kv.value.conn.callable;
+				w->flags = slot_kv.value.conn.flags;
+				w++;
+			}
+			s->emit_slots_dirty = false;
 		}
 
-		DEV_ASSERT(slot_count == s->slot_map.size());
+		slots = s->emit_slots;
 
 		// Disconnect all one-shot connections before emitting to prevent recursion.
-		for (uint32_t i = 0; i < slot_count; ++i) {
-			bool disconnect = slot_flags[i] & CONNECT_ONE_SHOT;
+		for (const SignalData::EmitSlot &slot : slots.span()) {
+			bool disconnect = slot.flags & CONNECT_ONE_SHOT;
 #ifdef TOOLS_ENABLED
-			if (disconnect && (slot_flags[i] & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
+			if (disconnect && (slot.flags & CONNECT_PERSIST) && Engine::get_singleton()->is_editor_hint()) {
 				// This signal was connected from the editor, and is being edited. Just don't disconnect for now.
 				disconnect = false;
 			}
 #endif
 			if (disconnect) {
-				_disconnect(p_name, slot_callables[i]);
+				_disconnect(p_name, slot.callable);
 			}
 		}
 	}
@@ -1339,12 +1334,12 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 
 	Error err = OK;
 
-	Vector<const Variant *> append_source_mem;
-	Variant source = this;
+	SmallVector<const Variant *, 8> append_source_mem;
+	Variant source;
 
-	for (uint32_t i = 0; i < slot_count; ++i) {
-		const Callable &callable = slot_callables[i];
-		const uint32_t &flags = slot_flags[i];
+	for (const SignalData::EmitSlot &slot : slots.span()) {
+		const Callable &callable = slot.callable;
+		const uint32_t &flags = slot.flags;
 
 		if (!callable.is_valid()) {
 			// Target might have been deleted during signal callback, this is expected and OK.
@@ -1359,8 +1354,11 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 			// Implemented by inserting before the first to-be-unbinded arg.
 			int source_index = p_argcount - callable.get_unbound_arguments_count();
 			if (source_index >= 0) {
+				if (source.get_type() == Variant::NIL) {
+					source = this;
+				}
 				append_source_mem.resize(p_argcount + 1);
-				const Variant **args_mem = append_source_mem.ptrw();
+				const Variant **args_mem = append_source_mem.ptr();
 
 				for (int j = 0; j < source_index; j++) {
 					args_mem[j] = p_args[j];
@@ -1409,14 +1407,8 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		}
 	}
 
-	for (uint32_t i = 0; i < slot_count; ++i) {
-		slot_callables[i].~Callable();
-	}
-
-	if (slot_callables != (Callable *)slot_callable_stack) {
-		memfree(slot_callables);
-		memfree(slot_flags);
-	}
+	// Release the callables before this object may be deleted below.
+	slots = Vector<SignalData::EmitSlot>();
 
 	if (pending_unref) {
 		// We have to do the same Ref<T> would do. We can't just use Ref<T>
@@ -1668,6 +1660,8 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 
 	//use callable version as key, so binds can be ignored
 	s->slot_map[*p_callable.get_base_comparator()] = slot;
+	s->emit_slots = Vector<SignalData::EmitSlot>();
+	s->emit_slots_dirty = true;
 
 	return OK;
 }
@@ -1748,6 +1742,10 @@ bool Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	}
 
 	s->slot_map.erase(*p_callable.get_base_comparator());
+	// Drop the array right away rather than on the next emission, which may never come,
+	// so it doesn't keep the disconnected callable (and what it binds) alive.
+	s->emit_slots = Vector<SignalData::EmitSlot>();
+	s->emit_slots_dirty = true;
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
@@ -2492,8 +2490,9 @@ void ObjectDB::debug_objects(DebugFunc p_func, void *p_user_data) {
 	spin_lock.lock();
 
 	for (uint32_t i = 0, count = slot_count; i < slot_max && count != 0; i++) {
-		if (object_slots[i].validator) {
-			p_func(object_slots[i].object, p_user_data);
+		ObjectSlot &object_slot = _get_slot(i);
+		if (object_slot.data.load(std::memory_order_relaxed) & OBJECTDB_VALIDATOR_MASK) {
+			p_func(object_slot.object.load(std::memory_order_relaxed), p_user_data);
 			count--;
 		}
 	}
@@ -2548,42 +2547,43 @@ void Object::get_argument_options(const StringName &p_function, int p_idx, List<
 
 SpinLock ObjectDB::spin_lock;
 uint32_t ObjectDB::slot_count = 0;
-uint32_t ObjectDB::slot_max = 0;
-ObjectDB::ObjectSlot *ObjectDB::object_slots = nullptr;
+std::atomic<uint32_t> ObjectDB::slot_max = 0;
+ObjectDB::ObjectSlot *ObjectDB::slot_blocks[1 << (OBJECTDB_SLOT_MAX_COUNT_BITS - OBJECTDB_SLOT_BLOCK_BITS)] = {};
 uint64_t ObjectDB::validator_counter = 0;
 
+#define OBJECTDB_NEXT_FREE_SHIFT OBJECTDB_VALIDATOR_BITS
+#define OBJECTDB_NEXT_FREE_MASK (OBJECTDB_SLOT_MAX_COUNT_MASK << OBJECTDB_NEXT_FREE_SHIFT)
+
 int ObjectDB::get_object_count() {
 	return slot_count;
 }
 
 ObjectID ObjectDB::add_instance(Object *p_object) {
 	spin_lock.lock();
-	if (unlikely(slot_count == slot_max)) {
+	uint32_t current_slot_max = slot_max.load(std::memory_order_relaxed);
+	if (unlikely(slot_count == current_slot_max)) {
 		CRASH_COND(slot_count == (1 << OBJECTDB_SLOT_MAX_COUNT_BITS));
 
-		uint32_t new_slot_max = slot_max > 0 ? slot_max * 2 : 1;
-		object_slots = (ObjectSlot *)memrealloc(object_slots, sizeof(ObjectSlot) * new_slot_max);
-		for (uint32_t i = slot_max; i < new_slot_max; i++) {
-			object_slots[i].object = nullptr;
-			object_slots[i].is_ref_counted = false;
-			object_slots[i].next_free = i;
-			object_slots[i].validator = 0;
+		// Add a block, the existing ones must stay where they are for lookups.
+		ObjectSlot *block = (ObjectSlot *)memalloc(sizeof(ObjectSlot) * OBJECTDB_SLOT_BLOCK_SIZE);
+		for (uint32_t i = 0; i < OBJECTDB_SLOT_BLOCK_SIZE; i++) {
+			memnew_placement(&block[i].data, std::atomic<uint64_t>(uint64_t(current_slot_max + i) << OBJECTDB_NEXT_FREE_SHIFT));
+			memnew_placement(&block[i].object, std::atomic<Object *>(nullptr));
 		}
-		slot_max = new_slot_max;
+		slot_blocks[current_slot_max >> OBJECTDB_SLOT_BLOCK_BITS] = block;
+		slot_max.store(current_slot_max + OBJECTDB_SLOT_BLOCK_SIZE, std::memory_order_release);
 	}
 
-	uint32_t slot = object_slots[slot_count].next_free;
-	if (object_slots[slot].object != nullptr) {
+	uint32_t slot = (_get_slot(slot_count).data.load(std::memory_order_relaxed) & OBJECTDB_NEXT_FREE_MASK) >> OBJECTDB_NEXT_FREE_SHIFT;
+	ObjectSlot &object_slot = _get_slot(slot);
+	if (object_slot.object.load(std::memory_order_relaxed) != nullptr) {
 		spin_lock.unlock();
-		ERR_FAIL_COND_V(object_slots[slot].object != nullptr, ObjectID());
+		ERR_FAIL_COND_V(object_slot.object.load(std::memory_order_relaxed) != nullptr, ObjectID());
 	}
-	object_slots[slot].object = p_object;
-	object_slots[slot].is_ref_counted = p_object->is_ref_counted();
 	validator_counter = (validator_counter + 1) & OBJECTDB_VALIDATOR_MASK;
 	if (unlikely(validator_counter == 0)) {
 		validator_counter = 1;
 	}
-	object_slots[slot].validator = validator_counter;
 
 	uint64_t id = validator_counter;
 	id <<= OBJECTDB_SLOT_MAX_COUNT_BITS;
@@ -2593,6 +2593,13 @@ ObjectID ObjectDB::add_instance(Object *p_object) {
 		id |= OBJECTDB_REFERENCE_BIT;
 	}
 
+	// The object must be set before the validator, lookups check the validator first.
+	object_slot.object.store(p_object, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	uint64_t data = object_slot.data.load(std::memory_order_relaxed) & OBJECTDB_NEXT_FREE_MASK;
+	data |= validator_counter | (id & OBJECTDB_REFERENCE_BIT);
+	object_slot.data.store(data, std::memory_order_release);
+
 	slot_count++;
 
 	spin_lock.unlock();
@@ -2606,29 +2613,36 @@ void ObjectDB::remove_instance(Object *p_object) {
 
 	spin_lock.lock();
 
+	ObjectSlot &object_slot = _get_slot(slot);
+
 #ifdef DEBUG_ENABLED
 
-	if (object_slots[slot].object != p_object) {
+	if (object_slot.object.load(std::memory_order_relaxed) != p_object) {
 		spin_lock.unlock();
-		ERR_FAIL_COND(object_slots[slot].object != p_object);
+		ERR_FAIL_COND(object_slot.object.load(std::memory_order_relaxed) != p_object);
 	}
 	{
 		uint64_t validator = (t >> OBJECTDB_SLOT_MAX_COUNT_BITS) & OBJECTDB_VALIDATOR_MASK;
-		if (object_slots[slot].validator != validator) {
+		if ((object_slot.data.load(std::memory_order_relaxed) & OBJECTDB_VALIDATOR_MASK) != validator) {
 			spin_lock.unlock();
-			ERR_FAIL_COND(object_slots[slot].validator != validator);
+			ERR_FAIL_COND((object_slot.data.load(std::memory_order_relaxed) & OBJECTDB_VALIDATOR_MASK) != validator);
 		}
 	}
 
 #endif
+	//invalidate, so checks against it fail
+	//the validator must be cleared before the object, lookups check it again after reading the object
+	object_slot.data.store(object_slot.data.load(std::memory_order_relaxed) & OBJECTDB_NEXT_FREE_MASK, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	object_slot.object.store(nullptr, std::memory_order_relaxed);
+
 	//decrease slot count
 	slot_count--;
 	//set the free slot properly
-	object_slots[slot_count].next_free = slot;
-	//invalidate, so checks against it fail
-	object_slots[slot].validator = 0;
-	object_slots[slot].is_ref_counted = false;
-	object_slots[slot].object = nullptr;
+	// That slot may be in use, this store then publishes its validator again and must be ordered after its object too.
+	ObjectSlot &free_slot = _get_slot(slot_count);
+	uint64_t free_data = free_slot.data.load(std::memory_order_relaxed) & ~OBJECTDB_NEXT_FREE_MASK;
+	free_slot.data.store(free_data | (uint64_t(slot) << OBJECTDB_NEXT_FREE_SHIFT), std::memory_order_release);
 
 	spin_lock.unlock();
 }
@@ -2651,8 +2665,9 @@ void ObjectDB::cleanup() {
 			Callable::CallError call_error;
 
 			for (uint32_t i = 0, count = slot_count; i < slot_max && count != 0; i++) {
-				if (object_slots[i].validator) {
-					Object *obj = object_slots[i].object;
+				uint64_t data = _get_slot(i).data.load(std::memory_order_relaxed);
+				if (data & OBJECTDB_VALIDATOR_MASK) {
+					Object *obj = _get_slot(i).object.load(std::memory_order_relaxed);
 
 					String extra_info;
 					if (obj->is_class("Node")) {
@@ -2665,7 +2680,7 @@ void ObjectDB::cleanup() {
 						extra_info = " - Reference count: " + itos((static_cast<RefCounted *>(obj))->get_reference_count());
 					}
 
-					uint64_t id = uint64_t(i) | (uint64_t(object_slots[i].validator) << OBJECTDB_SLOT_MAX_COUNT_BITS) | (object_slots[i].is_ref_counted ? OBJECTDB_REFERENCE_BIT : 0);
+					uint64_t id = uint64_t(i) | ((data & OBJECTDB_VALIDATOR_MASK) << OBJECTDB_SLOT_MAX_COUNT_BITS) | (data & OBJECTDB_REFERENCE_BIT);
 					DEV_ASSERT(id == (uint64_t)obj->get_instance_id()); // We could just use the id from the object, but this check may help catching memory corruption catastrophes.
 					print_line("Leaked instance: " + String(obj->get_class()) + ":" + uitos(id) + extra_info);
 
@@ -2676,9 +2691,11 @@ void ObjectDB::cleanup() {
 		}
 	}
 
-	if (object_slots) {
-		memfree(object_slots);
+	for (uint32_t i = 0; i < slot_max; i += OBJECTDB_SLOT_BLOCK_SIZE) {
+		memfree(slot_blocks[i >> OBJECTDB_SLOT_BLOCK_BITS]);
+		slot_blocks[i >> OBJECTDB_SLOT_BLOCK_BITS] = nullptr;
 	}
+	slot_max.store(0);
 
 	spin_lock.unlock();
 }
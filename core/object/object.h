@@ -634,8 +634,18 @@ private:
 			List<Connection>::Element *cE = nullptr;
 		};
 
+		// What emissions need from each connection. Copied into an array that emissions share,
+		// so they don't have to copy every callable. Dropped when connections change and rebuilt
+		// on the next emission.
+		struct EmitSlot {
+			Callable callable;
+			uint32_t flags = 0;
+		};
+
 		MethodInfo user;
 		HashMap<Callable, Slot> slot_map;
+		Vector<EmitSlot> emit_slots;
+		bool emit_slots_dirty = true;
 		bool removable = false;
 	};
 	friend struct _ObjectSignalLock;
@@ -1082,20 +1092,29 @@ class ObjectDB {
 #define OBJECTDB_SLOT_MAX_COUNT_BITS 24
 #define OBJECTDB_SLOT_MAX_COUNT_MASK ((uint64_t(1) << OBJECTDB_SLOT_MAX_COUNT_BITS) - 1)
 #define OBJECTDB_REFERENCE_BIT (uint64_t(1) << (OBJECTDB_SLOT_MAX_COUNT_BITS + OBJECTDB_VALIDATOR_BITS))
+#define OBJECTDB_SLOT_BLOCK_BITS 12
+#define OBJECTDB_SLOT_BLOCK_SIZE (1 << OBJECTDB_SLOT_BLOCK_BITS)
+#define OBJECTDB_SLOT_BLOCK_MASK (OBJECTDB_SLOT_BLOCK_SIZE - 1)
 
 	struct ObjectSlot { // 128 bits per slot.
-		uint64_t validator : OBJECTDB_VALIDATOR_BITS;
-		uint64_t next_free : OBJECTDB_SLOT_MAX_COUNT_BITS;
-		uint64_t is_ref_counted : 1;
-		Object *object = nullptr;
+		// Same layout as the ID: validator, then the next free slot (instead of the slot), then whether it's ref counted.
+		std::atomic<uint64_t> data;
+		std::atomic<Object *> object;
 	};
 
+	// Adding and removing instances is done with the lock, lookups are lock-free.
+	// Slots are allocated in blocks that never move, and lookups check the validator
+	// both before and after reading the object, so a slot reused meanwhile is noticed.
 	static SpinLock spin_lock;
 	static uint32_t slot_count;
-	static uint32_t slot_max;
-	static ObjectSlot *object_slots;
+	static std::atomic<uint32_t> slot_max;
+	static ObjectSlot *slot_blocks[1 << (OBJECTDB_SLOT_MAX_COUNT_BITS - OBJECTDB_SLOT_BLOCK_BITS)];
 	static uint64_t validator_counter;
 
+	_ALWAYS_INLINE_ static ObjectSlot &_get_slot(uint32_t p_slot) {
+		return slot_blocks[p_slot >> OBJECTDB_SLOT_BLOCK_BITS][p_slot & OBJECTDB_SLOT_BLOCK_MASK];
+	}
+
 	friend class Object;
 	friend void unregister_core_types();
 	static void cleanup();
@@ -1112,21 +1131,26 @@ public:
 	_ALWAYS_INLINE_ static Object *get_instance(ObjectID p_instance_id) {
 		uint64_t id = p_instance_id;
 		uint32_t slot = id & OBJECTDB_SLOT_MAX_COUNT_MASK;
+		uint64_t validator = (id >> OBJECTDB_SLOT_MAX_COUNT_BITS) & OBJECTDB_VALIDATOR_MASK;
 
-		ERR_FAIL_COND_V(slot >= slot_max, nullptr); // This should never happen unless RID is corrupted.
+		if (unlikely(validator == 0)) {
+			return nullptr; // Null ID, free slots have a zero validator.
+		}
 
-		spin_lock.lock();
+		ERR_FAIL_COND_V(slot >= slot_max.load(std::memory_order_acquire), nullptr); // This should never happen unless RID is corrupted.
 
-		uint64_t validator = (id >> OBJECTDB_SLOT_MAX_COUNT_BITS) & OBJECTDB_VALIDATOR_MASK;
+		ObjectSlot &object_slot = _get_slot(slot);
 
-		if (unlikely(object_slots[slot].validator != validator)) {
-			spin_lock.unlock();
+		if (unlikely((object_slot.data.load(std::memory_order_acquire) & OBJECTDB_VALIDATOR_MASK) != validator)) {
 			return nullptr;
 		}
 
-		Object *object = object_slots[slot].object;
+		Object *object = object_slot.object.load(std::memory_order_relaxed);
 
-		spin_lock.unlock();
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (unlikely((object_slot.data.load(std::memory_order_relaxed) & OBJECTDB_VALIDATOR_MASK) != validator)) {
+			return nullptr; // Removed while reading it.
+		}
 
 		return object;
 	}
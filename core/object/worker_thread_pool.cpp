@@ -53,6 +53,82 @@ WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
 thread_local WorkerThreadPool::UnlockableLocks WorkerThreadPool::unlockable_locks[MAX_UNLOCKABLE_LOCKS];
 #endif
 
+void WorkerThreadPool::TaskDeque::push(Task *p_task) {
+	MutexLock lock(mutex);
+	tasks.add_last(&p_task->task_elem);
+	count.increment();
+}
+
+// If p_before is given, it's only read once the queue is locked, so a task queued after an older one
+// was added to task_queue by the same thread is never seen without that one.
+WorkerThreadPool::Task *WorkerThreadPool::TaskDeque::pop_oldest(const std::atomic<uint64_t> *p_before) {
+	if (count.get() == 0) {
+		return nullptr;
+	}
+	MutexLock lock(mutex);
+	if (!tasks.first()) {
+		return nullptr;
+	}
+	Task *task = tasks.first()->self();
+	if (p_before && task->sequence >= p_before->load()) {
+		return nullptr;
+	}
+	tasks.remove(tasks.first());
+	count.decrement();
+	return task;
+}
+
+WorkerThreadPool::Task *WorkerThreadPool::_pop_queued_task(ThreadData *p_thread_data, const std::atomic<uint64_t> *p_before) {
+	if (queued_task_count.get() == 0) {
+		return nullptr;
+	}
+
+	// Tasks are taken in order from the thread's own queue, otherwise stolen from another thread.
+	Task *task = p_thread_data->queued_tasks.pop_oldest(p_before);
+
+	uint32_t thread_count = threads.size();
+	for (uint32_t i = 1; !task && i < thread_count; i++) {
+		task = threads[(p_thread_data->index + i) % thread_count].queued_tasks.pop_oldest(p_before);
+	}
+
+	if (task) {
+		queued_task_count.decrement();
+	}
+	return task;
+}
+
+// Spreads high priority group tasks over the per-thread queues, starting with the one at p_queue_index.
+// This doesn't need the task mutex, but doesn't notify threads either.
+void WorkerThreadPool::_push_group_tasks(Task **p_tasks, uint32_t p_count, uint32_t p_queue_index, uint32_t p_queue_count) {
+	uint64_t sequence = next_sequence.postadd(p_count);
+	// Counted before pushing, so threads checking the count never miss a pushed task.
+	queued_task_count.add(p_count);
+
+	uint32_t queue_idx = p_queue_index;
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_tasks[i]->sequence = sequence + i;
+		threads[queue_idx].queued_tasks.push(p_tasks[i]);
+		queue_idx = (queue_idx + 1) % p_queue_count;
+	}
+}
+
+// Must be called with the task mutex held.
+void WorkerThreadPool::_add_to_task_queue(Task *p_task) {
+	p_task->sequence = next_sequence.postincrement();
+	task_queue.add_last(&p_task->task_elem);
+	if (task_queue.first() == &p_task->task_elem) {
+		task_queue_first_sequence.store(p_task->sequence);
+	}
+}
+
+// Must be called with the task mutex held and task_queue not empty.
+WorkerThreadPool::Task *WorkerThreadPool::_take_from_task_queue() {
+	Task *task = task_queue.first()->self();
+	task_queue.remove(task_queue.first());
+	task_queue_first_sequence.store(task_queue.first() ? task_queue.first()->self()->sequence : UINT64_MAX);
+	return task;
+}
+
 void WorkerThreadPool::_process_task(Task *p_task) {
 #ifdef THREADS_ENABLED
 	int pool_thread_index = thread_ids[Thread::get_caller_id()];
@@ -73,20 +149,30 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		// about to be run uses scripting, guarantees are held.
 		ScriptServer::thread_enter();
 
-		task_mutex.lock();
-		p_task->pool_thread_index = pool_thread_index;
-		prev_task = curr_thread.current_task;
-		curr_thread.current_task = p_task;
-		curr_thread.has_pump_task = p_task->is_pump_task;
-		if (p_task->pending_notify_yield_over) {
-			curr_thread.yield_is_over = true;
+		if (p_task->group) {
+			// Group tasks can't be awaited nor notified individually, so there's no need to sync with other threads
+			// to start or finish one (see _notify_threads() about reading it as the current task).
+			// The thread flags are left alone, since they share storage with the ones written under the lock.
+			p_task->pool_thread_index = pool_thread_index;
+			prev_task = curr_thread.current_task;
+			curr_thread.current_task = p_task;
+		} else {
+			task_mutex.lock();
+			p_task->pool_thread_index = pool_thread_index;
+			prev_task = curr_thread.current_task;
+			curr_thread.current_task = p_task;
+			curr_thread.has_pump_task = p_task->is_pump_task;
+			if (p_task->pending_notify_yield_over) {
+				curr_thread.yield_is_over = true;
+			}
+			task_mutex.unlock();
 		}
-		task_mutex.unlock();
 	}
 #endif
 
 #ifdef THREADS_ENABLED
 	bool low_priority = p_task->low_priority;
+	bool locked = true;
 #endif
 
 	if (p_task->group) {
@@ -122,20 +208,38 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		if (do_post) {
 			p_task->group->done_semaphore.post();
 			p_task->group->completed.set_to(true);
+
+			// Dependents flag the group before checking it isn't completed (see _add_task_dependencies()),
+			// so either they see it completed or they are seen here.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (p_task->group->has_dependents.is_set()) {
+				MutexLock task_lock(task_mutex);
+				_release_dependents(p_task->group->dependents);
+			}
 		}
 		uint32_t max_users = p_task->group->tasks_used + 1; // Add 1 because the thread waiting for it is also user. Read before to avoid another thread freeing task after increment.
 		uint32_t finished_users = p_task->group->finished.increment();
 
 		if (finished_users == max_users) {
 			// Get rid of the group, because nobody else is using it.
-			MutexLock task_lock(task_mutex);
 			group_allocator.free(p_task->group);
 		}
 
-		// For groups, tasks get rid of themselves.
+#ifdef THREADS_ENABLED
+		// Replaced before the task is freed, so other threads don't find it as the current task after that.
+		curr_thread.current_task = prev_task;
+#endif
 
-		task_mutex.lock();
+		// For groups, tasks get rid of themselves.
 		task_allocator.free(p_task);
+
+#ifdef THREADS_ENABLED
+		// The lock is only needed to give back the low priority slot.
+		locked = low_priority;
+		if (low_priority) {
+			task_mutex.lock();
+		}
+#endif
 	} else {
 		if (p_task->native_func) {
 			p_task->native_func(p_task->native_func_userdata);
@@ -152,6 +256,7 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		if (p_task->waiting_user) {
 			p_task->done_semaphore.post(p_task->waiting_user);
 		}
+		_release_dependents(p_task->dependents);
 		// Let awaiters know.
 		for (uint32_t i = 0; i < threads.size(); i++) {
 			if (threads[i].awaited_task == p_task) {
@@ -174,7 +279,9 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 			}
 		}
 
-		task_mutex.unlock();
+		if (locked) {
+			task_mutex.unlock();
+		}
 	}
 
 	set_current_thread_safe_for_nodes(safe_for_nodes_backup);
@@ -187,8 +294,9 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 	Thread::set_name(vformat("WorkerThread %d", thread_data->index));
 
 	while (true) {
-		Task *task_to_process = nullptr;
-		{
+		// Per-thread queues can be checked without the pool lock.
+		Task *task_to_process = thread_data->pool->_pop_queued_task(thread_data, &thread_data->pool->task_queue_first_sequence);
+		if (!task_to_process) {
 			// Create the lock outside the inner loop so it isn't needlessly unlocked and relocked
 			//  when no task was found to process, and the loop is re-entered.
 			MutexLock lock(thread_data->pool->task_mutex);
@@ -201,17 +309,27 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 
 				thread_data->signaled = false;
 
-				if (!thread_data->pool->task_queue.first()) {
-					// There wasn't a task available yet.
-					// Let's wait for the next notification, then recheck.
-					thread_data->cond_var.wait(lock);
-					continue;
+				// Counted as waiting before checking the per-thread queues, which get tasks without the lock:
+				// either they are found below, or their pusher sees this thread may wait and notifies.
+				thread_data->pool->waiting_thread_count.increment();
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+
+				// Whichever task was queued first, from the per-thread queues or the shared one.
+				task_to_process = thread_data->pool->_pop_queued_task(thread_data, &thread_data->pool->task_queue_first_sequence);
+				if (!task_to_process && thread_data->pool->task_queue.first()) {
+					task_to_process = thread_data->pool->_take_from_task_queue();
 				}
 
-				// Got a task to process! Remove it from the queue, then break into the task handling section.
-				task_to_process = thread_data->pool->task_queue.first()->self();
-				thread_data->pool->task_queue.remove(thread_data->pool->task_queue.first());
-				break;
+				if (task_to_process) {
+					// Got a task to process! Break into the task handling section.
+					thread_data->pool->waiting_thread_count.decrement();
+					break;
+				}
+
+				// There wasn't a task available yet.
+				// Let's wait for the next notification, then recheck.
+				thread_data->cond_var.wait(lock);
+				thread_data->pool->waiting_thread_count.decrement();
 			}
 		}
 
@@ -240,16 +358,33 @@ void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high
 		control_cond_var.wait(p_lock);
 	}
 
+	for (uint32_t i = 0; i < p_count; i++) {
+		p_tasks[i]->low_priority = !p_high_priority;
+	}
+	_queue_tasks(p_tasks, p_count);
+}
+
+// Must be called with the task mutex held. The priority of each task is taken from its low_priority flag.
+void WorkerThreadPool::_queue_tasks(Task **p_tasks, uint32_t p_count) {
 	uint32_t to_process = 0;
 	uint32_t to_promote = 0;
 
 	ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
 
+	// High priority group tasks are spread over the per-thread queues, starting with the caller's, so they can
+	// be taken without contending for the pool lock. Tasks with an ID stay in the shared queue, so the rule
+	// about awaiting older tasks keeps holding. Sequence numbers keep the order between both kinds.
+	uint32_t queue_idx = caller_pool_thread ? caller_pool_thread->index : queue_index;
+
 	for (uint32_t i = 0; i < p_count; i++) {
-		p_tasks[i]->low_priority = !p_high_priority;
-		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
-			task_queue.add_last(&p_tasks[i]->task_elem);
-			if (!p_high_priority) {
+		bool high_priority = !p_tasks[i]->low_priority;
+		if (high_priority && p_tasks[i]->group) {
+			_push_group_tasks(&p_tasks[i], 1, queue_idx, threads.size());
+			queue_idx = (queue_idx + 1) % threads.size();
+			to_process++;
+		} else if (high_priority || low_priority_threads_used < max_low_priority_threads) {
+			_add_to_task_queue(p_tasks[i]);
+			if (!high_priority) {
 				low_priority_threads_used++;
 			}
 			to_process++;
@@ -260,9 +395,65 @@ void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high
 		}
 	}
 
+	if (!caller_pool_thread) {
+		queue_index = queue_idx;
+	}
+
 	_notify_threads(caller_pool_thread, to_process, to_promote);
 }
 
+// Must be called with the task mutex held. Returns whether the task has to wait for any of the dependencies.
+bool WorkerThreadPool::_add_task_dependencies(Task *p_task, TaskID p_id, Span<TaskID> p_dependencies) {
+	for (const TaskID &dependency : p_dependencies) {
+		// IDs are never reused, so a past ID that's no longer around belongs to something already awaited.
+		ERR_CONTINUE_MSG(dependency < 0 || dependency >= p_id, "Invalid Task or Group ID. Dependencies must have been added before.");
+		if (Task **taskp = tasks.getptr(dependency)) {
+			if (!(*taskp)->completed) {
+				(*taskp)->dependents.push_back(p_task);
+				p_task->pending_dependencies++;
+			}
+		} else if (Group **groupp = groups.getptr(dependency)) {
+			// Flagged before checking, since groups complete without the lock (see _process_task()).
+			(*groupp)->has_dependents.set();
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (!(*groupp)->completed.is_set()) {
+				(*groupp)->dependents.push_back(p_task);
+				p_task->pending_dependencies++;
+			}
+		}
+	}
+	return p_task->pending_dependencies > 0;
+}
+
+// Must be called with the task mutex held.
+void WorkerThreadPool::_release_dependents(LocalVector<Task *> &p_dependents) {
+	if (p_dependents.is_empty()) {
+		return;
+	}
+
+	Task **ready = (Task **)alloca(sizeof(Task *) * p_dependents.size());
+	uint32_t ready_count = 0;
+	for (Task *dependent : p_dependents) {
+		dependent->pending_dependencies--;
+		if (dependent->pending_dependencies == 0) {
+			ready[ready_count++] = dependent;
+		}
+	}
+	p_dependents.clear();
+
+	if (unlikely(threads.is_empty())) {
+		// No worker threads, so process them on the calling thread, as _post_tasks() does.
+		task_mutex.unlock();
+		for (uint32_t i = 0; i < ready_count; i++) {
+			_process_task(ready[i]);
+		}
+		task_mutex.lock();
+		return;
+	}
+
+	_queue_tasks(ready, ready_count);
+}
+
 void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count) {
 	uint32_t to_process = p_process_count;
 	uint32_t to_promote = p_promote_count;
@@ -287,9 +478,13 @@ void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data,
 		if (th.signaled) {
 			continue;
 		}
-		if (th.current_task) {
+		// Group tasks are set and replaced as the current task without the lock, and freed right after,
+		// so the current task is only dereferenced for threads awaiting with the lock released: those can't
+		// finish the task they are running until they take the lock back.
+		Task *current_task = th.current_task;
+		if (current_task) {
 			// Good thread for promoting low-prio?
-			if (to_promote && th.awaited_task && th.current_task->low_priority) {
+			if (to_promote && th.awaited_task && current_task->low_priority) {
 				if (likely(&th != p_current_thread_data)) {
 					th.cond_var.notify_one();
 				}
@@ -331,7 +526,7 @@ bool WorkerThreadPool::_try_promote_low_priority_task() {
 	if (low_priority_task_queue.first()) {
 		Task *low_prio_task = low_priority_task_queue.first()->self();
 		low_priority_task_queue.remove(low_priority_task_queue.first());
-		task_queue.add_last(&low_prio_task->task_elem);
+		_add_to_task_queue(low_prio_task);
 		low_priority_threads_used++;
 		return true;
 	} else {
@@ -343,7 +538,7 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
 
-WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, bool p_pump_task) {
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, bool p_pump_task, Span<TaskID> p_dependencies) {
 	MutexLock<BinaryMutex> lock(task_mutex);
 
 	// Get a free task
@@ -358,6 +553,12 @@ WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable,
 	task->is_pump_task = p_pump_task;
 	tasks.insert(id, task);
 
+	if (_add_task_dependencies(task, id, p_dependencies)) {
+		// It will be queued by the last dependency to complete.
+		task->low_priority = !p_high_priority;
+		return id;
+	}
+
 #ifdef THREADS_ENABLED
 	if (p_pump_task) {
 		pump_task_count++;
@@ -389,6 +590,18 @@ WorkerThreadPool::TaskID WorkerThreadPool::add_task_bind(const Callable &p_actio
 	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description, false);
 }
 
+WorkerThreadPool::TaskID WorkerThreadPool::add_native_task_with_dependencies(void (*p_func)(void *), void *p_userdata, Span<TaskID> p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description, false, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::add_task_with_dependencies(const Callable &p_action, Span<TaskID> p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description, false, p_dependencies);
+}
+
+WorkerThreadPool::TaskID WorkerThreadPool::_add_task_with_dependencies_bind(const Callable &p_action, const PackedInt64Array &p_dependencies, bool p_high_priority, const String &p_description) {
+	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description, false, p_dependencies);
+}
+
 bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
 	MutexLock task_lock(task_mutex);
 	const Task *const *taskp = tasks.getptr(p_task_id);
@@ -418,7 +631,7 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 	}
 
 	ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
-	if (caller_pool_thread && p_task_id <= caller_pool_thread->current_task->self) {
+	if (caller_pool_thread && p_task_id <= caller_pool_thread->current_task.load()->self) {
 		// Deadlock prevention:
 		// When a pool thread wants to wait for an older task, the following situations can happen:
 		// 1. Awaited task is deep in the stack of the awaiter.
@@ -487,6 +700,8 @@ void WorkerThreadPool::_unlock_unlockable_mutexes() {
 void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, Task *p_task) {
 	// Keep processing tasks until the condition to stop waiting is met.
 
+	Task *current_task = p_caller_pool_thread->current_task;
+
 	while (true) {
 		Task *task_to_process = nullptr;
 		bool relock_unlockables = false;
@@ -517,8 +732,8 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				if (was_signaled) {
 					// This thread was awaken for some additional reason, but it's about to exit.
 					// Let's find out what may be pending and forward the requests.
-					uint32_t to_process = task_queue.first() ? 1 : 0;
-					uint32_t to_promote = p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
+					uint32_t to_process = (task_queue.first() || queued_task_count.get()) ? 1 : 0;
+					uint32_t to_promote = current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
 					if (to_process || to_promote) {
 						// This thread must be left alone since it won't loop again.
 						p_caller_pool_thread->signaled = true;
@@ -529,19 +744,24 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 				break;
 			}
 
-			if (p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first()) {
+			if (current_task->low_priority && low_priority_task_queue.first()) {
 				if (_try_promote_low_priority_task()) {
 					_notify_threads(p_caller_pool_thread, 1, 0);
 				}
 			}
 
-			if (p_caller_pool_thread->pool->task_queue.first()) {
-				task_to_process = task_queue.first()->self();
-				if ((p_task == ThreadData::YIELDING || p_caller_pool_thread->has_pump_task == true) && task_to_process->is_pump_task) {
-					task_to_process = nullptr;
+			// See _thread_function() about counting as waiting before checking the per-thread queues.
+			waiting_thread_count.increment();
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			task_to_process = _pop_queued_task(p_caller_pool_thread, &task_queue_first_sequence);
+			if (!task_to_process && task_queue.first()) {
+				if ((p_task == ThreadData::YIELDING || p_caller_pool_thread->has_pump_task == true) && task_queue.first()->self()->is_pump_task) {
 					_notify_threads(p_caller_pool_thread, 1, 0);
+					// Per-thread queues never hold pump tasks, so any of them can be taken instead.
+					task_to_process = _pop_queued_task(p_caller_pool_thread, nullptr);
 				} else {
-					task_queue.remove(task_queue.first());
+					task_to_process = _take_from_task_queue();
 				}
 			}
 
@@ -557,6 +777,7 @@ void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, T
 
 				p_caller_pool_thread->awaited_task = nullptr;
 			}
+			waiting_thread_count.decrement();
 		}
 
 		if (relock_unlockables && this == singleton) {
@@ -588,7 +809,7 @@ bool WorkerThreadPool::_handle_runlevel(ThreadData *p_thread_data, MutexLock<Bin
 		} break;
 		case RUNLEVEL_PRE_EXIT_LANGUAGES: {
 			if (!p_thread_data->pre_exited_languages) {
-				if (!task_queue.first() && !low_priority_task_queue.first()) {
+				if (!task_queue.first() && !low_priority_task_queue.first() && queued_task_count.get() == 0) {
 					p_thread_data->pre_exited_languages = true;
 					runlevel_data.pre_exit_languages.num_idle_threads++;
 					control_cond_var.notify_all();
@@ -651,18 +872,15 @@ void WorkerThreadPool::notify_yield_over(TaskID p_task_id) {
 	td.cond_var.notify_one();
 }
 
-WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description) {
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, Span<TaskID> p_dependencies) {
 	ERR_FAIL_COND_V(p_elements < 0, INVALID_TASK_ID);
 	if (p_tasks < 0) {
 		p_tasks = MAX(1u, threads.size());
 	}
 
-	MutexLock<BinaryMutex> lock(task_mutex);
-
+	// The allocators are thread-safe, so the lock is only taken to register the group.
 	Group *group = group_allocator.alloc();
-	GroupID id = last_task++;
 	group->max = p_elements;
-	group->self = id;
 
 	Task **tasks_posted = nullptr;
 	if (p_elements == 0) {
@@ -691,9 +909,58 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 		}
 	}
 
-	groups[id] = group;
+	GroupID id;
+	ThreadData *caller_pool_thread = nullptr;
+	uint32_t queue_idx = 0;
+	uint32_t queue_count = 0;
+	{
+		MutexLock<BinaryMutex> lock(task_mutex);
 
-	_post_tasks(tasks_posted, p_tasks, p_high_priority, lock, false);
+		id = last_task++;
+		group->self = id;
+
+		if (p_tasks > 0 && !p_dependencies.is_empty()) {
+			// Every task of the group waits for the dependencies on its own, but they are all released at once.
+			bool pending = false;
+			for (int i = 0; i < p_tasks; i++) {
+				pending = _add_task_dependencies(tasks_posted[i], id, p_dependencies);
+				tasks_posted[i]->low_priority = !p_high_priority;
+			}
+			if (pending) {
+				p_tasks = 0;
+			}
+		}
+
+		groups[id] = group;
+
+		if (p_high_priority && !threads.is_empty() && runlevel != RUNLEVEL_EXIT_LANGUAGES) {
+			// Pushed to the per-thread queues below, once the lock is released.
+			caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
+			queue_count = threads.size();
+			queue_idx = caller_pool_thread ? caller_pool_thread->index : queue_index;
+			if (!caller_pool_thread) {
+				queue_index = (queue_index + p_tasks) % queue_count;
+			}
+		} else {
+			_post_tasks(tasks_posted, p_tasks, p_high_priority, lock, false);
+			p_tasks = 0;
+		}
+	}
+
+	if (p_tasks > 0) {
+		for (int i = 0; i < p_tasks; i++) {
+			tasks_posted[i]->low_priority = false;
+		}
+		_push_group_tasks(tasks_posted, p_tasks, queue_idx, queue_count);
+
+		// Threads count themselves as waiting before checking the per-thread queues (see _thread_function()),
+		// so if none is found waiting now, all of them will see the tasks just pushed.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (waiting_thread_count.get() > 0) {
+			MutexLock<BinaryMutex> lock(task_mutex);
+			_notify_threads(caller_pool_thread, p_tasks, 0);
+		}
+	}
 
 	return id;
 }
@@ -706,6 +973,18 @@ WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_act
 	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description);
 }
 
+WorkerThreadPool::GroupID WorkerThreadPool::add_native_group_task_with_dependencies(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, Span<TaskID> p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(Callable(), p_func, p_userdata, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::add_group_task_with_dependencies(const Callable &p_action, int p_elements, Span<TaskID> p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
+WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task_with_dependencies_bind(const Callable &p_action, int p_elements, const PackedInt64Array &p_dependencies, int p_tasks, bool p_high_priority, const String &p_description) {
+	return _add_group_task(p_action, nullptr, nullptr, nullptr, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+}
+
 uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
 	MutexLock task_lock(task_mutex);
 	const Group *const *groupp = groups.getptr(p_group);
@@ -765,8 +1044,9 @@ int WorkerThreadPool::get_thread_index() const {
 
 WorkerThreadPool::TaskID WorkerThreadPool::get_caller_task_id() const {
 	int th_index = get_thread_index();
-	if (th_index != -1 && threads[th_index].current_task) {
-		return threads[th_index].current_task->self;
+	Task *current_task = th_index != -1 ? threads[th_index].current_task.load() : nullptr;
+	if (current_task) {
+		return current_task->self;
 	} else {
 		return INVALID_TASK_ID;
 	}
@@ -774,8 +1054,9 @@ WorkerThreadPool::TaskID WorkerThreadPool::get_caller_task_id() const {
 
 WorkerThreadPool::GroupID WorkerThreadPool::get_caller_group_id() const {
 	int th_index = get_thread_index();
-	if (th_index != -1 && threads[th_index].current_task && threads[th_index].current_task->group) {
-		return threads[th_index].current_task->group->self;
+	Task *current_task = th_index != -1 ? threads[th_index].current_task.load() : nullptr;
+	if (current_task && current_task->group) {
+		return current_task->group->self;
 	} else {
 		return INVALID_TASK_ID;
 	}
@@ -873,6 +1154,7 @@ void WorkerThreadPool::finish() {
 
 	for (ThreadData &data : threads) {
 		data.thread.wait_to_finish();
+		data.queued_tasks.tasks.clear();
 	}
 
 	{
@@ -890,12 +1172,14 @@ void WorkerThreadPool::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_task_completed", "task_id"), &WorkerThreadPool::is_task_completed);
 	ClassDB::bind_method(D_METHOD("wait_for_task_completion", "task_id"), &WorkerThreadPool::wait_for_task_completion);
 	ClassDB::bind_method(D_METHOD("get_caller_task_id"), &WorkerThreadPool::get_caller_task_id);
+	ClassDB::bind_method(D_METHOD("add_task_with_dependencies", "action", "dependencies", "high_priority", "description"), &WorkerThreadPool::_add_task_with_dependencies_bind, DEFVAL(false), DEFVAL(String()));
 
 	ClassDB::bind_method(D_METHOD("add_group_task", "action", "elements", "tasks_needed", "high_priority", "description"), &WorkerThreadPool::add_group_task, DEFVAL(-1), DEFVAL(false), DEFVAL(String()));
 	ClassDB::bind_method(D_METHOD("is_group_task_completed", "group_id"), &WorkerThreadPool::is_group_task_completed);
 	ClassDB::bind_method(D_METHOD("get_group_processed_element_count", "group_id"), &WorkerThreadPool::get_group_processed_element_count);
 	ClassDB::bind_method(D_METHOD("wait_for_group_task_completion", "group_id"), &WorkerThreadPool::wait_for_group_task_completion);
 	ClassDB::bind_method(D_METHOD("get_caller_group_id"), &WorkerThreadPool::get_caller_group_id);
+	ClassDB::bind_method(D_METHOD("add_group_task_with_dependencies", "action", "elements", "dependencies", "tasks_needed", "high_priority", "description"), &WorkerThreadPool::_add_group_task_with_dependencies_bind, DEFVAL(-1), DEFVAL(false), DEFVAL(String()));
 }
 
 WorkerThreadPool *WorkerThreadPool::get_named_pool(const StringName &p_name) {
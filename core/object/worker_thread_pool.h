@@ -69,6 +69,8 @@ private:
 		SafeFlag completed;
 		SafeNumeric<uint32_t> finished;
 		uint32_t tasks_used = 0;
+		LocalVector<Task *> dependents; // Tasks waiting for this group to complete.
+		SafeFlag has_dependents; // Lets completion skip the task mutex when there are none.
 	};
 
 	struct Task {
@@ -89,6 +91,9 @@ private:
 		bool low_priority = false;
 		BaseTemplateUserdata *template_userdata = nullptr;
 		int pool_thread_index = -1;
+		uint32_t pending_dependencies = 0; // Tasks and groups to complete before this task is queued.
+		uint64_t sequence = 0; // Order of queuing, so tasks of the same priority start in order across queues.
+		LocalVector<Task *> dependents; // Tasks waiting for this one to complete.
 
 		void free_template_userdata();
 		Task() :
@@ -101,14 +106,28 @@ private:
 	static const uint32_t TASKS_PAGE_SIZE = 1024;
 	static const uint32_t GROUPS_PAGE_SIZE = 256;
 
-	PagedAllocator<Task, false, TASKS_PAGE_SIZE> task_allocator;
-	PagedAllocator<Group, false, GROUPS_PAGE_SIZE> group_allocator;
+	// Thread-safe, so that group tasks can be released without taking the task mutex.
+	PagedAllocator<Task, true, TASKS_PAGE_SIZE> task_allocator;
+	PagedAllocator<Group, true, GROUPS_PAGE_SIZE> group_allocator;
 
 	SelfList<Task>::List low_priority_task_queue;
-	SelfList<Task>::List task_queue;
+	SelfList<Task>::List task_queue; // Tasks with an ID and low priority group tasks.
+	std::atomic<uint64_t> task_queue_first_sequence = UINT64_MAX; // Sequence of the first task in task_queue, read without the lock.
 
 	BinaryMutex task_mutex;
 
+	// Work-stealing queue of high priority group tasks, one per pool thread. Tasks are added and taken
+	// without the task mutex held: the owner thread takes them in order, and threads that run out of work
+	// steal them from other threads. A task isn't taken while an older one is waiting in task_queue.
+	struct TaskDeque {
+		BinaryMutex mutex;
+		SelfList<Task>::List tasks;
+		SafeNumeric<uint32_t> count; // Read without locking, to skip empty queues when stealing.
+
+		void push(Task *p_task);
+		Task *pop_oldest(const std::atomic<uint64_t> *p_before);
+	};
+
 	struct ThreadData {
 		static Task *const YIELDING; // Too bad constexpr doesn't work here.
 
@@ -119,9 +138,10 @@ private:
 		bool pre_exited_languages : 1;
 		bool exited_languages : 1;
 		bool has_pump_task : 1; // Threads can only have one pump task.
-		Task *current_task = nullptr;
+		std::atomic<Task *> current_task = nullptr; // Set without the task mutex for group tasks, see _notify_threads().
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable, or special value (YIELDING).
 		ConditionVariable cond_var;
+		TaskDeque queued_tasks;
 		WorkerThreadPool *pool = nullptr;
 
 		ThreadData() :
@@ -168,6 +188,10 @@ private:
 	uint32_t max_low_priority_threads = 0;
 	uint32_t low_priority_threads_used = 0;
 	uint32_t notify_index = 0; // For rotating across threads, no help distributing load.
+	uint32_t queue_index = 0; // For spreading tasks posted from outside the pool across the per-thread queues.
+	SafeNumeric<uint32_t> queued_task_count; // Tasks in all per-thread queues.
+	SafeNumeric<uint64_t> next_sequence;
+	SafeNumeric<uint32_t> waiting_thread_count; // Threads that may wait for a notification, see _push_group_tasks().
 
 	uint64_t last_task = 1;
 	int pump_task_count = 0;
@@ -177,8 +201,15 @@ private:
 	static void _thread_function(void *p_user);
 
 	void _process_task(Task *task);
+	Task *_pop_queued_task(ThreadData *p_thread_data, const std::atomic<uint64_t> *p_before);
+	void _push_group_tasks(Task **p_tasks, uint32_t p_count, uint32_t p_queue_index, uint32_t p_queue_count);
+	void _add_to_task_queue(Task *p_task);
+	Task *_take_from_task_queue();
 
 	void _post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority, MutexLock<BinaryMutex> &p_lock, bool p_pump_task);
+	void _queue_tasks(Task **p_tasks, uint32_t p_count);
+	bool _add_task_dependencies(Task *p_task, TaskID p_id, Span<TaskID> p_dependencies);
+	void _release_dependents(LocalVector<Task *> &p_dependents);
 	void _notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count);
 
 	bool _try_promote_low_priority_task();
@@ -194,8 +225,11 @@ private:
 	static thread_local UnlockableLocks unlockable_locks[MAX_UNLOCKABLE_LOCKS];
 #endif
 
-	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, bool p_pump_task = false);
-	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
+	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description, bool p_pump_task = false, Span<TaskID> p_dependencies = Span<TaskID>());
+	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description, Span<TaskID> p_dependencies = Span<TaskID>());
+
+	TaskID _add_task_with_dependencies_bind(const Callable &p_action, const PackedInt64Array &p_dependencies, bool p_high_priority, const String &p_description);
+	GroupID _add_group_task_with_dependencies_bind(const Callable &p_action, int p_elements, const PackedInt64Array &p_dependencies, int p_tasks, bool p_high_priority, const String &p_description);
 
 	template <typename C, typename M, typename U>
 	struct TaskUserData : public BaseTemplateUserdata {
@@ -246,6 +280,20 @@ public:
 	TaskID add_task(const Callable &p_action, bool p_high_priority = false, const String &p_description = String(), bool p_pump_task = false);
 	TaskID add_task_bind(const Callable &p_action, bool p_high_priority = false, const String &p_description = String());
 
+	// Tasks and groups with dependencies are only queued once all the tasks and groups in p_dependencies have completed.
+	// They can be awaited as usual in the meantime, and so do the dependencies, in any order.
+	template <typename C, typename M, typename U>
+	TaskID add_template_task_with_dependencies(C *p_instance, M p_method, U p_userdata, Span<TaskID> p_dependencies, bool p_high_priority = false, const String &p_description = String()) {
+		typedef TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_task(Callable(), nullptr, nullptr, ud, p_high_priority, p_description, false, p_dependencies);
+	}
+	TaskID add_native_task_with_dependencies(void (*p_func)(void *), void *p_userdata, Span<TaskID> p_dependencies, bool p_high_priority = false, const String &p_description = String());
+	TaskID add_task_with_dependencies(const Callable &p_action, Span<TaskID> p_dependencies, bool p_high_priority = false, const String &p_description = String());
+
 	bool is_task_completed(TaskID p_task_id) const;
 	Error wait_for_task_completion(TaskID p_task_id);
 
@@ -263,6 +311,17 @@ public:
 	}
 	GroupID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	GroupID add_group_task(const Callable &p_action, int p_elements, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+	template <typename C, typename M, typename U>
+	GroupID add_template_group_task_with_dependencies(C *p_instance, M p_method, U p_userdata, int p_elements, Span<TaskID> p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String()) {
+		typedef GroupUserData<C, M, U> GroupUD;
+		GroupUD *ud = memnew(GroupUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_group_task(Callable(), nullptr, nullptr, ud, p_elements, p_tasks, p_high_priority, p_description, p_dependencies);
+	}
+	GroupID add_native_group_task_with_dependencies(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, Span<TaskID> p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
+	GroupID add_group_task_with_dependencies(const Callable &p_action, int p_elements, Span<TaskID> p_dependencies, int p_tasks = -1, bool p_high_priority = false, const String &p_description = String());
 	uint32_t get_group_processed_element_count(GroupID p_group) const;
 	bool is_group_task_completed(GroupID p_group) const;
 	void wait_for_group_task_completion(GroupID p_group);
@@ -0,0 +1,268 @@
+/**************************************************************************/
+/*  frame_allocator.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "frame_allocator.h"
+
+#include "core/os/mutex.h"
+#include "core/templates/safe_refcount.h"
+
+struct FrameAllocator::Arena {
+	uint8_t *blocks[MAX_BLOCKS] = {};
+	uint32_t block_count = 0;
+	uint32_t block_index = 0;
+	// Highest number of blocks used since the frame started, the rest can be trimmed.
+	uint32_t blocks_used = 0;
+	size_t offset = 0;
+	// Header of the most recent allocation, which can be resized or released in place.
+	uint8_t *last = nullptr;
+	uint64_t frame = 0;
+	// Allocations can be freed from other threads.
+	SafeNumeric<uint32_t> live;
+
+	// Running totals, only written by the owning thread so counting never contends.
+	SafeNumeric<uint64_t> bytes;
+	SafeNumeric<uint64_t> overflows;
+	// Totals already accounted for by end_frame().
+	uint64_t reported_bytes = 0;
+	uint64_t reported_overflows = 0;
+
+	// Every live arena, so end_frame() can sum their counters. Guarded by mutex, like
+	// the reported and retired totals.
+	static BinaryMutex mutex;
+	static Arena *first;
+	Arena *prev = nullptr;
+	Arena *next = nullptr;
+	// Counts of arenas whose thread exited since the last end_frame().
+	static uint64_t retired_bytes;
+	static uint64_t retired_overflows;
+
+	Arena() {
+		MutexLock lock(mutex);
+		next = first;
+		if (first) {
+			first->prev = this;
+		}
+		first = this;
+	}
+
+	~Arena() {
+		{
+			MutexLock lock(mutex);
+			retired_bytes += bytes.get() - reported_bytes;
+			retired_overflows += overflows.get() - reported_overflows;
+			if (prev) {
+				prev->next = next;
+			} else {
+				first = next;
+			}
+			if (next) {
+				next->prev = prev;
+			}
+		}
+
+		for (uint32_t i = 0; i < block_count; i++) {
+			Memory::free_static(blocks[i]);
+		}
+	}
+};
+
+struct FrameAllocator::AllocationHeader {
+	Arena *arena = nullptr; // nullptr if the allocation fell back to the heap.
+	uint64_t size = 0;
+};
+
+BinaryMutex FrameAllocator::Arena::mutex;
+FrameAllocator::Arena *FrameAllocator::Arena::first = nullptr;
+uint64_t FrameAllocator::Arena::retired_bytes = 0;
+uint64_t FrameAllocator::Arena::retired_overflows = 0;
+
+thread_local FrameAllocator::Arena FrameAllocator::thread_arena;
+
+static SafeNumeric<uint64_t> frame_counter;
+static SafeNumeric<uint64_t> last_frame_bytes;
+static SafeNumeric<uint64_t> last_frame_overflows;
+static SafeNumeric<uint64_t> frame_bytes_peak;
+
+void FrameAllocator::_prepare_arena(Arena &p_arena) {
+	if (p_arena.live.get() == 0) {
+		p_arena.block_index = 0;
+		p_arena.offset = 0;
+		p_arena.last = nullptr;
+	}
+
+	const uint64_t frame = frame_counter.get();
+	if (p_arena.frame != frame) {
+		// Blocks past the ones used during the previous frame are not holding any allocation.
+		const uint32_t keep = MAX(p_arena.blocks_used, p_arena.block_index + 1);
+		while (p_arena.block_count > keep) {
+			p_arena.block_count--;
+			Memory::free_static(p_arena.blocks[p_arena.block_count]);
+			p_arena.blocks[p_arena.block_count] = nullptr;
+		}
+		p_arena.blocks_used = 0;
+		p_arena.frame = frame;
+	}
+}
+
+void *FrameAllocator::alloc(size_t p_bytes) {
+	static_assert(sizeof(AllocationHeader) <= HEADER_SIZE);
+
+	Arena &arena = thread_arena;
+	_prepare_arena(arena);
+
+	arena.bytes.set(arena.bytes.get() + p_bytes);
+
+	const size_t size = HEADER_SIZE + Memory::get_aligned_address(p_bytes, Memory::MAX_ALIGN);
+	if (likely(size <= BLOCK_SIZE)) {
+		bool fits = arena.block_count > 0 && arena.offset + size <= BLOCK_SIZE;
+		if (!fits) {
+			const uint32_t next = arena.block_count == 0 ? 0 : arena.block_index + 1;
+			if (next < MAX_BLOCKS) {
+				if (next == arena.block_count) {
+					arena.blocks[next] = (uint8_t *)Memory::alloc_static(BLOCK_SIZE);
+					arena.block_count++;
+				}
+				arena.block_index = next;
+				arena.offset = 0;
+				fits = true;
+			}
+		}
+
+		if (fits) {
+			uint8_t *mem = arena.blocks[arena.block_index] + arena.offset;
+			arena.offset += size;
+			arena.last = mem;
+			arena.blocks_used = MAX(arena.blocks_used, arena.block_index + 1);
+			arena.live.increment();
+
+			AllocationHeader *header = (AllocationHeader *)mem;
+			header->arena = &arena;
+			header->size = p_bytes;
+			return mem + HEADER_SIZE;
+		}
+	}
+
+	arena.overflows.set(arena.overflows.get() + 1);
+
+	uint8_t *mem = (uint8_t *)Memory::alloc_static(p_bytes + HEADER_SIZE);
+	ERR_FAIL_NULL_V(mem, nullptr);
+
+	AllocationHeader *header = (AllocationHeader *)mem;
+	header->arena = nullptr;
+	header->size = p_bytes;
+	return mem + HEADER_SIZE;
+}
+
+void *FrameAllocator::realloc(void *p_memory, size_t p_bytes) {
+	if (p_memory == nullptr) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_memory);
+		return nullptr;
+	}
+
+	AllocationHeader *header = _get_header(p_memory);
+	Arena &arena = thread_arena;
+	if (header->arena == &arena && arena.last == (uint8_t *)header) {
+		// Last allocation of this thread's arena, resize it in place if the block has room.
+		const size_t start = (uint8_t *)header - arena.blocks[arena.block_index];
+		const size_t end = start + HEADER_SIZE + Memory::get_aligned_address(p_bytes, Memory::MAX_ALIGN);
+		if (end <= BLOCK_SIZE) {
+			if (p_bytes > header->size) {
+				arena.bytes.set(arena.bytes.get() + p_bytes - header->size);
+			}
+			arena.offset = end;
+			header->size = p_bytes;
+			return p_memory;
+		}
+	}
+
+	void *ret = alloc(p_bytes);
+	ERR_FAIL_NULL_V(ret, nullptr);
+	memcpy(ret, p_memory, MIN(header->size, (uint64_t)p_bytes));
+	free(p_memory);
+	return ret;
+}
+
+void FrameAllocator::free(void *p_memory) {
+	ERR_FAIL_NULL(p_memory);
+
+	AllocationHeader *header = _get_header(p_memory);
+	Arena *arena = header->arena;
+	if (arena == nullptr) {
+		Memory::free_static(header);
+		return;
+	}
+
+	if (arena == &thread_arena && arena->last == (uint8_t *)header) {
+		arena->offset = (uint8_t *)header - arena->blocks[arena->block_index];
+		arena->last = nullptr;
+	}
+	arena->live.decrement();
+}
+
+void FrameAllocator::end_frame() {
+	uint64_t bytes = 0;
+	uint64_t overflows = 0;
+	{
+		MutexLock lock(Arena::mutex);
+		for (Arena *arena = Arena::first; arena; arena = arena->next) {
+			const uint64_t arena_bytes = arena->bytes.get();
+			const uint64_t arena_overflows = arena->overflows.get();
+			bytes += arena_bytes - arena->reported_bytes;
+			overflows += arena_overflows - arena->reported_overflows;
+			arena->reported_bytes = arena_bytes;
+			arena->reported_overflows = arena_overflows;
+		}
+		bytes += Arena::retired_bytes;
+		overflows += Arena::retired_overflows;
+		Arena::retired_bytes = 0;
+		Arena::retired_overflows = 0;
+	}
+
+	last_frame_bytes.set(bytes);
+	frame_bytes_peak.exchange_if_greater(bytes);
+	last_frame_overflows.set(overflows);
+
+	frame_counter.increment();
+}
+
+uint64_t FrameAllocator::get_frame_bytes() {
+	return last_frame_bytes.get();
+}
+
+uint64_t FrameAllocator::get_frame_bytes_peak() {
+	return frame_bytes_peak.get();
+}
+
+uint64_t FrameAllocator::get_frame_overflow_count() {
+	return last_frame_overflows.get();
+}
@@ -0,0 +1,81 @@
+/**************************************************************************/
+/*  frame_allocator.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/memory.h"
+#include "core/templates/local_vector.h"
+
+// Linear (bump) allocator for transient allocations that never outlive the
+// current frame, such as scratch buffers used while culling or stepping physics.
+//
+// Every thread owns its own arena, so allocating never takes a lock nor touches
+// the global heap. An arena is rewound as soon as all of its allocations have
+// been freed, and blocks that were left unused during a frame are returned to
+// the heap once the next frame starts. Requests that don't fit in the arena fall
+// back to Memory::alloc_static() and are reported as overflows. Counters are kept
+// per arena and only summed by end_frame(), so they don't add shared writes.
+//
+// Memory returned by this allocator must be freed before the end of the frame,
+// and before the thread that allocated it exits.
+class FrameAllocator {
+	struct Arena;
+	struct AllocationHeader;
+
+	static constexpr size_t HEADER_SIZE = Memory::get_aligned_address(sizeof(void *) + sizeof(uint64_t), Memory::MAX_ALIGN);
+
+	static thread_local Arena thread_arena;
+
+	static void _prepare_arena(Arena &p_arena);
+	static _FORCE_INLINE_ AllocationHeader *_get_header(void *p_memory) {
+		return (AllocationHeader *)((uint8_t *)p_memory - HEADER_SIZE);
+	}
+
+public:
+	static constexpr uint32_t BLOCK_SIZE = 64 * 1024;
+	static constexpr uint32_t MAX_BLOCKS = 16;
+
+	static void *alloc(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_memory);
+
+	// Called once per frame by the main loop.
+	static void end_frame();
+
+	// Bytes requested during the last frame, across all threads.
+	static uint64_t get_frame_bytes();
+	static uint64_t get_frame_bytes_peak();
+	// Allocations that didn't fit in an arena during the last frame.
+	static uint64_t get_frame_overflow_count();
+};
+
+// LocalVector whose storage lives in the calling thread's frame arena.
+template <typename T, typename U = uint32_t>
+using FrameLocalVector = LocalVector<T, U, false, false, FrameAllocator>;
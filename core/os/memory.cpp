@@ -34,8 +34,25 @@
 #include "core/profiling/profiling.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef BUILTIN_ALLOCATOR_ENABLED
+#include "core/os/size_class_allocator.h"
+#endif
+
 #include <cstdlib>
 
+// Backend used by alloc_static(), realloc_static() and free_static().
+#ifdef BUILTIN_ALLOCATOR_ENABLED
+static _FORCE_INLINE_ void *_backend_alloc(size_t p_bytes) { return SizeClassAllocator::alloc(p_bytes); }
+static _FORCE_INLINE_ void *_backend_alloc_zeroed(size_t p_bytes) { return SizeClassAllocator::alloc_zeroed(p_bytes); }
+static _FORCE_INLINE_ void *_backend_realloc(void *p_memory, size_t p_bytes) { return SizeClassAllocator::realloc(p_memory, p_bytes); }
+static _FORCE_INLINE_ void _backend_free(void *p_memory) { SizeClassAllocator::free(p_memory); }
+#else
+static _FORCE_INLINE_ void *_backend_alloc(size_t p_bytes) { return malloc(p_bytes); }
+static _FORCE_INLINE_ void *_backend_alloc_zeroed(size_t p_bytes) { return calloc(1, p_bytes); }
+static _FORCE_INLINE_ void *_backend_realloc(void *p_memory, size_t p_bytes) { return realloc(p_memory, p_bytes); }
+static _FORCE_INLINE_ void _backend_free(void *p_memory) { free(p_memory); }
+#endif
+
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
 }
@@ -44,6 +61,10 @@ void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)) {
 	return p_allocfunc(p_size);
 }
 
+void *operator new(size_t p_size, Memory::Tag p_tag) {
+	return Memory::alloc_static_tagged(p_size, p_tag);
+}
+
 #ifdef _MSC_VER
 void operator delete(void *p_mem, const char *p_description) {
 	CRASH_NOW_MSG("Call to placement delete should not happen.");
@@ -56,11 +77,24 @@ void operator delete(void *p_mem, void *(*p_allocfunc)(size_t p_size)) {
 void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_description) {
 	CRASH_NOW_MSG("Call to placement delete should not happen.");
 }
+
+void operator delete(void *p_mem, Memory::Tag p_tag) {
+	CRASH_NOW_MSG("Call to placement delete should not happen.");
+}
 #endif
 
+// The tag of an allocation is stored in the upper bits of its size header.
+static constexpr uint32_t TAG_SHIFT = 56;
+static constexpr uint64_t SIZE_MASK = (uint64_t(1) << TAG_SHIFT) - 1;
+static_assert(Memory::TAG_MAX <= (1 << (64 - TAG_SHIFT)));
+
 #ifdef DEBUG_ENABLED
 static SafeNumeric<uint64_t> _current_mem_usage;
 static SafeNumeric<uint64_t> _max_mem_usage;
+static SafeNumeric<uint64_t> _tag_mem_usage[Memory::TAG_MAX];
+static SafeNumeric<uint64_t> _tag_alloc_count[Memory::TAG_MAX];
+static thread_local Memory::Tag _current_tag = Memory::TAG_UNTAGGED;
+static SafeFlag _tag_tracking_enabled;
 #endif
 
 void *Memory::alloc_aligned_static(size_t p_bytes, size_t p_alignment) {
@@ -107,9 +141,9 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 
 	void *mem;
 	if constexpr (p_ensure_zero) {
-		mem = calloc(1, p_bytes + (prepad ? DATA_OFFSET : 0));
+		mem = _backend_alloc_zeroed(p_bytes + (prepad ? DATA_OFFSET : 0));
 	} else {
-		mem = malloc(p_bytes + (prepad ? DATA_OFFSET : 0));
+		mem = _backend_alloc(p_bytes + (prepad ? DATA_OFFSET : 0));
 	}
 
 	ERR_FAIL_NULL_V(mem, nullptr);
@@ -119,11 +153,20 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 		uint8_t *s8 = (uint8_t *)mem;
 
 		uint64_t *s = (uint64_t *)(s8 + SIZE_OFFSET);
-		*s = p_bytes;
 
 #ifdef DEBUG_ENABLED
+		// Untagged allocations, and all allocations while tag tracking is disabled, aren't accounted per tag.
+		const Tag tag = _tag_tracking_enabled.is_set() ? _current_tag : TAG_UNTAGGED;
+		*s = p_bytes | ((uint64_t)tag << TAG_SHIFT);
+
 		uint64_t new_mem_usage = _current_mem_usage.add(p_bytes);
 		_max_mem_usage.exchange_if_greater(new_mem_usage);
+		if (tag != TAG_UNTAGGED) {
+			_tag_mem_usage[tag].add(p_bytes);
+			_tag_alloc_count[tag].increment();
+		}
+#else
+		*s = p_bytes;
 #endif
 		return s8 + DATA_OFFSET;
 	} else {
@@ -150,37 +193,46 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 	if (prepad) {
 		mem -= DATA_OFFSET;
 		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
+		const uint64_t tag_bits = *s & ~SIZE_MASK;
 
 #ifdef DEBUG_ENABLED
-		if (p_bytes > *s) {
-			uint64_t new_mem_usage = _current_mem_usage.add(p_bytes - *s);
+		const uint64_t prev_bytes = *s & SIZE_MASK;
+		const Tag tag = Tag(tag_bits >> TAG_SHIFT);
+		if (p_bytes > prev_bytes) {
+			uint64_t new_mem_usage = _current_mem_usage.add(p_bytes - prev_bytes);
 			_max_mem_usage.exchange_if_greater(new_mem_usage);
+			if (tag != TAG_UNTAGGED) {
+				_tag_mem_usage[tag].add(p_bytes - prev_bytes);
+			}
 		} else {
-			_current_mem_usage.sub(*s - p_bytes);
+			_current_mem_usage.sub(prev_bytes - p_bytes);
+			if (tag != TAG_UNTAGGED) {
+				_tag_mem_usage[tag].sub(prev_bytes - p_bytes);
+			}
 		}
 #endif
 
 		if (p_bytes == 0) {
 			GodotProfileFree(mem);
-			free(mem);
+			_backend_free(mem);
 			return nullptr;
 		} else {
-			*s = p_bytes;
+			*s = p_bytes | tag_bits;
 
 			GodotProfileFree(mem);
-			mem = (uint8_t *)realloc(mem, p_bytes + DATA_OFFSET);
+			mem = (uint8_t *)_backend_realloc(mem, p_bytes + DATA_OFFSET);
 			ERR_FAIL_NULL_V(mem, nullptr);
 			GodotProfileAlloc(mem, p_bytes + DATA_OFFSET);
 
 			s = (uint64_t *)(mem + SIZE_OFFSET);
 
-			*s = p_bytes;
+			*s = p_bytes | tag_bits;
 
 			return mem + DATA_OFFSET;
 		}
 	} else {
 		GodotProfileFree(mem);
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_backend_realloc(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 		GodotProfileAlloc(mem, p_bytes);
@@ -205,14 +257,18 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 
 #ifdef DEBUG_ENABLED
 		uint64_t *s = (uint64_t *)(mem + SIZE_OFFSET);
-		_current_mem_usage.sub(*s);
+		_current_mem_usage.sub(*s & SIZE_MASK);
+		const Tag tag = Tag(*s >> TAG_SHIFT);
+		if (tag != TAG_UNTAGGED) {
+			_tag_mem_usage[tag].sub(*s & SIZE_MASK);
+		}
 #endif
 
 		GodotProfileFree(mem);
-		free(mem);
+		_backend_free(mem);
 	} else {
 		GodotProfileFree(mem);
-		free(mem);
+		_backend_free(mem);
 	}
 }
 
@@ -236,6 +292,65 @@ uint64_t Memory::get_mem_max_usage() {
 #endif
 }
 
+void *Memory::alloc_static_tagged(size_t p_bytes, Tag p_tag) {
+#ifdef DEBUG_ENABLED
+	const Tag previous_tag = _current_tag;
+	_current_tag = p_tag;
+	void *mem = alloc_static(p_bytes);
+	_current_tag = previous_tag;
+	return mem;
+#else
+	return alloc_static(p_bytes);
+#endif
+}
+
+Memory::Tag Memory::get_current_tag() {
+#ifdef DEBUG_ENABLED
+	return _current_tag;
+#else
+	return TAG_UNTAGGED;
+#endif
+}
+
+void Memory::set_current_tag(Tag p_tag) {
+#ifdef DEBUG_ENABLED
+	DEV_ASSERT(p_tag < TAG_MAX);
+	_current_tag = p_tag;
+#endif
+}
+
+void Memory::set_tag_tracking_enabled(bool p_enabled) {
+#ifdef DEBUG_ENABLED
+	_tag_tracking_enabled.set_to(p_enabled);
+#endif
+}
+
+bool Memory::is_tag_tracking_enabled() {
+#ifdef DEBUG_ENABLED
+	return _tag_tracking_enabled.is_set();
+#else
+	return false;
+#endif
+}
+
+uint64_t Memory::get_tag_mem_usage(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef DEBUG_ENABLED
+	return _tag_mem_usage[p_tag].get();
+#else
+	return 0;
+#endif
+}
+
+uint64_t Memory::get_tag_alloc_count(Tag p_tag) {
+	ERR_FAIL_INDEX_V(p_tag, TAG_MAX, 0);
+#ifdef DEBUG_ENABLED
+	return _tag_alloc_count[p_tag].get();
+#else
+	return 0;
+#endif
+}
+
 _GlobalNil::_GlobalNil() {
 	left = this;
 	right = this;
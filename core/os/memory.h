@@ -96,11 +96,62 @@ void free_aligned_static(void *p_memory);
 uint64_t get_mem_available();
 uint64_t get_mem_usage();
 uint64_t get_mem_max_usage();
+
+// Subsystems that allocations can be attributed to, using MemoryTagScope or memnew_tagged().
+// Only tracked in debug builds, where every allocation is prepended with its size, and
+// only once enabled with set_tag_tracking_enabled() (`--debug-memory-tags`).
+enum Tag : uint8_t {
+	TAG_UNTAGGED,
+	TAG_RESOURCES,
+	TAG_SCRIPTING,
+	TAG_NAVIGATION,
+	TAG_PHYSICS,
+	TAG_RENDERING,
+	TAG_AUDIO,
+	TAG_MAX,
+};
+
+void *alloc_static_tagged(size_t p_bytes, Tag p_tag);
+
+// Tag applied to allocations made by the calling thread.
+Tag get_current_tag();
+void set_current_tag(Tag p_tag);
+
+// Disabled by default. Allocations made while disabled stay untagged once enabled.
+void set_tag_tracking_enabled(bool p_enabled);
+bool is_tag_tracking_enabled();
+
+// Always 0 for TAG_UNTAGGED, which isn't tracked.
+uint64_t get_tag_mem_usage(Tag p_tag);
+// Total amount of allocations made with this tag since startup.
+uint64_t get_tag_alloc_count(Tag p_tag);
 }; //namespace Memory
 
+// Attributes allocations made by the current thread to a subsystem until going out of scope.
+class MemoryTagScope {
+#ifdef DEBUG_ENABLED
+	Memory::Tag previous_tag;
+
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {
+		previous_tag = Memory::get_current_tag();
+		Memory::set_current_tag(p_tag);
+	}
+	_FORCE_INLINE_ ~MemoryTagScope() {
+		Memory::set_current_tag(previous_tag);
+	}
+#else
+public:
+	_FORCE_INLINE_ explicit MemoryTagScope(Memory::Tag p_tag) {}
+#endif
+};
+
+#define MEMORY_TAG_SCOPE(m_tag) MemoryTagScope GD_UNIQUE_NAME(__memory_tag_scope_)(m_tag)
+
 class DefaultAllocator {
 public:
 	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return Memory::alloc_static(p_memory, false); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_memory) { return Memory::realloc_static(p_ptr, p_memory, false); }
 	_FORCE_INLINE_ static void free(void *p_ptr) { Memory::free_static(p_ptr, false); }
 };
 
@@ -112,6 +163,7 @@ void *operator new(size_t p_size, const char *p_description); ///< operator new
 void *operator new(size_t p_size, void *(*p_allocfunc)(size_t p_size)); ///< operator new that takes a description and uses MemoryStaticPool
 
 void *operator new(size_t p_size, void *p_pointer, size_t check, const char *p_description); ///< operator new that takes a description and uses a pointer to the preallocated memory
+void *operator new(size_t p_size, Memory::Tag p_tag); ///< operator new that attributes the allocation to a memory tag
 
 #ifdef _MSC_VER
 // When compiling with VC++ 2017, the above declarations of placement new generate many irrelevant warnings (C4291).
@@ -119,10 +171,12 @@ void *operator new(size_t p_size, void *p_pointer, size_t check, const char *p_d
 void operator delete(void *p_mem, const char *p_description);
 void operator delete(void *p_mem, void *(*p_allocfunc)(size_t p_size));
 void operator delete(void *p_mem, void *p_pointer, size_t check, const char *p_description);
+void operator delete(void *p_mem, Memory::Tag p_tag);
 #endif
 
 #define memalloc(m_size) Memory::alloc_static(m_size)
 #define memalloc_zeroed(m_size) Memory::alloc_static_zeroed(m_size)
+#define memalloc_tagged(m_size, m_tag) Memory::alloc_static_tagged(m_size, m_tag)
 #define memrealloc(m_mem, m_size) Memory::realloc_static(m_mem, m_size)
 #define memfree(m_mem) Memory::free_static(m_mem)
 
@@ -135,6 +189,7 @@ _ALWAYS_INLINE_ T *_post_initialize(T *p_obj) {
 }
 
 #define memnew(m_class) _post_initialize(::new ("") m_class)
+#define memnew_tagged(m_class, m_tag) _post_initialize(::new (m_tag) m_class)
 
 #define memnew_allocator(m_class, m_allocator) _post_initialize(::new (m_allocator::alloc) m_class)
 #define memnew_placement(m_placement, m_class) _post_initialize(::new (m_placement) m_class)
@@ -0,0 +1,392 @@
+/**************************************************************************/
+/*  size_class_allocator.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "size_class_allocator.h"
+
+#include "core/os/spin_lock.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+// Size classes go in 16 bytes steps up to 256 bytes, then in 4 steps per power of 2 up to MAX_SIZE.
+static constexpr uint32_t SMALL_CLASS_COUNT = 16;
+static constexpr uint32_t SIZE_CLASS_COUNT = SMALL_CLASS_COUNT + 7 * 4;
+
+static constexpr uint32_t CHUNK_SHIFT = 16;
+static constexpr size_t CHUNK_SIZE = size_t(1) << CHUNK_SHIFT;
+static constexpr uint32_t CHUNKS_PER_SUPERBLOCK = 16;
+
+struct SizeClassTable {
+	// Class indices start at 1, 0 means the block is not owned by this allocator.
+	uint8_t class_of[SizeClassAllocator::MAX_SIZE / 16 + 1] = {};
+	uint32_t size_of[SIZE_CLASS_COUNT + 1] = {};
+	// Amount of blocks moved at once between thread caches and central lists.
+	uint32_t batch_of[SIZE_CLASS_COUNT + 1] = {};
+
+	constexpr SizeClassTable() {
+		for (uint32_t i = 1; i <= SIZE_CLASS_COUNT; i++) {
+			if (i <= SMALL_CLASS_COUNT) {
+				size_of[i] = i * 16;
+			} else {
+				const uint32_t step = i - SMALL_CLASS_COUNT - 1;
+				const uint32_t base = 256 << (step / 4);
+				size_of[i] = base + (base / 4) * (step % 4 + 1);
+			}
+			const uint32_t batch = 32768 / size_of[i];
+			batch_of[i] = batch < 2 ? 2 : (batch > 64 ? 64 : batch);
+		}
+
+		uint32_t current = 1;
+		for (uint32_t i = 0; i <= SizeClassAllocator::MAX_SIZE / 16; i++) {
+			while (size_of[current] < i * 16) {
+				current++;
+			}
+			class_of[i] = current;
+		}
+	}
+};
+
+static constexpr SizeClassTable size_classes;
+static_assert(size_classes.size_of[SIZE_CLASS_COUNT] == SizeClassAllocator::MAX_SIZE);
+
+/* Page map */
+
+// Maps each chunk of the address space to the size class of its blocks. On 64-bit
+// platforms, only the lower 48 bits of the address space are tracked, chunks that
+// would fall outside of it are never handed out. The top byte is ignored, as it may
+// hold a tag rather than a part of the address (e.g. with ARM's top byte ignore).
+
+#if defined(__LP64__) || defined(_WIN64)
+static constexpr uint32_t ADDRESS_BITS = 48;
+static constexpr uintptr_t ADDRESS_MASK = ~uintptr_t(0) >> 8;
+#else
+static constexpr uint32_t ADDRESS_BITS = 32;
+static constexpr uintptr_t ADDRESS_MASK = ~uintptr_t(0);
+#endif
+
+static constexpr uint32_t PAGEMAP_LEAF_BITS = 16;
+static constexpr uint32_t PAGEMAP_ROOT_BITS = ADDRESS_BITS - CHUNK_SHIFT - PAGEMAP_LEAF_BITS;
+static constexpr uintptr_t PAGEMAP_LEAF_MASK = (uintptr_t(1) << PAGEMAP_LEAF_BITS) - 1;
+
+static std::atomic<uint8_t *> pagemap[size_t(1) << PAGEMAP_ROOT_BITS];
+
+static _FORCE_INLINE_ uintptr_t _get_chunk_key(const void *p_memory) {
+	return (uintptr_t(p_memory) & ADDRESS_MASK) >> CHUNK_SHIFT;
+}
+
+static _FORCE_INLINE_ bool _is_chunk_key_tracked(uintptr_t p_key) {
+	return (p_key >> (PAGEMAP_ROOT_BITS + PAGEMAP_LEAF_BITS)) == 0;
+}
+
+static _FORCE_INLINE_ uint32_t _get_block_class(const void *p_memory) {
+	const uintptr_t key = _get_chunk_key(p_memory);
+	if (unlikely(!_is_chunk_key_tracked(key))) {
+		return 0;
+	}
+	const uint8_t *leaf = pagemap[key >> PAGEMAP_LEAF_BITS].load(std::memory_order_acquire);
+	return leaf ? leaf[key & PAGEMAP_LEAF_MASK] : 0;
+}
+
+/* Page heap */
+
+static SpinLock page_heap_lock;
+static void *free_chunks = nullptr;
+// Set once the system allocator hands out memory out of the tracked address space,
+// so that later allocations go straight to it instead of retrying.
+static bool chunks_untracked = false;
+
+static void *_alloc_chunk(uint32_t p_class) {
+	page_heap_lock.lock();
+
+	if (free_chunks == nullptr) {
+		if (chunks_untracked) {
+			page_heap_lock.unlock();
+			return nullptr;
+		}
+		uint8_t *superblock = (uint8_t *)malloc(CHUNKS_PER_SUPERBLOCK * CHUNK_SIZE + CHUNK_SIZE - 1);
+		if (superblock == nullptr) {
+			page_heap_lock.unlock();
+			return nullptr;
+		}
+		uint8_t *base = (uint8_t *)((uintptr_t(superblock) + CHUNK_SIZE - 1) & ~(uintptr_t)(CHUNK_SIZE - 1));
+		if (unlikely(!_is_chunk_key_tracked(_get_chunk_key(base + (CHUNKS_PER_SUPERBLOCK - 1) * CHUNK_SIZE)))) {
+			// Let the callers fall back to the system allocator.
+			::free(superblock);
+			chunks_untracked = true;
+			page_heap_lock.unlock();
+			return nullptr;
+		}
+		for (uint32_t i = 0; i < CHUNKS_PER_SUPERBLOCK; i++) {
+			void *chunk = base + i * CHUNK_SIZE;
+			*(void **)chunk = free_chunks;
+			free_chunks = chunk;
+		}
+	}
+
+	void *chunk = free_chunks;
+	const uintptr_t key = _get_chunk_key(chunk);
+	std::atomic<uint8_t *> &root = pagemap[key >> PAGEMAP_LEAF_BITS];
+	uint8_t *leaf = root.load(std::memory_order_acquire);
+	if (leaf == nullptr) {
+		leaf = (uint8_t *)calloc(size_t(1) << PAGEMAP_LEAF_BITS, sizeof(uint8_t));
+		if (leaf == nullptr) {
+			page_heap_lock.unlock();
+			return nullptr;
+		}
+		root.store(leaf, std::memory_order_release);
+	}
+
+	free_chunks = *(void **)chunk;
+	// Blocks of this chunk only reach other threads through a central list, which synchronizes this write.
+	leaf[key & PAGEMAP_LEAF_MASK] = (uint8_t)p_class;
+
+	page_heap_lock.unlock();
+	return chunk;
+}
+
+/* Central free lists */
+
+struct CentralList {
+	SpinLock lock;
+	void *head = nullptr;
+};
+
+static CentralList central_lists[SIZE_CLASS_COUNT + 1];
+
+// Pops up to p_max blocks into a linked list, returns the amount of blocks fetched.
+static uint32_t _central_fetch(uint32_t p_class, void *&r_head, uint32_t p_max) {
+	CentralList &list = central_lists[p_class];
+	list.lock.lock();
+
+	if (list.head == nullptr) {
+		list.lock.unlock();
+
+		uint8_t *chunk = (uint8_t *)_alloc_chunk(p_class);
+		if (chunk == nullptr) {
+			return 0;
+		}
+
+		// Carve the chunk into blocks linked in address order.
+		const uint32_t size = size_classes.size_of[p_class];
+		const uint32_t count = CHUNK_SIZE / size;
+		for (uint32_t i = 0; i < count - 1; i++) {
+			*(void **)(chunk + i * size) = chunk + (i + 1) * size;
+		}
+		void *tail = chunk + (count - 1) * size;
+
+		list.lock.lock();
+		*(void **)tail = list.head;
+		list.head = chunk;
+	}
+
+	void *head = list.head;
+	void *last = head;
+	uint32_t fetched = 1;
+	while (fetched < p_max && *(void **)last != nullptr) {
+		last = *(void **)last;
+		fetched++;
+	}
+	list.head = *(void **)last;
+
+	list.lock.unlock();
+
+	*(void **)last = nullptr;
+	r_head = head;
+	return fetched;
+}
+
+static void _central_release(uint32_t p_class, void *p_head, void *p_tail) {
+	CentralList &list = central_lists[p_class];
+	list.lock.lock();
+	*(void **)p_tail = list.head;
+	list.head = p_head;
+	list.lock.unlock();
+}
+
+/* Thread caches */
+
+struct ThreadCache {
+	struct List {
+		void *head = nullptr;
+		uint32_t count = 0;
+	};
+
+	List lists[SIZE_CLASS_COUNT + 1];
+
+	~ThreadCache();
+};
+
+static thread_local ThreadCache thread_cache;
+// Allocations can still happen while other thread locals are destroyed, after the cache is gone.
+static thread_local bool thread_cache_destroyed = false;
+
+ThreadCache::~ThreadCache() {
+	for (uint32_t i = 1; i <= SIZE_CLASS_COUNT; i++) {
+		List &list = lists[i];
+		if (list.head == nullptr) {
+			continue;
+		}
+		void *tail = list.head;
+		while (*(void **)tail != nullptr) {
+			tail = *(void **)tail;
+		}
+		_central_release(i, list.head, tail);
+		list.head = nullptr;
+		list.count = 0;
+	}
+	thread_cache_destroyed = true;
+}
+
+/* Allocator */
+
+// Returns nullptr if no chunk could be set up for the size class.
+static _FORCE_INLINE_ void *_alloc_block(uint32_t p_class) {
+	if (likely(!thread_cache_destroyed)) {
+		ThreadCache::List &list = thread_cache.lists[p_class];
+		if (unlikely(list.head == nullptr)) {
+			list.count = _central_fetch(p_class, list.head, size_classes.batch_of[p_class]);
+		}
+		if (likely(list.head != nullptr)) {
+			void *block = list.head;
+			list.head = *(void **)block;
+			list.count--;
+			return block;
+		}
+		return nullptr;
+	}
+
+	void *block = nullptr;
+	_central_fetch(p_class, block, 1);
+	return block;
+}
+
+void *SizeClassAllocator::alloc(size_t p_bytes) {
+	if (p_bytes > MAX_SIZE) {
+		return malloc(p_bytes);
+	}
+
+	void *block = _alloc_block(size_classes.class_of[(p_bytes + 15) >> 4]);
+	if (likely(block != nullptr)) {
+		return block;
+	}
+
+	// No chunk could be set up, free() and realloc() recognize system blocks of any size.
+	return malloc(p_bytes);
+}
+
+void *SizeClassAllocator::alloc_zeroed(size_t p_bytes) {
+	if (p_bytes > MAX_SIZE) {
+		return calloc(1, p_bytes);
+	}
+
+	void *block = alloc(p_bytes);
+	if (block) {
+		memset(block, 0, p_bytes);
+	}
+	return block;
+}
+
+void *SizeClassAllocator::realloc(void *p_memory, size_t p_bytes) {
+	if (p_memory == nullptr) {
+		return alloc(p_bytes);
+	}
+	if (p_bytes == 0) {
+		free(p_memory);
+		return nullptr;
+	}
+
+	const uint32_t block_class = _get_block_class(p_memory);
+	if (block_class == 0) {
+		if (p_bytes > MAX_SIZE) {
+			return ::realloc(p_memory, p_bytes);
+		}
+		void *block = _alloc_block(size_classes.class_of[(p_bytes + 15) >> 4]);
+		if (block == nullptr) {
+			return ::realloc(p_memory, p_bytes);
+		}
+		// The size of system blocks is unknown, resize it first so that p_bytes can be copied.
+		void *resized = ::realloc(p_memory, p_bytes);
+		if (resized == nullptr) {
+			free(block);
+			return nullptr;
+		}
+		memcpy(block, resized, p_bytes);
+		::free(resized);
+		return block;
+	}
+
+	if (p_bytes <= MAX_SIZE && size_classes.class_of[(p_bytes + 15) >> 4] == block_class) {
+		return p_memory;
+	}
+
+	void *block = alloc(p_bytes);
+	if (block) {
+		memcpy(block, p_memory, MIN((size_t)size_classes.size_of[block_class], p_bytes));
+		free(p_memory);
+	}
+	return block;
+}
+
+void SizeClassAllocator::free(void *p_memory) {
+	const uint32_t block_class = _get_block_class(p_memory);
+	if (block_class == 0) {
+		::free(p_memory);
+		return;
+	}
+
+	if (unlikely(thread_cache_destroyed)) {
+		*(void **)p_memory = nullptr;
+		_central_release(block_class, p_memory, p_memory);
+		return;
+	}
+
+	ThreadCache::List &list = thread_cache.lists[block_class];
+	*(void **)p_memory = list.head;
+	list.head = p_memory;
+	list.count++;
+
+	const uint32_t batch = size_classes.batch_of[block_class];
+	if (unlikely(list.count > batch * 2)) {
+		// Give a batch back so that memory freed by this thread can be reused by others.
+		void *head = list.head;
+		void *tail = head;
+		for (uint32_t i = 1; i < batch; i++) {
+			tail = *(void **)tail;
+		}
+		list.head = *(void **)tail;
+		list.count -= batch;
+		_central_release(block_class, head, tail);
+	}
+}
+
+size_t SizeClassAllocator::get_block_size(const void *p_memory) {
+	return size_classes.size_of[_get_block_class(p_memory)];
+}
@@ -0,0 +1,58 @@
+/**************************************************************************/
+/*  size_class_allocator.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/typedefs.h"
+
+// Thread-caching allocator used as the backend of Memory::alloc_static() and
+// friends when building with `builtin_allocator=yes`.
+//
+// Small requests are rounded up to one of a fixed set of size classes. Every
+// thread keeps a cache of free blocks for each size class, so most allocations
+// and frees don't need any synchronization. Thread caches are refilled from,
+// and spill back into, central free lists shared by all threads, which carve
+// their blocks out of chunks handed out by a central page heap.
+// Chunks are kept by the page heap once allocated and never returned to the system.
+//
+// Requests larger than MAX_SIZE go straight to the system allocator, as do all
+// requests if it hands out memory outside of the address range tracked for chunks.
+class SizeClassAllocator {
+public:
+	static constexpr size_t MAX_SIZE = 32 * 1024;
+
+	static void *alloc(size_t p_bytes);
+	static void *alloc_zeroed(size_t p_bytes);
+	static void *realloc(void *p_memory, size_t p_bytes);
+	static void free(void *p_memory);
+
+	// Usable size of a block returned by alloc(), or 0 if it is owned by the system allocator.
+	static size_t get_block_size(const void *p_memory);
+};
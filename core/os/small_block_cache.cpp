@@ -0,0 +1,85 @@
+/**************************************************************************/
+/*  small_block_cache.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "small_block_cache.h"
+
+#include "core/os/memory.h"
+
+static constexpr uint32_t BLOCK_SIZE_COUNT = SmallBlockCache::MAX_BLOCK_SIZE / SmallBlockCache::BLOCK_SIZE_STEP;
+
+struct BlockCache {
+	struct List {
+		void *blocks[SmallBlockCache::MAX_BLOCKS];
+		uint32_t count = 0;
+	};
+
+	List lists[BLOCK_SIZE_COUNT];
+
+	~BlockCache();
+};
+
+static _FORCE_INLINE_ uint32_t _get_list_index(size_t p_bytes) {
+	DEV_ASSERT(p_bytes > 0 && p_bytes <= SmallBlockCache::MAX_BLOCK_SIZE);
+	return (p_bytes - 1) / SmallBlockCache::BLOCK_SIZE_STEP;
+}
+
+static thread_local BlockCache block_cache;
+// Strings can still be freed while other thread locals are destroyed, after the cache is gone.
+static thread_local bool block_cache_destroyed = false;
+
+BlockCache::~BlockCache() {
+	for (List &list : lists) {
+		while (list.count > 0) {
+			Memory::free_static(list.blocks[--list.count], false);
+		}
+	}
+	block_cache_destroyed = true;
+}
+
+void *SmallBlockCache::alloc(size_t p_bytes) {
+	if (likely(!block_cache_destroyed)) {
+		BlockCache::List &list = block_cache.lists[_get_list_index(p_bytes)];
+		if (list.count > 0) {
+			return list.blocks[--list.count];
+		}
+	}
+	return Memory::alloc_static(get_block_size(p_bytes), false);
+}
+
+void SmallBlockCache::free(void *p_block, size_t p_bytes) {
+	if (likely(!block_cache_destroyed)) {
+		BlockCache::List &list = block_cache.lists[_get_list_index(p_bytes)];
+		if (list.count < MAX_BLOCKS) {
+			list.blocks[list.count++] = p_block;
+			return;
+		}
+	}
+	Memory::free_static(p_block, false);
+}
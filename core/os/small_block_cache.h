@@ -0,0 +1,58 @@
+/**************************************************************************/
+/*  small_block_cache.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/typedefs.h"
+
+// Per-thread cache of small memory blocks, used for the buffers of short
+// strings (see CowData), which are created and destroyed at a very high rate.
+//
+// Block sizes go in BLOCK_SIZE_STEP steps up to MAX_BLOCK_SIZE. Allocators don't
+// hand out memory at a finer granularity than that, so a block never takes more
+// memory than the system allocator would use for the exact request.
+// Freed blocks are kept by the freeing thread for reuse, up to MAX_BLOCKS per
+// size, so most short-lived strings never reach the global heap. Blocks come
+// from and go back to Memory::alloc_static(), so they are accounted as regular memory.
+class SmallBlockCache {
+public:
+	static constexpr size_t BLOCK_SIZE_STEP = 8;
+	static constexpr size_t MAX_BLOCK_SIZE = 96;
+	static constexpr uint32_t MAX_BLOCKS = 64;
+
+	// Size of the block used for p_bytes, which must be at most MAX_BLOCK_SIZE.
+	static constexpr size_t get_block_size(size_t p_bytes) {
+		return (p_bytes + BLOCK_SIZE_STEP - 1) & ~(BLOCK_SIZE_STEP - 1);
+	}
+
+	static void *alloc(size_t p_bytes);
+	// p_bytes must have the same block size as the amount of bytes passed to alloc().
+	static void free(void *p_block, size_t p_bytes);
+};
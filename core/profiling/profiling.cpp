@@ -236,6 +236,248 @@ void godot_init_profiler() {
 void godot_cleanup_profiler() {
 }
 
+#elif defined(GODOT_USE_TRACE_PROFILER)
+
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/string/ustring.h"
+
+#include <cstdio>
+
+namespace TraceProfiler {
+
+struct Event {
+	const char *name;
+	uint64_t time;
+	EventType type;
+};
+
+// Only the owner thread writes events; the count is published so they can be saved while capturing.
+struct EventBlock {
+	static constexpr uint32_t SIZE = 4096;
+
+	Event events[SIZE];
+	std::atomic<uint32_t> count = { 0 };
+	std::atomic<EventBlock *> next = { nullptr };
+};
+
+struct ThreadBuffer {
+	// Caps memory use at about 100 MiB per thread.
+	static constexpr uint32_t MAX_BLOCKS = 1024;
+
+	Thread::ID thread_id = 0;
+	uint32_t generation = 0;
+	uint32_t block_count = 0;
+	EventBlock *first = nullptr;
+	EventBlock *last = nullptr;
+	ThreadBuffer *next = nullptr;
+};
+
+static std::atomic<bool> capturing = { false };
+// Incremented when a capture starts, so each thread discards its old events the next time it records.
+// Also identifies the capture for record(), where 0 means none.
+static std::atomic<uint32_t> generation = { 0 };
+static std::atomic<uint64_t> dropped_events = { 0 };
+static std::atomic<ThreadBuffer *> thread_buffers = { nullptr };
+// Taken when registering threads, discarding events and saving; never when recording.
+static BinaryMutex mutex;
+static thread_local ThreadBuffer *thread_buffer = nullptr;
+static CharString output_path;
+
+static ThreadBuffer *_register_thread() {
+	ThreadBuffer *tb = memnew(ThreadBuffer);
+	tb->thread_id = Thread::get_caller_id();
+	tb->generation = generation.load(std::memory_order_acquire);
+	tb->first = memnew(EventBlock);
+	tb->last = tb->first;
+	tb->block_count = 1;
+
+	MutexLock lock(mutex);
+	tb->next = thread_buffers.load(std::memory_order_relaxed);
+	thread_buffers.store(tb, std::memory_order_release);
+	thread_buffer = tb;
+	return tb;
+}
+
+static void _reset_thread_buffer(ThreadBuffer *p_buffer, uint32_t p_generation) {
+	MutexLock lock(mutex);
+	EventBlock *block = p_buffer->first->next.load(std::memory_order_relaxed);
+	while (block) {
+		EventBlock *next = block->next.load(std::memory_order_relaxed);
+		memdelete(block);
+		block = next;
+	}
+	p_buffer->first->next.store(nullptr, std::memory_order_relaxed);
+	p_buffer->first->count.store(0, std::memory_order_relaxed);
+	p_buffer->last = p_buffer->first;
+	p_buffer->block_count = 1;
+	p_buffer->generation = p_generation;
+}
+
+uint32_t record(const char *p_name, EventType p_type, uint32_t p_capture) {
+	if (!capturing.load(std::memory_order_relaxed)) {
+		return 0;
+	}
+	const OS *os = OS::get_singleton();
+	if (unlikely(!os)) {
+		return 0;
+	}
+
+	uint32_t current_generation = generation.load(std::memory_order_acquire);
+	if (p_capture && p_capture != current_generation) {
+		return 0; // Began in a previous capture, whose events were discarded.
+	}
+
+	ThreadBuffer *tb = thread_buffer;
+	if (unlikely(!tb)) {
+		tb = _register_thread();
+	}
+	if (unlikely(tb->generation != current_generation)) {
+		_reset_thread_buffer(tb, current_generation);
+	}
+
+	EventBlock *block = tb->last;
+	uint32_t count = block->count.load(std::memory_order_relaxed);
+	if (unlikely(count == EventBlock::SIZE)) {
+		if (tb->block_count == ThreadBuffer::MAX_BLOCKS) {
+			dropped_events.fetch_add(1, std::memory_order_relaxed);
+			return 0;
+		}
+		EventBlock *new_block = memnew(EventBlock);
+		block->next.store(new_block, std::memory_order_release);
+		tb->last = new_block;
+		tb->block_count++;
+		block = new_block;
+		count = 0;
+	}
+
+	Event &event = block->events[count];
+	event.name = p_name;
+	event.time = os->get_ticks_usec();
+	event.type = p_type;
+	block->count.store(count + 1, std::memory_order_release);
+	return current_generation;
+}
+
+void start() {
+	generation.fetch_add(1, std::memory_order_release);
+	dropped_events.store(0, std::memory_order_relaxed);
+	capturing.store(true, std::memory_order_relaxed);
+}
+
+void stop() {
+	capturing.store(false, std::memory_order_relaxed);
+}
+
+bool is_capturing() {
+	return capturing.load(std::memory_order_relaxed);
+}
+
+static void _write_json_string(FILE *p_file, const char *p_string) {
+	fputc('"', p_file);
+	for (const char *c = p_string; *c; c++) {
+		if (*c == '"' || *c == '\\') {
+			fputc('\\', p_file);
+			fputc(*c, p_file);
+		} else if ((unsigned char)*c < 0x20) {
+			fprintf(p_file, "\\u%04x", (unsigned char)*c);
+		} else {
+			fputc(*c, p_file);
+		}
+	}
+	fputc('"', p_file);
+}
+
+bool save(const char *p_path) {
+	// Written with the C library, so traces can still be saved after the engine's file access is gone.
+	FILE *file = fopen(p_path, "wb");
+	ERR_FAIL_NULL_V_MSG(file, false, "Cannot open trace file '" + String::utf8(p_path) + "' for writing.");
+
+	MutexLock lock(mutex);
+	uint32_t current_generation = generation.load(std::memory_order_acquire);
+
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%llu,\"args\":{\"name\":\"Main thread\"}}", (unsigned long long)Thread::get_main_id());
+
+	for (ThreadBuffer *tb = thread_buffers.load(std::memory_order_acquire); tb; tb = tb->next) {
+		if (tb->generation != current_generation) {
+			continue; // Nothing recorded by this thread in this capture.
+		}
+		for (EventBlock *block = tb->first; block; block = block->next.load(std::memory_order_acquire)) {
+			uint32_t count = block->count.load(std::memory_order_acquire);
+			for (uint32_t i = 0; i < count; i++) {
+				const Event &event = block->events[i];
+				fputs(",\n{\"name\":", file);
+				_write_json_string(file, event.name);
+				switch (event.type) {
+					case EVENT_ZONE_BEGIN:
+						fputs(",\"ph\":\"B\"", file);
+						break;
+					case EVENT_ZONE_END:
+						fputs(",\"ph\":\"E\"", file);
+						break;
+					case EVENT_FRAME_MARK:
+						fputs(",\"ph\":\"i\",\"s\":\"g\"", file);
+						break;
+				}
+				fprintf(file, ",\"ts\":%llu,\"pid\":1,\"tid\":%llu}", (unsigned long long)event.time, (unsigned long long)tb->thread_id);
+			}
+		}
+	}
+	fputs("\n]}\n", file);
+	fclose(file);
+
+	uint64_t dropped = dropped_events.load(std::memory_order_relaxed);
+	if (dropped) {
+		WARN_PRINT("Trace buffers were full, " + itos(dropped) + " events were dropped.");
+	}
+	return true;
+}
+
+void set_output_path(const char *p_path) {
+	{
+		MutexLock lock(mutex);
+		output_path = p_path;
+	}
+	start();
+}
+
+} // namespace TraceProfiler
+
+void godot_init_profiler() {
+	// Stub; captures are started on demand or with --trace-file.
+}
+
+void godot_cleanup_profiler() {
+	TraceProfiler::stop();
+
+	CharString path;
+	{
+		MutexLock lock(TraceProfiler::mutex);
+		path = TraceProfiler::output_path;
+	}
+	if (path.length()) {
+		TraceProfiler::save(path.get_data());
+	}
+
+	// Nothing may be recorded after this point, as other threads keep pointers to their buffers.
+	TraceProfiler::thread_buffer = nullptr;
+	TraceProfiler::ThreadBuffer *tb = TraceProfiler::thread_buffers.exchange(nullptr, std::memory_order_acq_rel);
+	while (tb) {
+		TraceProfiler::EventBlock *block = tb->first;
+		while (block) {
+			TraceProfiler::EventBlock *next = block->next.load(std::memory_order_relaxed);
+			memdelete(block);
+			block = next;
+		}
+		TraceProfiler::ThreadBuffer *next = tb->next;
+		memdelete(tb);
+		tb = next;
+	}
+}
+
 #else
 void godot_init_profiler() {
 	// Stub
@@ -194,6 +194,81 @@ private:
 void godot_init_profiler();
 void godot_cleanup_profiler();
 
+#elif defined(GODOT_USE_TRACE_PROFILER)
+// Use the built-in profiler, which records events in memory and writes them as Chrome trace event JSON.
+// The result can be opened in chrome://tracing or https://ui.perfetto.dev.
+
+#include "core/typedefs.h"
+
+namespace TraceProfiler {
+
+enum EventType : uint32_t {
+	EVENT_ZONE_BEGIN,
+	EVENT_ZONE_END,
+	EVENT_FRAME_MARK,
+};
+
+// Returns the capture the event was recorded in, or 0 if nothing was recorded (not capturing, or out of space).
+// If p_capture isn't 0, the event is only recorded in that capture.
+// p_name must be a string with static lifetime.
+uint32_t record(const char *p_name, EventType p_type, uint32_t p_capture = 0);
+
+// Starting a capture discards the events of the previous one.
+void start();
+void stop();
+bool is_capturing();
+// Can be called while capturing. p_path is UTF-8.
+bool save(const char *p_path);
+// Starts capturing, and saves to p_path when the profiler is cleaned up.
+void set_output_path(const char *p_path);
+
+class ScopedZone {
+	const char *name = nullptr;
+	uint32_t capture = 0;
+
+public:
+	_FORCE_INLINE_ void begin(const char *p_name) {
+		capture = record(p_name, EVENT_ZONE_BEGIN);
+		name = capture ? p_name : nullptr;
+	}
+
+	// Zones started before the capture are not ended, to keep events balanced.
+	_FORCE_INLINE_ void end() {
+		if (name) {
+			record(name, EVENT_ZONE_END, capture);
+			name = nullptr;
+		}
+	}
+
+	_FORCE_INLINE_ explicit ScopedZone(const char *p_name) {
+		begin(p_name);
+	}
+
+	_FORCE_INLINE_ ~ScopedZone() {
+		end();
+	}
+};
+
+} // namespace TraceProfiler
+
+#define GodotProfileFrameMark TraceProfiler::record("Frame", TraceProfiler::EVENT_FRAME_MARK);
+#define GodotProfileZone(m_zone_name) TraceProfiler::ScopedZone GD_UNIQUE_NAME(__godot_trace_zone_)(m_zone_name)
+#define GodotProfileZoneGroupedFirst(m_group_name, m_zone_name) TraceProfiler::ScopedZone __godot_trace_zone_##m_group_name(m_zone_name)
+#define GodotProfileZoneGroupedEndEarly(m_group_name, m_zone_name) __godot_trace_zone_##m_group_name.end()
+#define GodotProfileZoneGrouped(m_group_name, m_zone_name) \
+	__godot_trace_zone_##m_group_name.end(); \
+	__godot_trace_zone_##m_group_name.begin(m_zone_name)
+
+// Script zones would need their names interned; not supported yet.
+#define GodotProfileZoneScript(m_ptr, m_file, m_function, m_name, m_line)
+#define GodotProfileZoneScriptSystemCall(m_ptr, m_file, m_function, m_name, m_line)
+
+#define GodotProfileAlloc(m_ptr, m_size)
+#define GodotProfileFree(m_ptr)
+
+void godot_init_profiler();
+void godot_cleanup_profiler();
+
 #else
 // No profiling; all macros are stubs.
 
@@ -476,6 +476,8 @@ void unregister_core_types() {
 
 	ResourceLoader::finalize();
 
+	Expression::clear_cache();
+
 	ClassDB::cleanup_defaults();
 	memdelete(_time);
 	ObjectDB::cleanup();
@@ -34,35 +34,186 @@
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 
+// The intern table is split into shards, each owning the buckets whose index matches it.
+// Looking up an existing name doesn't lock: buckets are walked with atomic loads, while
+// inserting and removing entries takes the lock of the shard.
+//
+// Since readers may still be walking an entry when it is removed, removed entries are
+// only retired, and freed once the shard has been observed without any active readers.
 struct StringName::Table {
 	constexpr static uint32_t TABLE_BITS = 16;
 	constexpr static uint32_t TABLE_LEN = 1 << TABLE_BITS;
 	constexpr static uint32_t TABLE_MASK = TABLE_LEN - 1;
 
-	static inline _Data *table[TABLE_LEN];
-	static inline BinaryMutex mutex;
-	static inline PagedAllocator<_Data> allocator;
+	constexpr static uint32_t SHARD_BITS = 6;
+	constexpr static uint32_t SHARD_COUNT = 1 << SHARD_BITS;
+	constexpr static uint32_t SHARD_MASK = SHARD_COUNT - 1;
+
+	struct alignas(64) Shard {
+		BinaryMutex mutex;
+		// Threads currently walking buckets of this shard without the lock.
+		std::atomic<uint32_t> readers = { 0 };
+		// Removed entries that may still be reachable by readers, linked through `prev`.
+		_Data *retired = nullptr;
+	};
+
+	static inline std::atomic<_Data *> table[TABLE_LEN];
+	static Shard shards[SHARD_COUNT];
+	static inline PagedAllocator<_Data, true> allocator;
+
+	_FORCE_INLINE_ static Shard &get_shard(uint32_t p_idx) {
+		return shards[p_idx & SHARD_MASK];
+	}
+
+	// Must be called with the shard locked.
+	static void free_retired(Shard &p_shard) {
+		while (p_shard.retired) {
+			_Data *d = p_shard.retired;
+			p_shard.retired = d->prev;
+			allocator.free(d);
+		}
+	}
+
+	// Finds and references an existing entry, without locking.
+	template <typename T>
+	static _Data *lookup(uint32_t p_hash, const T &p_name) {
+		const uint32_t idx = p_hash & TABLE_MASK;
+		Shard &shard = get_shard(idx);
+
+		shard.readers.fetch_add(1);
+		_Data *d = table[idx].load();
+		while (d) {
+			// Compare hash first.
+			if (d->hash == p_hash && d->name == p_name) {
+				break;
+			}
+			d = d->next.load();
+		}
+		if (d && !d->refcount.ref()) {
+			d = nullptr; // Being removed, let the caller insert a new entry.
+		}
+		shard.readers.fetch_sub(1);
+
+		return d;
+	}
+
+	template <typename T>
+	static _Data *intern(uint32_t p_hash, const T &p_name, bool p_static) {
+		_Data *d = nullptr;
+#ifdef DEBUG_ENABLED
+		// Reference counting for debugging is not atomic, so it needs the lock.
+		if (likely(!debug_stringname))
+#endif
+		{
+			d = lookup(p_hash, p_name);
+			if (d) {
+				if (p_static) {
+					d->static_count.increment();
+				}
+				return d;
+			}
+		}
+
+		const uint32_t idx = p_hash & TABLE_MASK;
+		MutexLock lock(get_shard(idx).mutex);
+
+		// Search again, another thread may have inserted it in the meantime.
+		d = table[idx].load();
+		while (d) {
+			if (d->hash == p_hash && d->name == p_name) {
+				break;
+			}
+			d = d->next.load();
+		}
+
+		if (d && d->refcount.ref()) {
+			// exists
+			if (p_static) {
+				d->static_count.increment();
+			}
+#ifdef DEBUG_ENABLED
+			if (unlikely(debug_stringname)) {
+				d->debug_references++;
+			}
+#endif
+			return d;
+		}
+
+		d = allocator.alloc();
+		d->name = p_name;
+		d->refcount.init();
+		d->static_count.set(p_static ? 1 : 0);
+		d->hash = p_hash;
+		d->prev = nullptr;
+
+#ifdef DEBUG_ENABLED
+		if (unlikely(debug_stringname)) {
+			// Keep in memory, force static.
+			d->refcount.ref();
+			d->static_count.increment();
+		}
+#endif
+
+		_Data *head = table[idx].load();
+		d->next.store(head);
+		if (head) {
+			head->prev = d;
+		}
+		// Publish only once fully initialized, readers may pick it up right away.
+		table[idx].store(d);
+
+		return d;
+	}
+
+	static void remove(_Data *p_data) {
+		const uint32_t idx = p_data->hash & TABLE_MASK;
+		Shard &shard = get_shard(idx);
+		MutexLock lock(shard.mutex);
+
+		_Data *next = p_data->next.load();
+		if (p_data->prev) {
+			p_data->prev->next.store(next);
+		} else {
+			table[idx].store(next);
+		}
+
+		if (next) {
+			next->prev = p_data->prev;
+		}
+
+		// Readers which started before the unlinking may still be walking the entry,
+		// its `next` is left intact so they can carry on.
+		p_data->prev = shard.retired;
+		shard.retired = p_data;
+		if (shard.readers.load() == 0) {
+			free_retired(shard);
+		}
+	}
 };
 
+StringName::Table::Shard StringName::Table::shards[StringName::Table::SHARD_COUNT];
+
 void StringName::setup() {
 	ERR_FAIL_COND(configured);
 	for (uint32_t i = 0; i < Table::TABLE_LEN; i++) {
-		Table::table[i] = nullptr;
+		Table::table[i].store(nullptr);
 	}
 	configured = true;
 }
 
 void StringName::cleanup() {
-	MutexLock lock(Table::mutex);
+	for (uint32_t i = 0; i < Table::SHARD_COUNT; i++) {
+		Table::shards[i].mutex.lock();
+	}
 
 #ifdef DEBUG_ENABLED
 	if (unlikely(debug_stringname)) {
 		Vector<_Data *> data;
 		for (uint32_t i = 0; i < Table::TABLE_LEN; i++) {
-			_Data *d = Table::table[i];
+			_Data *d = Table::table[i].load();
 			while (d) {
 				data.push_back(d);
-				d = d->next;
+				d = d->next.load();
 			}
 		}
 
@@ -86,8 +237,8 @@ void StringName::cleanup() {
 #endif
 	int lost_strings = 0;
 	for (uint32_t i = 0; i < Table::TABLE_LEN; i++) {
-		while (Table::table[i]) {
-			_Data *d = Table::table[i];
+		_Data *d = Table::table[i].load();
+		while (d) {
 			if (d->static_count.get() != d->refcount.get()) {
 				lost_strings++;
 
@@ -96,9 +247,15 @@ void StringName::cleanup() {
 				}
 			}
 
-			Table::table[i] = Table::table[i]->next;
+			_Data *next = d->next.load();
 			Table::allocator.free(d);
+			d = next;
 		}
+		Table::table[i].store(nullptr);
+	}
+	for (uint32_t i = 0; i < Table::SHARD_COUNT; i++) {
+		Table::free_retired(Table::shards[i]);
+		Table::shards[i].mutex.unlock();
 	}
 	if (lost_strings) {
 		print_verbose(vformat("StringName: %d unclaimed string names at exit.", lost_strings));
@@ -110,22 +267,10 @@ void StringName::unref() {
 	ERR_FAIL_COND(!configured);
 
 	if (_data && _data->refcount.unref()) {
-		MutexLock lock(Table::mutex);
-
 		if (CoreGlobals::leak_reporting_enabled && _data->static_count.get() > 0) {
 			ERR_PRINT("BUG: Unreferenced static string to 0: " + _data->name);
 		}
-		if (_data->prev) {
-			_data->prev->next = _data->next;
-		} else {
-			const uint32_t idx = _data->hash & Table::TABLE_MASK;
-			Table::table[idx] = _data->next;
-		}
-
-		if (_data->next) {
-			_data->next->prev = _data->prev;
-		}
-		Table::allocator.free(_data);
+		Table::remove(_data);
 	}
 
 	_data = nullptr;
@@ -210,52 +355,7 @@ StringName::StringName(const char *p_name, bool p_static) {
 		return; //empty, ignore
 	}
 
-	const uint32_t hash = String::hash(p_name);
-	const uint32_t idx = hash & Table::TABLE_MASK;
-
-	MutexLock lock(Table::mutex);
-	_data = Table::table[idx];
-
-	while (_data) {
-		// compare hash first
-		if (_data->hash == hash && _data->name == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = Table::allocator.alloc();
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->next = Table::table[idx];
-	_data->prev = nullptr;
-
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-	if (Table::table[idx]) {
-		Table::table[idx]->prev = _data;
-	}
-	Table::table[idx] = _data;
+	_data = Table::intern(String::hash(p_name), p_name, p_static);
 }
 
 StringName::StringName(const String &p_name, bool p_static) {
@@ -267,51 +367,7 @@ StringName::StringName(const String &p_name, bool p_static) {
 		return;
 	}
 
-	const uint32_t hash = p_name.hash();
-	const uint32_t idx = hash & Table::TABLE_MASK;
-
-	MutexLock lock(Table::mutex);
-	_data = Table::table[idx];
-
-	while (_data) {
-		if (_data->hash == hash && _data->name == p_name) {
-			break;
-		}
-		_data = _data->next;
-	}
-
-	if (_data && _data->refcount.ref()) {
-		// exists
-		if (p_static) {
-			_data->static_count.increment();
-		}
-#ifdef DEBUG_ENABLED
-		if (unlikely(debug_stringname)) {
-			_data->debug_references++;
-		}
-#endif
-		return;
-	}
-
-	_data = Table::allocator.alloc();
-	_data->name = p_name;
-	_data->refcount.init();
-	_data->static_count.set(p_static ? 1 : 0);
-	_data->hash = hash;
-	_data->next = Table::table[idx];
-	_data->prev = nullptr;
-#ifdef DEBUG_ENABLED
-	if (unlikely(debug_stringname)) {
-		// Keep in memory, force static.
-		_data->refcount.ref();
-		_data->static_count.increment();
-	}
-#endif
-
-	if (Table::table[idx]) {
-		Table::table[idx]->prev = _data;
-	}
-	Table::table[idx] = _data;
+	_data = Table::intern(p_name.hash(), p_name, p_static);
 }
 
 bool operator==(const String &p_name, const StringName &p_string_name) {
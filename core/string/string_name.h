@@ -50,7 +50,8 @@ class [[nodiscard]] StringName {
 
 		uint32_t hash = 0;
 		_Data *prev = nullptr;
-		_Data *next = nullptr;
+		// Read without locking when looking up existing names.
+		std::atomic<_Data *> next = nullptr;
 	};
 
 	_Data *_data = nullptr;
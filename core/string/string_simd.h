@@ -0,0 +1,306 @@
+/**************************************************************************/
+/*  string_simd.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/typedefs.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define STRING_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * Vectorized building blocks for the hot loops of String transcoding and searching.
+ *
+ * Every function processes whole blocks with SSE2 (x86) or NEON (ARM64) while the block
+ * is known to be uniform (e.g. all ASCII, no match), then finishes with a scalar loop
+ * starting at the first block that isn't. On other architectures only the scalar loop
+ * runs, so all backends return identical results.
+ */
+namespace StringSIMD {
+
+/// Returns the length of the run of ASCII characters (excluding NUL) at the start of `p_src`,
+/// and widens it to UTF-32 into `p_dst`.
+_FORCE_INLINE_ uint32_t ascii_to_utf32(const uint8_t *p_src, uint32_t p_len, char32_t *p_dst) {
+	uint32_t i = 0;
+#if defined(STRING_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i v = _mm_loadu_si128((const __m128i *)(p_src + i));
+		// Non-ASCII bytes have their top bit set, and so do NUL bytes after comparing with zero.
+		if (_mm_movemask_epi8(_mm_or_si128(v, _mm_cmpeq_epi8(v, zero))) != 0) {
+			break;
+		}
+		const __m128i lo = _mm_unpacklo_epi8(v, zero);
+		const __m128i hi = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *)(p_dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128((__m128i *)(p_dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128((__m128i *)(p_dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+	}
+#elif defined(STRING_SIMD_NEON)
+	for (; i + 16 <= p_len; i += 16) {
+		const uint8x16_t v = vld1q_u8(p_src + i);
+		if (vmaxvq_u8(v) >= 0x80 || vminvq_u8(v) == 0) {
+			break;
+		}
+		const uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+		const uint16x8_t hi = vmovl_high_u8(v);
+		vst1q_u32((uint32_t *)(p_dst + i), vmovl_u16(vget_low_u16(lo)));
+		vst1q_u32((uint32_t *)(p_dst + i + 4), vmovl_high_u16(lo));
+		vst1q_u32((uint32_t *)(p_dst + i + 8), vmovl_u16(vget_low_u16(hi)));
+		vst1q_u32((uint32_t *)(p_dst + i + 12), vmovl_high_u16(hi));
+	}
+#endif
+	for (; i < p_len; i++) {
+		const uint8_t c = p_src[i];
+		if (c == 0 || c >= 0x80) {
+			break;
+		}
+		p_dst[i] = c;
+	}
+	return i;
+}
+
+/// Returns the length of the run of characters at the start of `p_src` that are encoded as
+/// a single byte in UTF-8 (code points up to 0x7F).
+_FORCE_INLINE_ uint32_t utf32_ascii_length(const char32_t *p_src, uint32_t p_len) {
+	uint32_t i = 0;
+#if defined(STRING_SIMD_SSE2)
+	const __m128i high_bits = _mm_set1_epi32(~0x7F);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i *src = (const __m128i *)(p_src + i);
+		const __m128i v = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(src), _mm_loadu_si128(src + 1)), _mm_or_si128(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3)));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(v, high_bits), zero)) != 0xFFFF) {
+			break;
+		}
+	}
+#elif defined(STRING_SIMD_NEON)
+	for (; i + 16 <= p_len; i += 16) {
+		const uint32_t *src = (const uint32_t *)(p_src + i);
+		const uint32x4_t v = vorrq_u32(vorrq_u32(vld1q_u32(src), vld1q_u32(src + 4)), vorrq_u32(vld1q_u32(src + 8), vld1q_u32(src + 12)));
+		if (vmaxvq_u32(v) > 0x7F) {
+			break;
+		}
+	}
+#endif
+	while (i < p_len && uint32_t(p_src[i]) <= 0x7F) {
+		i++;
+	}
+	return i;
+}
+
+/// Narrows `p_len` characters that are all ASCII (see `utf32_ascii_length()`) to bytes.
+_FORCE_INLINE_ void utf32_to_ascii(const char32_t *p_src, uint32_t p_len, uint8_t *p_dst) {
+	uint32_t i = 0;
+#if defined(STRING_SIMD_SSE2)
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i *src = (const __m128i *)(p_src + i);
+		const __m128i lo = _mm_packs_epi32(_mm_loadu_si128(src), _mm_loadu_si128(src + 1));
+		const __m128i hi = _mm_packs_epi32(_mm_loadu_si128(src + 2), _mm_loadu_si128(src + 3));
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_packus_epi16(lo, hi));
+	}
+#elif defined(STRING_SIMD_NEON)
+	for (; i + 16 <= p_len; i += 16) {
+		const uint32_t *src = (const uint32_t *)(p_src + i);
+		const uint16x8_t lo = vcombine_u16(vmovn_u32(vld1q_u32(src)), vmovn_u32(vld1q_u32(src + 4)));
+		const uint16x8_t hi = vcombine_u16(vmovn_u32(vld1q_u32(src + 8)), vmovn_u32(vld1q_u32(src + 12)));
+		vst1q_u8(p_dst + i, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = uint8_t(p_src[i]);
+	}
+}
+
+/// Returns the length of the run of characters at the start of `p_src` that are encoded as
+/// a single, non-surrogate unit in UTF-16 (code points below 0xD800).
+_FORCE_INLINE_ uint32_t utf32_bmp_length(const char32_t *p_src, uint32_t p_len) {
+	uint32_t i = 0;
+#if defined(STRING_SIMD_SSE2)
+	// SSE2 only has signed comparisons, flip the sign bit to compare unsigned values.
+	const __m128i sign = _mm_set1_epi32(INT32_MIN);
+	const __m128i limit = _mm_set1_epi32(int32_t(0xD800 ^ 0x80000000));
+	for (; i + 8 <= p_len; i += 8) {
+		const __m128i *src = (const __m128i *)(p_src + i);
+		const __m128i below_a = _mm_cmplt_epi32(_mm_xor_si128(_mm_loadu_si128(src), sign), limit);
+		const __m128i below_b = _mm_cmplt_epi32(_mm_xor_si128(_mm_loadu_si128(src + 1), sign), limit);
+		if (_mm_movemask_epi8(_mm_and_si128(below_a, below_b)) != 0xFFFF) {
+			break;
+		}
+	}
+#elif defined(STRING_SIMD_NEON)
+	const uint32x4_t limit = vdupq_n_u32(0xD800);
+	for (; i + 8 <= p_len; i += 8) {
+		const uint32_t *src = (const uint32_t *)(p_src + i);
+		if (vmaxvq_u32(vmaxq_u32(vld1q_u32(src), vld1q_u32(src + 4))) >= 0xD800) {
+			break;
+		}
+	}
+#endif
+	while (i < p_len && uint32_t(p_src[i]) < 0xD800) {
+		i++;
+	}
+	return i;
+}
+
+/// Narrows `p_len` characters that are all below 0xD800 (see `utf32_bmp_length()`) to UTF-16 units.
+_FORCE_INLINE_ void utf32_to_utf16_bmp(const char32_t *p_src, uint32_t p_len, char16_t *p_dst) {
+	uint32_t i = 0;
+#if defined(STRING_SIMD_SSE2)
+	// There is no unsigned 32 to 16-bit pack in SSE2, so shift the range to fit a signed pack
+	// and shift it back after (16-bit lanes wrap around).
+	const __m128i bias32 = _mm_set1_epi32(0x8000);
+	const __m128i bias16 = _mm_set1_epi16(INT16_MIN);
+	for (; i + 8 <= p_len; i += 8) {
+		const __m128i *src = (const __m128i *)(p_src + i);
+		const __m128i packed = _mm_packs_epi32(_mm_sub_epi32(_mm_loadu_si128(src), bias32), _mm_sub_epi32(_mm_loadu_si128(src + 1), bias32));
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_add_epi16(packed, bias16));
+	}
+#elif defined(STRING_SIMD_NEON)
+	for (; i + 8 <= p_len; i += 8) {
+		const uint32_t *src = (const uint32_t *)(p_src + i);
+		vst1q_u16((uint16_t *)(p_dst + i), vcombine_u16(vmovn_u32(vld1q_u32(src)), vmovn_u32(vld1q_u32(src + 4))));
+	}
+#endif
+	for (; i < p_len; i++) {
+		p_dst[i] = char16_t(p_src[i]);
+	}
+}
+
+/// Returns the index of the first occurrence of `p_char` in `p_src`, or -1.
+_FORCE_INLINE_ int64_t find_char(const char32_t *p_src, uint64_t p_len, char32_t p_char) {
+	uint64_t i = 0;
+#if defined(STRING_SIMD_SSE2)
+	const __m128i needle = _mm_set1_epi32(int32_t(p_char));
+	for (; i + 16 <= p_len; i += 16) {
+		const __m128i *src = (const __m128i *)(p_src + i);
+		const __m128i eq_lo = _mm_or_si128(_mm_cmpeq_epi32(_mm_loadu_si128(src), needle), _mm_cmpeq_epi32(_mm_loadu_si128(src + 1), needle));
+		const __m128i eq_hi = _mm_or_si128(_mm_cmpeq_epi32(_mm_loadu_si128(src + 2), needle), _mm_cmpeq_epi32(_mm_loadu_si128(src + 3), needle));
+		if (_mm_movemask_epi8(_mm_or_si128(eq_lo, eq_hi)) != 0) {
+			break;
+		}
+	}
+#elif defined(STRING_SIMD_NEON)
+	const uint32x4_t needle = vdupq_n_u32(uint32_t(p_char));
+	for (; i + 16 <= p_len; i += 16) {
+		const uint32_t *src = (const uint32_t *)(p_src + i);
+		const uint32x4_t eq_lo = vorrq_u32(vceqq_u32(vld1q_u32(src), needle), vceqq_u32(vld1q_u32(src + 4), needle));
+		const uint32x4_t eq_hi = vorrq_u32(vceqq_u32(vld1q_u32(src + 8), needle), vceqq_u32(vld1q_u32(src + 12), needle));
+		if (vmaxvq_u32(vorrq_u32(eq_lo, eq_hi)) != 0) {
+			break;
+		}
+	}
+#endif
+	for (; i < p_len; i++) {
+		if (p_src[i] == p_char) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+/// Returns the index of the first occurrence of the sequence `p_seq` (of at least 2 characters)
+/// in `p_src`, or -1. `T` is either `char32_t` or `unsigned char` (Latin-1).
+///
+/// Candidate positions are found by comparing the first and the last character of the
+/// sequence with 4 positions at once, and only those are compared in full.
+template <typename T>
+int64_t find_sequence(const char32_t *p_src, uint64_t p_len, const T *p_seq, uint64_t p_seq_len) {
+	if (p_seq_len > p_len) {
+		return -1;
+	}
+	const uint64_t last = p_seq_len - 1;
+	const uint64_t end = p_len - p_seq_len; // Last candidate position.
+	const char32_t first_char = char32_t(p_seq[0]);
+	const char32_t last_char = char32_t(p_seq[last]);
+
+	uint64_t i = 0;
+#if defined(STRING_SIMD_SSE2) || defined(STRING_SIMD_NEON)
+#if defined(STRING_SIMD_SSE2)
+	const __m128i first = _mm_set1_epi32(int32_t(first_char));
+	const __m128i last_v = _mm_set1_epi32(int32_t(last_char));
+#else
+	const uint32x4_t first = vdupq_n_u32(uint32_t(first_char));
+	const uint32x4_t last_v = vdupq_n_u32(uint32_t(last_char));
+#endif
+	for (; i + 4 <= end + 1; i += 4) {
+		uint32_t mask;
+#if defined(STRING_SIMD_SSE2)
+		const __m128i eq_first = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p_src + i)), first);
+		const __m128i eq_last = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(p_src + i + last)), last_v);
+		mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_and_si128(eq_first, eq_last)));
+#else
+		const uint32x4_t eq = vandq_u32(vceqq_u32(vld1q_u32((const uint32_t *)(p_src + i)), first), vceqq_u32(vld1q_u32((const uint32_t *)(p_src + i + last)), last_v));
+		if (vmaxvq_u32(eq) == 0) {
+			continue;
+		}
+		mask = (vgetq_lane_u32(eq, 0) & 1) | (vgetq_lane_u32(eq, 1) & 2) | (vgetq_lane_u32(eq, 2) & 4) | (vgetq_lane_u32(eq, 3) & 8);
+#endif
+		for (uint32_t lane = 0; mask != 0; lane++, mask >>= 1) {
+			if (mask & 1) {
+				bool match = true;
+				for (uint64_t j = 1; j < last; j++) {
+					if (p_src[i + lane + j] != char32_t(p_seq[j])) {
+						match = false;
+						break;
+					}
+				}
+				if (match) {
+					return i + lane;
+				}
+			}
+		}
+	}
+#endif
+	for (; i <= end; i++) {
+		if (p_src[i] != first_char || p_src[i + last] != last_char) {
+			continue;
+		}
+		bool match = true;
+		for (uint64_t j = 1; j < last; j++) {
+			if (p_src[i + j] != char32_t(p_seq[j])) {
+				match = false;
+				break;
+			}
+		}
+		if (match) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+} // namespace StringSIMD
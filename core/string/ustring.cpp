@@ -43,6 +43,7 @@ STATIC_ASSERT_INCOMPLETE_TYPE(class, Object);
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/string/string_name.h"
+#include "core/string/string_simd.h"
 #include "core/string/translation_server.h"
 #include "core/string/ucaps.h"
 #include "core/variant/variant.h"
@@ -1768,17 +1769,19 @@ Error String::append_utf8(const char *p_utf8, int p_len) {
 
 	while (ptrtmp < ptr_limit && *ptrtmp) {
 		uint8_t c = *ptrtmp;
+
+		if ((c & 0b10000000) == 0) {
+			// Copy the whole run of ASCII characters at once.
+			const uint32_t ascii_length = StringSIMD::ascii_to_utf32(ptrtmp, ptr_limit - ptrtmp, dst);
+			dst += ascii_length;
+			ptrtmp += ascii_length;
+			continue;
+		}
+
 		uint32_t unicode = _replacement_char;
 		uint32_t size = 1;
 
-		if ((c & 0b10000000) == 0) {
-			unicode = c;
-			if (unicode > 0x7F) {
-				unicode = _replacement_char;
-				print_unicode_error(vformat("Invalid unicode codepoint (%d)", unicode), true);
-				result = Error::ERR_INVALID_DATA;
-			}
-		} else if ((c & 0b11100000) == 0b11000000) {
+		if ((c & 0b11100000) == 0b11000000) {
 			if (ptrtmp + 1 >= ptr_limit) {
 				print_unicode_error(vformat("Missing %x UTF-8 continuation byte", c), true);
 				result = Error::ERR_INVALID_DATA;
@@ -1920,10 +1923,18 @@ CharString String::utf8(Vector<uint8_t> *r_ch_length_map) const {
 	int fl = 0;
 	for (int i = 0; i < l; i++) {
 		uint32_t c = d[i];
+		if (c <= 0x7f) { // 7 bits, skip the whole ASCII run.
+			const int ascii_length = StringSIMD::utf32_ascii_length(d + i, l - i);
+			fl += ascii_length;
+			if (map_ptr) {
+				memset(map_ptr + i, 1, ascii_length);
+			}
+			i += ascii_length - 1;
+			continue;
+		}
+
 		int ch_w = 1;
-		if (c <= 0x7f) { // 7 bits.
-			ch_w = 1;
-		} else if (c <= 0x7ff) { // 11 bits
+		if (c <= 0x7ff) { // 11 bits
 			ch_w = 2;
 		} else if (c <= 0xffff) { // 16 bits
 			ch_w = 3;
@@ -1958,8 +1969,11 @@ CharString String::utf8(Vector<uint8_t> *r_ch_length_map) const {
 	for (int i = 0; i < l; i++) {
 		uint32_t c = d[i];
 
-		if (c <= 0x7f) { // 7 bits.
-			APPEND_CHAR(c);
+		if (c <= 0x7f) { // 7 bits, copy the whole ASCII run.
+			const int ascii_length = StringSIMD::utf32_ascii_length(d + i, l - i);
+			StringSIMD::utf32_to_ascii(d + i, ascii_length, cdst);
+			cdst += ascii_length;
+			i += ascii_length - 1;
 		} else if (c <= 0x7ff) { // 11 bits
 			APPEND_CHAR(uint32_t(0xc0 | ((c >> 6) & 0x1f))); // Top 5 bits.
 			APPEND_CHAR(uint32_t(0x80 | (c & 0x3f))); // Bottom 6 bits.
@@ -2129,7 +2143,11 @@ Char16String String::utf16() const {
 	int fl = 0;
 	for (int i = 0; i < l; i++) {
 		uint32_t c = d[i];
-		if (c <= 0xffff) { // 16 bits.
+		if (c < 0xd800) { // 16 bits, skip the whole run of characters below the surrogate range.
+			const int bmp_length = StringSIMD::utf32_bmp_length(d + i, l - i);
+			fl += bmp_length;
+			i += bmp_length - 1;
+		} else if (c <= 0xffff) { // 16 bits.
 			fl += 1;
 			if ((c & 0xfffff800) == 0xd800) {
 				print_unicode_error(vformat("Unpaired surrogate (%x)", c));
@@ -2155,7 +2173,12 @@ Char16String String::utf16() const {
 	for (int i = 0; i < l; i++) {
 		uint32_t c = d[i];
 
-		if (c <= 0xffff) { // 16 bits.
+		if (c < 0xd800) { // 16 bits, copy the whole run of characters below the surrogate range.
+			const int bmp_length = StringSIMD::utf32_bmp_length(d + i, l - i);
+			StringSIMD::utf32_to_utf16_bmp(d + i, bmp_length, (char16_t *)cdst);
+			cdst += bmp_length;
+			i += bmp_length - 1;
+		} else if (c <= 0xffff) { // 16 bits.
 			APPEND_CHAR(c);
 		} else if (c <= 0x10ffff) { // 32 bits.
 			APPEND_CHAR(uint32_t((c >> 10) + 0xd7c0)); // lead surrogate.
@@ -3032,12 +3055,14 @@ int String::find(const String &p_str, int p_from) const {
 		return -1; // Still out of bounds
 	}
 
-	if (p_str.length() == 1) {
+	int64_t index;
+	if (str_len == 1) {
 		// Optimize with single-char implementation.
-		return span().find(p_str[0], p_from);
+		index = StringSIMD::find_char(ptr() + p_from, len - p_from, p_str[0]);
+	} else {
+		index = StringSIMD::find_sequence(ptr() + p_from, len - p_from, p_str.ptr(), str_len);
 	}
-
-	return span().find_sequence(p_str.span(), p_from);
+	return index < 0 ? -1 : index + p_from;
 }
 
 int String::find(const char *p_str, int p_from) const {
@@ -3055,7 +3080,8 @@ int String::find(const char *p_str, int p_from) const {
 		return find_char(*p_str, p_from); // Optimize with single-char find.
 	}
 
-	return span().find_sequence(Span((const unsigned char *)p_str, str_len), p_from);
+	const int64_t index = StringSIMD::find_sequence(ptr() + p_from, len - p_from, (const unsigned char *)p_str, str_len);
+	return index < 0 ? -1 : index + p_from;
 }
 
 int String::find_char(char32_t p_char, int p_from) const {
@@ -3065,7 +3091,8 @@ int String::find_char(char32_t p_char, int p_from) const {
 	if (p_from < 0 || p_from >= length()) {
 		return -1;
 	}
-	return span().find(p_char, p_from);
+	const int64_t index = StringSIMD::find_char(ptr() + p_from, length() - p_from, p_char);
+	return index < 0 ? -1 : index + p_from;
 }
 
 int String::findmk(const Vector<String> &p_keys, int p_from, int *r_key) const {
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "core/math/math_funcs_binary.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/condition_variable.h"
 #include "core/os/mutex.h"
@@ -106,6 +107,8 @@ class CommandQueueMT {
 	/***** BASE *******/
 
 	static const uint32_t DEFAULT_COMMAND_MEM_SIZE_KB = 64;
+	static const uint32_t DEFAULT_RING_SIZE_KB = 256;
+	static const uint64_t RING_WRAP_MARKER = UINT64_MAX;
 
 	inline static thread_local bool flushing = false;
 
@@ -119,6 +122,22 @@ class CommandQueueMT {
 	uint64_t flush_read_ptr = 0;
 	std::atomic<bool> pending{ false };
 
+	// Ring buffer mode (see enable_ring_buffer()).
+	// Positions are byte counters that wrap around at 2^32, the offset in the ring being the position masked by its size.
+	// Each command in command_mem stores the ring position published when it was pushed, so the commands
+	// of both queues run in the order they were pushed in, as long as there was some synchronization
+	// between the threads pushing them.
+	Thread::ID ring_producer = Thread::UNASSIGNED_ID;
+	LocalVector<uint64_t> ring_mem;
+	uint32_t ring_mask = 0;
+	uint32_t ring_write = 0; // Only accessed by the producer.
+	uint32_t ring_read_cache = 0; // Last known read position, only accessed by the producer.
+	uint32_t ring_read = 0; // Only accessed by the thread flushing.
+	std::atomic<uint32_t> ring_published{ 0 };
+	std::atomic<uint32_t> ring_consumed{ 0 };
+	std::atomic<bool> command_mem_pending{ false };
+	bool ring_flushing = false;
+
 	template <typename T, typename... Args>
 	_FORCE_INLINE_ void create_command(Args &&...p_args) {
 		// alloc size is size+T+safeguard
@@ -127,14 +146,55 @@ class CommandQueueMT {
 
 		uint64_t size = command_mem.size();
 		command_mem.resize(size + alloc_size + sizeof(uint64_t));
-		*(uint64_t *)&command_mem[size] = alloc_size;
+		// In ring buffer mode, the upper half keeps the position the ring had reached.
+		*(uint64_t *)&command_mem[size] = ring_mem.is_empty() ? alloc_size : (alloc_size | ((uint64_t)ring_published.load() << 32));
 		void *cmd = &command_mem[size + sizeof(uint64_t)];
 		memnew_placement(cmd, T(std::forward<Args>(p_args)...));
+		if (!ring_mem.is_empty()) {
+			command_mem_pending.store(true);
+		}
 		pending.store(true);
 	}
 
+	// Only called from the producer thread. Returns false if the ring is full.
+	template <typename T, typename... Args>
+	_FORCE_INLINE_ bool _ring_create_command(Args &&...p_args) {
+		constexpr uint32_t alloc_size = ((sizeof(T) + 8U - 1U) & ~(8U - 1U)) + sizeof(uint64_t);
+
+		const uint32_t ring_size = ring_mask + 1;
+		uint32_t offset = ring_write & ring_mask;
+		// Commands must be contiguous, so the tail of the ring is skipped if too small.
+		uint32_t padding = offset + alloc_size > ring_size ? ring_size - offset : 0;
+		if (ring_write + padding + alloc_size - ring_read_cache > ring_size) {
+			ring_read_cache = ring_consumed.load(std::memory_order_acquire);
+			if (ring_write + padding + alloc_size - ring_read_cache > ring_size) {
+				return false;
+			}
+		}
+
+		uint8_t *ring = (uint8_t *)ring_mem.ptr();
+		if (padding) {
+			*(uint64_t *)&ring[offset] = RING_WRAP_MARKER;
+			ring_write += padding;
+			offset = 0;
+		}
+		*(uint64_t *)&ring[offset] = alloc_size;
+		memnew_placement(&ring[offset + sizeof(uint64_t)], T(std::forward<Args>(p_args)...));
+		ring_write += alloc_size;
+
+		// Sequentially consistent, so either the flushing thread sees this command after clearing
+		// the pending flag, or this thread sees the flag cleared and wakes it up.
+		ring_published.store(ring_write);
+		return true;
+	}
+
 	template <typename T, bool NeedsSync, typename... Args>
 	_FORCE_INLINE_ void _push_internal(Args &&...args) {
+		if (ring_producer != Thread::UNASSIGNED_ID && Thread::get_caller_id() == ring_producer) {
+			_ring_push_internal<T, NeedsSync>(std::forward<Args>(args)...);
+			return;
+		}
+
 		MutexLock mlock(mutex);
 		create_command<T>(std::forward<Args>(args)...);
 
@@ -148,6 +208,40 @@ class CommandQueueMT {
 		}
 	}
 
+	template <typename T, bool NeedsSync, typename... Args>
+	_FORCE_INLINE_ void _ring_push_internal(Args &&...args) {
+		if constexpr (NeedsSync) {
+			// Sync commands are counted before they can be run, which needs the lock anyway.
+			MutexLock mlock(mutex);
+			sync_tail++;
+			if (!_ring_create_command<T>(std::forward<Args>(args)...)) {
+				create_command<T>(std::forward<Args>(args)...);
+			}
+			pending.store(true);
+			if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {
+				WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);
+			}
+			_wait_for_sync(mlock);
+		} else {
+			if (unlikely(!_ring_create_command<T>(std::forward<Args>(args)...))) {
+				// The ring is full, so go through the locked queue. The order is kept.
+				MutexLock mlock(mutex);
+				create_command<T>(std::forward<Args>(args)...);
+				if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {
+					WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);
+				}
+				return;
+			}
+			// Only wake up the flushing thread if it may have run out of commands, instead of once per command.
+			if (!pending.load()) {
+				pending.store(true);
+				if (pump_task_id != WorkerThreadPool::INVALID_TASK_ID) {
+					WorkerThreadPool::get_singleton()->notify_yield_over(pump_task_id);
+				}
+			}
+		}
+	}
+
 	_FORCE_INLINE_ void _prevent_sync_wraparound() {
 		bool safe_to_reset = !sync_awaiters;
 		bool already_sync_to_latest = sync_head == sync_tail;
@@ -163,6 +257,11 @@ class CommandQueueMT {
 			return;
 		}
 
+		if (!ring_mem.is_empty()) {
+			_flush_ring();
+			return;
+		}
+
 		flushing = true;
 
 		MutexLock lock(mutex);
@@ -213,6 +312,129 @@ class CommandQueueMT {
 		flushing = false;
 	}
 
+	// Runs the commands in command_mem that were pushed before the ring reached its current read position.
+	// Returns whether any was run.
+	bool _flush_command_mem_to_ring_read() {
+		MutexLock lock(mutex);
+		bool flushed = false;
+
+		alignas(uint64_t) char cmd_local_mem[MAX_COMMAND_SIZE];
+
+		while (flush_read_ptr < command_mem.size()) {
+			uint64_t header = *(uint64_t *)&command_mem[flush_read_ptr];
+			if ((int32_t)((uint32_t)(header >> 32) - ring_read) > 0) {
+				// Ring commands pushed before this one must run first.
+				break;
+			}
+			uint64_t size = header & UINT32_MAX;
+			flush_read_ptr += sizeof(uint64_t);
+
+			// See _flush() about copying the command.
+			CommandBase *cmd_original = reinterpret_cast<CommandBase *>(&command_mem[flush_read_ptr]);
+			CommandBase *cmd_local = reinterpret_cast<CommandBase *>(cmd_local_mem);
+			memcpy(cmd_local_mem, (char *)cmd_original, size);
+
+			lock.temp_unlock();
+			cmd_local->call();
+			lock.temp_relock();
+
+			if (unlikely(cmd_local->sync)) {
+				sync_head++;
+				lock.temp_unlock(); // Give an opportunity to awaiters right away.
+				sync_cond_var.notify_all();
+				lock.temp_relock();
+			}
+
+			cmd_local->~CommandBase();
+
+			flush_read_ptr += size;
+			flushed = true;
+		}
+
+		if (flush_read_ptr == command_mem.size()) {
+			command_mem.clear();
+			flush_read_ptr = 0;
+			command_mem_pending.store(false);
+		}
+
+		return flushed;
+	}
+
+	void _flush_ring() {
+		flushing = true;
+
+		{
+			MutexLock lock(mutex);
+			if (unlikely(ring_flushing)) {
+				// Another thread is flushing.
+				lock.temp_unlock(); // Not really temp.
+				sync();
+				flushing = false;
+				return;
+			}
+			ring_flushing = true;
+		}
+
+		uint8_t *ring = (uint8_t *)ring_mem.ptr();
+		bool clearing_pending = false;
+
+		while (true) {
+			// Loaded first, so commands pushed to command_mem before any of the ones seen here are seen too.
+			uint32_t published = ring_published.load();
+
+			bool flushed = false;
+			if (command_mem_pending.load()) {
+				flushed = _flush_command_mem_to_ring_read();
+			}
+
+			if (ring_read != published) {
+				uint32_t offset = ring_read & ring_mask;
+				uint64_t size = *(uint64_t *)&ring[offset];
+				if (size == RING_WRAP_MARKER) {
+					ring_read += ring_mask + 1 - offset;
+				} else {
+					// Ring commands stay in place while running, the producer can't reuse their space yet.
+					CommandBase *cmd = reinterpret_cast<CommandBase *>(&ring[offset + sizeof(uint64_t)]);
+					cmd->call();
+
+					if (unlikely(cmd->sync)) {
+						MutexLock lock(mutex);
+						sync_head++;
+						lock.temp_unlock(); // Give an opportunity to awaiters right away.
+						sync_cond_var.notify_all();
+					}
+
+					cmd->~CommandBase();
+					ring_read += size;
+				}
+				ring_consumed.store(ring_read, std::memory_order_release);
+				clearing_pending = false;
+				continue;
+			}
+
+			if (flushed || ring_published.load() != ring_read) {
+				clearing_pending = false;
+				continue;
+			}
+
+			if (!clearing_pending) {
+				// Clear the flag and check once more, so either a push done meanwhile is seen or its pusher wakes this thread up.
+				pending.store(false);
+				clearing_pending = true;
+			} else if (!command_mem_pending.load()) {
+				break;
+			}
+		}
+
+		{
+			MutexLock lock(mutex);
+			ring_flushing = false;
+			_prevent_sync_wraparound();
+		}
+
+		flushing = false;
+	}
+
 	_FORCE_INLINE_ void _wait_for_sync(MutexLock<BinaryMutex> &p_lock) {
 		sync_awaiters++;
 		uint32_t sync_head_goal = sync_tail;
@@ -275,6 +497,18 @@ public:
 		pump_task_id = p_task_id;
 	}
 
+	// Commands pushed from p_producer_thread go through a lock-free ring buffer instead of the locked queue,
+	// and only wake the pump task up when it may have run out of commands. Other threads can still push
+	// commands as usual. Must be called before any command is pushed.
+	void enable_ring_buffer(Thread::ID p_producer_thread, uint32_t p_size_kb = DEFAULT_RING_SIZE_KB) {
+		MutexLock lock(mutex);
+		ERR_FAIL_COND_MSG(pending.load() || !ring_mem.is_empty(), "The ring buffer must be enabled before pushing any command.");
+		uint32_t size = Math::next_power_of_2(MAX(p_size_kb * 1024, (uint32_t)MAX_COMMAND_SIZE * 4));
+		ring_mem.resize(size / sizeof(uint64_t));
+		ring_mask = size - 1;
+		ring_producer = p_producer_thread;
+	}
+
 	CommandQueueMT() {
 		command_mem.reserve(DEFAULT_COMMAND_MEM_SIZE_KB * 1024);
 	}
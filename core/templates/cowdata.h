@@ -32,6 +32,7 @@
 
 #include "core/error/error_macros.h"
 #include "core/os/memory.h"
+#include "core/os/small_block_cache.h"
 #include "core/string/print_string.h"
 #include "core/templates/safe_refcount.h"
 #include "core/templates/span.h"
@@ -72,10 +73,42 @@ private:
 	static constexpr size_t SIZE_OFFSET = Memory::get_aligned_address(CAPACITY_OFFSET + sizeof(USize), alignof(USize));
 	static constexpr size_t DATA_OFFSET = Memory::get_aligned_address(SIZE_OFFSET + sizeof(USize), Memory::MAX_ALIGN);
 
+	// Buffers of string types that fit in a SmallBlockCache block are recycled per thread, as short
+	// strings are created and destroyed at a very high rate.
+	// Any buffer with a capacity of at most CACHED_CAPACITY is a cached block, of the block size for that capacity.
+	static constexpr USize CACHED_CAPACITY = (std::is_same_v<T, char32_t> || std::is_same_v<T, char>) ? (SmallBlockCache::MAX_BLOCK_SIZE - DATA_OFFSET) / sizeof(T) : 0;
+
 	mutable T *_ptr = nullptr;
 
 	// internal helpers
 
+	static _FORCE_INLINE_ bool _is_cached_capacity(USize p_capacity) {
+		if constexpr (CACHED_CAPACITY > 0) {
+			return p_capacity <= CACHED_CAPACITY;
+		} else {
+			return false;
+		}
+	}
+
+	static _FORCE_INLINE_ size_t _get_buffer_size(USize p_capacity) {
+		return p_capacity * sizeof(T) + DATA_OFFSET;
+	}
+
+	static _FORCE_INLINE_ uint8_t *_alloc_buffer(USize p_capacity) {
+		if (_is_cached_capacity(p_capacity)) {
+			return (uint8_t *)SmallBlockCache::alloc(_get_buffer_size(p_capacity));
+		}
+		return (uint8_t *)Memory::alloc_static(_get_buffer_size(p_capacity), false);
+	}
+
+	static _FORCE_INLINE_ void _free_buffer(uint8_t *p_mem, USize p_capacity) {
+		if (_is_cached_capacity(p_capacity)) {
+			SmallBlockCache::free(p_mem, _get_buffer_size(p_capacity));
+		} else {
+			Memory::free_static(p_mem, false);
+		}
+	}
+
 	static constexpr _FORCE_INLINE_ USize grow_capacity(USize p_previous_capacity) {
 		// 1.5x the given size.
 		// This ratio was chosen because it is close to the ideal growth rate of the golden ratio.
@@ -243,6 +276,7 @@ void CowData<T>::_unref() {
 	//          which is illegal after some of the elements in it have already been destructed, and
 	//          may lead to a segmentation fault.
 	USize current_size = size();
+	USize prev_capacity = capacity();
 	T *prev_ptr = _ptr;
 	_ptr = nullptr;
 
@@ -252,7 +286,7 @@ void CowData<T>::_unref() {
 	DEV_ASSERT(!_ptr);
 
 	// Free Memory.
-	Memory::free_static((uint8_t *)prev_ptr - DATA_OFFSET, false);
+	_free_buffer((uint8_t *)prev_ptr - DATA_OFFSET, prev_capacity);
 
 #ifdef DEBUG_ENABLED
 	// If any destructors access us through pointers, it is a bug.
@@ -464,7 +498,7 @@ template <typename T>
 Error CowData<T>::_alloc_exact(USize p_capacity) {
 	DEV_ASSERT(!_ptr);
 
-	uint8_t *mem_new = (uint8_t *)Memory::alloc_static(p_capacity * sizeof(T) + DATA_OFFSET, false);
+	uint8_t *mem_new = _alloc_buffer(p_capacity);
 	ERR_FAIL_NULL_V(mem_new, ERR_OUT_OF_MEMORY);
 
 	_ptr = _get_data_ptr(mem_new);
@@ -482,7 +516,25 @@ template <typename T>
 Error CowData<T>::_realloc_exact(USize p_capacity) {
 	DEV_ASSERT(_ptr);
 
-	uint8_t *mem_new = (uint8_t *)Memory::realloc_static(((uint8_t *)_ptr) - DATA_OFFSET, p_capacity * sizeof(T) + DATA_OFFSET, false);
+	uint8_t *mem_new;
+	if (_is_cached_capacity(p_capacity) || _is_cached_capacity(capacity())) {
+		if (_is_cached_capacity(p_capacity) && _is_cached_capacity(capacity()) && SmallBlockCache::get_block_size(_get_buffer_size(p_capacity)) == SmallBlockCache::get_block_size(_get_buffer_size(capacity()))) {
+			// Already in a cached block of that size.
+			*_get_capacity() = p_capacity;
+			return OK;
+		}
+
+		// Cached blocks can't be reallocated, move the data over (element types of cached buffers are trivial).
+		uint8_t *mem_old = ((uint8_t *)_ptr) - DATA_OFFSET;
+		mem_new = _alloc_buffer(p_capacity);
+		ERR_FAIL_NULL_V(mem_new, ERR_OUT_OF_MEMORY);
+
+		// When shrinking, the size is only updated by the caller after this.
+		memcpy(mem_new, mem_old, DATA_OFFSET + MIN((USize)size(), p_capacity) * sizeof(T));
+		_free_buffer(mem_old, capacity());
+	} else {
+		mem_new = (uint8_t *)Memory::realloc_static(((uint8_t *)_ptr) - DATA_OFFSET, _get_buffer_size(p_capacity), false);
+	}
 	ERR_FAIL_NULL_V(mem_new, ERR_OUT_OF_MEMORY);
 
 	_ptr = _get_data_ptr(mem_new);
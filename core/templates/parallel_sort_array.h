@@ -0,0 +1,170 @@
+/**************************************************************************/
+/*  parallel_sort_array.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/sort_array.h"
+
+// Sorts large arrays over the WorkerThreadPool: the array is split in one chunk per thread,
+// chunks are sorted in parallel with SortArray, then merged pairwise. Every merge round is
+// split in as many tasks as there are chunks, so that all threads keep working until the end.
+//
+// Like SortArray, the sort is not stable, and Comparator must be safe to call from several
+// threads at once. Needs a temporary buffer as large as the array. Small arrays, calls without
+// a thread pool, and calls from a task of the pool (waiting for the group tasks there could
+// deadlock the pool) fall back to SortArray on the calling thread.
+template <typename T, typename Comparator = Comparator<T>, bool Validate = SORT_ARRAY_VALIDATE_ENABLED>
+class ParallelSortArray {
+	static constexpr int64_t MIN_ELEMENTS_PER_CHUNK = 16384;
+
+	struct SortState {
+		T *buffers[2] = {};
+		int64_t len = 0;
+		uint32_t chunk_count = 0;
+		bool chunks_to_temp = false; // Move sorted chunks to the temporary buffer, so merging ends in the array.
+		uint32_t source = 0; // Buffer merged from in the current round.
+		uint32_t run_count = 0; // Sorted runs in the source buffer in the current round.
+	};
+
+	_FORCE_INLINE_ int64_t _get_chunk_begin(const SortState *p_state, uint32_t p_chunk) const {
+		return p_state->len * p_chunk / p_state->chunk_count;
+	}
+
+	void _sort_chunk(uint32_t p_index, SortState *p_state) {
+		const int64_t begin = _get_chunk_begin(p_state, p_index);
+		const int64_t end = _get_chunk_begin(p_state, p_index + 1);
+
+		SortArray<T, Comparator, Validate> sorter{ compare };
+		sorter.sort(p_state->buffers[0] + begin, end - begin);
+
+		if (p_state->chunks_to_temp) {
+			for (int64_t i = begin; i < end; i++) {
+				p_state->buffers[1][i] = std::move(p_state->buffers[0][i]);
+			}
+		}
+	}
+
+	// Returns how many elements of A are among the first p_count elements of the merge of A and B.
+	int64_t _get_merge_split(const T *p_a, int64_t p_a_len, const T *p_b, int64_t p_b_len, int64_t p_count) const {
+		int64_t low = MAX(int64_t(0), p_count - p_b_len);
+		int64_t high = MIN(p_count, p_a_len);
+		while (low < high) {
+			const int64_t a_taken = (low + high) / 2;
+			const int64_t b_taken = p_count - a_taken;
+			if (b_taken > 0 && a_taken < p_a_len && !compare(p_b[b_taken - 1], p_a[a_taken])) {
+				low = a_taken + 1; // A[a_taken] is merged before B[b_taken - 1], take more from A.
+			} else {
+				high = a_taken;
+			}
+		}
+		return low;
+	}
+
+	void _merge_part(uint32_t p_index, SortState *p_state) {
+		const uint32_t pair_count = p_state->run_count / 2;
+		const uint32_t parts_per_pair = p_state->chunk_count / pair_count;
+		const uint32_t chunks_per_run = p_state->chunk_count / p_state->run_count;
+		const uint32_t pair = p_index / parts_per_pair;
+		const uint32_t part = p_index % parts_per_pair;
+
+		const int64_t a_begin = _get_chunk_begin(p_state, pair * 2 * chunks_per_run);
+		const int64_t b_begin = _get_chunk_begin(p_state, (pair * 2 + 1) * chunks_per_run);
+		const int64_t b_end = _get_chunk_begin(p_state, (pair * 2 + 2) * chunks_per_run);
+
+		T *src = p_state->buffers[p_state->source];
+		T *dst = p_state->buffers[p_state->source ^ 1] + a_begin;
+		T *a = src + a_begin;
+		T *b = src + b_begin;
+		const int64_t a_len = b_begin - a_begin;
+		const int64_t b_len = b_end - b_begin;
+
+		const int64_t out_begin = (a_len + b_len) * part / parts_per_pair;
+		const int64_t out_end = (a_len + b_len) * (part + 1) / parts_per_pair;
+		int64_t i = _get_merge_split(a, a_len, b, b_len, out_begin);
+		int64_t j = out_begin - i;
+		const int64_t i_end = _get_merge_split(a, a_len, b, b_len, out_end);
+		const int64_t j_end = out_end - i_end;
+
+		for (int64_t k = out_begin; k < out_end; k++) {
+			if (j >= j_end || (i < i_end && !compare(b[j], a[i]))) {
+				dst[k] = std::move(a[i++]);
+			} else {
+				dst[k] = std::move(b[j++]);
+			}
+		}
+	}
+
+public:
+	Comparator compare;
+
+	void sort(T *p_array, int64_t p_len) {
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+
+		uint32_t chunk_count = 1;
+		if (pool && pool->get_thread_index() == -1) {
+			// Use a power of two, so that runs can always be merged in pairs.
+			const int64_t max_chunk_count = p_len / MIN_ELEMENTS_PER_CHUNK;
+			while (chunk_count < (uint32_t)pool->get_thread_count() && chunk_count * 2 <= max_chunk_count) {
+				chunk_count *= 2;
+			}
+		}
+
+		if (chunk_count == 1) {
+			SortArray<T, Comparator, Validate> sorter{ compare };
+			sorter.sort(p_array, p_len);
+			return;
+		}
+
+		uint32_t rounds = 0;
+		while ((1u << rounds) < chunk_count) {
+			rounds++;
+		}
+
+		SortState state;
+		state.buffers[0] = p_array;
+		state.buffers[1] = memnew_arr(T, p_len);
+		state.len = p_len;
+		state.chunk_count = chunk_count;
+		state.chunks_to_temp = rounds % 2 == 1;
+
+		WorkerThreadPool::GroupID group = pool->add_template_group_task(this, &ParallelSortArray::_sort_chunk, &state, chunk_count, -1, true, SNAME("ParallelSortArray"));
+		pool->wait_for_group_task_completion(group);
+
+		state.source = state.chunks_to_temp ? 1 : 0;
+		for (state.run_count = chunk_count; state.run_count > 1; state.run_count /= 2) {
+			group = pool->add_template_group_task(this, &ParallelSortArray::_merge_part, &state, chunk_count, -1, true, SNAME("ParallelSortArray"));
+			pool->wait_for_group_task_completion(group);
+			state.source ^= 1;
+		}
+
+		memdelete_arr(state.buffers[1]);
+	}
+};
@@ -0,0 +1,132 @@
+/**************************************************************************/
+/*  radix_sort.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/memory.h"
+#include "core/typedefs.h"
+
+#include <cstring>
+#include <type_traits>
+
+// Default key extractor of RadixSort, for integer and floating-point types.
+// Keys are unsigned integers which sort in the same order as the original values.
+template <typename T>
+struct RadixSortKey {
+	static_assert(std::is_arithmetic_v<T>, "RadixSortKey only supports arithmetic types, provide a custom key extractor instead.");
+
+	using Key = std::conditional_t<sizeof(T) == 1, uint8_t, std::conditional_t<sizeof(T) == 2, uint16_t, std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+	static constexpr Key SIGN_BIT = Key(Key(1) << (sizeof(Key) * 8 - 1));
+
+	_FORCE_INLINE_ Key operator()(const T &p_value) const {
+		if constexpr (std::is_floating_point_v<T>) {
+			Key bits;
+			memcpy(&bits, &p_value, sizeof(T));
+			// Flip all bits of negative numbers (so larger magnitudes sort first), and only the sign bit of positive ones.
+			// NaNs sort after positive infinity, or before negative infinity if their sign bit is set.
+			return (bits & SIGN_BIT) ? Key(~bits) : Key(bits | SIGN_BIT);
+		} else if constexpr (std::is_signed_v<T>) {
+			return Key(Key(p_value) ^ SIGN_BIT);
+		} else {
+			return Key(p_value);
+		}
+	}
+};
+
+// Stable least-significant-digit radix sort, one byte of the key per pass.
+// Runs in O(n) and is considerably faster than SortArray on large arrays of numbers, but needs
+// a scratch buffer as large as the array. Passes over bytes which are equal in all keys are skipped.
+//
+// KeyExtractor maps an element to an unsigned integer key, it must define the `Key` type.
+// Elements are moved with memcpy, so they must be trivially copyable.
+template <typename T, typename KeyExtractor = RadixSortKey<T>>
+class RadixSort {
+	static_assert(std::is_trivially_copyable_v<T>, "RadixSort only supports trivially copyable types.");
+
+	using Key = typename KeyExtractor::Key;
+	static_assert(std::is_unsigned_v<Key>, "RadixSort keys must be unsigned integers.");
+
+	static constexpr uint32_t PASSES = sizeof(Key);
+
+public:
+	KeyExtractor get_key;
+
+	// Sorts using p_scratch, which must have room for p_len elements, as temporary storage.
+	void sort(T *p_array, int64_t p_len, T *p_scratch) const {
+		if (p_len < 2) {
+			return;
+		}
+
+		// Count all digits at once, so each following pass only has to scatter the elements.
+		int64_t histograms[PASSES][256] = {};
+		for (int64_t i = 0; i < p_len; i++) {
+			const Key key = get_key(p_array[i]);
+			for (uint32_t pass = 0; pass < PASSES; pass++) {
+				histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+			}
+		}
+
+		T *src = p_array;
+		T *dst = p_scratch;
+		for (uint32_t pass = 0; pass < PASSES; pass++) {
+			int64_t *histogram = histograms[pass];
+			const uint32_t shift = pass * 8;
+			if (histogram[(get_key(src[0]) >> shift) & 0xFF] == p_len) {
+				continue; // All keys have the same digit, this pass would not move anything.
+			}
+
+			int64_t offset = 0;
+			for (uint32_t digit = 0; digit < 256; digit++) {
+				const int64_t count = histogram[digit];
+				histogram[digit] = offset;
+				offset += count;
+			}
+
+			for (int64_t i = 0; i < p_len; i++) {
+				const uint32_t digit = (get_key(src[i]) >> shift) & 0xFF;
+				memcpy((void *)&dst[histogram[digit]++], (const void *)&src[i], sizeof(T));
+			}
+			SWAP(src, dst);
+		}
+
+		if (src != p_array) {
+			memcpy((void *)p_array, (const void *)src, p_len * sizeof(T));
+		}
+	}
+
+	void sort(T *p_array, int64_t p_len) const {
+		if (p_len < 2) {
+			return;
+		}
+		T *scratch = (T *)memalloc(p_len * sizeof(T));
+		sort(p_array, p_len, scratch);
+		memfree(scratch);
+	}
+};
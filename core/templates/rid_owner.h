@@ -106,32 +106,112 @@ class RID_Alloc : public RID_AllocBase {
 
 	mutable Mutex mutex;
 
+	// When thread safe, free_list_chunks holds, for each free element, the index of the next free one,
+	// and this is the head of that list, along with a counter of changes to avoid ABA problems.
+	// Allocating and freeing are lock-free, the mutex is only taken to add chunks.
+	static constexpr uint32_t FREE_LIST_END = 0xFFFFFFFF;
+	std::atomic<uint64_t> free_list_head = { FREE_LIST_END };
+
+	_FORCE_INLINE_ static std::atomic<uint32_t> &_atomic(uint32_t &r_value) {
+		return *(std::atomic<uint32_t> *)&r_value;
+	}
+
+	// Pushes the elements linked from p_first to p_last to the free list.
+	_FORCE_INLINE_ void _push_free_list(uint32_t p_first, uint32_t p_last) {
+		uint64_t head = free_list_head.load(std::memory_order_relaxed);
+		uint64_t new_head;
+		do {
+			_atomic(free_list_chunks[p_last / elements_in_chunk][p_last % elements_in_chunk]).store(uint32_t(head), std::memory_order_relaxed);
+			new_head = (((head >> 32) + 1) << 32) | p_first;
+		} while (!free_list_head.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	bool _add_free_chunk() {
+		MutexLock lock(mutex);
+
+		if (uint32_t(free_list_head.load(std::memory_order_acquire)) != FREE_LIST_END) {
+			return true; // Another thread added one, or elements were freed.
+		}
+
+		uint32_t chunk_count = max_alloc / elements_in_chunk;
+		if (chunk_count == chunk_limit) {
+			if (description != nullptr) {
+				ERR_FAIL_V_MSG(false, vformat("Element limit for RID of type '%s' reached.", String(description)));
+			} else {
+				ERR_FAIL_V_MSG(false, "Element limit reached.");
+			}
+		}
+
+		chunks[chunk_count] = (Chunk *)memalloc(sizeof(Chunk) * elements_in_chunk); //but don't initialize
+		free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
+
+		for (uint32_t i = 0; i < elements_in_chunk; i++) {
+			// Don't initialize chunk.
+			chunks[chunk_count][i].validator = 0xFFFFFFFF;
+			free_list_chunks[chunk_count][i] = max_alloc + i + 1;
+		}
+
+		// Store atomically to avoid data race with the load in get_or_null().
+		uint32_t first = max_alloc;
+		_atomic(max_alloc).store(max_alloc + elements_in_chunk, std::memory_order_release);
+		_push_free_list(first, first + elements_in_chunk - 1);
+		return true;
+	}
+
+	RID _allocate_rid_lock_free() {
+		uint32_t free_index;
+		uint64_t head = free_list_head.load(std::memory_order_acquire);
+		while (true) {
+			free_index = uint32_t(head);
+			if (unlikely(free_index == FREE_LIST_END)) {
+				if (!_add_free_chunk()) {
+					return RID();
+				}
+				head = free_list_head.load(std::memory_order_acquire);
+				continue;
+			}
+			// May be stale if another thread took this element meanwhile, but then the exchange fails.
+			uint32_t next = _atomic(free_list_chunks[free_index / elements_in_chunk][free_index % elements_in_chunk]).load(std::memory_order_relaxed);
+			uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+			if (free_list_head.compare_exchange_weak(head, new_head, std::memory_order_acquire, std::memory_order_acquire)) {
+				break;
+			}
+		}
+
+		uint32_t validator = 1 + (uint32_t)(_gen_id() % 0x7FFFFFFF);
+		uint64_t id = validator;
+		id <<= 32;
+		id |= free_index;
+
+		_atomic(chunks[free_index / elements_in_chunk][free_index % elements_in_chunk].validator).store(validator | 0x80000000, std::memory_order_relaxed); //mark uninitialized bit
+
+		_atomic(alloc_count).fetch_add(1, std::memory_order_relaxed);
+
+		return _make_from_id(id);
+	}
+
+	_FORCE_INLINE_ uint32_t _get_validator(uint32_t p_index) const {
+		uint32_t &validator = chunks[p_index / elements_in_chunk][p_index % elements_in_chunk].validator;
+		if constexpr (THREAD_SAFE) {
+			return _atomic(validator).load(std::memory_order_relaxed);
+		}
+		return validator;
+	}
+
 	_FORCE_INLINE_ RID _allocate_rid() {
 		if constexpr (THREAD_SAFE) {
-			mutex.lock();
+			return _allocate_rid_lock_free();
 		}
 
 		if (alloc_count == max_alloc) {
 			//allocate a new chunk
 			uint32_t chunk_count = alloc_count == 0 ? 0 : (max_alloc / elements_in_chunk);
-			if (THREAD_SAFE && chunk_count == chunk_limit) {
-				mutex.unlock();
-				if (description != nullptr) {
-					ERR_FAIL_V_MSG(RID(), vformat("Element limit for RID of type '%s' reached.", String(description)));
-				} else {
-					ERR_FAIL_V_MSG(RID(), "Element limit reached.");
-				}
-			}
 
 			//grow chunks
-			if constexpr (!THREAD_SAFE) {
-				chunks = (Chunk **)memrealloc(chunks, sizeof(Chunk *) * (chunk_count + 1));
-			}
+			chunks = (Chunk **)memrealloc(chunks, sizeof(Chunk *) * (chunk_count + 1));
 			chunks[chunk_count] = (Chunk *)memalloc(sizeof(Chunk) * elements_in_chunk); //but don't initialize
 			//grow free lists
-			if constexpr (!THREAD_SAFE) {
-				free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
-			}
+			free_list_chunks = (uint32_t **)memrealloc(free_list_chunks, sizeof(uint32_t *) * (chunk_count + 1));
 			free_list_chunks[chunk_count] = (uint32_t *)memalloc(sizeof(uint32_t) * elements_in_chunk);
 
 			//initialize
@@ -141,12 +221,7 @@ class RID_Alloc : public RID_AllocBase {
 				free_list_chunks[chunk_count][i] = alloc_count + i;
 			}
 
-			if constexpr (THREAD_SAFE) {
-				// Store atomically to avoid data race with the load in get_or_null().
-				((std::atomic<uint32_t> *)&max_alloc)->store(max_alloc + elements_in_chunk, std::memory_order_relaxed);
-			} else {
-				max_alloc += elements_in_chunk;
-			}
+			max_alloc += elements_in_chunk;
 		}
 
 		uint32_t free_index = free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk];
@@ -164,10 +239,6 @@ class RID_Alloc : public RID_AllocBase {
 
 		alloc_count++;
 
-		if constexpr (THREAD_SAFE) {
-			mutex.unlock();
-		}
-
 		return _make_from_id(id);
 	}
 
@@ -200,8 +271,8 @@ public:
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
 		uint32_t ma;
-		if constexpr (THREAD_SAFE) { // Read atomically to avoid data race with the store in _allocate_rid().
-			ma = ((std::atomic<uint32_t> *)&max_alloc)->load(std::memory_order_relaxed);
+		if constexpr (THREAD_SAFE) { // Read atomically to avoid data race with the store in _add_free_chunk().
+			ma = _atomic(max_alloc).load(std::memory_order_acquire);
 		} else {
 			ma = max_alloc;
 		}
@@ -231,19 +302,25 @@ public:
 #endif
 		}
 
+		uint32_t chunk_validator = _get_validator(idx);
+
 		if (unlikely(p_initialize)) {
-			if (unlikely(!(c.validator & 0x80000000))) {
+			if (unlikely(!(chunk_validator & 0x80000000))) {
 				ERR_FAIL_V_MSG(nullptr, "Initializing already initialized RID");
 			}
 
-			if (unlikely((c.validator & 0x7FFFFFFF) != validator)) {
+			if (unlikely((chunk_validator & 0x7FFFFFFF) != validator)) {
 				ERR_FAIL_V_MSG(nullptr, "Attempting to initialize the wrong RID");
 			}
 
-			c.validator &= 0x7FFFFFFF; //initialized
+			if constexpr (THREAD_SAFE) {
+				_atomic(c.validator).fetch_and(0x7FFFFFFF, std::memory_order_relaxed); //initialized
+			} else {
+				c.validator &= 0x7FFFFFFF; //initialized
+			}
 
-		} else if (unlikely(c.validator != validator)) {
-			if ((c.validator & 0x80000000) && c.validator != 0xFFFFFFFF) {
+		} else if (unlikely(chunk_validator != validator)) {
+			if ((chunk_validator & 0x80000000) && chunk_validator != 0xFFFFFFFF) {
 				ERR_FAIL_V_MSG(nullptr, "Attempting to use an uninitialized RID");
 			}
 			return nullptr;
@@ -300,16 +377,15 @@ public:
 	}
 
 	_FORCE_INLINE_ bool owns(const RID &p_rid) const {
-		if constexpr (THREAD_SAFE) {
-			mutex.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if constexpr (THREAD_SAFE) {
-				mutex.unlock();
-			}
+		uint32_t ma;
+		if constexpr (THREAD_SAFE) {
+			ma = _atomic(const_cast<uint32_t &>(max_alloc)).load(std::memory_order_acquire);
+		} else {
+			ma = max_alloc;
+		}
+		if (unlikely(idx >= ma)) {
 			return false;
 		}
 
@@ -318,26 +394,26 @@ public:
 
 		uint32_t validator = uint32_t(id >> 32);
 
-		bool owned = (chunks[idx_chunk][idx_element].validator & 0x7FFFFFFF) == validator;
-
+		uint32_t chunk_validator;
 		if constexpr (THREAD_SAFE) {
-			mutex.unlock();
+			chunk_validator = _atomic(chunks[idx_chunk][idx_element].validator).load(std::memory_order_relaxed);
+		} else {
+			chunk_validator = chunks[idx_chunk][idx_element].validator;
 		}
 
-		return owned;
+		return (chunk_validator & 0x7FFFFFFF) == validator;
 	}
 
 	_FORCE_INLINE_ void free(const RID &p_rid) {
-		if constexpr (THREAD_SAFE) {
-			mutex.lock();
-		}
-
 		uint64_t id = p_rid.get_id();
 		uint32_t idx = uint32_t(id & 0xFFFFFFFF);
-		if (unlikely(idx >= max_alloc)) {
-			if constexpr (THREAD_SAFE) {
-				mutex.unlock();
-			}
+		uint32_t ma;
+		if constexpr (THREAD_SAFE) {
+			ma = _atomic(max_alloc).load(std::memory_order_acquire);
+		} else {
+			ma = max_alloc;
+		}
+		if (unlikely(idx >= ma)) {
 			ERR_FAIL();
 		}
 
@@ -345,66 +421,70 @@ public:
 		uint32_t idx_element = idx % elements_in_chunk;
 
 		uint32_t validator = uint32_t(id >> 32);
-		if (unlikely(chunks[idx_chunk][idx_element].validator & 0x80000000)) {
-			if constexpr (THREAD_SAFE) {
-				mutex.unlock();
+		Chunk &c = chunks[idx_chunk][idx_element];
+
+		if constexpr (THREAD_SAFE) {
+			// Invalidate it first, so freeing it from two threads at once fails for one of them.
+			uint32_t expected = validator;
+			if (unlikely(!_atomic(c.validator).compare_exchange_strong(expected, 0xFFFFFFFF, std::memory_order_acquire, std::memory_order_relaxed))) {
+				if (expected & 0x80000000) {
+					ERR_FAIL_MSG("Attempted to free an uninitialized or invalid RID");
+				}
+				ERR_FAIL();
 			}
+
+#ifdef TSAN_ENABLED
+			__tsan_acquire(&c.data); // We know not a race in practice.
+#endif
+			c.data.~T();
+
+			_atomic(alloc_count).fetch_sub(1, std::memory_order_relaxed);
+			_push_free_list(idx, idx);
+			return;
+		}
+
+		if (unlikely(c.validator & 0x80000000)) {
 			ERR_FAIL_MSG("Attempted to free an uninitialized or invalid RID");
-		} else if (unlikely(chunks[idx_chunk][idx_element].validator != validator)) {
-			if constexpr (THREAD_SAFE) {
-				mutex.unlock();
-			}
+		} else if (unlikely(c.validator != validator)) {
 			ERR_FAIL();
 		}
 
-		chunks[idx_chunk][idx_element].data.~T();
-		chunks[idx_chunk][idx_element].validator = 0xFFFFFFFF; // go invalid
+		c.data.~T();
+		c.validator = 0xFFFFFFFF; // go invalid
 
 		alloc_count--;
 		free_list_chunks[alloc_count / elements_in_chunk][alloc_count % elements_in_chunk] = idx;
-
-		if constexpr (THREAD_SAFE) {
-			mutex.unlock();
-		}
 	}
 
 	_FORCE_INLINE_ uint32_t get_rid_count() const {
+		if constexpr (THREAD_SAFE) {
+			return _atomic(const_cast<uint32_t &>(alloc_count)).load(std::memory_order_relaxed);
+		}
 		return alloc_count;
 	}
 	LocalVector<RID> get_owned_list() const {
 		LocalVector<RID> owned;
-		if constexpr (THREAD_SAFE) {
-			mutex.lock();
-		}
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = chunks[i / elements_in_chunk][i % elements_in_chunk].validator;
+		uint32_t ma = THREAD_SAFE ? _atomic(const_cast<uint32_t &>(max_alloc)).load(std::memory_order_acquire) : max_alloc;
+		for (size_t i = 0; i < ma; i++) {
+			uint64_t validator = _get_validator(i);
 			if (validator != 0xFFFFFFFF) {
 				owned.push_back(_make_from_id((validator << 32) | i));
 			}
 		}
-		if constexpr (THREAD_SAFE) {
-			mutex.unlock();
-		}
 		return owned;
 	}
 
 	//used for fast iteration in the elements or RIDs
 	void fill_owned_buffer(RID *p_rid_buffer) const {
-		if constexpr (THREAD_SAFE) {
-			mutex.lock();
-		}
 		uint32_t idx = 0;
-		for (size_t i = 0; i < max_alloc; i++) {
-			uint64_t validator = chunks[i / elements_in_chunk][i % elements_in_chunk].validator;
+		uint32_t ma = THREAD_SAFE ? _atomic(const_cast<uint32_t &>(max_alloc)).load(std::memory_order_acquire) : max_alloc;
+		for (size_t i = 0; i < ma; i++) {
+			uint64_t validator = _get_validator(i);
 			if (validator != 0xFFFFFFFF) {
 				p_rid_buffer[idx] = _make_from_id((validator << 32) | i);
 				idx++;
 			}
 		}
-
-		if constexpr (THREAD_SAFE) {
-			mutex.unlock();
-		}
 	}
 
 	void set_description(const char *p_description) {
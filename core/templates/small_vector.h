@@ -0,0 +1,348 @@
+/**************************************************************************/
+/*  small_vector.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+#include "core/string/print_string.h"
+#include "core/templates/sort_array.h"
+#include "core/templates/span.h"
+#include "core/templates/vector.h"
+
+#include <initializer_list>
+#include <type_traits>
+
+GODOT_GCC_WARNING_PUSH_AND_IGNORE("-Warray-bounds")
+
+/**
+ * A vector that stores up to INLINE_CAPACITY elements inline, and transparently
+ * moves them to the heap if it grows larger than that.
+ * Useful for containers that are almost always small, but have no hard upper bound
+ * (unlike FixedVector), to avoid allocating in bottleneck code.
+ *
+ * Has the same API as LocalVector. Like LocalVector, elements are assumed to be
+ * trivially relocatable.
+ */
+template <typename T, uint32_t INLINE_CAPACITY, typename U = uint32_t>
+class SmallVector {
+	static_assert(INLINE_CAPACITY > 0, "Use LocalVector if no inline storage is needed.");
+
+private:
+	U count = 0;
+	U capacity = INLINE_CAPACITY;
+	T *data = _get_inline_data();
+	alignas(T) uint8_t inline_data[INLINE_CAPACITY * sizeof(T)];
+
+	_FORCE_INLINE_ T *_get_inline_data() { return reinterpret_cast<T *>(inline_data); }
+	_FORCE_INLINE_ bool _is_inline() const { return data == reinterpret_cast<const T *>(inline_data); }
+
+	template <bool p_init>
+	void _resize(U p_size) {
+		if (p_size < count) {
+			if constexpr (!std::is_trivially_destructible_v<T>) {
+				for (U i = p_size; i < count; i++) {
+					data[i].~T();
+				}
+			}
+			count = p_size;
+		} else if (p_size > count) {
+			reserve(p_size);
+			if constexpr (p_init) {
+				memnew_arr_placement(data + count, p_size - count);
+			} else {
+				static_assert(std::is_trivially_destructible_v<T>, "T must be trivially destructible to resize uninitialized");
+			}
+			count = p_size;
+		}
+	}
+
+	// Takes over the elements of p_from, which must not be used afterwards without being reset.
+	void _take_from(SmallVector &p_from) {
+		count = p_from.count;
+		if (p_from._is_inline()) {
+			// Note: Assumes trivial relocatability.
+			memcpy((void *)data, (const void *)p_from.data, count * sizeof(T));
+		} else {
+			data = p_from.data;
+			capacity = p_from.capacity;
+		}
+
+		p_from.data = p_from._get_inline_data();
+		p_from.count = 0;
+		p_from.capacity = INLINE_CAPACITY;
+	}
+
+public:
+	_FORCE_INLINE_ T *ptr() { return data; }
+	_FORCE_INLINE_ const T *ptr() const { return data; }
+	_FORCE_INLINE_ U size() const { return count; }
+
+	_FORCE_INLINE_ Span<T> span() const { return Span(data, count); }
+	_FORCE_INLINE_ operator Span<T>() const { return span(); }
+
+	// Returns whether the elements have been moved out of the inline storage.
+	_FORCE_INLINE_ bool is_on_heap() const { return !_is_inline(); }
+
+	// Must take a copy instead of a reference (see GH-31736).
+	_FORCE_INLINE_ void push_back(T p_elem) {
+		if (unlikely(count == capacity)) {
+			reserve(count + 1);
+		}
+
+		memnew_placement(&data[count++], T(std::move(p_elem)));
+	}
+
+	void remove_at(U p_index) {
+		ERR_FAIL_UNSIGNED_INDEX(p_index, count);
+		count--;
+		for (U i = p_index; i < count; i++) {
+			data[i] = std::move(data[i + 1]);
+		}
+		data[count].~T();
+	}
+
+	/// Removes the item copying the last value into the position of the one to
+	/// remove. It's generally faster than `remove_at`.
+	void remove_at_unordered(U p_index) {
+		ERR_FAIL_INDEX(p_index, count);
+		count--;
+		if (count > p_index) {
+			data[p_index] = std::move(data[count]);
+		}
+		data[count].~T();
+	}
+
+	_FORCE_INLINE_ bool erase(const T &p_val) {
+		int64_t idx = find(p_val);
+		if (idx >= 0) {
+			remove_at(idx);
+			return true;
+		}
+		return false;
+	}
+
+	bool erase_unordered(const T &p_val) {
+		int64_t idx = find(p_val);
+		if (idx >= 0) {
+			remove_at_unordered(idx);
+			return true;
+		}
+		return false;
+	}
+
+	U erase_multiple_unordered(const T &p_val) {
+		U from = 0;
+		U occurrences = 0;
+		while (true) {
+			int64_t idx = find(p_val, from);
+
+			if (idx == -1) {
+				break;
+			}
+			remove_at_unordered(idx);
+			from = idx;
+			occurrences++;
+		}
+		return occurrences;
+	}
+
+	void reverse() {
+		for (U i = 0; i < count / 2; i++) {
+			SWAP(data[i], data[count - i - 1]);
+		}
+	}
+
+	_FORCE_INLINE_ void clear() { resize(0); }
+	// Clears the vector and releases heap memory, if any.
+	_FORCE_INLINE_ void reset() {
+		clear();
+		if (!_is_inline()) {
+			Memory::free_static(data);
+			data = _get_inline_data();
+			capacity = INLINE_CAPACITY;
+		}
+	}
+	_FORCE_INLINE_ bool is_empty() const { return count == 0; }
+	_FORCE_INLINE_ U get_capacity() const { return capacity; }
+	void reserve(U p_size) {
+		if (p_size > capacity) {
+			// Grow 1.5x like LocalVector, or to the needed size if that isn't enough.
+			U new_capacity = capacity + ((1 + capacity) >> 1);
+			if (p_size > new_capacity) {
+				new_capacity = p_size;
+			}
+
+			if (_is_inline()) {
+				T *heap_data = (T *)Memory::alloc_static(new_capacity * sizeof(T));
+				CRASH_COND_MSG(!heap_data, "Out of memory");
+				// Note: Assumes trivial relocatability.
+				memcpy((void *)heap_data, (const void *)data, count * sizeof(T));
+				data = heap_data;
+			} else {
+				data = (T *)Memory::realloc_static(data, new_capacity * sizeof(T));
+				CRASH_COND_MSG(!data, "Out of memory");
+			}
+			capacity = new_capacity;
+		} else if (p_size < count) {
+			WARN_VERBOSE("reserve() called with a capacity smaller than the current size. This is likely a mistake.");
+		}
+	}
+
+	/// Resize the vector.
+	/// Elements are initialized (or not) depending on what the default C++ behavior for T is.
+	void resize(U p_size) {
+		// Don't init when trivially constructible.
+		_resize<!std::is_trivially_constructible_v<T>>(p_size);
+	}
+
+	/// Resize and set all values to 0 / false / nullptr.
+	_FORCE_INLINE_ void resize_initialized(U p_size) { _resize<true>(p_size); }
+
+	/// Resize and keep memory uninitialized.
+	/// This means that any newly added elements have an unknown value, and are expected to be set after the `resize_uninitialized` call.
+	/// This is only available for trivially destructible types (otherwise, trivial resize might be UB).
+	_FORCE_INLINE_ void resize_uninitialized(U p_size) { _resize<false>(p_size); }
+
+	_FORCE_INLINE_ const T &operator[](U p_index) const {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return data[p_index];
+	}
+	_FORCE_INLINE_ T &operator[](U p_index) {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, count);
+		return data[p_index];
+	}
+
+	_FORCE_INLINE_ T *begin() { return data; }
+	_FORCE_INLINE_ T *end() { return data + count; }
+	_FORCE_INLINE_ const T *begin() const { return data; }
+	_FORCE_INLINE_ const T *end() const { return data + count; }
+
+	void insert(U p_pos, T p_val) {
+		ERR_FAIL_UNSIGNED_INDEX(p_pos, count + 1);
+		if (p_pos == count) {
+			push_back(std::move(p_val));
+		} else {
+			resize(count + 1);
+			for (U i = count - 1; i > p_pos; i--) {
+				data[i] = std::move(data[i - 1]);
+			}
+			data[p_pos] = std::move(p_val);
+		}
+	}
+
+	int64_t find(const T &p_val, int64_t p_from = 0) const {
+		if (p_from < 0) {
+			p_from = size() + p_from;
+		}
+		if (p_from < 0 || p_from >= size()) {
+			return -1;
+		}
+		return span().find(p_val, p_from);
+	}
+
+	bool has(const T &p_val) const {
+		return find(p_val) != -1;
+	}
+
+	template <typename C>
+	void sort_custom() {
+		U len = count;
+		if (len == 0) {
+			return;
+		}
+
+		SortArray<T, C> sorter;
+		sorter.sort(data, len);
+	}
+
+	void sort() {
+		sort_custom<Comparator<T>>();
+	}
+
+	void ordered_insert(T p_val) {
+		U i;
+		for (i = 0; i < count; i++) {
+			if (p_val < data[i]) {
+				break;
+			}
+		}
+		insert(i, p_val);
+	}
+
+	explicit operator Vector<T>() const {
+		Vector<T> ret;
+		ret.resize(count);
+		T *w = ret.ptrw();
+		if (w) {
+			copy_arr_placement(w, data, count);
+		}
+		return ret;
+	}
+
+	_FORCE_INLINE_ SmallVector() {}
+	_FORCE_INLINE_ SmallVector(std::initializer_list<T> p_init) {
+		reserve(p_init.size());
+		for (const T &element : p_init) {
+			push_back(element);
+		}
+	}
+	_FORCE_INLINE_ explicit SmallVector(const SmallVector &p_from) {
+		reserve(p_from.count);
+		copy_arr_placement(data, p_from.data, p_from.count);
+		count = p_from.count;
+	}
+	_FORCE_INLINE_ SmallVector(SmallVector &&p_from) {
+		_take_from(p_from);
+	}
+
+	inline void operator=(const SmallVector &p_from) {
+		if (unlikely(this == &p_from)) {
+			return;
+		}
+		resize(p_from.size());
+		for (U i = 0; i < p_from.count; i++) {
+			data[i] = p_from.data[i];
+		}
+	}
+	inline void operator=(SmallVector &&p_from) {
+		if (unlikely(this == &p_from)) {
+			return;
+		}
+		reset();
+		_take_from(p_from);
+	}
+
+	_FORCE_INLINE_ ~SmallVector() {
+		reset();
+	}
+};
+
+GODOT_GCC_WARNING_POP
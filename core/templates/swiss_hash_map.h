@@ -0,0 +1,856 @@
+/**************************************************************************/
+/*  swiss_hash_map.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/math/math_funcs_binary.h"
+#include "core/os/memory.h"
+#include "core/string/print_string.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SWISS_HASH_MAP_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define SWISS_HASH_MAP_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h> // Needed for `_BitScanForward` and `_BitScanForward64` below.
+#endif
+
+/**
+ * A group of control bytes of a SwissHashMap, which are probed in parallel.
+ *
+ * Each slot of the map has one control byte: either `CTRL_EMPTY`, `CTRL_DELETED`,
+ * or the 7 upper bits of the hash of the key stored in the slot. Matching a group
+ * returns a bit mask with one bit per matching slot, use `get_first_slot()` to
+ * convert the lowest set bit to a slot index within the group.
+ *
+ * Uses SSE2 or NEON when available, and an 8-wide SWAR fallback otherwise.
+ */
+struct SwissHashMapGroup {
+	static constexpr uint8_t CTRL_EMPTY = 0x80;
+	static constexpr uint8_t CTRL_DELETED = 0xFE;
+
+#if defined(SWISS_HASH_MAP_SSE2)
+	static constexpr uint32_t WIDTH = 16;
+	static constexpr uint32_t MASK_SHIFT = 0; // One bit per slot.
+
+	__m128i ctrl;
+
+	_FORCE_INLINE_ explicit SwissHashMapGroup(const uint8_t *p_ctrl) {
+		ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_ctrl));
+	}
+
+	_FORCE_INLINE_ uint64_t match(uint8_t p_h2) const {
+		return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(char(p_h2)))));
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty() const {
+		return match(CTRL_EMPTY);
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		// Both special values have the high bit set, hashes don't.
+		return uint32_t(_mm_movemask_epi8(ctrl));
+	}
+#elif defined(SWISS_HASH_MAP_NEON)
+	static constexpr uint32_t WIDTH = 16;
+	static constexpr uint32_t MASK_SHIFT = 2; // One nibble per slot.
+
+	uint8x16_t ctrl;
+
+	static _FORCE_INLINE_ uint64_t _to_mask(uint8x16_t p_cmp) {
+		// Narrow each byte to a nibble, there is no movemask equivalent on NEON.
+		const uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(p_cmp), 4);
+		return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0) & 0x8888888888888888ULL;
+	}
+
+	_FORCE_INLINE_ explicit SwissHashMapGroup(const uint8_t *p_ctrl) {
+		ctrl = vld1q_u8(p_ctrl);
+	}
+
+	_FORCE_INLINE_ uint64_t match(uint8_t p_h2) const {
+		return _to_mask(vceqq_u8(ctrl, vdupq_n_u8(p_h2)));
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty() const {
+		return match(CTRL_EMPTY);
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		return _to_mask(vcltq_s8(vreinterpretq_s8_u8(ctrl), vdupq_n_s8(0)));
+	}
+#else
+	static constexpr uint32_t WIDTH = 8;
+	static constexpr uint32_t MASK_SHIFT = 3; // One byte per slot, only the high bit is set.
+
+	static constexpr uint64_t LSBS = 0x0101010101010101ULL;
+	static constexpr uint64_t MSBS = 0x8080808080808080ULL;
+
+	uint64_t ctrl;
+
+	_FORCE_INLINE_ explicit SwissHashMapGroup(const uint8_t *p_ctrl) {
+		memcpy(&ctrl, p_ctrl, sizeof(ctrl));
+#ifdef BIG_ENDIAN_ENABLED
+		ctrl = BSWAP64(ctrl);
+#endif
+	}
+
+	_FORCE_INLINE_ uint64_t match(uint8_t p_h2) const {
+		// May report false positives for bytes following a match, which is fine
+		// since matches are always confirmed by comparing keys.
+		const uint64_t x = ctrl ^ (LSBS * p_h2);
+		return (x - LSBS) & ~x & MSBS;
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty() const {
+		// Empty is the only special value with bit 1 cleared.
+		return ctrl & ~(ctrl << 6) & MSBS;
+	}
+
+	_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+		return ctrl & MSBS;
+	}
+#endif
+
+	static _FORCE_INLINE_ uint32_t get_first_slot(uint64_t p_mask) {
+#ifdef _MSC_VER
+		unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+		_BitScanForward64(&index, p_mask);
+#else
+		// `_BitScanForward64` is only available on 64-bit targets.
+		if (!_BitScanForward(&index, uint32_t(p_mask))) {
+			_BitScanForward(&index, uint32_t(p_mask >> 32));
+			index += 32;
+		}
+#endif
+		return uint32_t(index) >> MASK_SHIFT;
+#else
+		return uint32_t(__builtin_ctzll(p_mask)) >> MASK_SHIFT;
+#endif
+	}
+};
+
+/**
+ * An array-based hash map using Swiss table style open addressing, meant as a
+ * drop-in replacement for AHashMap on hot lookup paths.
+ *
+ * Like AHashMap, elements are stored contiguously in insertion order, iteration
+ * is a linear walk over that array, and erasing an element moves the last one
+ * into its place. The lookup index is different: every slot has a one byte
+ * control value holding 7 bits of the key hash, and lookups compare a whole
+ * group of control bytes against the hash at once using SIMD, so most probes
+ * only touch a single cache line and compare at most one key.
+ *
+ * The maximum load factor is 7/8. Erased slots become tombstones, which are
+ * cleaned up when the map needs to grow.
+ */
+template <typename TKey, typename TValue,
+		typename Hasher = HashMapHasherDefault,
+		typename Comparator = HashMapComparatorDefault<TKey>>
+class SwissHashMap {
+public:
+	// Must be a power of two, and at least as large as a group.
+	static constexpr uint32_t INITIAL_CAPACITY = 16;
+	static_assert(INITIAL_CAPACITY >= SwissHashMapGroup::WIDTH);
+
+private:
+	static constexpr uint32_t INVALID_SLOT = UINT32_MAX;
+
+	typedef KeyValue<TKey, TValue> MapKeyValue;
+	MapKeyValue *_elements = nullptr;
+	// Hash of each element, indexed like `_elements`.
+	uint32_t *_hashes = nullptr;
+	// Element index of each slot, followed by the control bytes of each slot, in one allocation.
+	uint32_t *_slots = nullptr;
+	uint8_t *_ctrl = nullptr;
+
+	// Due to optimization, this is `capacity - 1`. Use + 1 to get normal capacity.
+	uint32_t _capacity_mask = 0;
+	uint32_t _size = 0;
+	// Empty slots that can still be filled before a rehash is needed.
+	uint32_t _growth_left = 0;
+
+	static _FORCE_INLINE_ uint32_t _get_max_elements(uint32_t p_capacity_mask) {
+		const uint32_t capacity = p_capacity_mask + 1;
+		return capacity - capacity / 8;
+	}
+
+	static _FORCE_INLINE_ uint32_t _capacity_mask_for(uint32_t p_elements) {
+		// Smallest power of two capacity that can hold p_elements at the maximum load factor.
+		const uint32_t capacity = Math::next_power_of_2(MAX(INITIAL_CAPACITY, p_elements + p_elements / 7 + 1));
+		return capacity - 1;
+	}
+
+	static _FORCE_INLINE_ uint8_t _h2(uint32_t p_hash) {
+		return uint8_t(p_hash >> 25);
+	}
+
+	// Walks groups using triangular probing, which visits every group once since the group count is a power of two.
+	struct ProbeSeq {
+		uint32_t offset;
+		uint32_t stride = 0;
+		uint32_t mask;
+
+		_FORCE_INLINE_ ProbeSeq(uint32_t p_hash, uint32_t p_mask) {
+			mask = p_mask;
+			offset = p_hash & p_mask & ~(SwissHashMapGroup::WIDTH - 1);
+		}
+
+		_FORCE_INLINE_ void next() {
+			stride += SwissHashMapGroup::WIDTH;
+			offset = (offset + stride) & mask;
+		}
+	};
+
+	_FORCE_INLINE_ uint32_t _hash(const TKey &p_key) const {
+		return Hasher::hash(p_key);
+	}
+
+	uint32_t _lookup_slot(const TKey &p_key, uint32_t p_hash) const {
+		if (unlikely(_elements == nullptr)) {
+			return INVALID_SLOT; // Failed lookups, no _elements.
+		}
+
+		const uint8_t h2 = _h2(p_hash);
+		ProbeSeq seq(p_hash, _capacity_mask);
+		while (true) {
+			const SwissHashMapGroup group(_ctrl + seq.offset);
+			for (uint64_t mask = group.match(h2); mask != 0; mask &= mask - 1) {
+				const uint32_t slot = seq.offset + SwissHashMapGroup::get_first_slot(mask);
+				if (Comparator::compare(_elements[_slots[slot]].key, p_key)) {
+					return slot;
+				}
+			}
+			if (likely(group.match_empty() != 0)) {
+				return INVALID_SLOT;
+			}
+			seq.next();
+		}
+	}
+
+	bool _lookup_idx(const TKey &p_key, uint32_t &r_element_idx, uint32_t &r_slot) const {
+		return _lookup_idx_with_hash(p_key, r_element_idx, r_slot, _hash(p_key));
+	}
+
+	bool _lookup_idx_with_hash(const TKey &p_key, uint32_t &r_element_idx, uint32_t &r_slot, uint32_t p_hash) const {
+		const uint32_t slot = _lookup_slot(p_key, p_hash);
+		if (slot == INVALID_SLOT) {
+			return false;
+		}
+		r_slot = slot;
+		r_element_idx = _slots[slot];
+		return true;
+	}
+
+	// Finds the slot pointing to an element, without comparing keys.
+	uint32_t _find_element_slot(uint32_t p_element_idx) const {
+		const uint32_t hash = _hashes[p_element_idx];
+		const uint8_t h2 = _h2(hash);
+		ProbeSeq seq(hash, _capacity_mask);
+		while (true) {
+			const SwissHashMapGroup group(_ctrl + seq.offset);
+			for (uint64_t mask = group.match(h2); mask != 0; mask &= mask - 1) {
+				const uint32_t slot = seq.offset + SwissHashMapGroup::get_first_slot(mask);
+				if (_slots[slot] == p_element_idx) {
+					return slot;
+				}
+			}
+			seq.next();
+		}
+	}
+
+	uint32_t _find_insert_slot(uint32_t p_hash) const {
+		ProbeSeq seq(p_hash, _capacity_mask);
+		while (true) {
+			const uint64_t mask = SwissHashMapGroup(_ctrl + seq.offset).match_empty_or_deleted();
+			if (mask != 0) {
+				return seq.offset + SwissHashMapGroup::get_first_slot(mask);
+			}
+			seq.next();
+		}
+	}
+
+	void _insert_slot(uint32_t p_hash, uint32_t p_element_idx) {
+		const uint32_t slot = _find_insert_slot(p_hash);
+		if (_ctrl[slot] == SwissHashMapGroup::CTRL_EMPTY) {
+			_growth_left--;
+		}
+		_ctrl[slot] = _h2(p_hash);
+		_slots[slot] = p_element_idx;
+	}
+
+	void _erase_slot(uint32_t p_slot) {
+		// If the group still has an empty slot, it was never full, so no probe
+		// sequence continues past it and the slot can be made empty again.
+		const uint32_t group_offset = p_slot & ~(SwissHashMapGroup::WIDTH - 1);
+		if (SwissHashMapGroup(_ctrl + group_offset).match_empty() != 0) {
+			_ctrl[p_slot] = SwissHashMapGroup::CTRL_EMPTY;
+			_growth_left++;
+		} else {
+			_ctrl[p_slot] = SwissHashMapGroup::CTRL_DELETED;
+		}
+	}
+
+	void _allocate_index(uint32_t p_capacity_mask) {
+		const uint32_t real_capacity = p_capacity_mask + 1;
+		_capacity_mask = p_capacity_mask;
+		_slots = reinterpret_cast<uint32_t *>(Memory::alloc_static(real_capacity * (sizeof(uint32_t) + sizeof(uint8_t))));
+		_ctrl = reinterpret_cast<uint8_t *>(_slots + real_capacity);
+		memset(_ctrl, SwissHashMapGroup::CTRL_EMPTY, real_capacity);
+		_growth_left = _get_max_elements(p_capacity_mask);
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity_mask) {
+		// Rebuilding the index drops all tombstones, so this also works to clean up
+		// the map without growing it.
+		const bool grow = p_new_capacity_mask != _capacity_mask;
+		Memory::free_static(_slots);
+		_allocate_index(p_new_capacity_mask);
+
+		if (grow) {
+			const uint32_t max_elements = _get_max_elements(_capacity_mask);
+			_elements = reinterpret_cast<MapKeyValue *>(Memory::realloc_static(_elements, sizeof(MapKeyValue) * max_elements));
+			_hashes = reinterpret_cast<uint32_t *>(Memory::realloc_static(_hashes, sizeof(uint32_t) * max_elements));
+		}
+
+		for (uint32_t i = 0; i < _size; i++) {
+			_insert_slot(_hashes[i], i);
+		}
+	}
+
+	int32_t _insert_element(const TKey &p_key, const TValue &p_value, uint32_t p_hash) {
+		if (unlikely(_elements == nullptr)) {
+			// Allocate on demand to save memory.
+			_allocate_index(_capacity_mask);
+			const uint32_t max_elements = _get_max_elements(_capacity_mask);
+			_elements = reinterpret_cast<MapKeyValue *>(Memory::alloc_static(sizeof(MapKeyValue) * max_elements));
+			_hashes = reinterpret_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * max_elements));
+		}
+
+		if (unlikely(_growth_left == 0)) {
+			// Only tombstones are left, rehash in place if the map is not actually full.
+			if (_size < _get_max_elements(_capacity_mask) / 2) {
+				_resize_and_rehash(_capacity_mask);
+			} else {
+				_resize_and_rehash(_capacity_mask * 2 + 1);
+			}
+		}
+
+		memnew_placement(&_elements[_size], MapKeyValue(p_key, p_value));
+		_hashes[_size] = p_hash;
+
+		_insert_slot(p_hash, _size);
+		_size++;
+		return _size - 1;
+	}
+
+	void _init_from(const SwissHashMap &p_other) {
+		_capacity_mask = p_other._capacity_mask;
+		_size = p_other._size;
+
+		if (p_other._size == 0) {
+			return;
+		}
+
+		const uint32_t real_capacity = _capacity_mask + 1;
+		const uint32_t max_elements = _get_max_elements(_capacity_mask);
+		_slots = reinterpret_cast<uint32_t *>(Memory::alloc_static(real_capacity * (sizeof(uint32_t) + sizeof(uint8_t))));
+		_ctrl = reinterpret_cast<uint8_t *>(_slots + real_capacity);
+		_elements = reinterpret_cast<MapKeyValue *>(Memory::alloc_static(sizeof(MapKeyValue) * max_elements));
+		_hashes = reinterpret_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * max_elements));
+		_growth_left = p_other._growth_left;
+
+		if constexpr (std::is_trivially_copyable_v<TKey> && std::is_trivially_copyable_v<TValue>) {
+			void *destination = _elements;
+			const void *source = p_other._elements;
+			memcpy(destination, source, sizeof(MapKeyValue) * _size);
+		} else {
+			for (uint32_t i = 0; i < _size; i++) {
+				memnew_placement(&_elements[i], MapKeyValue(p_other._elements[i]));
+			}
+		}
+
+		memcpy(_hashes, p_other._hashes, sizeof(uint32_t) * _size);
+		memcpy(_slots, p_other._slots, real_capacity * (sizeof(uint32_t) + sizeof(uint8_t)));
+	}
+
+public:
+	/* Standard Godot Container API */
+
+	_FORCE_INLINE_ uint32_t get_capacity() const { return _capacity_mask + 1; }
+	_FORCE_INLINE_ uint32_t size() const { return _size; }
+
+	_FORCE_INLINE_ bool is_empty() const {
+		return _size == 0;
+	}
+
+	void clear() {
+		if (_elements == nullptr || _size == 0) {
+			return;
+		}
+
+		memset(_ctrl, SwissHashMapGroup::CTRL_EMPTY, _capacity_mask + 1);
+		_growth_left = _get_max_elements(_capacity_mask);
+		if constexpr (!(std::is_trivially_destructible_v<TKey> && std::is_trivially_destructible_v<TValue>)) {
+			for (uint32_t i = 0; i < _size; i++) {
+				_elements[i].key.~TKey();
+				_elements[i].value.~TValue();
+			}
+		}
+
+		_size = 0;
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+		CRASH_COND_MSG(!exists, "SwissHashMap key not found.");
+		return _elements[element_idx].value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+		CRASH_COND_MSG(!exists, "SwissHashMap key not found.");
+		return _elements[element_idx].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+
+		if (exists) {
+			return &_elements[element_idx].value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+
+		if (exists) {
+			return &_elements[element_idx].value;
+		}
+		return nullptr;
+	}
+
+	bool has(const TKey &p_key) const {
+		return _lookup_slot(p_key, _hash(p_key)) != INVALID_SLOT;
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t slot = 0;
+		uint32_t element_idx = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+
+		if (!exists) {
+			return false;
+		}
+
+		_erase_slot(slot);
+		_elements[element_idx].key.~TKey();
+		_elements[element_idx].value.~TValue();
+		_size--;
+
+		if (element_idx < _size) {
+			memcpy((void *)&_elements[element_idx], (const void *)&_elements[_size], sizeof(MapKeyValue));
+			_slots[_find_element_slot(_size)] = element_idx;
+			_hashes[element_idx] = _hashes[_size];
+		}
+
+		return true;
+	}
+
+	// Replace the key of an entry in-place, without invalidating iterators or changing the entries position during iteration.
+	// p_old_key must exist in the map and p_new_key must not, unless it is equal to p_old_key.
+	bool replace_key(const TKey &p_old_key, const TKey &p_new_key) {
+		if (p_old_key == p_new_key) {
+			return true;
+		}
+		uint32_t slot = 0;
+		uint32_t element_idx = 0;
+		ERR_FAIL_COND_V(_lookup_idx(p_new_key, element_idx, slot), false);
+		ERR_FAIL_COND_V(!_lookup_idx(p_old_key, element_idx, slot), false);
+		MapKeyValue &element = _elements[element_idx];
+		const_cast<TKey &>(element.key) = p_new_key;
+
+		_erase_slot(slot);
+
+		const uint32_t hash = _hash(p_new_key);
+		_hashes[element_idx] = hash;
+		if (unlikely(_growth_left == 0)) {
+			// Only tombstones are left, rebuilding the index also inserts the new key.
+			_resize_and_rehash(_capacity_mask);
+		} else {
+			_insert_slot(hash, element_idx);
+		}
+
+		return true;
+	}
+
+	// Reserves space for a number of elements, useful to avoid many resizes and rehashes.
+	// If adding a known (possibly large) number of elements at once, must be larger than old capacity.
+	void reserve(uint32_t p_new_capacity) {
+		const uint32_t new_capacity_mask = _capacity_mask_for(p_new_capacity);
+		if (_elements == nullptr) {
+			_capacity_mask = MAX(_capacity_mask, new_capacity_mask);
+			return; // Unallocated yet.
+		}
+		if (new_capacity_mask <= _capacity_mask) {
+			if (p_new_capacity < size()) {
+				WARN_VERBOSE("reserve() called with a capacity smaller than the current size. This is likely a mistake.");
+			}
+			return;
+		}
+		_resize_and_rehash(new_capacity_mask);
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const MapKeyValue &operator*() const {
+			return *pair;
+		}
+		_FORCE_INLINE_ const MapKeyValue *operator->() const {
+			return pair;
+		}
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			pair++;
+			return *this;
+		}
+
+		_FORCE_INLINE_ ConstIterator &operator--() {
+			pair--;
+			if (pair < begin) {
+				pair = end;
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return pair == b.pair; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return pair != b.pair; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return pair != end;
+		}
+
+		_FORCE_INLINE_ ConstIterator(MapKeyValue *p_key, MapKeyValue *p_begin, MapKeyValue *p_end) {
+			pair = p_key;
+			begin = p_begin;
+			end = p_end;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+		_FORCE_INLINE_ ConstIterator(const ConstIterator &p_it) {
+			pair = p_it.pair;
+			begin = p_it.begin;
+			end = p_it.end;
+		}
+		_FORCE_INLINE_ void operator=(const ConstIterator &p_it) {
+			pair = p_it.pair;
+			begin = p_it.begin;
+			end = p_it.end;
+		}
+
+	private:
+		MapKeyValue *pair = nullptr;
+		MapKeyValue *begin = nullptr;
+		MapKeyValue *end = nullptr;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ MapKeyValue &operator*() const {
+			return *pair;
+		}
+		_FORCE_INLINE_ MapKeyValue *operator->() const {
+			return pair;
+		}
+		_FORCE_INLINE_ Iterator &operator++() {
+			pair++;
+			return *this;
+		}
+		_FORCE_INLINE_ Iterator &operator--() {
+			pair--;
+			if (pair < begin) {
+				pair = end;
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return pair == b.pair; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return pair != b.pair; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return pair != end;
+		}
+
+		_FORCE_INLINE_ Iterator(MapKeyValue *p_key, MapKeyValue *p_begin, MapKeyValue *p_end) {
+			pair = p_key;
+			begin = p_begin;
+			end = p_end;
+		}
+		_FORCE_INLINE_ Iterator() {}
+		_FORCE_INLINE_ Iterator(const Iterator &p_it) {
+			pair = p_it.pair;
+			begin = p_it.begin;
+			end = p_it.end;
+		}
+		_FORCE_INLINE_ void operator=(const Iterator &p_it) {
+			pair = p_it.pair;
+			begin = p_it.begin;
+			end = p_it.end;
+		}
+
+		operator ConstIterator() const {
+			return ConstIterator(pair, begin, end);
+		}
+
+	private:
+		MapKeyValue *pair = nullptr;
+		MapKeyValue *begin = nullptr;
+		MapKeyValue *end = nullptr;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(_elements, _elements, _elements + _size);
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(_elements + _size, _elements, _elements + _size);
+	}
+	_FORCE_INLINE_ Iterator last() {
+		if (unlikely(_size == 0)) {
+			return Iterator(nullptr, nullptr, nullptr);
+		}
+		return Iterator(_elements + _size - 1, _elements, _elements + _size);
+	}
+
+	Iterator find(const TKey &p_key) {
+		uint32_t slot = 0;
+		uint32_t element_idx = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+		if (!exists) {
+			return end();
+		}
+		return Iterator(_elements + element_idx, _elements, _elements + _size);
+	}
+
+	void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			erase(p_iter->key);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(_elements, _elements, _elements + _size);
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(_elements + _size, _elements, _elements + _size);
+	}
+	_FORCE_INLINE_ ConstIterator last() const {
+		if (unlikely(_size == 0)) {
+			return ConstIterator(nullptr, nullptr, nullptr);
+		}
+		return ConstIterator(_elements + _size - 1, _elements, _elements + _size);
+	}
+
+	ConstIterator find(const TKey &p_key) const {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+		if (!exists) {
+			return end();
+		}
+		return ConstIterator(_elements + element_idx, _elements, _elements + _size);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+		CRASH_COND(!exists);
+		return _elements[element_idx].value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		uint32_t hash = _hash(p_key);
+		bool exists = _lookup_idx_with_hash(p_key, element_idx, slot, hash);
+
+		if (exists) {
+			return _elements[element_idx].value;
+		} else {
+			element_idx = _insert_element(p_key, TValue(), hash);
+			return _elements[element_idx].value;
+		}
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		uint32_t hash = _hash(p_key);
+		bool exists = _lookup_idx_with_hash(p_key, element_idx, slot, hash);
+
+		if (!exists) {
+			element_idx = _insert_element(p_key, p_value, hash);
+		} else {
+			_elements[element_idx].value = p_value;
+		}
+		return Iterator(_elements + element_idx, _elements, _elements + _size);
+	}
+
+	// Inserts an element without checking if it already exists.
+	Iterator insert_new(const TKey &p_key, const TValue &p_value) {
+		DEV_ASSERT(!has(p_key));
+		uint32_t hash = _hash(p_key);
+		uint32_t element_idx = _insert_element(p_key, p_value, hash);
+		return Iterator(_elements + element_idx, _elements, _elements + _size);
+	}
+
+	/* Array methods. */
+
+	// Unsafe. Changing keys and going outside the bounds of an array can lead to undefined behavior.
+	KeyValue<TKey, TValue> *get_elements_ptr() {
+		return _elements;
+	}
+
+	// Returns the element index. If not found, returns -1.
+	int get_index(const TKey &p_key) {
+		uint32_t element_idx = 0;
+		uint32_t slot = 0;
+		bool exists = _lookup_idx(p_key, element_idx, slot);
+		if (!exists) {
+			return -1;
+		}
+		return element_idx;
+	}
+
+	KeyValue<TKey, TValue> &get_by_index(uint32_t p_index) {
+		CRASH_BAD_UNSIGNED_INDEX(p_index, _size);
+		return _elements[p_index];
+	}
+
+	bool erase_by_index(uint32_t p_index) {
+		if (p_index >= size()) {
+			return false;
+		}
+		return erase(_elements[p_index].key);
+	}
+
+	/* Constructors */
+
+	SwissHashMap(SwissHashMap &&p_other) {
+		_elements = p_other._elements;
+		_hashes = p_other._hashes;
+		_slots = p_other._slots;
+		_ctrl = p_other._ctrl;
+		_capacity_mask = p_other._capacity_mask;
+		_size = p_other._size;
+		_growth_left = p_other._growth_left;
+
+		p_other._elements = nullptr;
+		p_other._hashes = nullptr;
+		p_other._slots = nullptr;
+		p_other._ctrl = nullptr;
+		p_other._capacity_mask = INITIAL_CAPACITY - 1;
+		p_other._size = 0;
+		p_other._growth_left = 0;
+	}
+
+	explicit SwissHashMap(const SwissHashMap &p_other) {
+		_init_from(p_other);
+	}
+
+	void operator=(const SwissHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+
+		reset();
+
+		_init_from(p_other);
+	}
+
+	SwissHashMap(uint32_t p_initial_capacity) {
+		_capacity_mask = _capacity_mask_for(p_initial_capacity);
+	}
+	SwissHashMap() :
+			_capacity_mask(INITIAL_CAPACITY - 1) {
+	}
+
+	SwissHashMap(std::initializer_list<KeyValue<TKey, TValue>> p_init) :
+			_capacity_mask(INITIAL_CAPACITY - 1) {
+		reserve(p_init.size());
+		for (const KeyValue<TKey, TValue> &E : p_init) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void reset() {
+		if (_elements != nullptr) {
+			if constexpr (!(std::is_trivially_destructible_v<TKey> && std::is_trivially_destructible_v<TValue>)) {
+				for (uint32_t i = 0; i < _size; i++) {
+					_elements[i].key.~TKey();
+					_elements[i].value.~TValue();
+				}
+			}
+			Memory::free_static(_elements);
+			Memory::free_static(_hashes);
+			Memory::free_static(_slots);
+			_elements = nullptr;
+			_hashes = nullptr;
+			_slots = nullptr;
+			_ctrl = nullptr;
+		}
+		_capacity_mask = INITIAL_CAPACITY - 1;
+		_size = 0;
+		_growth_left = 0;
+	}
+
+	~SwissHashMap() {
+		reset();
+	}
+};
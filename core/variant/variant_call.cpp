@@ -38,6 +38,8 @@
 #include "core/os/os.h"
 #include "core/templates/a_hash_map.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/parallel_sort_array.h"
+#include "core/templates/radix_sort.h"
 
 typedef void (*VariantFunc)(Variant &r_ret, Variant &p_self, const Variant **p_args);
 typedef void (*VariantConstructFunc)(Variant &r_ret, const Variant **p_args);
@@ -1259,6 +1261,16 @@ struct _VariantCall {
 		enum_data[p_type].value_to_enum[p_enumeration_name] = p_enum_type_name;
 	}
 
+	template <typename T>
+	static void func_PackedArray_radix_sort(Vector<T> *p_instance) {
+		RadixSort<T>().sort(p_instance->ptrw(), p_instance->size());
+	}
+
+	template <typename T>
+	static void func_PackedArray_parallel_sort(Vector<T> *p_instance) {
+		ParallelSortArray<T>().sort(p_instance->ptrw(), p_instance->size());
+	}
+
 #ifndef DISABLE_DEPRECATED
 	template <typename T>
 	static Vector<T> _duplicate_bind_compat_112290(Vector<T> *p_vector) {
@@ -2763,6 +2775,8 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedByteArray, reverse, sarray(), varray());
 	bind_method(PackedByteArray, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedByteArray, sort, sarray(), varray());
+	bind_function(PackedByteArray, radix_sort, _VariantCall::func_PackedArray_radix_sort<uint8_t>, sarray(), varray());
+	bind_function(PackedByteArray, parallel_sort, _VariantCall::func_PackedArray_parallel_sort<uint8_t>, sarray(), varray());
 	bind_method(PackedByteArray, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedByteArray, duplicate, sarray(), varray());
 #ifndef DISABLE_DEPRECATED
@@ -2843,6 +2857,8 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedInt32Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedInt32Array, to_byte_array, sarray(), varray());
 	bind_method(PackedInt32Array, sort, sarray(), varray());
+	bind_function(PackedInt32Array, radix_sort, _VariantCall::func_PackedArray_radix_sort<int32_t>, sarray(), varray());
+	bind_function(PackedInt32Array, parallel_sort, _VariantCall::func_PackedArray_parallel_sort<int32_t>, sarray(), varray());
 	bind_method(PackedInt32Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedInt32Array, duplicate, sarray(), varray());
 #ifndef DISABLE_DEPRECATED
@@ -2871,6 +2887,8 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedInt64Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedInt64Array, to_byte_array, sarray(), varray());
 	bind_method(PackedInt64Array, sort, sarray(), varray());
+	bind_function(PackedInt64Array, radix_sort, _VariantCall::func_PackedArray_radix_sort<int64_t>, sarray(), varray());
+	bind_function(PackedInt64Array, parallel_sort, _VariantCall::func_PackedArray_parallel_sort<int64_t>, sarray(), varray());
 	bind_method(PackedInt64Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedInt64Array, duplicate, sarray(), varray());
 #ifndef DISABLE_DEPRECATED
@@ -2899,6 +2917,8 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedFloat32Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedFloat32Array, to_byte_array, sarray(), varray());
 	bind_method(PackedFloat32Array, sort, sarray(), varray());
+	bind_function(PackedFloat32Array, radix_sort, _VariantCall::func_PackedArray_radix_sort<float>, sarray(), varray());
+	bind_function(PackedFloat32Array, parallel_sort, _VariantCall::func_PackedArray_parallel_sort<float>, sarray(), varray());
 	bind_method(PackedFloat32Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedFloat32Array, duplicate, sarray(), varray());
 #ifndef DISABLE_DEPRECATED
@@ -2927,6 +2947,8 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedFloat64Array, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_method(PackedFloat64Array, to_byte_array, sarray(), varray());
 	bind_method(PackedFloat64Array, sort, sarray(), varray());
+	bind_function(PackedFloat64Array, radix_sort, _VariantCall::func_PackedArray_radix_sort<double>, sarray(), varray());
+	bind_function(PackedFloat64Array, parallel_sort, _VariantCall::func_PackedArray_parallel_sort<double>, sarray(), varray());
 	bind_method(PackedFloat64Array, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedFloat64Array, duplicate, sarray(), varray());
 #ifndef DISABLE_DEPRECATED
@@ -2955,6 +2977,7 @@ static void _register_variant_builtin_methods_array() {
 	bind_method(PackedStringArray, slice, sarray("begin", "end"), varray(INT_MAX));
 	bind_function(PackedStringArray, to_byte_array, _VariantCall::func_PackedStringArray_to_byte_array, sarray(), varray());
 	bind_method(PackedStringArray, sort, sarray(), varray());
+	bind_function(PackedStringArray, parallel_sort, _VariantCall::func_PackedArray_parallel_sort<String>, sarray(), varray());
 	bind_method(PackedStringArray, bsearch, sarray("value", "before"), varray(true));
 	bind_method(PackedStringArray, duplicate, sarray(), varray());
 #ifndef DISABLE_DEPRECATED
@@ -49,6 +49,7 @@
 #include "core/io/resource_loader.h"
 #include "core/object/message_queue.h"
 #include "core/object/script_language.h"
+#include "core/os/frame_allocator.h"
 #include "core/os/os.h"
 #include "core/os/time.h"
 #include "core/profiling/profiling.h"
@@ -640,6 +641,9 @@ void Main::print_help(const char *p_binary) {
 	print_help_option("--ignore-error-breaks", "If debugger is connected, prevents sending error breakpoints.\n");
 	print_help_option("--profiling", "Enable profiling in the script debugger.\n");
 	print_help_option("--gpu-profile", "Show a GPU profile of the tasks that took the most time during frame rendering.\n");
+#ifdef GODOT_USE_TRACE_PROFILER
+	print_help_option("--trace-file <path>", "Record engine profiling zones and save them to the given file when quitting, in Chrome trace event JSON format.\n");
+#endif
 	print_help_option("--gpu-validation", "Enable graphics API validation layers for debugging.\n");
 #ifdef DEBUG_ENABLED
 	print_help_option("--gpu-abort", "Abort on graphics API usage errors (usually validation layer errors). May help see the problem if your system freezes.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
@@ -659,6 +663,7 @@ void Main::print_help(const char *p_binary) {
 	print_help_option("--debug-navigation", "Show navigation polygons when running the scene.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
 	print_help_option("--debug-avoidance", "Show navigation avoidance debug visuals when running the scene.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
 	print_help_option("--debug-stringnames", "Print all StringName allocations to stdout when the engine quits.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
+	print_help_option("--debug-memory-tags", "Account static memory allocations to their subsystem, shown in the memory tag monitors.\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
 	print_help_option("--debug-canvas-item-redraw", "Display a rectangle each time a canvas item requests a redraw (useful to troubleshoot low processor mode).\n", CLI_OPTION_AVAILABILITY_TEMPLATE_DEBUG);
 
 #endif
@@ -717,7 +722,7 @@ void Main::print_help(const char *p_binary) {
 	print_help_option("--benchmark-file <path>", "Benchmark the run time and save it to a given file in JSON format. The path should be absolute.\n", CLI_OPTION_AVAILABILITY_EDITOR);
 #endif // TOOLS_ENABLED
 #ifdef TESTS_ENABLED
-	print_help_option("--test [--help]", "Run unit tests. Use --test --help for more information.\n");
+	print_help_option("--test [--help]", "Run unit tests. Use --test --help for more information, or --test --bench to run benchmarks.\n");
 #endif // TESTS_ENABLED
 	OS::get_singleton()->print("\n");
 }
@@ -1841,6 +1846,8 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 			debug_canvas_item_redraw = true;
 		} else if (arg == "--debug-stringnames") {
 			StringName::set_debug_stringnames(true);
+		} else if (arg == "--debug-memory-tags") {
+			Memory::set_tag_tracking_enabled(true);
 		} else if (arg == "--debug-mute-audio") {
 			debug_mute_audio = true;
 #endif // defined(DEBUG_ENABLED)
@@ -1911,6 +1918,16 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 #endif // TOOLS_ENABLED
 		} else if (arg == "--gpu-profile") {
 			profile_gpu = true;
+#ifdef GODOT_USE_TRACE_PROFILER
+		} else if (arg == "--trace-file") {
+			if (N) {
+				TraceProfiler::set_output_path(N->get().utf8().get_data());
+				N = N->next();
+			} else {
+				OS::get_singleton()->print("Missing <path> argument for --trace-file <path>.\n");
+				goto error;
+			}
+#endif
 		} else if (arg == "--disable-crash-handler") {
 			OS::get_singleton()->disable_crash_handler();
 		} else if (arg == "--skip-breakpoints") {
@@ -4997,6 +5014,8 @@ bool Main::iteration() {
 		EngineDebugger::get_singleton()->iteration(frame_time, process_ticks, physics_process_ticks, physics_step);
 	}
 
+	FrameAllocator::end_frame();
+
 	frames++;
 	Engine::get_singleton()->_process_frames++;
 
@@ -5018,6 +5037,7 @@ bool Main::iteration() {
 		performance->set_process_time(USEC_TO_SEC(process_max));
 		performance->set_physics_process_time(USEC_TO_SEC(physics_process_max));
 		performance->set_navigation_process_time(USEC_TO_SEC(navigation_process_max));
+		performance->update_memory_tag_rates(USEC_TO_SEC(frame));
 		process_max = 0;
 		physics_process_max = 0;
 		navigation_process_max = 0;
@@ -31,6 +31,7 @@
 #include "performance.h"
 #include "performance.compat.inc"
 
+#include "core/os/frame_allocator.h"
 #include "core/os/os.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/node.h"
@@ -133,6 +134,21 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_3D_EDGE_FREE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_3D_OBSTACLE_COUNT);
 #endif // NAVIGATION_3D_DISABLED
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ALLOCATOR);
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ALLOCATOR_PEAK);
+	BIND_ENUM_CONSTANT(MEMORY_FRAME_ALLOCATOR_OVERFLOWS);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_RESOURCES);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_SCRIPTING);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_NAVIGATION);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_PHYSICS);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_RENDERING);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_AUDIO);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_RESOURCES_ALLOCATION_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_SCRIPTING_ALLOCATION_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_NAVIGATION_ALLOCATION_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_PHYSICS_ALLOCATION_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_RENDERING_ALLOCATION_RATE);
+	BIND_ENUM_CONSTANT(MEMORY_TAG_AUDIO_ALLOCATION_RATE);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 
 	BIND_ENUM_CONSTANT(MONITOR_TYPE_QUANTITY);
@@ -227,7 +243,25 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		PNAME("navigation_3d/edges_connected"),
 		PNAME("navigation_3d/edges_free"),
 		PNAME("navigation_3d/obstacles"),
+#else
+		// Keep the fixed indices of the monitors after them.
+		"", "", "", "", "", "", "", "", "", "",
 #endif // NAVIGATION_3D_DISABLED
+		PNAME("memory/frame_allocator"),
+		PNAME("memory/frame_allocator_peak"),
+		PNAME("memory/frame_allocator_overflows"),
+		PNAME("memory_tags/resources"),
+		PNAME("memory_tags/scripting"),
+		PNAME("memory_tags/navigation"),
+		PNAME("memory_tags/physics"),
+		PNAME("memory_tags/rendering"),
+		PNAME("memory_tags/audio"),
+		PNAME("memory_tags/resources_allocations_per_second"),
+		PNAME("memory_tags/scripting_allocations_per_second"),
+		PNAME("memory_tags/navigation_allocations_per_second"),
+		PNAME("memory_tags/physics_allocations_per_second"),
+		PNAME("memory_tags/rendering_allocations_per_second"),
+		PNAME("memory_tags/audio_allocations_per_second"),
 	};
 	static_assert(std_size(names) == MONITOR_MAX);
 
@@ -252,6 +286,26 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return Memory::get_mem_max_usage();
 		case MEMORY_MESSAGE_BUFFER_MAX:
 			return MessageQueue::get_singleton()->get_max_buffer_usage();
+		case MEMORY_FRAME_ALLOCATOR:
+			return FrameAllocator::get_frame_bytes();
+		case MEMORY_FRAME_ALLOCATOR_PEAK:
+			return FrameAllocator::get_frame_bytes_peak();
+		case MEMORY_FRAME_ALLOCATOR_OVERFLOWS:
+			return FrameAllocator::get_frame_overflow_count();
+		case MEMORY_TAG_RESOURCES:
+		case MEMORY_TAG_SCRIPTING:
+		case MEMORY_TAG_NAVIGATION:
+		case MEMORY_TAG_PHYSICS:
+		case MEMORY_TAG_RENDERING:
+		case MEMORY_TAG_AUDIO:
+			return Memory::get_tag_mem_usage(Memory::Tag(Memory::TAG_RESOURCES + (p_monitor - MEMORY_TAG_RESOURCES)));
+		case MEMORY_TAG_RESOURCES_ALLOCATION_RATE:
+		case MEMORY_TAG_SCRIPTING_ALLOCATION_RATE:
+		case MEMORY_TAG_NAVIGATION_ALLOCATION_RATE:
+		case MEMORY_TAG_PHYSICS_ALLOCATION_RATE:
+		case MEMORY_TAG_RENDERING_ALLOCATION_RATE:
+		case MEMORY_TAG_AUDIO_ALLOCATION_RATE:
+			return _memory_tag_alloc_rates[Memory::TAG_RESOURCES + (p_monitor - MEMORY_TAG_RESOURCES_ALLOCATION_RATE)];
 		case OBJECT_COUNT:
 			return ObjectDB::get_object_count();
 		case OBJECT_RESOURCE_COUNT:
@@ -513,7 +567,7 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
-#ifndef _3D_DISABLED
+		// Also used when 3D is disabled, to keep the fixed indices of the monitors after them.
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
@@ -524,8 +578,21 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
-#endif // _3D_DISABLED
-
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
 	};
 	static_assert((sizeof(types) / sizeof(MonitorType)) == MONITOR_MAX);
 
@@ -544,6 +611,15 @@ void Performance::set_navigation_process_time(double p_pt) {
 	_navigation_process_time = p_pt;
 }
 
+void Performance::update_memory_tag_rates(double p_elapsed) {
+	ERR_FAIL_COND(p_elapsed <= 0.0);
+	for (int i = 0; i < Memory::TAG_MAX; i++) {
+		const uint64_t count = Memory::get_tag_alloc_count(Memory::Tag(i));
+		_memory_tag_alloc_rates[i] = (count - _memory_tag_alloc_counts[i]) / p_elapsed;
+		_memory_tag_alloc_counts[i] = count;
+	}
+}
+
 void Performance::add_custom_monitor(const StringName &p_id, const Callable &p_callable, const Vector<Variant> &p_args, MonitorType p_type) {
 	ERR_FAIL_COND_MSG(has_custom_monitor(p_id), "Custom monitor with id '" + String(p_id) + "' already exists.");
 	_monitor_map.insert(p_id, MonitorCall(p_type, p_callable, p_args));
@@ -57,6 +57,9 @@ class Performance : public Object {
 	double _physics_process_time;
 	double _navigation_process_time;
 
+	uint64_t _memory_tag_alloc_counts[Memory::TAG_MAX] = {};
+	double _memory_tag_alloc_rates[Memory::TAG_MAX] = {};
+
 public:
 	enum Monitor {
 		TIME_FPS,
@@ -121,6 +124,23 @@ public:
 		NAVIGATION_3D_EDGE_FREE_COUNT,
 		NAVIGATION_3D_OBSTACLE_COUNT,
 #endif // _3D_DISABLED
+		// Fixed, so the values of the following monitors don't depend on 3D being disabled.
+		MEMORY_FRAME_ALLOCATOR = 59,
+		MEMORY_FRAME_ALLOCATOR_PEAK,
+		MEMORY_FRAME_ALLOCATOR_OVERFLOWS,
+		// Fixed as well, for the same reason.
+		MEMORY_TAG_RESOURCES = 62,
+		MEMORY_TAG_SCRIPTING,
+		MEMORY_TAG_NAVIGATION,
+		MEMORY_TAG_PHYSICS,
+		MEMORY_TAG_RENDERING,
+		MEMORY_TAG_AUDIO,
+		MEMORY_TAG_RESOURCES_ALLOCATION_RATE,
+		MEMORY_TAG_SCRIPTING_ALLOCATION_RATE,
+		MEMORY_TAG_NAVIGATION_ALLOCATION_RATE,
+		MEMORY_TAG_PHYSICS_ALLOCATION_RATE,
+		MEMORY_TAG_RENDERING_ALLOCATION_RATE,
+		MEMORY_TAG_AUDIO_ALLOCATION_RATE,
 		MONITOR_MAX
 	};
 
@@ -139,6 +159,7 @@ public:
 	void set_process_time(double p_pt);
 	void set_physics_process_time(double p_pt);
 	void set_navigation_process_time(double p_pt);
+	void update_memory_tag_rates(double p_elapsed);
 
 	void add_custom_monitor(const StringName &p_id, const Callable &p_callable, const Vector<Variant> &p_args, MonitorType p_type = MONITOR_TYPE_QUANTITY);
 	void remove_custom_monitor(const StringName &p_id);
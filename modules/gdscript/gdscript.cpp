@@ -928,6 +928,8 @@ const Variant GDScript::get_rpc_config() const {
 }
 
 Variant GDScript::callp(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	MEMORY_TAG_SCOPE(Memory::TAG_SCRIPTING);
+
 	GDScript *top = this;
 	while (top) {
 		if (likely(top->valid)) {
@@ -1903,6 +1905,8 @@ void GDScriptInstance::_call_implicit_ready_recursively(GDScript *p_script) {
 }
 
 Variant GDScriptInstance::callp(const StringName &p_method, const Variant **p_args, int p_argcount, Callable::CallError &r_error) {
+	MEMORY_TAG_SCOPE(Memory::TAG_SCRIPTING);
+
 	GDScript *sptr = script.ptr();
 	if (unlikely(p_method == SceneStringName(_ready))) {
 		// Call implicit ready first, including for the super classes recursively.
@@ -1288,6 +1288,8 @@ void GodotPhysicsServer2D::init() {
 }
 
 void GodotPhysicsServer2D::step(real_t p_step) {
+	MEMORY_TAG_SCOPE(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1310,6 +1312,8 @@ void GodotPhysicsServer2D::sync() {
 }
 
 void GodotPhysicsServer2D::flush_queries() {
+	MEMORY_TAG_SCOPE(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
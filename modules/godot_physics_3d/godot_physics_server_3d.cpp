@@ -1672,6 +1672,8 @@ void GodotPhysicsServer3D::init() {
 }
 
 void GodotPhysicsServer3D::step(real_t p_step) {
+	MEMORY_TAG_SCOPE(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1694,6 +1696,8 @@ void GodotPhysicsServer3D::sync() {
 }
 
 void GodotPhysicsServer3D::flush_queries() {
+	MEMORY_TAG_SCOPE(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
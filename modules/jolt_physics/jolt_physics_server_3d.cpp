@@ -1615,6 +1615,8 @@ void JoltPhysicsServer3D::finish() {
 }
 
 void JoltPhysicsServer3D::step(real_t p_step) {
+	MEMORY_TAG_SCOPE(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1637,6 +1639,8 @@ void JoltPhysicsServer3D::end_sync() {
 }
 
 void JoltPhysicsServer3D::flush_queries() {
+	MEMORY_TAG_SCOPE(Memory::TAG_PHYSICS);
+
 	if (!active) {
 		return;
 	}
@@ -1303,6 +1303,7 @@ void GodotNavigationServer2D::process(double p_delta_time) {
 	// Use for things that (only) need to update once per main loop iteration and rendered frame or is visible to the user.
 	// E.g. (final) sync of objects for this main loop iteration, updating rendered debug visuals, updating debug statistics, ...
 
+	MEMORY_TAG_SCOPE(Memory::TAG_NAVIGATION);
 	sync();
 }
 
@@ -1314,6 +1315,7 @@ void GodotNavigationServer2D::physics_process(double p_delta_time) {
 	// If physics process needs to play catchup this function will be called multiple times per frame so it should not hold
 	// costly updates that are not important outside the stepped calculations to avoid causing a physics performance death spiral.
 
+	MEMORY_TAG_SCOPE(Memory::TAG_NAVIGATION);
 	flush_queries();
 
 	if (!active) {
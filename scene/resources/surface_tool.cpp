@@ -30,6 +30,7 @@
 
 #include "surface_tool.h"
 
+#include "core/math/transform_batch.h"
 #include "core/templates/a_hash_map.h"
 
 #define EQ_VERTEX_DIST 0.00001
@@ -1039,16 +1040,21 @@ void SurfaceTool::append_from(const Ref<Mesh> &p_existing, int p_surface, const
 	}
 	int vfrom = vertex_array.size();
 
-	for (Vertex &v : nvertices) {
-		v.vertex = p_xform.xform(v.vertex);
+	if (!nvertices.is_empty()) {
+		// Transform the members of all vertices in place, in batches.
+		Vertex *vertices = nvertices.ptr();
+		TransformBatch::xform(p_xform, &vertices->vertex, &vertices->vertex, nvertices.size(), sizeof(Vertex));
 		if (nformat & RS::ARRAY_FORMAT_NORMAL) {
-			v.normal = p_xform.basis.xform(v.normal);
+			TransformBatch::basis_xform(p_xform.basis, &vertices->normal, &vertices->normal, nvertices.size(), sizeof(Vertex));
 		}
 		if (nformat & RS::ARRAY_FORMAT_TANGENT) {
-			v.tangent = p_xform.basis.xform(v.tangent);
-			v.binormal = p_xform.basis.xform(v.binormal);
+			TransformBatch::basis_xform(p_xform.basis, &vertices->tangent, &vertices->tangent, nvertices.size(), sizeof(Vertex));
+			TransformBatch::basis_xform(p_xform.basis, &vertices->binormal, &vertices->binormal, nvertices.size(), sizeof(Vertex));
 		}
+	}
 
+	vertex_array.reserve(vertex_array.size() + nvertices.size());
+	for (const Vertex &v : nvertices) {
 		vertex_array.push_back(v);
 	}
 
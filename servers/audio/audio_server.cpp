@@ -259,6 +259,8 @@ AudioDriver *AudioDriverManager::get_driver(int p_driver) {
 //////////////////////////////////////////////
 
 void AudioServer::_driver_process(int p_frames, int32_t *p_buffer) {
+	MEMORY_TAG_SCOPE(Memory::TAG_AUDIO);
+
 	mix_count++;
 	int todo = p_frames;
 
@@ -1538,6 +1540,8 @@ void AudioServer::init() {
 }
 
 void AudioServer::update() {
+	MEMORY_TAG_SCOPE(Memory::TAG_AUDIO);
+
 #ifdef DEBUG_ENABLED
 	if (EngineDebugger::is_profiling(SNAME("servers"))) {
 		// Driver time includes server time + effects times
@@ -32,6 +32,7 @@
 #include "physics_server_2d.compat.inc"
 
 #include "core/config/project_settings.h"
+#include "core/templates/small_vector.h"
 #include "core/variant/typed_array.h"
 
 PhysicsServer2D *PhysicsServer2D::singleton = nullptr;
@@ -358,13 +359,17 @@ Dictionary PhysicsDirectSpaceState2D::_intersect_ray(RequiredParam<PhysicsRayQue
 	return d;
 }
 
+// Matches the default result count of the query methods exposed to scripts, so that
+// using the defaults doesn't allocate.
+static constexpr uint32_t QUERY_RESULTS_ON_STACK = 32;
+
 TypedArray<Dictionary> PhysicsDirectSpaceState2D::_intersect_point(RequiredParam<PhysicsPointQueryParameters2D> rp_point_query, int p_max_results) {
 	EXTRACT_PARAM_OR_FAIL_V(p_point_query, rp_point_query, TypedArray<Dictionary>());
 
-	Vector<ShapeResult> ret;
-	ret.resize(p_max_results);
+	SmallVector<ShapeResult, QUERY_RESULTS_ON_STACK> ret;
+	ret.resize(MAX(p_max_results, 0));
 
-	int rc = intersect_point(p_point_query->get_parameters(), ret.ptrw(), ret.size());
+	int rc = intersect_point(p_point_query->get_parameters(), ret.ptr(), ret.size());
 
 	if (rc == 0) {
 		return TypedArray<Dictionary>();
@@ -386,9 +391,9 @@ TypedArray<Dictionary> PhysicsDirectSpaceState2D::_intersect_point(RequiredParam
 TypedArray<Dictionary> PhysicsDirectSpaceState2D::_intersect_shape(RequiredParam<PhysicsShapeQueryParameters2D> rp_shape_query, int p_max_results) {
 	EXTRACT_PARAM_OR_FAIL_V(p_shape_query, rp_shape_query, TypedArray<Dictionary>());
 
-	Vector<ShapeResult> sr;
-	sr.resize(p_max_results);
-	int rc = intersect_shape(p_shape_query->get_parameters(), sr.ptrw(), sr.size());
+	SmallVector<ShapeResult, QUERY_RESULTS_ON_STACK> sr;
+	sr.resize(MAX(p_max_results, 0));
+	int rc = intersect_shape(p_shape_query->get_parameters(), sr.ptr(), sr.size());
 	TypedArray<Dictionary> ret;
 	ret.resize(rc);
 	for (int i = 0; i < rc; i++) {
@@ -421,10 +426,10 @@ Vector<real_t> PhysicsDirectSpaceState2D::_cast_motion(RequiredParam<PhysicsShap
 TypedArray<Vector2> PhysicsDirectSpaceState2D::_collide_shape(RequiredParam<PhysicsShapeQueryParameters2D> rp_shape_query, int p_max_results) {
 	EXTRACT_PARAM_OR_FAIL_V(p_shape_query, rp_shape_query, TypedArray<Vector2>());
 
-	Vector<Vector2> ret;
-	ret.resize(p_max_results * 2);
+	SmallVector<Vector2, QUERY_RESULTS_ON_STACK * 2> ret;
+	ret.resize(MAX(p_max_results * 2, 0));
 	int rc = 0;
-	bool res = collide_shape(p_shape_query->get_parameters(), ret.ptrw(), p_max_results, rc);
+	bool res = collide_shape(p_shape_query->get_parameters(), ret.ptr(), p_max_results, rc);
 	if (!res) {
 		return TypedArray<Vector2>();
 	}
@@ -40,6 +40,8 @@ void PhysicsServer3DWrapMT::_thread_exit() {
 }
 
 void PhysicsServer3DWrapMT::_thread_loop() {
+	MEMORY_TAG_SCOPE(Memory::TAG_PHYSICS);
+
 	while (!exit) {
 		WorkerThreadPool::get_singleton()->yield();
 
@@ -88,6 +90,7 @@ void PhysicsServer3DWrapMT::init() {
 	if (create_thread) {
 		WorkerThreadPool::TaskID tid = WorkerThreadPool::get_singleton()->add_task(callable_mp(this, &PhysicsServer3DWrapMT::_thread_loop), true, "Physics server 3D pump task", true);
 		command_queue.set_pump_task_id(tid);
+		command_queue.enable_ring_buffer(Thread::get_caller_id());
 		command_queue.push(this, &PhysicsServer3DWrapMT::_assign_mt_ids, tid);
 		command_queue.push_and_sync(physics_server_3d, &PhysicsServer3D::init);
 		DEV_ASSERT(server_task_id == tid);
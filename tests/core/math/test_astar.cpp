@@ -33,6 +33,8 @@
 TEST_FORCE_LINK(test_astar)
 
 #include "core/math/a_star.h"
+#include "core/math/random_pcg.h"
+#include "tests/test_benchmark.h"
 
 namespace TestAStar {
 
@@ -234,4 +236,130 @@ TEST_CASE("[AStar3D] Path from disabled point is empty") {
 	CHECK(a.get_point_path(1, 2).is_empty());
 }
 
+// Grid graph of p_size x p_size points with random weights and a few disabled points.
+template <typename T, typename V>
+static void make_grid_graph(T &r_astar, int32_t p_size, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	for (int32_t y = 0; y < p_size; y++) {
+		for (int32_t x = 0; x < p_size; x++) {
+			const int64_t id = y * p_size + x;
+			V pos;
+			pos.x = x;
+			pos.y = y;
+			r_astar.add_point(id, pos, rng.random(1.0f, 3.0f));
+			if (x > 0) {
+				r_astar.connect_points(id, id - 1);
+			}
+			if (y > 0) {
+				r_astar.connect_points(id, id - p_size, rng.rand() % 4 != 0);
+			}
+			if (rng.rand() % 8 == 0) {
+				r_astar.set_point_disabled(id);
+			}
+		}
+	}
+}
+
+static LocalVector<Vector<int64_t>> unpack_id_paths(const PackedInt64Array &p_packed) {
+	LocalVector<Vector<int64_t>> paths;
+	for (int64_t i = 0; i < p_packed.size(); i += p_packed[i] + 1) {
+		paths.push_back(p_packed.slice(i + 1, i + 1 + p_packed[i]));
+	}
+	return paths;
+}
+
+TEST_CASE("[AStar3D] Batched id paths match single queries") {
+	AStar3D a;
+	make_grid_graph<AStar3D, Vector3>(a, 24, 7);
+
+	// Reused point slots must not see stale search data.
+	a.get_id_path(0, 24 * 24 - 1);
+	for (int64_t id = 30; id < 40; id++) {
+		a.remove_point(id);
+	}
+	for (int64_t id = 30; id < 40; id++) {
+		a.add_point(id, Vector3(id - 24, 1, 0));
+		a.connect_points(id, id - 24);
+		a.connect_points(id, id + 24);
+	}
+
+	RandomPCG rng(3);
+	PackedInt64Array from_ids;
+	PackedInt64Array to_ids;
+	for (int i = 0; i < 200; i++) {
+		from_ids.push_back(rng.random(0, 24 * 24 - 1));
+		to_ids.push_back(rng.random(0, 24 * 24 - 1));
+	}
+
+	for (bool allow_partial_path : { false, true }) {
+		LocalVector<Vector<int64_t>> paths = unpack_id_paths(a.get_id_paths(from_ids, to_ids, allow_partial_path));
+		REQUIRE(paths.size() == (uint32_t)from_ids.size());
+		for (int64_t i = 0; i < from_ids.size(); i++) {
+			CHECK(paths[i] == a.get_id_path(from_ids[i], to_ids[i], allow_partial_path));
+		}
+	}
+
+	ERR_PRINT_OFF;
+	CHECK(a.get_id_paths(from_ids, PackedInt64Array()).is_empty());
+	ERR_PRINT_ON;
+	CHECK(a.get_id_paths(PackedInt64Array(), PackedInt64Array()).is_empty());
+}
+
+TEST_CASE("[AStar3D] Batched id paths use overridden costs") {
+	ABCX abcx;
+	PackedInt64Array from_ids = { ABCX::A, ABCX::X, ABCX::C };
+	PackedInt64Array to_ids = { ABCX::C, ABCX::C, ABCX::C };
+	PackedInt64Array expected = { 3, ABCX::A, ABCX::B, ABCX::C, 4, ABCX::X, ABCX::A, ABCX::B, ABCX::C, 1, ABCX::C };
+	CHECK(abcx.get_id_paths(from_ids, to_ids) == expected);
+}
+
+TEST_CASE("[AStar2D] Batched id paths match single queries") {
+	AStar2D a;
+	make_grid_graph<AStar2D, Vector2>(a, 24, 11);
+
+	RandomPCG rng(5);
+	PackedInt64Array from_ids;
+	PackedInt64Array to_ids;
+	for (int i = 0; i < 200; i++) {
+		from_ids.push_back(rng.random(0, 24 * 24 - 1));
+		to_ids.push_back(rng.random(0, 24 * 24 - 1));
+	}
+
+	for (bool allow_partial_path : { false, true }) {
+		LocalVector<Vector<int64_t>> paths = unpack_id_paths(a.get_id_paths(from_ids, to_ids, allow_partial_path));
+		REQUIRE(paths.size() == (uint32_t)from_ids.size());
+		for (int64_t i = 0; i < from_ids.size(); i++) {
+			CHECK(paths[i] == a.get_id_path(from_ids[i], to_ids[i], allow_partial_path));
+		}
+	}
+}
+
+TEST_CASE("[AStar3D][Benchmark] Batched id paths" * doctest::skip()) {
+	const int32_t size = 256;
+	AStar3D a;
+	make_grid_graph<AStar3D, Vector3>(a, size, 1);
+
+	RandomPCG rng(2);
+	for (int32_t count : { 1, 16, 256 }) {
+		PackedInt64Array from_ids;
+		PackedInt64Array to_ids;
+		for (int32_t i = 0; i < count; i++) {
+			from_ids.push_back(rng.random(0, size * size - 1));
+			to_ids.push_back(rng.random(0, size * size - 1));
+		}
+
+		TestBenchmark::run(vformat("AStar3D single queries (256 x 256, %d paths)", count), [&]() {
+			int64_t length = 0;
+			for (int32_t i = 0; i < count; i++) {
+				length += a.get_id_path(from_ids[i], to_ids[i], true).size();
+			}
+			TestBenchmark::do_not_optimize(length);
+		});
+
+		TestBenchmark::run(vformat("AStar3D batched queries (256 x 256, %d paths)", count), [&]() {
+			TestBenchmark::do_not_optimize(a.get_id_paths(from_ids, to_ids, true).size());
+		});
+	}
+}
+
 } // namespace TestAStar
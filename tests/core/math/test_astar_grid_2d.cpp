@@ -0,0 +1,257 @@
+/**************************************************************************/
+/*  test_astar_grid_2d.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_astar_grid_2d)
+
+#include "core/math/a_star_grid_2d.h"
+#include "core/math/random_pcg.h"
+#include "core/variant/typed_array.h"
+#include "tests/test_benchmark.h"
+
+namespace TestAStarGrid2D {
+
+static Ref<AStarGrid2D> create_random_grid(RandomPCG &p_rng, const Rect2i &p_region, real_t p_solid_ratio) {
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(p_region);
+	grid->update();
+	for (int32_t y = p_region.position.y; y < p_region.get_end().y; y++) {
+		for (int32_t x = p_region.position.x; x < p_region.get_end().x; x++) {
+			if (p_rng.randf() < p_solid_ratio) {
+				grid->set_point_solid(Vector2i(x, y));
+			}
+		}
+	}
+	return grid;
+}
+
+// Returns the cost of the path, or -1 if a step isn't allowed by the diagonal mode.
+static real_t get_path_cost(const Ref<AStarGrid2D> &p_grid, const TypedArray<Vector2i> &p_path) {
+	real_t cost = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		const Vector2i from = p_path[i - 1];
+		const Vector2i to = p_path[i];
+		const Vector2i step = to - from;
+		if (step == Vector2i() || Math::abs(step.x) > 1 || Math::abs(step.y) > 1 || p_grid->is_point_solid(to)) {
+			return -1;
+		}
+		if (step.x != 0 && step.y != 0) {
+			const bool a = !p_grid->is_point_solid(Vector2i(to.x, from.y));
+			const bool b = !p_grid->is_point_solid(Vector2i(from.x, to.y));
+			switch (p_grid->get_diagonal_mode()) {
+				case AStarGrid2D::DIAGONAL_MODE_NEVER:
+					return -1;
+				case AStarGrid2D::DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE:
+					if (!a && !b) {
+						return -1;
+					}
+					break;
+				case AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES:
+					if (!a || !b) {
+						return -1;
+					}
+					break;
+				default:
+					break;
+			}
+		}
+		cost += Vector2(step).length();
+	}
+	return cost;
+}
+
+TEST_CASE("[AStarGrid2D] Hierarchical paths are valid and close to the shortest ones") {
+	RandomPCG rng(1234);
+	// The region isn't a multiple of the cluster size, so the last clusters are smaller.
+	const Rect2i region = Rect2i(-5, 3, 90, 61);
+
+	for (int mode = 0; mode < AStarGrid2D::DIAGONAL_MODE_MAX; mode++) {
+		Ref<AStarGrid2D> grid = create_random_grid(rng, region, 0.3);
+		grid->set_diagonal_mode(AStarGrid2D::DiagonalMode(mode));
+
+		int found = 0;
+		int mismatches = 0;
+		int invalid = 0;
+		real_t flat_cost = 0;
+		real_t hierarchical_cost = 0;
+		for (int i = 0; i < 200; i++) {
+			const Vector2i from = Vector2i(rng.random(region.position.x, region.get_end().x - 1), rng.random(region.position.y, region.get_end().y - 1));
+			const Vector2i to = Vector2i(rng.random(region.position.x, region.get_end().x - 1), rng.random(region.position.y, region.get_end().y - 1));
+
+			grid->set_hierarchical_enabled(false);
+			const TypedArray<Vector2i> flat_path = grid->get_id_path(from, to);
+			grid->set_hierarchical_enabled(true);
+			grid->set_cluster_size(8);
+			const TypedArray<Vector2i> path = grid->get_id_path(from, to);
+
+			if (flat_path.is_empty() != path.is_empty()) {
+				mismatches++;
+				continue;
+			}
+			if (path.is_empty()) {
+				continue;
+			}
+			const Vector2i first = path[0];
+			const Vector2i last = path[path.size() - 1];
+			const real_t cost = get_path_cost(grid, path);
+			if (first != from || last != to || cost < 0) {
+				invalid++;
+				continue;
+			}
+			found++;
+			flat_cost += get_path_cost(grid, flat_path);
+			hierarchical_cost += cost;
+		}
+		CHECK_MESSAGE(found > 20, "Many points should be connected.");
+		CHECK(mismatches == 0);
+		CHECK(invalid == 0);
+		CHECK(hierarchical_cost >= flat_cost);
+		CHECK_MESSAGE(hierarchical_cost <= flat_cost * 1.2, "Hierarchical paths should be close to the shortest ones.");
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Hierarchical clusters are updated with the grid") {
+	RandomPCG rng(4321);
+	// Enough clusters for the fresh grids to be built on threads, unlike the updated one.
+	const Rect2i region = Rect2i(0, 0, 100, 100);
+	Ref<AStarGrid2D> grid = create_random_grid(rng, region, 0.25);
+	grid->set_hierarchical_enabled(true);
+	grid->set_cluster_size(10);
+
+	for (int round = 0; round < 10; round++) {
+		LocalVector<Vector2i> queries;
+		for (int i = 0; i < 40; i++) {
+			queries.push_back(Vector2i(rng.random(0, 99), rng.random(0, 99)));
+		}
+
+		// Clusters built from scratch must give the same paths as the updated ones.
+		Ref<AStarGrid2D> fresh;
+		fresh.instantiate();
+		fresh->set_region(region);
+		fresh->update();
+		for (int32_t y = 0; y < region.size.y; y++) {
+			for (int32_t x = 0; x < region.size.x; x++) {
+				fresh->set_point_solid(Vector2i(x, y), grid->is_point_solid(Vector2i(x, y)));
+			}
+		}
+		fresh->set_hierarchical_enabled(true);
+		fresh->set_cluster_size(10);
+
+		int mismatches = 0;
+		for (uint32_t i = 0; i + 1 < queries.size(); i += 2) {
+			if (grid->get_id_path(queries[i], queries[i + 1]) != fresh->get_id_path(queries[i], queries[i + 1])) {
+				mismatches++;
+			}
+		}
+		CHECK(mismatches == 0);
+
+		for (int i = 0; i < 100; i++) {
+			const Vector2i id = Vector2i(rng.random(0, 99), rng.random(0, 99));
+			grid->set_point_solid(id, !grid->is_point_solid(id));
+		}
+		const Vector2i corner = Vector2i(rng.random(0, 95), rng.random(0, 95));
+		grid->fill_solid_region(Rect2i(corner, Size2i(4, 4)), rng.randf() < 0.5);
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Hierarchical partial paths") {
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(0, 0, 32, 32));
+	grid->update();
+	// A closed room around the end.
+	grid->fill_solid_region(Rect2i(20, 20, 8, 8));
+	grid->fill_solid_region(Rect2i(21, 21, 6, 6), false);
+	grid->set_hierarchical_enabled(true);
+	grid->set_cluster_size(8);
+
+	CHECK(grid->get_id_path(Vector2i(0, 0), Vector2i(23, 23)).is_empty());
+	const TypedArray<Vector2i> partial_path = grid->get_id_path(Vector2i(0, 0), Vector2i(23, 23), true);
+	grid->set_hierarchical_enabled(false);
+	CHECK(partial_path == grid->get_id_path(Vector2i(0, 0), Vector2i(23, 23), true));
+}
+
+TEST_CASE("[AStarGrid2D][Benchmark] Hierarchical pathfinding on a large grid" * doctest::skip()) {
+	// Rooms of 32 x 32 points with a few doors, on a 2048 x 2048 grid.
+	const int32_t size = 2048;
+	RandomPCG rng(42);
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(0, 0, size, size));
+	grid->update();
+	for (int32_t i = 0; i < size; i += 32) {
+		grid->fill_solid_region(Rect2i(i, 0, 1, size));
+		grid->fill_solid_region(Rect2i(0, i, size, 1));
+	}
+	for (int32_t y = 0; y < size; y += 32) {
+		for (int32_t x = 0; x < size; x += 32) {
+			grid->fill_solid_region(Rect2i(x + rng.random(1, 28), y, 3, 1), false);
+			grid->fill_solid_region(Rect2i(x, y + rng.random(1, 28), 1, 3), false);
+		}
+	}
+
+	LocalVector<Vector2i> queries;
+	for (int i = 0; i < 20; i++) {
+		queries.push_back(Vector2i(rng.random(1, size - 1), rng.random(1, size - 1)));
+	}
+
+	TestBenchmark::run("AStarGrid2D flat queries (2048 x 2048, 10 paths)", [&]() {
+		int64_t length = 0;
+		for (uint32_t i = 0; i < queries.size(); i += 2) {
+			length += grid->get_id_path(queries[i], queries[i + 1]).size();
+		}
+		TestBenchmark::do_not_optimize(length);
+	});
+
+	grid->set_hierarchical_enabled(true);
+	TestBenchmark::run("AStarGrid2D hierarchical build (2048 x 2048)", [&]() {
+		grid->set_cluster_size(grid->get_cluster_size() == 16 ? 17 : 16);
+		TestBenchmark::do_not_optimize(grid->get_id_path(Vector2i(1, 1), Vector2i(2, 2)).size());
+	});
+	grid->set_cluster_size(16);
+
+	TestBenchmark::run("AStarGrid2D hierarchical queries (2048 x 2048, 10 paths)", [&]() {
+		int64_t length = 0;
+		for (uint32_t i = 0; i < queries.size(); i += 2) {
+			length += grid->get_id_path(queries[i], queries[i + 1]).size();
+		}
+		TestBenchmark::do_not_optimize(length);
+	});
+
+	TestBenchmark::run("AStarGrid2D hierarchical update and query (2048 x 2048, 1 point)", [&]() {
+		const Vector2i id = Vector2i(rng.random(1, size - 1), rng.random(1, size - 1));
+		grid->set_point_solid(id, !grid->is_point_solid(id));
+		TestBenchmark::do_not_optimize(grid->get_id_path(queries[0], queries[1]).size());
+	});
+}
+
+} // namespace TestAStarGrid2D
@@ -0,0 +1,326 @@
+/**************************************************************************/
+/*  test_bvh.cpp                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_bvh)
+
+#include "core/math/bvh.h"
+#include "core/math/random_pcg.h"
+#include "core/templates/hash_set.h"
+#include "tests/test_benchmark.h"
+
+namespace TestBVH {
+
+struct Object {
+	uint32_t id = 0;
+	AABB aabb;
+};
+
+template <typename T>
+class PairTestFunction {
+public:
+	static bool user_pair_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+template <typename T>
+class CullTestFunction {
+public:
+	static bool user_cull_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+// Small leaves so that a few thousand objects are enough for the threaded paths.
+typedef BVH_Manager<Object, 2, true, 4, PairTestFunction<Object>, CullTestFunction<Object>> PairingBVH;
+
+// Keeps the set of pairs up to date from the callbacks.
+struct PairSet {
+	HashSet<uint64_t> pairs;
+
+	static uint64_t key(const Object *p_a, const Object *p_b) {
+		return (uint64_t)MIN(p_a->id, p_b->id) << 32 | MAX(p_a->id, p_b->id);
+	}
+
+	static void *pair(void *p_self, uint32_t p_id_a, Object *p_a, int p_subindex_a, uint32_t p_id_b, Object *p_b, int p_subindex_b) {
+		((PairSet *)p_self)->pairs.insert(key(p_a, p_b));
+		return nullptr;
+	}
+
+	static void unpair(void *p_self, uint32_t p_id_a, Object *p_a, int p_subindex_a, uint32_t p_id_b, Object *p_b, int p_subindex_b, void *p_pair_data) {
+		((PairSet *)p_self)->pairs.erase(key(p_a, p_b));
+	}
+};
+
+// Coordinates on a coarse grid, so boxes often touch exactly.
+static AABB random_aabb(RandomPCG &p_rng, real_t p_world_size, real_t p_max_size) {
+	const Vector3 position = Vector3(p_rng.random(0.0f, (float)p_world_size), p_rng.random(0.0f, (float)p_world_size), p_rng.random(0.0f, (float)p_world_size)).snappedf(0.25);
+	const Vector3 size = Vector3(p_rng.random(0.0f, (float)p_max_size), p_rng.random(0.0f, (float)p_max_size), p_rng.random(0.0f, (float)p_max_size)).snappedf(0.25);
+	return AABB(position, size);
+}
+
+static bool aabbs_touch(const AABB &p_a, const AABB &p_b) {
+	const Vector3 a_end = p_a.get_end();
+	const Vector3 b_end = p_b.get_end();
+	return p_a.position.x <= b_end.x && p_a.position.y <= b_end.y && p_a.position.z <= b_end.z &&
+			p_b.position.x <= a_end.x && p_b.position.y <= a_end.y && p_b.position.z <= a_end.z;
+}
+
+static Vector<uint32_t> sorted_ids(Object **p_results, int p_count) {
+	Vector<uint32_t> ids;
+	for (int i = 0; i < p_count; i++) {
+		ids.push_back(p_results[i]->id);
+	}
+	ids.sort();
+	return ids;
+}
+
+TEST_CASE("[BVH] Culling matches a brute force search") {
+	constexpr int COUNT = 2000;
+	constexpr int QUERIES = 100;
+
+	RandomPCG rng(7);
+	LocalVector<Object> objects;
+	objects.resize(COUNT);
+
+	BVH_Manager<Object> bvh;
+	bvh.params_set_pairing_expansion(0);
+	LocalVector<BVHHandle> handles;
+	for (int i = 0; i < COUNT; i++) {
+		objects[i].id = i;
+		objects[i].aabb = random_aabb(rng, 100, 4);
+		handles.push_back(bvh.create(&objects[i], true, 0, 1, objects[i].aabb));
+	}
+
+	LocalVector<Object *> results;
+	results.resize(COUNT);
+
+	for (int pass = 0; pass < 2; pass++) {
+		if (pass == 1) {
+			// move some of the objects, both a little and far, then check again
+			for (int i = 0; i < COUNT; i += 3) {
+				objects[i].aabb = (i % 2) ? objects[i].aabb.grow(0.25) : random_aabb(rng, 100, 4);
+				bvh.move(handles[i], objects[i].aabb);
+			}
+			bvh.update();
+		}
+
+		for (int q = 0; q < QUERIES; q++) {
+			const AABB query = random_aabb(rng, 100, 20);
+			Vector<uint32_t> expected;
+			for (const Object &object : objects) {
+				if (aabbs_touch(object.aabb, query)) {
+					expected.push_back(object.id);
+				}
+			}
+			const int count = bvh.cull_aabb(query, results.ptr(), COUNT, nullptr);
+			CHECK_MESSAGE(sorted_ids(results.ptr(), count) == expected, "cull_aabb() should find all the touching boxes.");
+		}
+
+		for (int q = 0; q < QUERIES; q++) {
+			const Vector3 point = random_aabb(rng, 100, 0).position;
+			Vector<uint32_t> expected;
+			for (const Object &object : objects) {
+				if (aabbs_touch(object.aabb, AABB(point, Vector3()))) {
+					expected.push_back(object.id);
+				}
+			}
+			const int count = bvh.cull_point(point, results.ptr(), COUNT, nullptr);
+			CHECK_MESSAGE(sorted_ids(results.ptr(), count) == expected, "cull_point() should find all the boxes containing the point.");
+		}
+
+		for (int q = 0; q < QUERIES; q++) {
+			const Vector3 from = random_aabb(rng, 100, 0).position;
+			const Vector3 to = random_aabb(rng, 100, 0).position;
+			Vector<uint32_t> expected;
+			for (const Object &object : objects) {
+				if (object.aabb.intersects_segment(from, to)) {
+					expected.push_back(object.id);
+				}
+			}
+			const int count = bvh.cull_segment(from, to, results.ptr(), COUNT, nullptr);
+			CHECK_MESSAGE(sorted_ids(results.ptr(), count) == expected, "cull_segment() should find all the boxes crossed by the segment.");
+		}
+	}
+}
+
+TEST_CASE("[BVH] Culling 2D bounds matches a brute force search") {
+	constexpr int COUNT = 1000;
+
+	RandomPCG rng(11);
+	LocalVector<Rect2> rects;
+	LocalVector<Object> objects;
+	objects.resize(COUNT);
+
+	BVH_Manager<Object, 1, false, 32, BVH_DummyPairTestFunction<Object>, BVH_DummyCullTestFunction<Object>, Rect2, Vector2> bvh;
+	bvh.params_set_pairing_expansion(0);
+	for (int i = 0; i < COUNT; i++) {
+		const AABB aabb = random_aabb(rng, 100, 4);
+		rects.push_back(Rect2(aabb.position.x, aabb.position.y, aabb.size.x, aabb.size.y));
+		objects[i].id = i;
+		bvh.create(&objects[i], true, 0, 1, rects[i]);
+	}
+
+	LocalVector<Object *> results;
+	results.resize(COUNT);
+	for (int q = 0; q < 100; q++) {
+		const AABB query_aabb = random_aabb(rng, 100, 20);
+		const Rect2 query = Rect2(query_aabb.position.x, query_aabb.position.y, query_aabb.size.x, query_aabb.size.y);
+		Vector<uint32_t> expected;
+		for (int i = 0; i < COUNT; i++) {
+			const Vector2 end = rects[i].get_end();
+			const Vector2 query_end = query.get_end();
+			if (rects[i].position.x <= query_end.x && rects[i].position.y <= query_end.y && query.position.x <= end.x && query.position.y <= end.y) {
+				expected.push_back(i);
+			}
+		}
+		const int count = bvh.cull_aabb(query, results.ptr(), COUNT, nullptr);
+		CHECK_MESSAGE(sorted_ids(results.ptr(), count) == expected, "cull_aabb() should find all the touching rectangles.");
+	}
+}
+
+TEST_CASE("[BVH] Threaded refitting and pairing give the same pairs") {
+	constexpr int COUNT = 6000;
+	constexpr int FRAMES = 8;
+
+	RandomPCG rng(3);
+	LocalVector<Object> objects;
+	objects.resize(COUNT);
+
+	PairingBVH bvhs[2];
+	PairSet pair_sets[2];
+	LocalVector<BVHHandle> handles[2];
+	for (int b = 0; b < 2; b++) {
+		bvhs[b].params_set_use_threads(b == 1);
+		bvhs[b].set_pair_callback(PairSet::pair, &pair_sets[b]);
+		bvhs[b].set_unpair_callback(PairSet::unpair, &pair_sets[b]);
+	}
+
+	for (int i = 0; i < COUNT; i++) {
+		objects[i].id = i;
+		objects[i].aabb = random_aabb(rng, 60, 2);
+		// static objects go in the first tree, and only the moving ones collide with it
+		const bool is_static = i % 4 == 0;
+		for (int b = 0; b < 2; b++) {
+			handles[b].push_back(bvhs[b].create(&objects[i], true, is_static ? 0 : 1, is_static ? 2 : 3, objects[i].aabb));
+		}
+	}
+
+	for (int frame = 0; frame < FRAMES; frame++) {
+		for (int i = 0; i < COUNT; i++) {
+			if (i % 4 == 0) {
+				continue;
+			}
+			objects[i].aabb.position += Vector3(rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f));
+			for (int b = 0; b < 2; b++) {
+				bvhs[b].move(handles[b][i], objects[i].aabb);
+			}
+		}
+		for (int b = 0; b < 2; b++) {
+			bvhs[b].update();
+		}
+
+		CHECK(pair_sets[0].pairs.size() > 0);
+		bool same_pairs = pair_sets[0].pairs.size() == pair_sets[1].pairs.size();
+		for (const uint64_t &pair : pair_sets[0].pairs) {
+			same_pairs = same_pairs && pair_sets[1].pairs.has(pair);
+		}
+		CHECK_MESSAGE(same_pairs, "The threaded BVH should find the same pairs.");
+
+		LocalVector<Object *> results[2];
+		for (int q = 0; q < 20; q++) {
+			const AABB query = random_aabb(rng, 60, 10);
+			int counts[2];
+			for (int b = 0; b < 2; b++) {
+				results[b].resize(COUNT);
+				counts[b] = bvhs[b].cull_aabb(query, results[b].ptr(), COUNT, nullptr);
+			}
+			CHECK(sorted_ids(results[0].ptr(), counts[0]) == sorted_ids(results[1].ptr(), counts[1]));
+		}
+	}
+}
+
+TEST_CASE("[BVH][Benchmark] Moving 100k objects" * doctest::skip()) {
+	constexpr int COUNT = 100000;
+
+	RandomPCG rng(1);
+	LocalVector<Object> objects;
+	objects.resize(COUNT);
+	LocalVector<Vector3> velocities;
+	for (int i = 0; i < COUNT; i++) {
+		objects[i].id = i;
+		objects[i].aabb = AABB(Vector3(rng.random(0.0f, 500.0f), rng.random(0.0f, 500.0f), rng.random(0.0f, 500.0f)), Vector3(1, 1, 1));
+		velocities.push_back(Vector3(rng.random(-0.1f, 0.1f), rng.random(-0.1f, 0.1f), rng.random(-0.1f, 0.1f)));
+	}
+
+	for (int threaded = 0; threaded < 2; threaded++) {
+		// same layout as the physics broadphase
+		BVH_Manager<Object, 2, true, 128, PairTestFunction<Object>, CullTestFunction<Object>> bvh;
+		bvh.params_set_use_threads(threaded);
+		LocalVector<BVHHandle> handles;
+		for (Object &object : objects) {
+			handles.push_back(bvh.create(&object, true, 1, 3, object.aabb));
+		}
+		bvh.update();
+
+		TestBenchmark::run(threaded ? "BVH move and update (100k objects, threaded)" : "BVH move and update (100k objects)", [&]() {
+			for (int i = 0; i < COUNT; i++) {
+				objects[i].aabb.position += velocities[i];
+				bvh.move(handles[i], objects[i].aabb);
+			}
+			bvh.update();
+		});
+
+		if (!threaded) {
+			LocalVector<Object *> results;
+			results.resize(COUNT);
+			TestBenchmark::run("BVH cull_aabb (100k objects, 1000 queries)", [&]() {
+				int total = 0;
+				for (int q = 0; q < 1000; q++) {
+					const Vector3 position = objects[(q * 97) % COUNT].aabb.position;
+					total += bvh.cull_aabb(AABB(position, Vector3(10, 10, 10)), results.ptr(), COUNT, nullptr);
+				}
+				TestBenchmark::do_not_optimize(total);
+			});
+			TestBenchmark::run("BVH cull_segment (100k objects, 1000 queries)", [&]() {
+				int total = 0;
+				for (int q = 0; q < 1000; q++) {
+					const Vector3 from = objects[(q * 97) % COUNT].aabb.position;
+					total += bvh.cull_segment(from, from + Vector3(50, 20, -30), results.ptr(), COUNT, nullptr);
+				}
+				TestBenchmark::do_not_optimize(total);
+			});
+		}
+	}
+}
+
+} // namespace TestBVH
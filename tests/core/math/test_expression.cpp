@@ -33,6 +33,7 @@
 TEST_FORCE_LINK(test_expression)
 
 #include "core/math/expression.h"
+#include "tests/test_benchmark.h"
 
 namespace TestExpression {
 
@@ -488,4 +489,136 @@ TEST_CASE("[Expression] Unusual expressions") {
 	//		"`(-9223372036854775807 - 1) / -1` should return the expected result.");
 }
 
+TEST_CASE("[Expression] Numeric operators on inputs") {
+	Expression expression;
+	PackedStringArray parameter_names = { "a", "b" };
+
+	CHECK_MESSAGE(
+			expression.parse("a + b", parameter_names) == OK,
+			"The expression should parse successfully.");
+	Variant result = expression.execute({ 2, 3 });
+	CHECK_MESSAGE(
+			(result.get_type() == Variant::INT && int(result) == 5),
+			"Integer addition should return an integer.");
+	result = expression.execute({ 2, 0.5 });
+	CHECK_MESSAGE(
+			(result.get_type() == Variant::FLOAT && double(result) == 2.5),
+			"Mixed addition should return a float.");
+	result = expression.execute({ "foo", "bar" });
+	CHECK_MESSAGE(
+			String(result) == "foobar",
+			"Other types should still be added.");
+
+	CHECK_MESSAGE(
+			expression.parse("a / b", parameter_names) == OK,
+			"The expression should parse successfully.");
+	result = expression.execute({ 7, 2 });
+	CHECK_MESSAGE(
+			(result.get_type() == Variant::INT && int(result) == 3),
+			"Integer division should return an integer.");
+	result = expression.execute({ 7.0, 2 });
+	CHECK_MESSAGE(
+			double(result) == 3.5,
+			"Float division should return the expected result.");
+	ERR_PRINT_OFF;
+	expression.execute({ 7, 0 });
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Integer division by zero should fail.");
+	ERR_PRINT_ON;
+
+	CHECK_MESSAGE(
+			expression.parse("a * b <= -a", parameter_names) == OK,
+			"The expression should parse successfully.");
+	result = expression.execute({ 2, -1 });
+	CHECK_MESSAGE(
+			(result.get_type() == Variant::BOOL && bool(result)),
+			"Comparisons should return a boolean.");
+	result = expression.execute({ 0.5, 1 });
+	CHECK_MESSAGE(
+			(result.get_type() == Variant::BOOL && !bool(result)),
+			"Comparisons should return a boolean.");
+}
+
+TEST_CASE("[Expression] Constant subexpressions") {
+	Expression expression;
+	PackedStringArray parameter_names = { "x" };
+
+	CHECK_MESSAGE(
+			expression.parse("x * (Vector2(1, 2).y + 3 * 2)", parameter_names) == OK,
+			"The expression should parse successfully.");
+	CHECK_MESSAGE(
+			double(expression.execute({ 0.5 })) == 4.0,
+			"The expression should return the expected result.");
+
+	// Containers must not be shared between executions.
+	CHECK_MESSAGE(
+			expression.parse("[1, 2]") == OK,
+			"The expression should parse successfully.");
+	Array first = expression.execute();
+	first.push_back(3);
+	Array second = expression.execute();
+	CHECK_MESSAGE(
+			second.size() == 2,
+			"Each execution should return a new array.");
+
+	// Invalid operations are still reported when executing.
+	CHECK_MESSAGE(
+			expression.parse("1 + (5 % 0)") == OK,
+			"The expression should parse successfully.");
+	ERR_PRINT_OFF;
+	expression.execute();
+	CHECK_MESSAGE(
+			expression.has_execute_failed(),
+			"Modulo by zero should fail.");
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[Expression] Expressions parsed from the same text") {
+	Expression first;
+	Expression second;
+	PackedStringArray parameter_names = { "foo" };
+
+	CHECK(first.parse("foo * 2", parameter_names) == OK);
+	CHECK(second.parse("foo * 2", parameter_names) == OK);
+	CHECK(int(first.execute({ 3 })) == 6);
+	CHECK(int(second.execute({ 4 })) == 8);
+
+	// Without the input, `foo` is a property of the base instance.
+	CHECK(second.parse("foo * 2") == OK);
+	ERR_PRINT_OFF;
+	second.execute({ 4 });
+	ERR_PRINT_ON;
+	CHECK(second.has_execute_failed());
+	CHECK(int(first.execute({ 5 })) == 10);
+
+	// Parse errors are reported every time.
+	CHECK(first.parse("foo *", parameter_names) == ERR_INVALID_PARAMETER);
+	CHECK(second.parse("foo *", parameter_names) == ERR_INVALID_PARAMETER);
+	CHECK_FALSE(second.get_error_text().is_empty());
+}
+
+TEST_CASE("[Expression][Benchmark] Formula evaluation" * doctest::skip()) {
+	Expression expression;
+	PackedStringArray parameter_names = { "x", "y", "t" };
+	const String formula = "x * x + y * 0.5 - (t * 2.0 + PI / 4.0) / (x + 1)";
+	Array inputs = { 1.5, 2.5, 0.25 };
+	REQUIRE(expression.parse(formula, parameter_names) == OK);
+
+	TestBenchmark::run("Expression execute (numeric formula)", [&]() {
+		TestBenchmark::do_not_optimize(expression.execute(inputs));
+	});
+
+	TestBenchmark::run("Expression parse and execute (numeric formula)", [&]() {
+		expression.parse(formula, parameter_names);
+		TestBenchmark::do_not_optimize(expression.execute(inputs));
+	});
+
+	Expression calls;
+	REQUIRE(calls.parse("Vector2(x, y).length() + snappedf(t, 0.1)", parameter_names) == OK);
+	TestBenchmark::run("Expression execute (constructor and calls)", [&]() {
+		TestBenchmark::do_not_optimize(calls.execute(inputs));
+	});
+}
+
 } // namespace TestExpression
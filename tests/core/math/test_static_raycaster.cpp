@@ -0,0 +1,340 @@
+/**************************************************************************/
+/*  test_static_raycaster.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_static_raycaster)
+
+#include "core/math/random_pcg.h"
+#include "core/math/static_raycaster_bvh.h"
+#include "tests/test_benchmark.h"
+
+namespace TestStaticRaycaster {
+
+typedef StaticRaycaster::Ray Ray;
+
+struct TestMesh {
+	PackedVector3Array vertices;
+	PackedInt32Array indices;
+	unsigned int id = 0;
+};
+
+// An indexed grid and a soup of random triangles, both overlapping the same space.
+static LocalVector<TestMesh> create_test_meshes(RandomPCG &p_rng) {
+	LocalVector<TestMesh> meshes;
+
+	TestMesh grid;
+	grid.id = 7;
+	const int size = 16;
+	for (int x = 0; x <= size; x++) {
+		for (int z = 0; z <= size; z++) {
+			grid.vertices.push_back(Vector3(x - size / 2, p_rng.random(-6.0f, -4.0f), z - size / 2));
+		}
+	}
+	for (int x = 0; x < size; x++) {
+		for (int z = 0; z < size; z++) {
+			const int a = x * (size + 1) + z;
+			const int b = a + size + 1;
+			grid.indices.append_array({ a, b, a + 1, b, b + 1, a + 1 });
+		}
+	}
+	meshes.push_back(grid);
+
+	TestMesh soup;
+	soup.id = 3;
+	for (int i = 0; i < 1000; i++) {
+		const Vector3 center = Vector3(p_rng.random(-20.0f, 20.0f), p_rng.random(-20.0f, 20.0f), p_rng.random(-20.0f, 20.0f));
+		for (int j = 0; j < 3; j++) {
+			soup.vertices.push_back(center + Vector3(p_rng.random(-2.0f, 2.0f), p_rng.random(-2.0f, 2.0f), p_rng.random(-2.0f, 2.0f)));
+		}
+	}
+	meshes.push_back(soup);
+
+	return meshes;
+}
+
+static Ref<StaticRaycasterBVH> create_raycaster(const LocalVector<TestMesh> &p_meshes) {
+	Ref<StaticRaycasterBVH> raycaster;
+	raycaster.instantiate();
+	for (const TestMesh &mesh : p_meshes) {
+		raycaster->add_mesh(mesh.vertices, mesh.indices, mesh.id);
+	}
+	raycaster->commit();
+	return raycaster;
+}
+
+// Closest hit over all triangles, ties going to the triangle added first.
+static void brute_force_intersect(const LocalVector<TestMesh> &p_meshes, const HashSet<int> &p_filter, Ray &r_ray) {
+	real_t t_max = r_ray.tfar;
+	for (const TestMesh &mesh : p_meshes) {
+		if (p_filter.has(mesh.id)) {
+			continue;
+		}
+		const int count = (mesh.indices.is_empty() ? mesh.vertices.size() : mesh.indices.size()) / 3;
+		for (int i = 0; i < count; i++) {
+			Vector3 vertices[3];
+			for (int j = 0; j < 3; j++) {
+				vertices[j] = mesh.vertices[mesh.indices.is_empty() ? i * 3 + j : mesh.indices[i * 3 + j]];
+			}
+			const Vector3 e1 = vertices[1] - vertices[0];
+			const Vector3 e2 = vertices[2] - vertices[0];
+			const Vector3 h = r_ray.dir.cross(e2);
+			const real_t a = e1.dot(h);
+			const real_t f = 1.0f / a;
+			const Vector3 s = r_ray.org - vertices[0];
+			const real_t u = f * s.dot(h);
+			const Vector3 q = s.cross(e1);
+			const real_t v = f * r_ray.dir.dot(q);
+			const real_t t = f * e2.dot(q);
+			const bool hit = a != 0 && u >= 0 && v >= 0 && u + v <= 1 && t >= r_ray.tnear && t <= t_max;
+			if (hit && (t < t_max || r_ray.geomID == Ray::INVALID_GEOMETRY_ID)) {
+				t_max = t;
+				r_ray.tfar = t;
+				r_ray.u = u;
+				r_ray.v = v;
+				r_ray.normal = e1.cross(e2);
+				r_ray.primID = i;
+				r_ray.geomID = mesh.id;
+			}
+		}
+	}
+}
+
+static bool rays_equal(const Ray &p_a, const Ray &p_b) {
+	if (p_a.geomID != p_b.geomID) {
+		return false;
+	}
+	return p_a.geomID == Ray::INVALID_GEOMETRY_ID || (p_a.primID == p_b.primID && p_a.tfar == p_b.tfar && p_a.u == p_b.u && p_a.v == p_b.v && p_a.normal == p_b.normal);
+}
+
+static Ray create_random_ray(RandomPCG &p_rng, int p_index) {
+	const Vector3 from = Vector3(p_rng.random(-30.0f, 30.0f), p_rng.random(-30.0f, 30.0f), p_rng.random(-30.0f, 30.0f));
+	Vector3 dir = Vector3(p_rng.random(-1.0f, 1.0f), p_rng.random(-1.0f, 1.0f), p_rng.random(-1.0f, 1.0f));
+	if (p_index % 4 == 0) {
+		// Axis aligned rays have zero components in their direction.
+		dir = Vector3();
+		dir[p_index % 3] = (p_index % 8) ? 1 : -1;
+	}
+	if (p_index % 5 == 0) {
+		return Ray(from, dir, p_rng.random(0.0f, 10.0f), p_rng.random(10.0f, 40.0f));
+	}
+	return Ray(from, dir);
+}
+
+// Rows of rays from a camera at one corner, the way occlusion culling traces them.
+static Vector<Ray> create_camera_rays(int p_size) {
+	Vector<Ray> rays;
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			const Vector3 dir = Vector3(x / real_t(p_size) - 0.5, y / real_t(p_size) - 0.5, -1.0);
+			rays.push_back(Ray(Vector3(0, 0, 30), dir, 0.0f, 100.0f));
+		}
+	}
+	return rays;
+}
+
+TEST_CASE("[StaticRaycaster] Built-in raycaster matches a brute force search") {
+	RandomPCG rng(12345);
+	const LocalVector<TestMesh> meshes = create_test_meshes(rng);
+	Ref<StaticRaycasterBVH> raycaster = create_raycaster(meshes);
+
+	int hits = 0;
+	int mismatches = 0;
+	for (int i = 0; i < 2000; i++) {
+		Ray ray = create_random_ray(rng, i);
+		Ray expected = ray;
+		brute_force_intersect(meshes, HashSet<int>(), expected);
+		const bool hit = raycaster->intersect(ray);
+		if (hit != bool(expected) || !rays_equal(ray, expected)) {
+			mismatches++;
+		}
+		hits += hit;
+	}
+	CHECK_MESSAGE(hits > 200, "Many rays should hit something.");
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("[StaticRaycaster] Batched rays match single rays") {
+	RandomPCG rng(54321);
+	const LocalVector<TestMesh> meshes = create_test_meshes(rng);
+	Ref<StaticRaycasterBVH> raycaster = create_raycaster(meshes);
+
+	// Coherent rays are traced in packets, incoherent ones one by one.
+	Vector<Ray> rays = create_camera_rays(40);
+	for (int i = 0; i < 1000; i++) {
+		rays.push_back(create_random_ray(rng, i));
+	}
+
+	Vector<Ray> batched = rays;
+	raycaster->intersect(batched);
+
+	int mismatches = 0;
+	for (int i = 0; i < rays.size(); i++) {
+		Ray ray = rays[i];
+		raycaster->intersect(ray);
+		if (!rays_equal(ray, batched[i])) {
+			mismatches++;
+		}
+	}
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("[StaticRaycaster] Mesh filter") {
+	RandomPCG rng(777);
+	const LocalVector<TestMesh> meshes = create_test_meshes(rng);
+	Ref<StaticRaycasterBVH> raycaster = create_raycaster(meshes);
+
+	// Straight down onto the grid, through the soup.
+	HashSet<int> filter;
+	filter.insert(3);
+	raycaster->set_mesh_filter(filter);
+
+	Vector<Ray> rays;
+	for (int i = 0; i < 256; i++) {
+		rays.push_back(Ray(Vector3(rng.random(-7.0f, 7.0f), 30, rng.random(-7.0f, 7.0f)), Vector3(0, -1, 0)));
+	}
+
+	Vector<Ray> filtered = rays;
+	raycaster->intersect(filtered);
+	int mismatches = 0;
+	for (int i = 0; i < rays.size(); i++) {
+		Ray expected = rays[i];
+		brute_force_intersect(meshes, filter, expected);
+		if (filtered[i].geomID != 7 || !rays_equal(filtered[i], expected)) {
+			mismatches++;
+		}
+	}
+	CHECK_MESSAGE(mismatches == 0, "Only the grid should be hit.");
+
+	raycaster->clear_mesh_filter();
+	Vector<Ray> unfiltered = rays;
+	raycaster->intersect(unfiltered);
+	int soup_hits = 0;
+	for (const Ray &ray : unfiltered) {
+		soup_hits += ray.geomID == 3;
+	}
+	CHECK_MESSAGE(soup_hits > 0, "The soup should be hit again once the filter is cleared.");
+}
+
+TEST_CASE("[StaticRaycaster] Ray segment and empty scene") {
+	Ref<StaticRaycasterBVH> raycaster;
+	raycaster.instantiate();
+	raycaster->commit();
+	Ray ray = Ray(Vector3(0, 1, 0), Vector3(0, -1, 0));
+	CHECK_FALSE(raycaster->intersect(ray));
+
+	raycaster->add_mesh(PackedVector3Array({ Vector3(-1, 0, -1), Vector3(-1, 0, 1), Vector3(1, 0, -1) }), PackedInt32Array(), 0);
+	raycaster->commit();
+
+	CHECK(raycaster->intersect(ray));
+	CHECK(ray.geomID == 0);
+	CHECK(ray.primID == 0);
+	CHECK(ray.tfar == doctest::Approx(1.0));
+
+	// Outside of [tnear, tfar].
+	Ray short_ray = Ray(Vector3(0, 1, 0), Vector3(0, -1, 0), 0.0f, 0.5f);
+	CHECK_FALSE(raycaster->intersect(short_ray));
+	CHECK_FALSE(bool(short_ray));
+	Ray late_ray = Ray(Vector3(0, 1, 0), Vector3(0, -1, 0), 1.5f);
+	CHECK_FALSE(raycaster->intersect(late_ray));
+
+	CHECK(StaticRaycaster::create().is_valid());
+}
+
+TEST_CASE("[StaticRaycaster][Benchmark] Million triangle scene" * doctest::skip()) {
+	// A bumpy terrain of 708 x 708 quads, a bit over a million triangles.
+	const int size = 708;
+	PackedVector3Array vertices;
+	PackedInt32Array indices;
+	for (int x = 0; x <= size; x++) {
+		for (int z = 0; z <= size; z++) {
+			vertices.push_back(Vector3(x, Math::sin(x * 0.1) * Math::cos(z * 0.13) * 10.0, z));
+		}
+	}
+	for (int x = 0; x < size; x++) {
+		for (int z = 0; z < size; z++) {
+			const int a = x * (size + 1) + z;
+			const int b = a + size + 1;
+			indices.append_array({ a, b, a + 1, b, b + 1, a + 1 });
+		}
+	}
+
+	RandomPCG rng(42);
+	Vector<Ray> incoherent;
+	for (int i = 0; i < 100000; i++) {
+		const Vector3 from = Vector3(rng.random(0.0f, (float)size), 50.0f, rng.random(0.0f, (float)size));
+		incoherent.push_back(Ray(from, Vector3(rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f))));
+	}
+	Vector<Ray> coherent;
+	for (int y = 0; y < 316; y++) {
+		for (int x = 0; x < 316; x++) {
+			coherent.push_back(Ray(Vector3(size / 2, 40, size / 2), Vector3(x / 316.0 - 0.5, -0.5, y / 316.0 - 0.5)));
+		}
+	}
+
+	// Compares against the registered implementation (Embree) when there is one.
+	LocalVector<Ref<StaticRaycaster>> raycasters;
+	raycasters.push_back(Ref<StaticRaycaster>(StaticRaycasterBVH::create_bvh_raycaster()));
+	Ref<StaticRaycaster> registered = StaticRaycaster::create();
+	if (registered->get_class_name() != raycasters[0]->get_class_name()) {
+		raycasters.push_back(registered);
+	}
+
+	for (Ref<StaticRaycaster> &raycaster : raycasters) {
+		const String name = raycaster->get_class_name();
+		raycaster->add_mesh(vertices, indices, 0);
+		TestBenchmark::run(name + " commit (1M triangles)", [&]() {
+			raycaster->commit();
+		});
+
+		TestBenchmark::run(name + " intersect (1M triangles, 100k incoherent rays)", [&]() {
+			int hits = 0;
+			for (const Ray &ray : incoherent) {
+				Ray r = ray;
+				hits += raycaster->intersect(r);
+			}
+			TestBenchmark::do_not_optimize(hits);
+		});
+
+		TestBenchmark::run(name + " batched intersect (1M triangles, 100k coherent rays)", [&]() {
+			Vector<Ray> rays = coherent;
+			raycaster->intersect(rays);
+			TestBenchmark::do_not_optimize(rays[0].geomID);
+		});
+
+		TestBenchmark::run(name + " batched intersect (1M triangles, 100k incoherent rays)", [&]() {
+			Vector<Ray> rays = incoherent;
+			raycaster->intersect(rays);
+			TestBenchmark::do_not_optimize(rays[0].geomID);
+		});
+	}
+}
+
+} // namespace TestStaticRaycaster
@@ -33,6 +33,7 @@
 TEST_FORCE_LINK(test_transform_2d)
 
 #include "core/math/transform_2d.h"
+#include "core/math/transform_batch.h"
 
 namespace TestTransform2D {
 
@@ -243,4 +244,29 @@ TEST_CASE("[Transform2D] Is conformal checks") {
 			"Transform2D with the X axis skewed 45 degrees should not be conformal.");
 }
 
+TEST_CASE("[Transform2D] Batch transforms match per-vector transforms") {
+	const Transform2D transform = Transform2D(0.7, Size2(2, 3), 0.2, Vector2(4, 5));
+
+	// Sizes around the SIMD width, to cover the remainder loop.
+	for (int count : { 0, 1, 3, 4, 5, 8, 11, 64 }) {
+		Vector<Vector2> points;
+		for (int i = 0; i < count; i++) {
+			points.push_back(Vector2(i * 1.5 - 7, i * 0.25));
+		}
+
+		Vector<Vector2> transformed = transform.xform(points);
+		Vector<Vector2> inverse = transform.xform_inv(points);
+		Vector<Vector2> basis_transformed;
+		basis_transformed.resize(count);
+		TransformBatch::basis_xform(transform, points.ptr(), basis_transformed.ptrw(), count);
+		REQUIRE(transformed.size() == count);
+		REQUIRE(inverse.size() == count);
+		for (int i = 0; i < count; i++) {
+			CHECK(transformed[i].is_equal_approx(transform.xform(points[i])));
+			CHECK(inverse[i].is_equal_approx(transform.xform_inv(points[i])));
+			CHECK(basis_transformed[i].is_equal_approx(transform.basis_xform(points[i])));
+		}
+	}
+}
+
 } // namespace TestTransform2D
@@ -33,6 +33,8 @@
 TEST_FORCE_LINK(test_transform_3d)
 
 #include "core/math/transform_3d.h"
+#include "core/math/transform_batch.h"
+#include "tests/test_benchmark.h"
 
 namespace TestTransform3D {
 
@@ -136,4 +138,84 @@ TEST_CASE("[Transform3D] Rotate in-place (local rotation)") {
 	CHECK_MESSAGE(rotated_transform.is_equal_approx(expected), "The rotated transform should have a new orientation but still be based on the same origin.");
 }
 
+TEST_CASE("[Transform3D] Batch transforms match per-vector transforms") {
+	const Transform3D transform = Transform3D(Basis(Vector3(1, 2, 3).normalized(), 0.7).scaled(Vector3(1, 2, 3)), Vector3(4, 5, 6));
+
+	// Sizes around the SIMD width, to cover the remainder loop.
+	for (int count : { 0, 1, 3, 4, 5, 8, 11, 64 }) {
+		Vector<Vector3> points;
+		for (int i = 0; i < count; i++) {
+			points.push_back(Vector3(i * 1.5 - 7, i * 0.25, 3 - i));
+		}
+
+		Vector<Vector3> transformed = transform.xform(points);
+		Vector<Vector3> inverse = transform.xform_inv(points);
+		Vector<Vector3> basis_transformed = transform.basis.xform(points);
+		Vector<Vector3> basis_inverse = transform.basis.xform_inv(points);
+		REQUIRE(transformed.size() == count);
+		REQUIRE(inverse.size() == count);
+		for (int i = 0; i < count; i++) {
+			CHECK(transformed[i].is_equal_approx(transform.xform(points[i])));
+			CHECK(inverse[i].is_equal_approx(transform.xform_inv(points[i])));
+			CHECK(basis_transformed[i].is_equal_approx(transform.basis.xform(points[i])));
+			CHECK(basis_inverse[i].is_equal_approx(transform.basis.xform_inv(points[i])));
+		}
+	}
+
+	// Members of an array of structures, transformed in place.
+	struct Vertex {
+		Vector3 position;
+		float padding = 42;
+	};
+	Vertex vertices[7];
+	for (int i = 0; i < 7; i++) {
+		vertices[i].position = Vector3(i, -i, i * 2);
+	}
+	TransformBatch::xform(transform, &vertices[0].position, &vertices[0].position, 7, sizeof(Vertex));
+	for (int i = 0; i < 7; i++) {
+		CHECK(vertices[i].position.is_equal_approx(transform.xform(Vector3(i, -i, i * 2))));
+		CHECK(vertices[i].padding == 42);
+	}
+}
+
+TEST_CASE("[Transform3D][Benchmark] Transforming points and composing transforms" * doctest::skip()) {
+	constexpr int COUNT = 1000;
+
+	LocalVector<Vector3> points;
+	for (int i = 0; i < COUNT; i++) {
+		points.push_back(Vector3(i, i * 0.5, -i));
+	}
+	const Transform3D transform = Transform3D(Basis(Vector3(1, 2, 3).normalized(), 0.7).scaled(Vector3(1, 2, 3)), Vector3(4, 5, 6));
+
+	TestBenchmark::run("Transform3D::xform (1000 points)", [&]() {
+		Vector3 sum;
+		for (const Vector3 &point : points) {
+			sum += transform.xform(point);
+		}
+		TestBenchmark::do_not_optimize(sum);
+	});
+	Vector<Vector3> packed_points;
+	for (const Vector3 &point : points) {
+		packed_points.push_back(point);
+	}
+	TestBenchmark::run("Transform3D::xform (PackedVector3Array, 1000 points)", [&]() {
+		Vector<Vector3> transformed = transform.xform(packed_points);
+		TestBenchmark::do_not_optimize(transformed);
+	});
+	TestBenchmark::run("Transform3D::xform_inv (1000 points)", [&]() {
+		Vector3 sum;
+		for (const Vector3 &point : points) {
+			sum += transform.xform_inv(point);
+		}
+		TestBenchmark::do_not_optimize(sum);
+	});
+	TestBenchmark::run("Transform3D composition and affine_inverse (1000 times)", [&]() {
+		Transform3D result;
+		for (int i = 0; i < COUNT; i++) {
+			result = (result * transform).affine_inverse();
+		}
+		TestBenchmark::do_not_optimize(result);
+	});
+}
+
 } // namespace TestTransform3D
@@ -34,8 +34,11 @@ TEST_FORCE_LINK(test_triangle_mesh)
 
 #ifndef _3D_DISABLED
 
+#include "core/math/geometry_3d.h"
+#include "core/math/random_pcg.h"
 #include "core/math/triangle_mesh.h"
 #include "scene/resources/3d/primitive_meshes.h"
+#include "tests/test_benchmark.h"
 
 namespace TestTriangleMesh {
 
@@ -82,6 +85,209 @@ TEST_CASE("[SceneTree][TriangleMesh] BVH creation and intersection") {
 	}
 }
 
+// Random triangles plus a grid, so there are overlapping faces as well as faces sharing edges.
+static Vector<Vector3> create_test_faces(RandomPCG &p_rng, int p_random_count, int p_grid_size) {
+	Vector<Vector3> faces;
+	for (int i = 0; i < p_random_count; i++) {
+		const Vector3 center = Vector3(p_rng.random(-20.0f, 20.0f), p_rng.random(-20.0f, 20.0f), p_rng.random(-20.0f, 20.0f));
+		for (int j = 0; j < 3; j++) {
+			faces.push_back(center + Vector3(p_rng.random(-2.0f, 2.0f), p_rng.random(-2.0f, 2.0f), p_rng.random(-2.0f, 2.0f)));
+		}
+	}
+	for (int x = 0; x < p_grid_size; x++) {
+		for (int z = 0; z < p_grid_size; z++) {
+			const Vector3 a = Vector3(x - p_grid_size / 2, -5, z - p_grid_size / 2);
+			faces.push_back(a);
+			faces.push_back(a + Vector3(1, 0, 0));
+			faces.push_back(a + Vector3(0, 0, 1));
+			faces.push_back(a + Vector3(1, 0, 0));
+			faces.push_back(a + Vector3(1, 0, 1));
+			faces.push_back(a + Vector3(0, 0, 1));
+		}
+	}
+	return faces;
+}
+
+// Closest hit over all faces, ties going to the lowest face index.
+static int32_t brute_force_intersect(const Vector<Face3> &p_faces, const Vector3 &p_from, const Vector3 &p_to_or_dir, bool p_segment, Vector3 &r_point) {
+	const Vector3 n = p_segment ? (p_to_or_dir - p_from).normalized() : p_to_or_dir;
+	real_t d = p_segment ? 1e10 : 1e20;
+	int32_t face_index = -1;
+	for (int i = 0; i < p_faces.size(); i++) {
+		Vector3 res;
+		const bool hit = p_segment ? p_faces[i].intersects_segment(p_from, p_to_or_dir, &res) : p_faces[i].intersects_ray(p_from, p_to_or_dir, &res);
+		if (hit && n.dot(res) < d) {
+			d = n.dot(res);
+			face_index = i;
+			r_point = res;
+		}
+	}
+	return face_index;
+}
+
+TEST_CASE("[TriangleMesh] Intersections match a brute force search") {
+	RandomPCG rng(12345);
+	Ref<TriangleMesh> triangle_mesh;
+	triangle_mesh.instantiate();
+	triangle_mesh->create(create_test_faces(rng, 2000, 16));
+	REQUIRE(triangle_mesh->is_valid());
+	const Vector<Face3> faces = triangle_mesh->get_faces();
+
+	int hits = 0;
+	int mismatches = 0;
+	for (int i = 0; i < 1000; i++) {
+		const Vector3 from = Vector3(rng.random(-30.0f, 30.0f), rng.random(-30.0f, 30.0f), rng.random(-30.0f, 30.0f));
+		Vector3 dir = Vector3(rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f), rng.random(-1.0f, 1.0f));
+		if (i % 4 == 0) {
+			// Axis aligned rays have zero components in their direction.
+			dir = Vector3();
+			dir[i % 3] = (i % 8) ? 1 : -1;
+		}
+
+		for (int segment = 0; segment < 2; segment++) {
+			const Vector3 to_or_dir = segment ? from + dir * 40 : dir;
+			Vector3 expected_point;
+			const int32_t expected = brute_force_intersect(faces, from, to_or_dir, segment, expected_point);
+
+			Vector3 point;
+			Vector3 normal;
+			int32_t face_index = -1;
+			const bool hit = segment ? triangle_mesh->intersect_segment(from, to_or_dir, point, normal, nullptr, &face_index) : triangle_mesh->intersect_ray(from, to_or_dir, point, normal, nullptr, &face_index);
+			if (hit != (expected != -1) || (hit && (face_index != expected || point != expected_point || normal.dot(dir) > 0))) {
+				mismatches++;
+			}
+			hits += hit;
+		}
+	}
+	CHECK_MESSAGE(hits > 200, "Many queries should hit something.");
+	CHECK(mismatches == 0);
+}
+
+TEST_CASE("[TriangleMesh] Batched ray intersections match single queries") {
+	RandomPCG rng(54321);
+	Ref<TriangleMesh> triangle_mesh;
+	triangle_mesh.instantiate();
+	Vector<int32_t> surface_indices;
+	const Vector<Vector3> faces = create_test_faces(rng, 500, 8);
+	for (int i = 0; i < faces.size(); i++) {
+		surface_indices.push_back(i / 30);
+	}
+	triangle_mesh->create(faces, surface_indices);
+
+	const int count = 1000;
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> dir;
+	for (int i = 0; i < count; i++) {
+		from.push_back(Vector3(rng.random(-30.0f, 30.0f), rng.random(-30.0f, 30.0f), rng.random(-30.0f, 30.0f)));
+		dir.push_back(-from[i] + Vector3(rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f), rng.random(-10.0f, 10.0f)));
+	}
+
+	for (int threaded = 0; threaded < 2; threaded++) {
+		LocalVector<TriangleMesh::RayResult> results;
+		results.resize(count);
+		triangle_mesh->intersect_rays(from.ptr(), dir.ptr(), count, results.ptr(), threaded);
+
+		int mismatches = 0;
+		for (int i = 0; i < count; i++) {
+			Vector3 point;
+			Vector3 normal;
+			int32_t surface_index = -1;
+			int32_t face_index = -1;
+			const bool hit = triangle_mesh->intersect_ray(from[i], dir[i], point, normal, &surface_index, &face_index);
+			const TriangleMesh::RayResult &result = results[i];
+			if (hit != result.hit || (hit && (point != result.point || normal != result.normal || surface_index != result.surface_index || face_index != result.face_index))) {
+				mismatches++;
+			}
+		}
+		CHECK(mismatches == 0);
+	}
+}
+
+TEST_CASE("[TriangleMesh] Inside convex shape") {
+	RandomPCG rng(777);
+	Ref<TriangleMesh> triangle_mesh;
+	triangle_mesh.instantiate();
+	triangle_mesh->create(create_test_faces(rng, 200, 0));
+
+	const Vector<Plane> big = Geometry3D::build_box_planes(Vector3(30, 30, 30));
+	const Vector<Vector3> big_points = Geometry3D::compute_convex_mesh_points(big.ptr(), big.size());
+	CHECK(triangle_mesh->inside_convex_shape(big.ptr(), big.size(), big_points.ptr(), big_points.size()));
+
+	const Vector<Plane> small = Geometry3D::build_box_planes(Vector3(10, 10, 10));
+	const Vector<Vector3> small_points = Geometry3D::compute_convex_mesh_points(small.ptr(), small.size());
+	CHECK_FALSE(triangle_mesh->inside_convex_shape(small.ptr(), small.size(), small_points.ptr(), small_points.size()));
+
+	// Shrinking the mesh brings it inside the smaller box.
+	CHECK(triangle_mesh->inside_convex_shape(small.ptr(), small.size(), small_points.ptr(), small_points.size(), Vector3(0.4, 0.4, 0.4)));
+}
+
+TEST_CASE("[TriangleMesh][Benchmark] Million triangle mesh" * doctest::skip()) {
+	// A bumpy terrain of 708 x 708 quads, a bit over a million triangles.
+	const int size = 708;
+	Vector<Vector3> faces;
+	faces.resize(size * size * 6);
+	Vector3 *w = faces.ptrw();
+	for (int x = 0; x < size; x++) {
+		for (int z = 0; z < size; z++) {
+			Vector3 quad[4];
+			for (int i = 0; i < 4; i++) {
+				const real_t px = x + (i & 1);
+				const real_t pz = z + (i >> 1);
+				quad[i] = Vector3(px, Math::sin(px * 0.1) * Math::cos(pz * 0.13) * 10.0, pz);
+			}
+			Vector3 *quad_faces = &w[(x * size + z) * 6];
+			quad_faces[0] = quad[0];
+			quad_faces[1] = quad[1];
+			quad_faces[2] = quad[2];
+			quad_faces[3] = quad[1];
+			quad_faces[4] = quad[3];
+			quad_faces[5] = quad[2];
+		}
+	}
+
+	Ref<TriangleMesh> triangle_mesh;
+	triangle_mesh.instantiate();
+	TestBenchmark::run("TriangleMesh create (1M triangles)", [&]() {
+		triangle_mesh->create(faces);
+	});
+
+	RandomPCG rng(42);
+	const int count = 100000;
+	LocalVector<Vector3> from;
+	LocalVector<Vector3> dir;
+	for (int i = 0; i < count; i++) {
+		from.push_back(Vector3(rng.random(0.0f, (float)size), 50.0f, rng.random(0.0f, (float)size)));
+		dir.push_back(Vector3(rng.random(-1.0f, 1.0f), -1.0f, rng.random(-1.0f, 1.0f)));
+	}
+
+	TestBenchmark::run("TriangleMesh intersect_ray (1M triangles, 100k rays)", [&]() {
+		int hits = 0;
+		for (int i = 0; i < count; i++) {
+			Vector3 point;
+			Vector3 normal;
+			hits += triangle_mesh->intersect_ray(from[i], dir[i], point, normal);
+		}
+		TestBenchmark::do_not_optimize(hits);
+	});
+
+	TestBenchmark::run("TriangleMesh intersect_segment (1M triangles, 100k segments)", [&]() {
+		int hits = 0;
+		for (int i = 0; i < count; i++) {
+			Vector3 point;
+			Vector3 normal;
+			hits += triangle_mesh->intersect_segment(from[i], from[i] + dir[i] * 100, point, normal);
+		}
+		TestBenchmark::do_not_optimize(hits);
+	});
+
+	LocalVector<TriangleMesh::RayResult> results;
+	results.resize(count);
+	TestBenchmark::run("TriangleMesh intersect_rays (1M triangles, 100k rays, threaded)", [&]() {
+		triangle_mesh->intersect_rays(from.ptr(), dir.ptr(), count, results.ptr());
+		TestBenchmark::do_not_optimize(results[0].hit);
+	});
+}
+
 } // namespace TestTriangleMesh
 
 #endif // _3D_DISABLED
@@ -0,0 +1,147 @@
+/**************************************************************************/
+/*  test_message_queue.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_message_queue)
+
+#include "core/object/message_queue.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/safe_refcount.h"
+
+namespace TestMessageQueue {
+
+static LocalVector<int> calls;
+
+static void record_call(int p_value) {
+	calls.push_back(p_value);
+}
+
+static void record_call_no_args() {
+	calls.push_back(-1);
+}
+
+TEST_CASE("[MessageQueue] Calls are flushed in order") {
+	calls.clear();
+	CallQueue queue;
+
+	for (int i = 0; i < 2000; i++) {
+		queue.push_callable(callable_mp_static(&record_call), i);
+	}
+	CHECK(queue.has_messages());
+	CHECK(queue.flush() == OK);
+	CHECK_FALSE(queue.has_messages());
+
+	REQUIRE(calls.size() == 2000);
+	for (int i = 0; i < 2000; i++) {
+		CHECK(calls[i] == i);
+	}
+}
+
+TEST_CASE("[MessageQueue] Coalesce identical pending calls") {
+	calls.clear();
+	CallQueue queue;
+	queue.set_coalesce_calls(true);
+	CHECK(queue.is_coalescing_calls());
+
+	queue.push_callable(callable_mp_static(&record_call_no_args));
+	queue.push_callable(callable_mp_static(&record_call), 1);
+	queue.push_callable(callable_mp_static(&record_call_no_args));
+	queue.push_callable(callable_mp_static(&record_call), 2);
+	queue.push_callable(callable_mp_static(&record_call), 1);
+	queue.flush();
+
+	REQUIRE(calls.size() == 3);
+	CHECK(calls[0] == -1);
+	CHECK(calls[1] == 1);
+	CHECK(calls[2] == 2);
+
+	CallQueue::Stats stats = queue.get_stats();
+	CHECK(stats.pushed == 5);
+	CHECK(stats.coalesced == 2);
+
+	// Calls that already ran are no longer pending.
+	calls.clear();
+	queue.push_callable(callable_mp_static(&record_call), 1);
+	queue.flush();
+	CHECK(calls.size() == 1);
+
+	queue.reset_stats();
+	queue.set_coalesce_calls(false);
+	calls.clear();
+	queue.push_callable(callable_mp_static(&record_call_no_args));
+	queue.push_callable(callable_mp_static(&record_call_no_args));
+	queue.flush();
+	CHECK(calls.size() == 2);
+	CHECK(queue.get_stats().coalesced == 0);
+}
+
+struct ThreadPushState {
+	SafeNumeric<uint32_t> pushed;
+
+	void push(uint32_t p_index, CallQueue *p_queue) {
+		p_queue->push_callable(callable_mp_static(&record_call), (int)p_index);
+		pushed.increment();
+	}
+};
+
+TEST_CASE("[MessageQueue] Calls pushed from pool threads") {
+	calls.clear();
+	CallQueue queue;
+	ThreadPushState state;
+
+	const uint32_t count = 1000;
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&state, &ThreadPushState::push, &queue, count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK(state.pushed.get() == count);
+	CHECK(queue.has_messages());
+
+	// Pushed after all the others, so it must run last.
+	queue.push_callable(callable_mp_static(&record_call), (int)count);
+	queue.flush();
+	CHECK_FALSE(queue.has_messages());
+
+	REQUIRE(calls.size() == count + 1);
+	LocalVector<int> seen;
+	seen.resize(count + 1);
+	for (int &value : seen) {
+		value = 0;
+	}
+	for (int value : calls) {
+		seen[value]++;
+	}
+	for (uint32_t i = 0; i <= count; i++) {
+		CHECK_MESSAGE(seen[i] == 1, vformat("Call %d should have run exactly once.", i));
+	}
+	CHECK(calls[count] == (int)count);
+	CHECK(queue.get_stats().pushed == count + 1);
+}
+
+} // namespace TestMessageQueue
@@ -35,7 +35,11 @@ TEST_FORCE_LINK(test_object)
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/templates/safe_refcount.h"
 #include "tests/signal_watcher.h"
+#include "tests/test_benchmark.h"
 
 namespace TestObject {
 
@@ -690,4 +694,258 @@ TEST_CASE("[Object] RequiredResult") {
 	CHECK_EQ(ref, var);
 }
 
+class _SignalBenchmarkReceiver : public Object {
+	GDCLASS(_SignalBenchmarkReceiver, Object);
+
+public:
+	int64_t sum = 0;
+
+	void on_signal(int p_value) { sum += p_value; }
+};
+
+class _SignalChangingReceiver : public Object {
+	GDCLASS(_SignalChangingReceiver, Object);
+
+public:
+	Object *emitter = nullptr;
+	_SignalBenchmarkReceiver *other = nullptr;
+	int calls = 0;
+
+	void disconnect_other(int p_value) {
+		calls++;
+		emitter->disconnect("changing_signal", callable_mp(other, &_SignalBenchmarkReceiver::on_signal));
+	}
+	void connect_other(int p_value) {
+		calls++;
+		if (!emitter->is_connected("changing_signal", callable_mp(other, &_SignalBenchmarkReceiver::on_signal))) {
+			emitter->connect("changing_signal", callable_mp(other, &_SignalBenchmarkReceiver::on_signal));
+		}
+	}
+	void on_signal_bound(int p_value, const Ref<RefCounted> &p_bound) {
+		calls++;
+	}
+};
+
+TEST_CASE("[Object] Connections changed while emitting a signal") {
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("changing_signal", PropertyInfo(Variant::INT, "value")));
+	_SignalChangingReceiver changer;
+	changer.emitter = &emitter;
+	_SignalBenchmarkReceiver other;
+	changer.other = &other;
+
+	SUBCASE("Connections removed while emitting are still called") {
+		emitter.connect("changing_signal", callable_mp(&changer, &_SignalChangingReceiver::disconnect_other));
+		emitter.connect("changing_signal", callable_mp(&other, &_SignalBenchmarkReceiver::on_signal));
+		emitter.emit_signal("changing_signal", 3);
+		CHECK(changer.calls == 1);
+		CHECK(other.sum == 3);
+
+		emitter.emit_signal("changing_signal", 4);
+		CHECK(changer.calls == 2);
+		CHECK_MESSAGE(other.sum == 3, "The removed connection should not be called anymore.");
+	}
+
+	SUBCASE("Connections added while emitting are called from the next emission") {
+		emitter.connect("changing_signal", callable_mp(&changer, &_SignalChangingReceiver::connect_other));
+		emitter.emit_signal("changing_signal", 3);
+		CHECK(changer.calls == 1);
+		CHECK(other.sum == 0);
+
+		emitter.emit_signal("changing_signal", 4);
+		CHECK(changer.calls == 2);
+		CHECK(other.sum == 4);
+	}
+
+	SUBCASE("One-shot connections are called once") {
+		emitter.connect("changing_signal", callable_mp(&other, &_SignalBenchmarkReceiver::on_signal), Object::CONNECT_ONE_SHOT);
+		emitter.emit_signal("changing_signal", 3);
+		emitter.emit_signal("changing_signal", 4);
+		CHECK(other.sum == 3);
+		CHECK_FALSE(emitter.is_connected("changing_signal", callable_mp(&other, &_SignalBenchmarkReceiver::on_signal)));
+	}
+
+	SUBCASE("Bound arguments are released on disconnect") {
+		Ref<RefCounted> bound;
+		bound.instantiate();
+		const ObjectID bound_id = bound->get_instance_id();
+		Callable callable = callable_mp(&changer, &_SignalChangingReceiver::on_signal_bound).bind(bound);
+		emitter.connect("changing_signal", callable);
+		emitter.emit_signal("changing_signal", 3);
+		CHECK(changer.calls == 1);
+
+		emitter.disconnect("changing_signal", callable);
+		bound.unref();
+		CHECK_MESSAGE(ObjectDB::get_instance(bound_id) != nullptr, "The callable kept by the test should still hold the bound argument.");
+		callable = Callable();
+		CHECK_MESSAGE(ObjectDB::get_instance(bound_id) == nullptr, "The disconnected callable should not be kept alive by the signal.");
+	}
+}
+
+#ifdef DEBUG_ENABLED
+TEST_CASE("[Object] Signal emission doesn't allocate") {
+	// Allocations are only counted in debug builds, using a memory tag.
+	const bool was_tracking_tags = Memory::is_tag_tracking_enabled();
+	Memory::set_tag_tracking_enabled(true);
+
+	for (int connection_count : { 0, 1, 10, 100 }) {
+		Object emitter;
+		emitter.add_user_signal(MethodInfo("benchmark_signal", PropertyInfo(Variant::INT, "value")));
+
+		LocalVector<_SignalBenchmarkReceiver *> receivers;
+		for (int i = 0; i < connection_count; i++) {
+			_SignalBenchmarkReceiver *receiver = memnew(_SignalBenchmarkReceiver);
+			emitter.connect("benchmark_signal", callable_mp(receiver, &_SignalBenchmarkReceiver::on_signal));
+			receivers.push_back(receiver);
+		}
+
+		const StringName signal_name = "benchmark_signal";
+		// The first emission after connecting builds the array of connections to emit to.
+		emitter.emit_signal(signal_name, 1);
+
+		const uint64_t alloc_count = Memory::get_tag_alloc_count(Memory::TAG_SCRIPTING);
+		{
+			MEMORY_TAG_SCOPE(Memory::TAG_SCRIPTING);
+			for (int i = 0; i < 10; i++) {
+				emitter.emit_signal(signal_name, 1);
+			}
+		}
+		CHECK_MESSAGE(Memory::get_tag_alloc_count(Memory::TAG_SCRIPTING) == alloc_count, vformat("Emitting a signal with %d connections shouldn't allocate.", connection_count));
+
+		for (_SignalBenchmarkReceiver *receiver : receivers) {
+			CHECK(receiver->sum == 11);
+			memdelete(receiver);
+		}
+	}
+
+	Memory::set_tag_tracking_enabled(was_tracking_tags);
+}
+#endif // DEBUG_ENABLED
+
+TEST_CASE("[Object][Benchmark] Signal emission" * doctest::skip()) {
+	for (int connection_count : { 0, 1, 10, 100 }) {
+		Object emitter;
+		emitter.add_user_signal(MethodInfo("benchmark_signal", PropertyInfo(Variant::INT, "value")));
+
+		LocalVector<_SignalBenchmarkReceiver *> receivers;
+		for (int i = 0; i < connection_count; i++) {
+			_SignalBenchmarkReceiver *receiver = memnew(_SignalBenchmarkReceiver);
+			emitter.connect("benchmark_signal", callable_mp(receiver, &_SignalBenchmarkReceiver::on_signal));
+			receivers.push_back(receiver);
+		}
+
+		const StringName signal_name = "benchmark_signal";
+		TestBenchmark::run(vformat("Signal emission (%d connections)", connection_count), [&]() {
+			emitter.emit_signal(signal_name, 1);
+		});
+
+		for (_SignalBenchmarkReceiver *receiver : receivers) {
+			memdelete(receiver);
+		}
+	}
+}
+
+struct _ObjectDBLookupState {
+	LocalVector<Object *> objects;
+	LocalVector<ObjectID> ids;
+	LocalVector<ObjectID> freed_ids;
+	SafeFlag exit;
+	SafeNumeric<uint64_t> lookups;
+	SafeNumeric<uint32_t> errors;
+
+	static void lookup_loop(void *p_userdata) {
+		_ObjectDBLookupState *state = static_cast<_ObjectDBLookupState *>(p_userdata);
+		uint64_t count = 0;
+		uint32_t errors = 0;
+		while (!state->exit.is_set()) {
+			for (uint32_t i = 0; i < state->ids.size(); i++) {
+				if (ObjectDB::get_instance(state->ids[i]) != state->objects[i]) {
+					errors++;
+				}
+			}
+			for (const ObjectID &id : state->freed_ids) {
+				if (ObjectDB::get_instance(id) != nullptr) {
+					errors++;
+				}
+			}
+			count += state->ids.size() + state->freed_ids.size();
+		}
+		state->lookups.add(count);
+		state->errors.add(errors);
+	}
+};
+
+TEST_CASE("[Object] ObjectDB lookups from several threads") {
+	_ObjectDBLookupState state;
+	for (int i = 0; i < 256; i++) {
+		Object *object = memnew(Object);
+		state.objects.push_back(object);
+		state.ids.push_back(object->get_instance_id());
+	}
+	for (int i = 0; i < 256; i++) {
+		Object *object = memnew(Object);
+		state.freed_ids.push_back(object->get_instance_id());
+		memdelete(object);
+	}
+
+	Thread threads[4];
+	for (Thread &thread : threads) {
+		thread.start(&_ObjectDBLookupState::lookup_loop, &state);
+	}
+
+	// Reuse the slots of the freed objects while looking up.
+	for (int i = 0; i < 200; i++) {
+		LocalVector<Object *> churn;
+		for (int j = 0; j < 256; j++) {
+			churn.push_back(memnew(Object));
+		}
+		for (Object *object : churn) {
+			memdelete(object);
+		}
+	}
+
+	state.exit.set();
+	for (Thread &thread : threads) {
+		thread.wait_to_finish();
+	}
+
+	CHECK(state.lookups.get() > 0);
+	CHECK_MESSAGE(state.errors.get() == 0, "Live objects should always be found, and freed ones never.");
+
+	for (Object *object : state.objects) {
+		memdelete(object);
+	}
+}
+
+TEST_CASE("[Object][Benchmark] ObjectDB lookups with increasing thread counts" * doctest::skip()) {
+	for (int thread_count : { 1, 2, 4, 8, 16 }) {
+		_ObjectDBLookupState state;
+		for (int i = 0; i < 1024; i++) {
+			Object *object = memnew(Object);
+			state.objects.push_back(object);
+			state.ids.push_back(object->get_instance_id());
+		}
+
+		LocalVector<Thread *> threads;
+		for (int i = 0; i < thread_count; i++) {
+			threads.push_back(memnew(Thread));
+			threads[i]->start(&_ObjectDBLookupState::lookup_loop, &state);
+		}
+		const uint64_t usec = 1000000;
+		OS::get_singleton()->delay_usec(usec);
+		state.exit.set();
+		for (Thread *thread : threads) {
+			thread->wait_to_finish();
+			memdelete(thread);
+		}
+
+		CHECK(state.errors.get() == 0);
+		print_line(vformat("%d threads: %.1f million lookups per second.", thread_count, state.lookups.get() / (double)usec));
+
+		for (Object *object : state.objects) {
+			memdelete(object);
+		}
+	}
+}
+
 } // namespace TestObject
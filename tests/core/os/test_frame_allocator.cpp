@@ -0,0 +1,138 @@
+/**************************************************************************/
+/*  test_frame_allocator.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_frame_allocator)
+
+#include "core/os/frame_allocator.h"
+#include "core/os/thread.h"
+
+namespace TestFrameAllocator {
+
+TEST_CASE("[FrameAllocator] Allocation alignment") {
+	void *a = FrameAllocator::alloc(3);
+	void *b = FrameAllocator::alloc(17);
+	CHECK((size_t)a % Memory::MAX_ALIGN == 0);
+	CHECK((size_t)b % Memory::MAX_ALIGN == 0);
+	CHECK(a != b);
+	FrameAllocator::free(b);
+	FrameAllocator::free(a);
+}
+
+TEST_CASE("[FrameAllocator] Arena is rewound once all allocations are freed") {
+	void *a = FrameAllocator::alloc(64);
+	void *b = FrameAllocator::alloc(64);
+	FrameAllocator::free(a);
+	FrameAllocator::free(b);
+
+	void *c = FrameAllocator::alloc(64);
+	CHECK_MESSAGE(c == a, "Memory should be reused once the arena is empty.");
+	FrameAllocator::free(c);
+}
+
+TEST_CASE("[FrameAllocator] Realloc preserves contents") {
+	uint8_t *a = (uint8_t *)FrameAllocator::alloc(16);
+	for (int i = 0; i < 16; i++) {
+		a[i] = i;
+	}
+
+	uint8_t *b = (uint8_t *)FrameAllocator::realloc(a, 1024);
+	CHECK_MESSAGE(b == a, "The last allocation should grow in place.");
+
+	uint8_t *other = (uint8_t *)FrameAllocator::alloc(16);
+	uint8_t *c = (uint8_t *)FrameAllocator::realloc(b, 2048);
+	CHECK(c != b);
+	for (int i = 0; i < 16; i++) {
+		CHECK(c[i] == i);
+	}
+
+	FrameAllocator::free(other);
+	FrameAllocator::free(c);
+}
+
+TEST_CASE("[FrameAllocator] Large allocations fall back to the heap") {
+	FrameAllocator::end_frame();
+
+	uint8_t *a = (uint8_t *)FrameAllocator::alloc(FrameAllocator::BLOCK_SIZE * 2);
+	REQUIRE(a != nullptr);
+	memset(a, 0xAB, FrameAllocator::BLOCK_SIZE * 2);
+	FrameAllocator::free(a);
+
+	FrameAllocator::end_frame();
+	CHECK(FrameAllocator::get_frame_overflow_count() == 1);
+	CHECK(FrameAllocator::get_frame_bytes() == FrameAllocator::BLOCK_SIZE * 2);
+	CHECK(FrameAllocator::get_frame_bytes_peak() >= FrameAllocator::BLOCK_SIZE * 2);
+}
+
+#ifdef THREADS_ENABLED
+static void _alloc_in_thread(void *p_userdata) {
+	void *a = FrameAllocator::alloc(*(size_t *)p_userdata);
+	FrameAllocator::free(a);
+}
+
+TEST_CASE("[FrameAllocator] Counters include threads that exited during the frame") {
+	FrameAllocator::end_frame();
+
+	size_t bytes = 100;
+	Thread thread;
+	thread.start(_alloc_in_thread, &bytes);
+	thread.wait_to_finish();
+
+	void *a = FrameAllocator::alloc(20);
+	FrameAllocator::free(a);
+
+	FrameAllocator::end_frame();
+	CHECK(FrameAllocator::get_frame_bytes() == 120);
+
+	FrameAllocator::end_frame();
+	CHECK_MESSAGE(FrameAllocator::get_frame_bytes() == 0, "Bytes should only be reported for the frame they were allocated in.");
+}
+#endif // THREADS_ENABLED
+
+TEST_CASE("[FrameAllocator] FrameLocalVector") {
+	FrameLocalVector<int> vector;
+	for (int i = 0; i < 10000; i++) {
+		vector.push_back(i);
+	}
+	CHECK(vector.size() == 10000);
+
+	bool all_equal = true;
+	for (int i = 0; i < 10000; i++) {
+		all_equal &= vector[i] == i;
+	}
+	CHECK(all_equal);
+
+	FrameLocalVector<String> strings = { "a", "b", "c" };
+	CHECK(strings.size() == 3);
+	CHECK(strings[2] == "c");
+}
+
+} // namespace TestFrameAllocator
@@ -0,0 +1,147 @@
+/**************************************************************************/
+/*  test_memory_tags.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_memory_tags)
+
+#include "core/os/memory.h"
+
+namespace TestMemoryTags {
+
+#ifdef DEBUG_ENABLED
+
+struct TaggedObject {
+	uint64_t data[8] = {};
+};
+
+// Tag tracking is disabled by default.
+struct TagTrackingEnabler {
+	bool was_enabled = Memory::is_tag_tracking_enabled();
+
+	TagTrackingEnabler() { Memory::set_tag_tracking_enabled(true); }
+	~TagTrackingEnabler() { Memory::set_tag_tracking_enabled(was_enabled); }
+};
+
+TEST_CASE("[Memory] Tag scope sets and restores the current tag") {
+	CHECK(Memory::get_current_tag() == Memory::TAG_UNTAGGED);
+	{
+		MEMORY_TAG_SCOPE(Memory::TAG_PHYSICS);
+		CHECK(Memory::get_current_tag() == Memory::TAG_PHYSICS);
+		{
+			MEMORY_TAG_SCOPE(Memory::TAG_AUDIO);
+			CHECK(Memory::get_current_tag() == Memory::TAG_AUDIO);
+		}
+		CHECK(Memory::get_current_tag() == Memory::TAG_PHYSICS);
+	}
+	CHECK(Memory::get_current_tag() == Memory::TAG_UNTAGGED);
+}
+
+TEST_CASE("[Memory] Tagged allocations are accounted to their tag") {
+	TagTrackingEnabler enabler;
+	const uint64_t usage = Memory::get_tag_mem_usage(Memory::TAG_AUDIO);
+	const uint64_t count = Memory::get_tag_alloc_count(Memory::TAG_AUDIO);
+
+	void *mem = memalloc_tagged(1000, Memory::TAG_AUDIO);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_AUDIO) == usage + 1000);
+	CHECK(Memory::get_tag_alloc_count(Memory::TAG_AUDIO) == count + 1);
+	CHECK_MESSAGE(Memory::get_current_tag() == Memory::TAG_UNTAGGED, "Tagged allocation should not leak its tag to the thread.");
+
+	mem = memrealloc(mem, 3000);
+	CHECK_MESSAGE(Memory::get_tag_mem_usage(Memory::TAG_AUDIO) == usage + 3000, "Reallocation should keep the original tag.");
+	mem = memrealloc(mem, 500);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_AUDIO) == usage + 500);
+
+	memfree(mem);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_AUDIO) == usage);
+	CHECK_MESSAGE(Memory::get_tag_alloc_count(Memory::TAG_AUDIO) == count + 1, "Allocation count is cumulative.");
+}
+
+TEST_CASE("[Memory] Allocations inside a tag scope are accounted to the scope tag") {
+	TagTrackingEnabler enabler;
+	const uint64_t usage = Memory::get_tag_mem_usage(Memory::TAG_NAVIGATION);
+
+	void *mem = nullptr;
+	{
+		MEMORY_TAG_SCOPE(Memory::TAG_NAVIGATION);
+		mem = memalloc(256);
+	}
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_NAVIGATION) == usage + 256);
+
+	// Freeing outside of the scope still releases from the original tag.
+	memfree(mem);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_NAVIGATION) == usage);
+}
+
+TEST_CASE("[Memory] memnew_tagged") {
+	TagTrackingEnabler enabler;
+	const uint64_t usage = Memory::get_tag_mem_usage(Memory::TAG_RESOURCES);
+
+	TaggedObject *object = memnew_tagged(TaggedObject, Memory::TAG_RESOURCES);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_RESOURCES) == usage + sizeof(TaggedObject));
+	CHECK(object->data[0] == 0);
+
+	memdelete(object);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_RESOURCES) == usage);
+}
+
+TEST_CASE("[Memory] Allocations are not accounted while tag tracking is disabled") {
+	const bool was_enabled = Memory::is_tag_tracking_enabled();
+	Memory::set_tag_tracking_enabled(false);
+
+	const uint64_t usage = Memory::get_tag_mem_usage(Memory::TAG_PHYSICS);
+	const uint64_t count = Memory::get_tag_alloc_count(Memory::TAG_PHYSICS);
+
+	void *mem = memalloc_tagged(1000, Memory::TAG_PHYSICS);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_PHYSICS) == usage);
+	CHECK(Memory::get_tag_alloc_count(Memory::TAG_PHYSICS) == count);
+
+	// Enabling it afterwards doesn't account previous allocations when they are released.
+	Memory::set_tag_tracking_enabled(true);
+	mem = memrealloc(mem, 2000);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_PHYSICS) == usage);
+	memfree(mem);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_PHYSICS) == usage);
+
+	Memory::set_tag_tracking_enabled(was_enabled);
+}
+
+TEST_CASE("[Memory] Untagged allocations are not accounted") {
+	TagTrackingEnabler enabler;
+
+	void *mem = memalloc(1000);
+	CHECK(Memory::get_tag_mem_usage(Memory::TAG_UNTAGGED) == 0);
+	CHECK(Memory::get_tag_alloc_count(Memory::TAG_UNTAGGED) == 0);
+	memfree(mem);
+}
+
+#endif // DEBUG_ENABLED
+
+} // namespace TestMemoryTags
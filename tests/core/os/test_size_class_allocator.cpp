@@ -0,0 +1,239 @@
+/**************************************************************************/
+/*  test_size_class_allocator.cpp                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_size_class_allocator)
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "core/os/size_class_allocator.h"
+#include "core/variant/variant.h"
+#include "tests/test_benchmark.h"
+
+namespace TestSizeClassAllocator {
+
+TEST_CASE("[SizeClassAllocator] Size classes") {
+	void *tiny = SizeClassAllocator::alloc(1);
+	void *medium = SizeClassAllocator::alloc(300);
+	void *large = SizeClassAllocator::alloc(SizeClassAllocator::MAX_SIZE + 1);
+
+	CHECK(SizeClassAllocator::get_block_size(tiny) == 16);
+	CHECK(SizeClassAllocator::get_block_size(medium) == 320);
+	CHECK_MESSAGE(SizeClassAllocator::get_block_size(large) == 0, "Large blocks should come from the system allocator.");
+	CHECK((size_t)tiny % 16 == 0);
+	CHECK((size_t)medium % 16 == 0);
+
+	SizeClassAllocator::free(large);
+	SizeClassAllocator::free(medium);
+	SizeClassAllocator::free(tiny);
+}
+
+TEST_CASE("[SizeClassAllocator] Blocks are reused") {
+	void *a = SizeClassAllocator::alloc(48);
+	SizeClassAllocator::free(a);
+	void *b = SizeClassAllocator::alloc(40);
+	CHECK_MESSAGE(a == b, "The last freed block of a size class should be handed out first.");
+	SizeClassAllocator::free(b);
+}
+
+TEST_CASE("[SizeClassAllocator] Realloc preserves contents") {
+	uint8_t *mem = (uint8_t *)SizeClassAllocator::alloc(10);
+	for (int i = 0; i < 10; i++) {
+		mem[i] = i;
+	}
+
+	mem = (uint8_t *)SizeClassAllocator::realloc(mem, 12);
+	CHECK(SizeClassAllocator::get_block_size(mem) == 16);
+
+	mem = (uint8_t *)SizeClassAllocator::realloc(mem, 5000);
+	CHECK(SizeClassAllocator::get_block_size(mem) >= 5000);
+
+	mem = (uint8_t *)SizeClassAllocator::realloc(mem, SizeClassAllocator::MAX_SIZE * 4);
+	CHECK(SizeClassAllocator::get_block_size(mem) == 0);
+
+	mem = (uint8_t *)SizeClassAllocator::realloc(mem, 10);
+	CHECK(SizeClassAllocator::get_block_size(mem) == 16);
+
+	bool preserved = true;
+	for (int i = 0; i < 10; i++) {
+		preserved &= mem[i] == i;
+	}
+	CHECK(preserved);
+
+	CHECK(SizeClassAllocator::realloc(mem, 0) == nullptr);
+}
+
+TEST_CASE("[SizeClassAllocator] Small system blocks") {
+	// What alloc() falls back to when no chunk can be set up.
+	uint8_t *mem = (uint8_t *)malloc(8);
+	for (int i = 0; i < 8; i++) {
+		mem[i] = i;
+	}
+	CHECK(SizeClassAllocator::get_block_size(mem) == 0);
+
+	mem = (uint8_t *)SizeClassAllocator::realloc(mem, 100);
+	CHECK(SizeClassAllocator::get_block_size(mem) == 112);
+	bool preserved = true;
+	for (int i = 0; i < 8; i++) {
+		preserved &= mem[i] == i;
+	}
+	CHECK(preserved);
+	SizeClassAllocator::free(mem);
+
+	mem = (uint8_t *)malloc(8);
+	SizeClassAllocator::free(mem);
+}
+
+TEST_CASE("[SizeClassAllocator] Zeroed allocations") {
+	uint8_t *mem = (uint8_t *)SizeClassAllocator::alloc(64);
+	memset(mem, 0xFF, 64);
+	SizeClassAllocator::free(mem);
+
+	mem = (uint8_t *)SizeClassAllocator::alloc_zeroed(64);
+	bool zeroed = true;
+	for (int i = 0; i < 64; i++) {
+		zeroed &= mem[i] == 0;
+	}
+	CHECK(zeroed);
+	SizeClassAllocator::free(mem);
+}
+
+// The same workloads run with both allocators, regardless of the backend of Memory.
+struct ChurnAllocator {
+	void *(*alloc)(size_t);
+	void *(*realloc)(void *, size_t);
+	void (*free)(void *);
+};
+
+static const ChurnAllocator system_allocator = { &malloc, &realloc, &free };
+static const ChurnAllocator builtin_allocator = { &SizeClassAllocator::alloc, &SizeClassAllocator::realloc, &SizeClassAllocator::free };
+
+static void _churn_blocks(void *p_userdata, uint32_t p_index) {
+	const ChurnAllocator &allocator = *(const ChurnAllocator *)p_userdata;
+	static constexpr int LIVE_BLOCKS = 512;
+	void *live[LIVE_BLOCKS] = {};
+	uint32_t state = p_index + 1;
+
+	for (int i = 0; i < 200000; i++) {
+		state = state * 1103515245 + 12345;
+		const int slot = (state >> 8) % LIVE_BLOCKS;
+		// Mostly small blocks, like String, Vector and Variant containers.
+		const size_t size = 8 + (state >> 16) % ((state & 0xF) == 0 ? 4096 : 256);
+		if (live[slot]) {
+			allocator.free(live[slot]);
+		}
+		live[slot] = allocator.alloc(size);
+		*(uint8_t *)live[slot] = 1;
+	}
+
+	for (int i = 0; i < LIVE_BLOCKS; i++) {
+		if (live[i]) {
+			allocator.free(live[i]);
+		}
+	}
+}
+
+// Buffers grown one power of 2 at a time, like Vector::push_back() and String concatenation.
+static void _churn_growth(void *p_userdata, uint32_t p_index) {
+	const ChurnAllocator &allocator = *(const ChurnAllocator *)p_userdata;
+	static constexpr int LIVE_BUFFERS = 64;
+	void *live[LIVE_BUFFERS] = {};
+	uint32_t state = p_index + 1;
+
+	for (int i = 0; i < 20000; i++) {
+		state = state * 1103515245 + 12345;
+		const int slot = (state >> 8) % LIVE_BUFFERS;
+		if (live[slot]) {
+			allocator.free(live[slot]);
+		}
+		const size_t final_size = size_t(16) << ((state >> 16) % 9);
+		void *buffer = nullptr;
+		for (size_t size = 16; size <= final_size; size *= 2) {
+			buffer = allocator.realloc(buffer, size);
+			((uint8_t *)buffer)[size - 1] = 1;
+		}
+		live[slot] = buffer;
+	}
+
+	for (int i = 0; i < LIVE_BUFFERS; i++) {
+		if (live[i]) {
+			allocator.free(live[i]);
+		}
+	}
+}
+
+static void _churn_variants(void *p_userdata, uint32_t p_index) {
+	for (int i = 0; i < 2000; i++) {
+		String string = "node_" + itos(i * (p_index + 1));
+		Vector<Variant> values;
+		for (int j = 0; j < 16; j++) {
+			values.push_back(string + String::num_int64(j));
+		}
+		Dictionary dictionary;
+		dictionary[string] = values;
+		Variant copy = dictionary.duplicate(true);
+	}
+}
+
+static void _run_churn(void (*p_func)(void *, uint32_t), const ChurnAllocator *p_allocator, int p_thread_count) {
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(p_func, (void *)p_allocator, p_thread_count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+}
+
+TEST_CASE("[SizeClassAllocator][Benchmark] Allocation churn" * doctest::skip()) {
+	const int thread_count = OS::get_singleton()->get_processor_count();
+
+	TestBenchmark::run("Block churn, system allocator", [&]() {
+		_run_churn(&_churn_blocks, &system_allocator, thread_count);
+	});
+	TestBenchmark::run("Block churn, size-class allocator", [&]() {
+		_run_churn(&_churn_blocks, &builtin_allocator, thread_count);
+	});
+	TestBenchmark::run("Buffer growth, system allocator", [&]() {
+		_run_churn(&_churn_growth, &system_allocator, thread_count);
+	});
+	TestBenchmark::run("Buffer growth, size-class allocator", [&]() {
+		_run_churn(&_churn_growth, &builtin_allocator, thread_count);
+	});
+
+	// Goes through Memory, so this one depends on the build.
+#ifdef BUILTIN_ALLOCATOR_ENABLED
+	TestBenchmark::run("Variant/String/Vector churn, size-class allocator backend", [&]() {
+		_run_churn(&_churn_variants, nullptr, thread_count);
+	});
+#else
+	TestBenchmark::run("Variant/String/Vector churn, system allocator backend", [&]() {
+		_run_churn(&_churn_variants, nullptr, thread_count);
+	});
+#endif
+}
+
+} // namespace TestSizeClassAllocator
@@ -0,0 +1,164 @@
+/**************************************************************************/
+/*  test_trace_profiler.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_trace_profiler)
+
+#include "core/profiling/profiling.h"
+
+#ifdef GODOT_USE_TRACE_PROFILER
+
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/os/thread.h"
+#include "tests/test_utils.h"
+
+namespace TestTraceProfiler {
+
+static constexpr int ZONE_ITERATIONS = 100;
+
+static void _record_nested_zones(void *p_userdata) {
+	for (int i = 0; i < ZONE_ITERATIONS; i++) {
+		TraceProfiler::ScopedZone outer("Outer");
+		{
+			TraceProfiler::ScopedZone inner("Inner");
+			TraceProfiler::ScopedZone innermost("Innermost");
+		}
+	}
+}
+
+// Parses a saved capture, checks that every thread ends its zones in reverse order of beginning them,
+// and returns how many zones with each name were recorded. Zones still open when saving are added to r_open_zones.
+static HashMap<String, int> _check_capture(const String &p_path, LocalVector<String> &r_open_zones) {
+	HashMap<String, int> zone_counts;
+
+	Ref<JSON> json;
+	json.instantiate();
+	REQUIRE_MESSAGE(json->parse(FileAccess::get_file_as_string(p_path)) == OK, "The capture should be valid JSON.");
+	const Dictionary data = json->get_data();
+	REQUIRE(data.has("traceEvents"));
+	const Array events = data["traceEvents"];
+
+	HashMap<String, LocalVector<String>> zone_stacks;
+	HashMap<String, uint64_t> last_times;
+	bool ordered = true;
+	bool balanced = true;
+	for (const Variant &event_variant : events) {
+		const Dictionary event = event_variant;
+		const String ph = event["ph"];
+		if (ph != "B" && ph != "E") {
+			continue;
+		}
+		const String tid = event["tid"];
+		const String name = event["name"];
+		const uint64_t time = event["ts"];
+
+		if (last_times.has(tid) && time < last_times[tid]) {
+			ordered = false;
+		}
+		last_times[tid] = time;
+
+		LocalVector<String> &stack = zone_stacks[tid];
+		if (ph == "B") {
+			stack.push_back(name);
+			zone_counts[name]++;
+		} else if (stack.is_empty() || stack[stack.size() - 1] != name) {
+			balanced = false;
+		} else {
+			stack.remove_at(stack.size() - 1);
+		}
+	}
+	r_open_zones.clear();
+	for (const KeyValue<String, LocalVector<String>> &E : zone_stacks) {
+		for (const String &name : E.value) {
+			r_open_zones.push_back(name);
+		}
+	}
+	CHECK_MESSAGE(ordered, "Events of a thread should be in chronological order.");
+	CHECK_MESSAGE(balanced, "Every zone should end on the thread it began on, in reverse order of beginning.");
+
+	return zone_counts;
+}
+
+TEST_CASE("[TraceProfiler] Nested zones on several threads are saved balanced across captures") {
+	const bool was_capturing = TraceProfiler::is_capturing();
+	const String path = TestUtils::get_temp_path("trace_profiler_test.json");
+
+	// Not recorded, so its end must not be either.
+	TraceProfiler::ScopedZone before_capture("Before capture");
+
+	TraceProfiler::start();
+	// Began in the first capture, but ends in the second one.
+	TraceProfiler::ScopedZone spanning_captures("Spanning captures");
+
+	const int thread_count = 4;
+	Thread threads[thread_count];
+	for (Thread &thread : threads) {
+		thread.start(_record_nested_zones, nullptr);
+	}
+	_record_nested_zones(nullptr);
+	for (Thread &thread : threads) {
+		thread.wait_to_finish();
+	}
+
+	// Saving while capturing, the spanning zone is still open.
+	REQUIRE(TraceProfiler::save(path.utf8().get_data()));
+	LocalVector<String> open_zones;
+	HashMap<String, int> zone_counts = _check_capture(path, open_zones);
+	CHECK(open_zones.size() == 1);
+	CHECK(open_zones.has("Spanning captures"));
+	CHECK(zone_counts["Outer"] == (thread_count + 1) * ZONE_ITERATIONS);
+	CHECK(zone_counts["Inner"] == (thread_count + 1) * ZONE_ITERATIONS);
+	CHECK(zone_counts["Innermost"] == (thread_count + 1) * ZONE_ITERATIONS);
+	CHECK_FALSE(zone_counts.has("Before capture"));
+
+	// Starting a new capture discards the events of the first one, including the beginning of the spanning zone.
+	TraceProfiler::start();
+	_record_nested_zones(nullptr);
+	spanning_captures.end();
+	before_capture.end();
+	TraceProfiler::stop();
+
+	REQUIRE(TraceProfiler::save(path.utf8().get_data()));
+	zone_counts = _check_capture(path, open_zones);
+	CHECK(open_zones.is_empty());
+	CHECK(zone_counts["Outer"] == ZONE_ITERATIONS);
+	CHECK_FALSE(zone_counts.has("Spanning captures"));
+	CHECK_FALSE(zone_counts.has("Before capture"));
+
+	if (was_capturing) {
+		TraceProfiler::start();
+	}
+}
+
+} // namespace TestTraceProfiler
+
+#endif // GODOT_USE_TRACE_PROFILER
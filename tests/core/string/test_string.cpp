@@ -32,7 +32,11 @@
 
 TEST_FORCE_LINK(test_string)
 
+#include "core/io/json.h"
+#include "core/string/node_path.h"
 #include "core/string/ustring.h"
+#include "core/variant/variant_utility.h"
+#include "tests/test_benchmark.h"
 
 namespace TestString {
 
@@ -2245,4 +2249,79 @@ TEST_CASE("[String][URL] Parse URL") {
 #undef CHECK_URL
 }
 
+TEST_CASE("[String] Short strings growing and shrinking across small block capacity") {
+	String s;
+	String expected_prefix;
+	for (int i = 0; i < 64; i++) {
+		s += String::chr('a' + i % 26);
+		CHECK(s.length() == i + 1);
+		CHECK(s[i] == char32_t('a' + i % 26));
+		if (i == 7) {
+			expected_prefix = s;
+		}
+	}
+
+	// Copies share the buffer until written to.
+	String copy = s;
+	while (copy.length() > 8) {
+		copy.remove_at(copy.length() - 1);
+	}
+	CHECK(copy == expected_prefix);
+	CHECK(s.length() == 64);
+
+	s = s.left(3);
+	CHECK(s == "abc");
+	s += "defghijklmnopqrstuvwxyz";
+	CHECK(s == "abcdefghijklmnopqrstuvwxyz");
+	s = s.substr(0, 5);
+	CHECK(s == "abcde");
+
+	CharString utf8 = String("short").utf8();
+	CHECK(utf8.length() == 5);
+	CHECK(String::utf8(utf8.get_data()) == "short");
+}
+
+TEST_CASE("[String][Benchmark] Short string workloads" * doctest::skip()) {
+	int i = 0;
+	TestBenchmark::run("Concatenate a short string", [&]() {
+		String s = "node_";
+		s += itos(i++ % 100);
+		TestBenchmark::do_not_optimize(s);
+	});
+
+	TestBenchmark::run("Parse a node path", [&]() {
+		NodePath path("Root/Player/Sprite:position:x");
+		TestBenchmark::do_not_optimize(path);
+	});
+
+	TestBenchmark::run("Split a short list", [&]() {
+		Vector<String> parts = String("key,value,x,y,z,width,height").split(",");
+		TestBenchmark::do_not_optimize(parts);
+	});
+
+	// Mostly short keys and values, like settings and save files.
+	const String json = R"({"name": "Player", "class": "CharacterBody2D", "position": [12.5, 40.0], "visible": true, "groups": ["actors", "players"], "stats": {"hp": 100, "mp": 20, "speed": 3.5, "level": 7}})";
+	TestBenchmark::run("Parse JSON", [&]() {
+		Variant value = JSON::parse_string(json);
+		TestBenchmark::do_not_optimize(value);
+	});
+
+	const Variant json_value = JSON::parse_string(json);
+	TestBenchmark::run("Stringify JSON", [&]() {
+		String text = JSON::stringify(json_value);
+		TestBenchmark::do_not_optimize(text);
+	});
+
+	const String text = VariantUtilityFunctions::var_to_str(json_value);
+	TestBenchmark::run("Parse with VariantParser", [&]() {
+		Variant value = VariantUtilityFunctions::str_to_var(text);
+		TestBenchmark::do_not_optimize(value);
+	});
+
+	TestBenchmark::run("Write with VariantWriter", [&]() {
+		String written = VariantUtilityFunctions::var_to_str(json_value);
+		TestBenchmark::do_not_optimize(written);
+	});
+}
+
 } // namespace TestString
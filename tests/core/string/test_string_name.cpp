@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*  test_string_name.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_string_name)
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "core/string/string_name.h"
+#include "tests/test_benchmark.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName a = "test_string_name_interning";
+	const StringName b = String("test_string_name_interning");
+	const StringName c = "test_string_name_other";
+
+	CHECK(a == b);
+	CHECK(a.data_unique_pointer() == b.data_unique_pointer());
+	CHECK(a != c);
+	CHECK(a == "test_string_name_interning");
+	CHECK(String(a) == "test_string_name_interning");
+	CHECK(a.hash() == String("test_string_name_interning").hash());
+
+	CHECK(StringName().is_empty());
+	CHECK(StringName("").is_empty());
+	CHECK(StringName(String()).is_empty());
+}
+
+TEST_CASE("[StringName] Names are released and interned again") {
+	const String name = "test_string_name_released";
+	{
+		const StringName a = name;
+		CHECK(a == name);
+	}
+	// The entry was freed, a new one must be created with the same contents.
+	const StringName b = name;
+	const StringName c = name;
+	CHECK(b == name);
+	CHECK(b.data_unique_pointer() == c.data_unique_pointer());
+}
+
+struct InternStressData {
+	static constexpr int NAME_COUNT = 256;
+
+	String names[NAME_COUNT];
+	// Kept alive for the whole test, every thread must resolve to these.
+	StringName pinned[NAME_COUNT / 2];
+	SafeNumeric<uint32_t> failures;
+};
+
+static void _intern_stress(void *p_userdata, uint32_t p_index) {
+	InternStressData *data = (InternStressData *)p_userdata;
+	uint32_t state = p_index * 7919 + 1;
+
+	for (int i = 0; i < 20000; i++) {
+		state = state * 1103515245 + 12345;
+		const int idx = (state >> 8) % InternStressData::NAME_COUNT;
+
+		// Names in the second half are not pinned, so they keep being freed and interned again by the threads.
+		const StringName name = data->names[idx];
+		const StringName other = data->names[idx].utf8().get_data();
+		if (name != other || String(name) != data->names[idx]) {
+			data->failures.increment();
+		}
+		if (idx < InternStressData::NAME_COUNT / 2 && name != data->pinned[idx]) {
+			data->failures.increment();
+		}
+	}
+}
+
+TEST_CASE("[StringName] Concurrent interning") {
+	InternStressData data;
+	for (int i = 0; i < InternStressData::NAME_COUNT; i++) {
+		data.names[i] = "test_string_name_stress_" + itos(i);
+	}
+	for (int i = 0; i < InternStressData::NAME_COUNT / 2; i++) {
+		data.pinned[i] = data.names[i];
+	}
+
+	const int thread_count = MAX(4, OS::get_singleton()->get_processor_count());
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(&_intern_stress, &data, thread_count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+
+	CHECK(data.failures.get() == 0);
+	for (int i = 0; i < InternStressData::NAME_COUNT / 2; i++) {
+		CHECK(data.pinned[i] == StringName(data.names[i]));
+	}
+}
+
+static void _lookup_existing(void *p_userdata, uint32_t p_index) {
+	const Vector<String> &names = *(const Vector<String> *)p_userdata;
+	for (const String &name : names) {
+		StringName string_name = name;
+		TestBenchmark::do_not_optimize(string_name);
+	}
+}
+
+TEST_CASE("[StringName][Benchmark] Concurrent lookup of existing names" * doctest::skip()) {
+	Vector<String> names;
+	LocalVector<StringName> pinned;
+	for (int i = 0; i < 10000; i++) {
+		names.push_back("benchmark_name_" + itos(i));
+		pinned.push_back(names[i]);
+	}
+
+	for (int thread_count = 1; thread_count <= OS::get_singleton()->get_processor_count(); thread_count *= 2) {
+		// A pool of its own, sized to the thread count being measured.
+		WorkerThreadPool *pool = memnew(WorkerThreadPool(false));
+		pool->init(thread_count);
+
+		TestBenchmark::run(vformat("%d lookups per thread (%d threads)", names.size(), thread_count), [&]() {
+			WorkerThreadPool::GroupID group = pool->add_native_group_task(&_lookup_existing, &names, thread_count, thread_count, true);
+			pool->wait_for_group_task_completion(group);
+		});
+
+		pool->finish();
+		memdelete(pool);
+	}
+}
+
+} // namespace TestStringName
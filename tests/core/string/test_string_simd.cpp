@@ -0,0 +1,296 @@
+/**************************************************************************/
+/*  test_string_simd.cpp                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_string_simd)
+
+#include "core/math/random_pcg.h"
+#include "core/string/string_simd.h"
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+
+namespace TestStringSIMD {
+
+// Random text biased towards long ASCII runs, so that both the vectorized blocks and
+// the transitions to the scalar paths are exercised.
+static LocalVector<char32_t> _random_text(RandomPCG &p_rng, uint32_t p_length, bool p_allow_surrogates = false) {
+	static const char32_t non_ascii[] = { 0xE9, 0x7FF, 0x800, 0x4E2D, 0xD7FF, 0xE000, 0xFFFD, 0xFFFF, 0x10000, 0x1F600, 0x10FFFF };
+	LocalVector<char32_t> text;
+	for (uint32_t i = 0; i < p_length; i++) {
+		const uint32_t kind = p_rng.rand(100);
+		if (kind < 85) {
+			text.push_back(char32_t(0x20 + p_rng.rand(0x5F)));
+		} else if (kind < 88) {
+			text.push_back(char32_t(1 + p_rng.rand(0x7F)));
+		} else if (kind < 98 || !p_allow_surrogates) {
+			text.push_back(non_ascii[p_rng.rand(std_size(non_ascii))]);
+		} else {
+			text.push_back(char32_t(0xD800 + p_rng.rand(0x800)));
+		}
+	}
+	return text;
+}
+
+static String _to_string(const LocalVector<char32_t> &p_text) {
+	String string;
+	string.resize_uninitialized(p_text.size() + 1);
+	char32_t *dst = string.ptrw();
+	for (uint32_t i = 0; i < p_text.size(); i++) {
+		dst[i] = p_text[i];
+	}
+	dst[p_text.size()] = 0;
+	return string;
+}
+
+static void _encode_utf8(char32_t p_char, LocalVector<uint8_t> &r_bytes) {
+	const uint32_t c = p_char;
+	if (c <= 0x7F) {
+		r_bytes.push_back(c);
+	} else if (c <= 0x7FF) {
+		r_bytes.push_back(0xC0 | (c >> 6));
+		r_bytes.push_back(0x80 | (c & 0x3F));
+	} else if (c <= 0xFFFF) {
+		r_bytes.push_back(0xE0 | (c >> 12));
+		r_bytes.push_back(0x80 | ((c >> 6) & 0x3F));
+		r_bytes.push_back(0x80 | (c & 0x3F));
+	} else {
+		r_bytes.push_back(0xF0 | (c >> 18));
+		r_bytes.push_back(0x80 | ((c >> 12) & 0x3F));
+		r_bytes.push_back(0x80 | ((c >> 6) & 0x3F));
+		r_bytes.push_back(0x80 | (c & 0x3F));
+	}
+}
+
+static int _find_reference(const String &p_string, const String &p_what, int p_from) {
+	for (int i = p_from; i <= p_string.length() - p_what.length(); i++) {
+		bool match = true;
+		for (int j = 0; j < p_what.length(); j++) {
+			if (p_string[i + j] != p_what[j]) {
+				match = false;
+				break;
+			}
+		}
+		if (match) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+TEST_CASE("[StringSIMD] Run lengths and conversions at every offset and length") {
+	RandomPCG rng(12345);
+	for (int iteration = 0; iteration < 200; iteration++) {
+		const LocalVector<char32_t> text = _random_text(rng, 1 + rng.rand(80));
+		LocalVector<uint8_t> bytes;
+		for (char32_t c : text) {
+			bytes.push_back(c <= 0x7F ? uint8_t(c) : uint8_t(0x80 + rng.rand(0x80)));
+		}
+
+		for (uint32_t from = 0; from < text.size(); from++) {
+			const uint32_t len = text.size() - from;
+
+			uint32_t expected = 0;
+			while (expected < len && text[from + expected] <= 0x7F) {
+				expected++;
+			}
+			CHECK(StringSIMD::utf32_ascii_length(text.ptr() + from, len) == expected);
+
+			uint8_t narrow[128];
+			StringSIMD::utf32_to_ascii(text.ptr() + from, expected, narrow);
+			char32_t wide[128];
+			CHECK(StringSIMD::ascii_to_utf32(narrow, expected, wide) == expected);
+			CHECK(memcmp(wide, text.ptr() + from, expected * sizeof(char32_t)) == 0);
+
+			expected = 0;
+			while (expected < len && bytes[from + expected] > 0 && bytes[from + expected] < 0x80) {
+				expected++;
+			}
+			CHECK(StringSIMD::ascii_to_utf32(bytes.ptr() + from, len, wide) == expected);
+
+			expected = 0;
+			while (expected < len && text[from + expected] < 0xD800) {
+				expected++;
+			}
+			CHECK(StringSIMD::utf32_bmp_length(text.ptr() + from, len) == expected);
+
+			char16_t utf16[128];
+			StringSIMD::utf32_to_utf16_bmp(text.ptr() + from, expected, utf16);
+			bool utf16_equal = true;
+			for (uint32_t i = 0; i < expected; i++) {
+				utf16_equal = utf16_equal && char32_t(utf16[i]) == text[from + i];
+			}
+			CHECK(utf16_equal);
+
+			const char32_t what = text[rng.rand(text.size())];
+			int64_t expected_index = -1;
+			for (uint32_t i = from; i < text.size(); i++) {
+				if (text[i] == what) {
+					expected_index = i - from;
+					break;
+				}
+			}
+			CHECK(StringSIMD::find_char(text.ptr() + from, len, what) == expected_index);
+		}
+	}
+}
+
+TEST_CASE("[StringSIMD] UTF-8 encoding and decoding of fuzzed valid text") {
+	RandomPCG rng(4321);
+	for (int iteration = 0; iteration < 500; iteration++) {
+		const LocalVector<char32_t> text = _random_text(rng, rng.rand(300));
+		const String string = _to_string(text);
+
+		LocalVector<uint8_t> expected;
+		LocalVector<uint8_t> expected_lengths;
+		for (char32_t c : text) {
+			const uint32_t prev_size = expected.size();
+			_encode_utf8(c, expected);
+			expected_lengths.push_back(expected.size() - prev_size);
+		}
+
+		Vector<uint8_t> lengths;
+		const CharString utf8 = string.utf8(&lengths);
+		REQUIRE(utf8.length() == (int)expected.size());
+		if (!text.is_empty()) {
+			CHECK(memcmp(utf8.get_data(), expected.ptr(), expected.size()) == 0);
+			REQUIRE(lengths.size() == (int)expected_lengths.size());
+			CHECK(memcmp(lengths.ptr(), expected_lengths.ptr(), expected_lengths.size()) == 0);
+		}
+
+		String decoded;
+		CHECK(decoded.append_utf8(utf8.get_data(), utf8.length()) == OK);
+		CHECK(decoded == string);
+	}
+}
+
+TEST_CASE("[StringSIMD] UTF-8 decoding of fuzzed invalid input") {
+	// ASCII bytes are never part of a multi-byte sequence, and decoding stops looking ahead at
+	// the first one. So decoding the whole input must match decoding each run of non-ASCII bytes
+	// together with the ASCII byte following it, and copying the other ASCII bytes.
+	RandomPCG rng(777);
+	ERR_PRINT_OFF;
+	for (int iteration = 0; iteration < 500; iteration++) {
+		LocalVector<uint8_t> bytes;
+		const uint32_t length = rng.rand(200);
+		for (uint32_t i = 0; i < length; i++) {
+			uint8_t byte = rng.rand(100) < 80 ? uint8_t(1 + rng.rand(0x7F)) : uint8_t(0x80 + rng.rand(0x80));
+			if (byte == 0xEF) {
+				byte = 0xEE; // Avoid BOMs, they are only skipped at the start of the input.
+			}
+			bytes.push_back(byte);
+		}
+
+		String expected;
+		uint32_t i = 0;
+		while (i < bytes.size()) {
+			if (bytes[i] < 0x80) {
+				expected += char32_t(bytes[i]);
+				i++;
+				continue;
+			}
+			uint32_t end = i;
+			while (end < bytes.size() && bytes[end] >= 0x80) {
+				end++;
+			}
+			if (end < bytes.size()) {
+				end++;
+			}
+			expected.append_utf8((const char *)bytes.ptr() + i, end - i);
+			i = end;
+		}
+
+		String decoded;
+		decoded.append_utf8((const char *)bytes.ptr(), bytes.size());
+		CHECK(decoded == expected);
+	}
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[StringSIMD] UTF-16 encoding of fuzzed text") {
+	RandomPCG rng(99);
+	ERR_PRINT_OFF;
+	for (int iteration = 0; iteration < 500; iteration++) {
+		const LocalVector<char32_t> text = _random_text(rng, rng.rand(300), true);
+
+		LocalVector<char16_t> expected;
+		for (char32_t c : text) {
+			if (c <= 0xFFFF) {
+				expected.push_back(c);
+			} else {
+				expected.push_back((c >> 10) + 0xD7C0);
+				expected.push_back((c & 0x3FF) | 0xDC00);
+			}
+		}
+
+		const Char16String utf16 = _to_string(text).utf16();
+		REQUIRE(utf16.length() == (int)expected.size());
+		if (!expected.is_empty()) {
+			CHECK(memcmp(utf16.get_data(), expected.ptr(), expected.size() * sizeof(char16_t)) == 0);
+		}
+	}
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[StringSIMD] Find and contains on fuzzed text") {
+	RandomPCG rng(2024);
+	for (int iteration = 0; iteration < 2000; iteration++) {
+		// Use a small alphabet so that partial matches are frequent.
+		String string;
+		const uint32_t length = rng.rand(100);
+		for (uint32_t i = 0; i < length; i++) {
+			string += char32_t(rng.rand(100) < 95 ? 'a' + rng.rand(3) : 0x4E2D);
+		}
+
+		String what;
+		if (length > 0 && rng.rand(2) == 0) {
+			const int start = rng.rand(length);
+			what = string.substr(start, 1 + rng.rand(MIN(12u, length - start)));
+		} else {
+			const uint32_t what_length = 1 + rng.rand(6);
+			for (uint32_t i = 0; i < what_length; i++) {
+				what += char32_t('a' + rng.rand(3));
+			}
+		}
+		const int from = length > 0 ? rng.rand(length) : 0;
+
+		const int expected = _find_reference(string, what, from);
+		CHECK(string.find(what, from) == expected);
+		if (!what.contains_char(0x4E2D)) {
+			CHECK(string.find(what.ascii().get_data(), from) == expected);
+		}
+		CHECK(string.contains(what) == (_find_reference(string, what, 0) != -1));
+		if (what.length() == 1) {
+			CHECK(string.find_char(what[0], from) == expected);
+		}
+	}
+}
+
+} // namespace TestStringSIMD
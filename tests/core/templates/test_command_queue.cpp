@@ -37,6 +37,8 @@ TEST_FORCE_LINK(test_command_queue)
 #include "core/os/os.h"
 #include "core/os/thread.h"
 #include "core/templates/command_queue_mt.h"
+#include "core/templates/safe_refcount.h"
+#include "tests/test_benchmark.h"
 
 namespace TestCommandQueue {
 
@@ -519,4 +521,139 @@ TEST_CASE("[CommandQueue] Test Parameter Passing Semantics") {
 	sts.destroy_threads();
 }
 
+class RingBufferTestState {
+public:
+	CommandQueueMT command_queue;
+	Thread consumer_thread;
+	Thread producer_thread;
+	SafeFlag exit_consumer;
+	SafeNumeric<uint32_t> main_pushed;
+
+	uint32_t main_count = 0;
+	uint32_t other_count = 0;
+	int errors = 0;
+
+	void main_command(uint32_t p_index, Transform3D p_transform) {
+		if (p_index != main_count + 1 || p_transform.origin.x != p_index) {
+			errors++;
+		}
+		main_count = p_index;
+	}
+	void other_command(uint32_t p_index, uint32_t p_main_pushed) {
+		// Commands pushed from the main thread before this one was pushed must have run.
+		if (p_index != other_count + 1 || main_count < p_main_pushed) {
+			errors++;
+		}
+		other_count = p_index;
+	}
+	uint32_t get_main_count() {
+		return main_count;
+	}
+
+	static void consumer_loop(void *p_userdata) {
+		RingBufferTestState *state = static_cast<RingBufferTestState *>(p_userdata);
+		while (!state->exit_consumer.is_set()) {
+			state->command_queue.flush_all();
+		}
+		state->command_queue.flush_all();
+	}
+	static void producer_loop(void *p_userdata) {
+		RingBufferTestState *state = static_cast<RingBufferTestState *>(p_userdata);
+		for (uint32_t i = 1; i <= 2000; i++) {
+			state->command_queue.push(state, &RingBufferTestState::other_command, i, state->main_pushed.get());
+			if (i % 500 == 0) {
+				state->command_queue.sync();
+			}
+		}
+	}
+};
+
+TEST_CASE("[CommandQueue] Ring buffer keeps the order of commands") {
+	RingBufferTestState state;
+	// The smallest ring possible, so it wraps around and fills up often.
+	state.command_queue.enable_ring_buffer(Thread::get_caller_id(), 1);
+	state.consumer_thread.start(&RingBufferTestState::consumer_loop, &state);
+	state.producer_thread.start(&RingBufferTestState::producer_loop, &state);
+
+	const uint32_t command_count = 10000;
+	int ret_errors = 0;
+	for (uint32_t i = 1; i <= command_count; i++) {
+		state.command_queue.push(&state, &RingBufferTestState::main_command, i, Transform3D(Basis(), Vector3(i, 0, 0)));
+		state.main_pushed.set(i);
+		if (i % 1000 == 0) {
+			uint32_t ret = 0;
+			state.command_queue.push_and_ret(&state, &RingBufferTestState::get_main_count, &ret);
+			if (ret != i) {
+				ret_errors++;
+			}
+		}
+	}
+
+	state.producer_thread.wait_to_finish();
+	state.command_queue.sync();
+	CHECK_MESSAGE(ret_errors == 0, "Commands with return values should run after the ones pushed before them.");
+
+	state.exit_consumer.set();
+	state.consumer_thread.wait_to_finish();
+
+	CHECK(state.main_count == command_count);
+	CHECK(state.other_count == 2000);
+	CHECK_MESSAGE(state.errors == 0, "Commands should run in the order they were pushed in.");
+}
+
+class CommandQueueBenchmark {
+public:
+	CommandQueueMT command_queue;
+	SafeFlag exit_consumer;
+	Thread consumer;
+	uint64_t sum = 0;
+	uint64_t expected_sum = 0;
+
+	void add(uint64_t p_value, Transform3D p_transform) {
+		sum += p_value;
+	}
+
+	static void consumer_loop(void *p_userdata) {
+		CommandQueueBenchmark *bench = static_cast<CommandQueueBenchmark *>(p_userdata);
+		while (!bench->exit_consumer.is_set()) {
+			bench->command_queue.flush_all();
+		}
+		bench->command_queue.flush_all();
+	}
+
+	void start(bool p_ring_buffer) {
+		if (p_ring_buffer) {
+			command_queue.enable_ring_buffer(Thread::get_caller_id());
+		}
+		consumer.start(&CommandQueueBenchmark::consumer_loop, this);
+	}
+
+	void push_commands(uint32_t p_command_count) {
+		for (uint32_t i = 0; i < p_command_count; i++) {
+			command_queue.push(this, &CommandQueueBenchmark::add, (uint64_t)i, Transform3D());
+			expected_sum += i;
+		}
+		command_queue.sync();
+	}
+
+	void stop() {
+		exit_consumer.set();
+		consumer.wait_to_finish();
+	}
+};
+
+TEST_CASE("[CommandQueue][Benchmark] Mutex queue versus ring buffer" * doctest::skip()) {
+	const uint32_t command_count = 1000;
+	for (int i = 0; i < 2; i++) {
+		bool ring_buffer = i == 1;
+		CommandQueueBenchmark bench;
+		bench.start(ring_buffer);
+		TestBenchmark::run(vformat("%s, %d commands then sync", ring_buffer ? "Ring buffer" : "Mutex", command_count), [&]() {
+			bench.push_commands(command_count);
+		});
+		bench.stop();
+		CHECK(bench.sum == bench.expected_sum);
+	}
+}
+
 } // namespace TestCommandQueue
@@ -33,6 +33,7 @@
 TEST_FORCE_LINK(test_hash_map)
 
 #include "core/templates/hash_map.h"
+#include "tests/test_benchmark.h"
 
 namespace TestHashMap {
 
@@ -174,4 +175,45 @@ TEST_CASE("[HashMap] Sort") {
 	}
 }
 
+TEST_CASE("[HashMap][Benchmark] Insertion, lookup and erasure" * doctest::skip()) {
+	constexpr int COUNT = 1000;
+
+	TestBenchmark::run("HashMap<int, int> insert + erase (1000 keys)", [&]() {
+		HashMap<int, int> map;
+		for (int i = 0; i < COUNT; i++) {
+			map.insert(i * 7919, i);
+		}
+		for (int i = 0; i < COUNT; i++) {
+			map.erase(i * 7919);
+		}
+		TestBenchmark::do_not_optimize(map);
+	});
+
+	HashMap<int, int> map;
+	for (int i = 0; i < COUNT; i++) {
+		map.insert(i * 7919, i);
+	}
+	TestBenchmark::run("HashMap<int, int> lookup (1000 keys)", [&]() {
+		int sum = 0;
+		for (int i = 0; i < COUNT; i++) {
+			sum += map[i * 7919];
+		}
+		TestBenchmark::do_not_optimize(sum);
+	});
+
+	HashMap<String, int> string_map;
+	LocalVector<String> keys;
+	for (int i = 0; i < COUNT; i++) {
+		keys.push_back(itos(i * 7919));
+		string_map.insert(keys[i], i);
+	}
+	TestBenchmark::run("HashMap<String, int> lookup (1000 keys)", [&]() {
+		int sum = 0;
+		for (const String &key : keys) {
+			sum += string_map[key];
+		}
+		TestBenchmark::do_not_optimize(sum);
+	});
+}
+
 } // namespace TestHashMap
@@ -0,0 +1,162 @@
+/**************************************************************************/
+/*  test_parallel_sort_array.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_parallel_sort_array)
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/parallel_sort_array.h"
+#include "core/templates/radix_sort.h"
+#include "core/templates/safe_refcount.h"
+#include "core/templates/vector.h"
+#include "core/variant/variant.h"
+#include "tests/test_benchmark.h"
+
+namespace TestParallelSortArray {
+
+TEST_CASE("[ParallelSortArray] Matches SortArray") {
+	RandomPCG rng(1234);
+	// Sizes around the thresholds for splitting, and uneven chunk sizes.
+	for (int size : { 0, 1, 100, 32767, 32768, 100003, 400000 }) {
+		Vector<int> values;
+		values.resize(size);
+		for (int i = 0; i < size; i++) {
+			values.write[i] = rng.rand(1000); // Many duplicates.
+		}
+		Vector<int> expected = values;
+		expected.sort();
+
+		ParallelSortArray<int>().sort(values.ptrw(), values.size());
+		CHECK_MESSAGE(values == expected, vformat("Size %d.", size));
+	}
+}
+
+TEST_CASE("[ParallelSortArray] Non-trivial elements and custom comparator") {
+	RandomPCG rng(99);
+	Vector<String> strings;
+	for (int i = 0; i < 100000; i++) {
+		strings.push_back(itos(rng.rand(50000)));
+	}
+
+	Vector<String> expected = strings;
+	expected.sort_custom<NaturalNoCaseComparator>();
+	ParallelSortArray<String, NaturalNoCaseComparator>().sort(strings.ptrw(), strings.size());
+	CHECK(strings == expected);
+}
+
+struct SortInTasks {
+	LocalVector<Vector<int>> values;
+	SafeNumeric<int> started;
+};
+
+static void _sort_in_task(void *p_userdata) {
+	SortInTasks *sort_in_tasks = (SortInTasks *)p_userdata;
+	const int index = sort_in_tasks->started.postincrement();
+	// Wait until all threads of the pool run one of these tasks, so that none is left to run group tasks.
+	while (sort_in_tasks->started.get() < (int)sort_in_tasks->values.size()) {
+		OS::get_singleton()->delay_usec(100);
+	}
+	Vector<int> &values = sort_in_tasks->values[index];
+	ParallelSortArray<int>().sort(values.ptrw(), values.size());
+}
+
+TEST_CASE("[ParallelSortArray] Sorting from WorkerThreadPool tasks") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	RandomPCG rng(42);
+	SortInTasks sort_in_tasks;
+	LocalVector<Vector<int>> expected;
+	sort_in_tasks.values.resize(pool->get_thread_count());
+	for (Vector<int> &values : sort_in_tasks.values) {
+		values.resize(100000);
+		for (int i = 0; i < values.size(); i++) {
+			values.write[i] = rng.rand();
+		}
+		expected.push_back(values);
+		expected[expected.size() - 1].sort();
+	}
+
+	// Must sort on the threads of the tasks instead of waiting for group tasks.
+	LocalVector<WorkerThreadPool::TaskID> tasks;
+	for (uint32_t i = 0; i < sort_in_tasks.values.size(); i++) {
+		tasks.push_back(pool->add_native_task(&_sort_in_task, &sort_in_tasks, true));
+	}
+	for (WorkerThreadPool::TaskID task : tasks) {
+		pool->wait_for_task_completion(task);
+	}
+	for (uint32_t i = 0; i < expected.size(); i++) {
+		CHECK(sort_in_tasks.values[i] == expected[i]);
+	}
+}
+
+TEST_CASE("[ParallelSortArray] Packed array method (variant call)") {
+	PackedStringArray strings = { "delta", "alpha", "charlie", "bravo" };
+	Variant v_array = strings;
+	Callable::CallError err;
+	Variant v_ret;
+	v_array.callp("parallel_sort", nullptr, 0, v_ret, err);
+	CHECK(err.error == Callable::CallError::CALL_OK);
+	CHECK(v_array.operator PackedStringArray() == PackedStringArray{ "alpha", "bravo", "charlie", "delta" });
+
+	v_array = PackedFloat64Array{ 3.0, -2.0, 1.0 };
+	v_array.callp("parallel_sort", nullptr, 0, v_ret, err);
+	CHECK(err.error == Callable::CallError::CALL_OK);
+	CHECK(v_array.operator PackedFloat64Array() == PackedFloat64Array{ -2.0, 1.0, 3.0 });
+}
+
+TEST_CASE("[ParallelSortArray][Benchmark] SortArray, ParallelSortArray and RadixSort" * doctest::skip()) {
+	RandomPCG rng(5);
+	for (int size : { 1000000, 10000000, 50000000 }) {
+		Vector<int32_t> source;
+		source.resize(size);
+		for (int i = 0; i < size; i++) {
+			source.write[i] = int32_t(rng.rand());
+		}
+
+		// Every iteration sorts a fresh copy of the source, the copy is timed for all sorts alike.
+		Vector<int32_t> values;
+		TestBenchmark::run(vformat("SortArray, %d int32", size), [&]() {
+			values = source;
+			values.sort();
+		});
+		TestBenchmark::run(vformat("ParallelSortArray, %d int32", size), [&]() {
+			values = source;
+			ParallelSortArray<int32_t>().sort(values.ptrw(), values.size());
+		});
+		TestBenchmark::run(vformat("RadixSort, %d int32", size), [&]() {
+			values = source;
+			RadixSort<int32_t>().sort(values.ptrw(), values.size());
+		});
+	}
+}
+
+} // namespace TestParallelSortArray
@@ -0,0 +1,143 @@
+/**************************************************************************/
+/*  test_radix_sort.cpp                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_radix_sort)
+
+#include "core/math/random_pcg.h"
+#include "core/templates/radix_sort.h"
+#include "core/templates/vector.h"
+#include "core/variant/variant.h"
+
+namespace TestRadixSort {
+
+template <typename T>
+static void _check_matches_sort_array(const Vector<T> &p_values) {
+	Vector<T> expected = p_values;
+	expected.sort();
+	Vector<T> sorted = p_values;
+	RadixSort<T>().sort(sorted.ptrw(), sorted.size());
+	CHECK(sorted == expected);
+}
+
+TEST_CASE("[RadixSort] Integers") {
+	RandomPCG rng(42);
+	Vector<uint8_t> bytes;
+	Vector<int32_t> ints;
+	Vector<int64_t> longs;
+	for (int i = 0; i < 10000; i++) {
+		bytes.push_back(rng.rand());
+		ints.push_back(int32_t(rng.rand()));
+		// Mix small values (so some passes are skipped) and full range values of both signs.
+		longs.push_back(i % 2 ? int64_t(rng.rand(100)) - 50 : int64_t((uint64_t(rng.rand()) << 32) | rng.rand()));
+	}
+	ints.push_back(INT32_MIN);
+	ints.push_back(INT32_MAX);
+	longs.push_back(INT64_MIN);
+	longs.push_back(INT64_MAX);
+
+	_check_matches_sort_array(bytes);
+	_check_matches_sort_array(ints);
+	_check_matches_sort_array(longs);
+	_check_matches_sort_array(Vector<int32_t>());
+	_check_matches_sort_array(Vector<int32_t>{ 7 });
+	_check_matches_sort_array(Vector<int32_t>{ 3, 3, 3, 3 });
+}
+
+TEST_CASE("[RadixSort] Floats") {
+	RandomPCG rng(7);
+	Vector<float> floats;
+	Vector<double> doubles;
+	for (int i = 0; i < 10000; i++) {
+		floats.push_back(rng.randf() * 2000.0f - 1000.0f);
+		doubles.push_back((rng.randf() - 0.5) * Math::pow(10.0, double(rng.rand(40)) - 20.0));
+	}
+	floats.push_back(Math::INF);
+	floats.push_back(-Math::INF);
+	floats.push_back(0.0f);
+	doubles.push_back(-Math::INF);
+	doubles.push_back(1e-310); // Denormal.
+	doubles.push_back(-1e-310);
+
+	_check_matches_sort_array(floats);
+	_check_matches_sort_array(doubles);
+
+	Vector<double> zeros = { 0.0, -0.0, 1.0, -1.0 };
+	RadixSort<double>().sort(zeros.ptrw(), zeros.size());
+	CHECK(zeros[0] == -1.0);
+	CHECK(std::signbit(zeros[1]));
+	CHECK(!std::signbit(zeros[2]));
+	CHECK(zeros[3] == 1.0);
+}
+
+struct _KeyedValue {
+	uint16_t key = 0;
+	int index = 0;
+};
+
+struct _KeyedValueKey {
+	using Key = uint16_t;
+	Key operator()(const _KeyedValue &p_value) const { return p_value.key; }
+};
+
+TEST_CASE("[RadixSort] Custom key extractor is stable") {
+	RandomPCG rng(3);
+	Vector<_KeyedValue> values;
+	for (int i = 0; i < 5000; i++) {
+		values.push_back({ uint16_t(rng.rand(300)), i });
+	}
+
+	RadixSort<_KeyedValue, _KeyedValueKey>().sort(values.ptrw(), values.size());
+
+	bool sorted = true;
+	for (int i = 1; i < values.size(); i++) {
+		const _KeyedValue &prev = values[i - 1];
+		const _KeyedValue &cur = values[i];
+		sorted = sorted && (prev.key < cur.key || (prev.key == cur.key && prev.index < cur.index));
+	}
+	CHECK(sorted);
+}
+
+TEST_CASE("[RadixSort] Packed array method (variant call)") {
+	Variant v_array = PackedInt64Array{ 5, -3, 100, 0, -3, 42 };
+	Callable::CallError err;
+	Variant v_ret;
+	v_array.callp("radix_sort", nullptr, 0, v_ret, err);
+	CHECK(err.error == Callable::CallError::CALL_OK);
+	CHECK(v_array.operator PackedInt64Array() == PackedInt64Array{ -3, -3, 0, 5, 42, 100 });
+
+	v_array = PackedFloat32Array{ 2.5f, -1.0f, 0.25f };
+	v_array.callp("radix_sort", nullptr, 0, v_ret, err);
+	CHECK(err.error == Callable::CallError::CALL_OK);
+	CHECK(v_array.operator PackedFloat32Array() == PackedFloat32Array{ -1.0f, 0.25f, 2.5f });
+}
+
+} // namespace TestRadixSort
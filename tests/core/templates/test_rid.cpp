@@ -37,6 +37,7 @@ TEST_FORCE_LINK(test_rid)
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
+#include "tests/test_benchmark.h"
 
 #ifdef TSAN_ENABLED
 #include <sanitizer/tsan_interface.h>
@@ -241,6 +242,118 @@ TEST_CASE("[RID_Owner] Thread safety") {
 		tester.test();
 	}
 }
+
+TEST_CASE("[RID_Owner] Concurrent allocation and freeing") {
+	static constexpr uint32_t ROUNDS = 200;
+	static constexpr uint32_t RIDS_PER_ROUND = 64;
+
+	struct StressTester {
+		// Small chunks, so threads also race to add new ones.
+		RID_Owner<uint64_t, true> rid_owner{ sizeof(uint64_t) * 16 };
+		TightLocalVector<Thread> threads;
+		SafeNumeric<uint32_t> next_thread_idx;
+		SafeNumeric<uint32_t> errors;
+
+		static void thread_func(void *p_data) {
+			StressTester *st = (StressTester *)p_data;
+			uint64_t self_th_idx = st->next_thread_idx.postincrement();
+
+			RID rids[RIDS_PER_ROUND];
+			for (uint32_t round = 0; round < ROUNDS; round++) {
+				for (uint32_t i = 0; i < RIDS_PER_ROUND; i++) {
+					rids[i] = st->rid_owner.make_rid((self_th_idx << 32) | (round * RIDS_PER_ROUND + i));
+				}
+				for (uint32_t i = 0; i < RIDS_PER_ROUND; i++) {
+					uint64_t *value = st->rid_owner.get_or_null(rids[i]);
+					if (!value || *value != ((self_th_idx << 32) | (round * RIDS_PER_ROUND + i)) || !st->rid_owner.owns(rids[i])) {
+						st->errors.increment();
+					}
+				}
+				for (uint32_t i = 0; i < RIDS_PER_ROUND; i++) {
+					st->rid_owner.free(rids[i]);
+					// A freed RID must stay invalid, even if its slot is reused by another thread.
+					if (st->rid_owner.owns(rids[i])) {
+						st->errors.increment();
+					}
+				}
+			}
+		}
+
+		void test() {
+			threads.resize(OS::get_singleton()->get_processor_count());
+			for (uint32_t i = 0; i < threads.size(); i++) {
+				threads[i].start(&StressTester::thread_func, this);
+			}
+			for (uint32_t i = 0; i < threads.size(); i++) {
+				threads[i].wait_to_finish();
+			}
+
+			CHECK(errors.get() == 0);
+			CHECK(rid_owner.get_rid_count() == 0);
+		}
+	};
+
+	StressTester tester;
+	tester.test();
+
+	// Slots are reused rather than leaked.
+	LocalVector<RID> rids;
+	for (uint32_t i = 0; i < RIDS_PER_ROUND; i++) {
+		rids.push_back(tester.rid_owner.make_rid(i));
+	}
+	CHECK(tester.rid_owner.get_rid_count() == RIDS_PER_ROUND);
+	CHECK(tester.rid_owner.get_owned_list().size() == RIDS_PER_ROUND);
+	for (const RID &rid : rids) {
+		tester.rid_owner.free(rid);
+	}
+}
+
+TEST_CASE("[RID_Owner][Benchmark] Allocation and lookup from several threads" * doctest::skip()) {
+	static constexpr uint32_t OPERATIONS = 16384; // Per thread, in every iteration.
+	static constexpr uint32_t BATCH = 256;
+
+	struct BenchmarkState {
+		RID_Owner<uint64_t, true> rid_owner;
+		SafeNumeric<uint64_t> checksum;
+	};
+
+	for (uint32_t thread_count = 1; (int)thread_count <= OS::get_singleton()->get_processor_count(); thread_count *= 2) {
+		BenchmarkState state;
+		TightLocalVector<Thread> threads;
+		threads.resize(thread_count);
+		uint64_t iterations = 0;
+
+		TestBenchmark::run(vformat("%d make_rid/get_or_null/free per thread (%d threads)", OPERATIONS, thread_count), [&]() {
+			for (uint32_t i = 0; i < thread_count; i++) {
+				threads[i].start(
+						[](void *p_data) {
+							BenchmarkState *bs = (BenchmarkState *)p_data;
+							RID rids[BATCH];
+							uint64_t sum = 0;
+							for (uint32_t op = 0; op < OPERATIONS; op += BATCH) {
+								for (uint32_t i = 0; i < BATCH; i++) {
+									rids[i] = bs->rid_owner.make_rid(op + i);
+								}
+								for (uint32_t i = 0; i < BATCH; i++) {
+									sum += *bs->rid_owner.get_or_null(rids[i]);
+								}
+								for (uint32_t i = 0; i < BATCH; i++) {
+									bs->rid_owner.free(rids[i]);
+								}
+							}
+							bs->checksum.add(sum);
+						},
+						&state);
+			}
+			for (uint32_t i = 0; i < thread_count; i++) {
+				threads[i].wait_to_finish();
+			}
+			iterations++;
+		});
+
+		CHECK(state.checksum.get() == iterations * thread_count * ((uint64_t)OPERATIONS * (OPERATIONS - 1) / 2));
+	}
+}
 #endif // THREADS_ENABLED
 
 } // namespace TestRID
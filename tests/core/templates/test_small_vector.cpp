@@ -0,0 +1,184 @@
+/**************************************************************************/
+/*  test_small_vector.cpp                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_small_vector)
+
+#include "core/templates/local_vector.h"
+#include "core/templates/small_vector.h"
+#include "tests/test_benchmark.h"
+
+namespace TestSmallVector {
+
+TEST_CASE("[SmallVector] List initialization") {
+	SmallVector<int, 4> vector{ 0, 1, 2, 3, 4 };
+
+	CHECK(vector.size() == 5);
+	CHECK(vector.is_on_heap());
+	for (int i = 0; i < 5; i++) {
+		CHECK(vector[i] == i);
+	}
+}
+
+TEST_CASE("[SmallVector] Elements are stored inline until capacity is exceeded") {
+	SmallVector<int, 4> vector;
+	CHECK(vector.get_capacity() == 4);
+
+	for (int i = 0; i < 4; i++) {
+		vector.push_back(i);
+	}
+	CHECK_FALSE(vector.is_on_heap());
+	CHECK((uint8_t *)vector.ptr() >= (uint8_t *)&vector);
+	CHECK((uint8_t *)vector.ptr() < (uint8_t *)&vector + sizeof(vector));
+
+	vector.push_back(4);
+	CHECK(vector.is_on_heap());
+	CHECK(vector.get_capacity() > 4);
+	for (int i = 0; i < 5; i++) {
+		CHECK(vector[i] == i);
+	}
+
+	vector.reset();
+	CHECK(vector.is_empty());
+	CHECK_FALSE(vector.is_on_heap());
+	CHECK(vector.get_capacity() == 4);
+}
+
+TEST_CASE("[SmallVector] Non-trivial elements") {
+	SmallVector<String, 2> vector;
+	vector.push_back("alpha");
+	vector.push_back("beta");
+	vector.push_back("gamma");
+	vector.insert(0, "first");
+
+	CHECK(vector.size() == 4);
+	CHECK(vector[0] == "first");
+	CHECK(vector[1] == "alpha");
+	CHECK(vector[2] == "beta");
+	CHECK(vector[3] == "gamma");
+
+	CHECK(vector.erase("beta"));
+	CHECK(vector.find("gamma") == 2);
+	CHECK_FALSE(vector.has("beta"));
+
+	vector.remove_at_unordered(0);
+	CHECK(vector.size() == 2);
+	CHECK(vector[0] == "gamma");
+
+	vector.resize(4);
+	CHECK(vector[3].is_empty());
+}
+
+TEST_CASE("[SmallVector] Copy and move") {
+	SmallVector<String, 3> small{ "a", "b" };
+	SmallVector<String, 3> large{ "a", "b", "c", "d" };
+
+	SmallVector<String, 3> small_copy(small);
+	SmallVector<String, 3> large_copy(large);
+	CHECK(small_copy.size() == 2);
+	CHECK(small_copy[1] == "b");
+	CHECK(large_copy.size() == 4);
+	CHECK(large_copy[3] == "d");
+	CHECK(large_copy.ptr() != large.ptr());
+
+	SmallVector<String, 3> small_moved(std::move(small));
+	CHECK(small.is_empty());
+	CHECK(small_moved.size() == 2);
+	CHECK(small_moved[0] == "a");
+	CHECK_FALSE(small_moved.is_on_heap());
+
+	const String *large_data = large.ptr();
+	SmallVector<String, 3> large_moved(std::move(large));
+	CHECK(large.is_empty());
+	CHECK_FALSE(large.is_on_heap());
+	CHECK_MESSAGE(large_moved.ptr() == large_data, "Moving a heap-backed vector should steal its buffer.");
+
+	small_moved = large_copy;
+	CHECK(small_moved.size() == 4);
+	CHECK(small_moved[2] == "c");
+
+	large_moved = std::move(small_copy);
+	CHECK(large_moved.size() == 2);
+	CHECK(large_moved[1] == "b");
+}
+
+TEST_CASE("[SmallVector] Sort and reverse") {
+	SmallVector<int, 8> vector{ 5, 3, 9, 1, 7, 2, 8, 4, 6, 0 };
+	vector.sort();
+	for (int i = 0; i < 10; i++) {
+		CHECK(vector[i] == i);
+	}
+
+	vector.reverse();
+	for (int i = 0; i < 10; i++) {
+		CHECK(vector[i] == 9 - i);
+	}
+
+	int sum = 0;
+	for (int value : vector) {
+		sum += value;
+	}
+	CHECK(sum == 45);
+}
+
+template <typename TVector>
+static uint64_t _sum_short_lived_vector(uint64_t p_first, int p_size) {
+	TVector vector;
+	for (int i = 0; i < p_size; i++) {
+		vector.push_back(p_first + i);
+	}
+	uint64_t sum = 0;
+	for (uint32_t i = 0; i < vector.size(); i++) {
+		sum += vector[i];
+	}
+	return sum;
+}
+
+TEST_CASE("[SmallVector][Benchmark] Short-lived small vectors" * doctest::skip()) {
+	for (int size : { 2, 4, 8, 16 }) {
+		CHECK(_sum_short_lived_vector<LocalVector<uint64_t>>(size, size) == _sum_short_lived_vector<SmallVector<uint64_t, 8>>(size, size));
+
+		// The first value changes every iteration, so the sums can't be computed at compile time.
+		uint64_t first = 0;
+		TestBenchmark::run(vformat("LocalVector, %d elements", size), [&]() {
+			uint64_t sum = _sum_short_lived_vector<LocalVector<uint64_t>>(first++, size);
+			TestBenchmark::do_not_optimize(sum);
+		});
+
+		first = 0;
+		TestBenchmark::run(vformat("SmallVector<8>, %d elements", size), [&]() {
+			uint64_t sum = _sum_short_lived_vector<SmallVector<uint64_t, 8>>(first++, size);
+			TestBenchmark::do_not_optimize(sum);
+		});
+	}
+}
+
+} // namespace TestSmallVector
@@ -0,0 +1,431 @@
+/**************************************************************************/
+/*  test_swiss_hash_map.cpp                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "tests/test_macros.h"
+
+TEST_FORCE_LINK(test_swiss_hash_map)
+
+#include "core/math/random_pcg.h"
+#include "core/string/string_name.h"
+#include "core/templates/a_hash_map.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/swiss_hash_map.h"
+#include "tests/test_benchmark.h"
+
+namespace TestSwissHashMap {
+
+TEST_CASE("[SwissHashMap] List initialization") {
+	SwissHashMap<int, String> map{ { 0, "A" }, { 1, "B" }, { 2, "C" }, { 3, "D" }, { 4, "E" } };
+
+	CHECK(map.size() == 5);
+	CHECK(map[0] == "A");
+	CHECK(map[1] == "B");
+	CHECK(map[2] == "C");
+	CHECK(map[3] == "D");
+	CHECK(map[4] == "E");
+}
+
+TEST_CASE("[SwissHashMap] List initialization with existing elements") {
+	SwissHashMap<int, String> map{ { 0, "A" }, { 0, "B" }, { 0, "C" }, { 0, "D" }, { 0, "E" } };
+
+	CHECK(map.size() == 1);
+	CHECK(map[0] == "E");
+}
+
+TEST_CASE("[SwissHashMap] Insert element") {
+	SwissHashMap<int, int> map;
+	SwissHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+}
+
+TEST_CASE("[SwissHashMap] Overwrite element") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(42, 1234);
+
+	CHECK(map[42] == 1234);
+}
+
+TEST_CASE("[SwissHashMap] Erase via element") {
+	SwissHashMap<int, int> map;
+	SwissHashMap<int, int>::Iterator e = map.insert(42, 84);
+	map.remove(e);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+}
+
+TEST_CASE("[SwissHashMap] Erase via key") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.erase(42);
+	CHECK(!map.has(42));
+	CHECK(!map.find(42));
+}
+
+TEST_CASE("[SwissHashMap] Size") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 84);
+	map.insert(123, 84);
+	map.insert(0, 84);
+	map.insert(123485, 84);
+
+	CHECK(map.size() == 4);
+}
+
+TEST_CASE("[SwissHashMap] Iteration") {
+	SwissHashMap<int, int> map;
+
+	map.insert(42, 84);
+	map.insert(123, 12385);
+	map.insert(0, 12934);
+	map.insert(123485, 1238888);
+	map.insert(123, 111111);
+
+	Vector<Pair<int, int>> expected;
+	expected.push_back(Pair<int, int>(42, 84));
+	expected.push_back(Pair<int, int>(123, 111111));
+	expected.push_back(Pair<int, int>(0, 12934));
+	expected.push_back(Pair<int, int>(123485, 1238888));
+
+	int idx = 0;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(expected[idx] == Pair<int, int>(E.key, E.value));
+		idx++;
+	}
+
+	idx--;
+	for (SwissHashMap<int, int>::Iterator it = map.last(); it; --it) {
+		CHECK(expected[idx] == Pair<int, int>(it->key, it->value));
+		idx--;
+	}
+}
+
+TEST_CASE("[SwissHashMap] Replace key") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(0, 12934);
+	CHECK(map.replace_key(0, 1));
+	CHECK(map.has(1));
+	CHECK(!map.has(0));
+	CHECK(map[1] == 12934);
+	CHECK(map.size() == 2);
+}
+
+TEST_CASE("[SwissHashMap] Clear") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 12385);
+	map.insert(0, 12934);
+
+	map.clear();
+	CHECK(!map.has(42));
+	CHECK(map.size() == 0);
+	CHECK(map.is_empty());
+
+	map.insert(123, 1);
+	CHECK(map[123] == 1);
+}
+
+TEST_CASE("[SwissHashMap] Get") {
+	SwissHashMap<int, int> map;
+	map.insert(42, 84);
+	map.insert(123, 12385);
+	map.insert(0, 12934);
+
+	CHECK(map.get(123) == 12385);
+	map.get(123) = 10;
+	CHECK(map.get(123) == 10);
+
+	CHECK(*map.getptr(0) == 12934);
+	*map.getptr(0) = 1;
+	CHECK(*map.getptr(0) == 1);
+
+	CHECK(map.get(42) == 84);
+	CHECK(map.getptr(-10) == nullptr);
+}
+
+TEST_CASE("[SwissHashMap] Insert, iterate and remove many elements") {
+	const int elem_max = 1234;
+	SwissHashMap<int, int> map;
+	for (int i = 0; i < elem_max; i++) {
+		map.insert(i, i);
+	}
+
+	// Insertion order should have been kept.
+	int idx = 0;
+	for (const KeyValue<int, int> &K : map) {
+		CHECK(idx == K.key);
+		CHECK(idx == K.value);
+		CHECK(map.has(idx));
+		idx++;
+	}
+
+	Vector<int> elems_still_valid;
+
+	for (int i = 0; i < elem_max; i++) {
+		if ((i % 5) == 0) {
+			map.erase(i);
+		} else {
+			elems_still_valid.push_back(i);
+		}
+	}
+
+	CHECK(elems_still_valid.size() == map.size());
+
+	for (int i = 0; i < elems_still_valid.size(); i++) {
+		CHECK(map.has(elems_still_valid[i]));
+		CHECK(map[elems_still_valid[i]] == elems_still_valid[i]);
+	}
+}
+
+TEST_CASE("[SwissHashMap] Insert, iterate and remove many strings") {
+	const int elem_max = 432;
+	SwissHashMap<String, String> map;
+
+	for (int i = 0; i < elem_max; i++) {
+		map.insert(itos(i), itos(i));
+	}
+
+	// Insertion order should have been kept.
+	int idx = 0;
+	for (auto &K : map) {
+		CHECK(itos(idx) == K.key);
+		CHECK(itos(idx) == K.value);
+		CHECK(map.has(itos(idx)));
+		idx++;
+	}
+
+	Vector<String> elems_still_valid;
+
+	for (int i = 0; i < elem_max; i++) {
+		if ((i % 5) == 0) {
+			map.erase(itos(i));
+		} else {
+			elems_still_valid.push_back(itos(i));
+		}
+	}
+
+	CHECK(elems_still_valid.size() == map.size());
+
+	for (int i = 0; i < elems_still_valid.size(); i++) {
+		CHECK(map.has(elems_still_valid[i]));
+	}
+}
+
+TEST_CASE("[SwissHashMap] Insert and erase churn matches HashMap") {
+	// Keeps the map at a stable size while erasing, so tombstones have to be reclaimed without growing.
+	SwissHashMap<int, int> map;
+	HashMap<int, int> reference;
+	RandomPCG rng(1234);
+
+	for (int i = 0; i < 20000; i++) {
+		const int key = rng.rand() % 256;
+		if (reference.has(key)) {
+			CHECK(map.erase(key));
+			reference.erase(key);
+		} else {
+			map.insert(key, i);
+			reference.insert(key, i);
+		}
+	}
+
+	CHECK(map.size() == reference.size());
+	CHECK_MESSAGE(map.get_capacity() <= 512, "Erasing should not cause the map to grow indefinitely.");
+	for (const KeyValue<int, int> &E : reference) {
+		const int *value = map.getptr(E.key);
+		REQUIRE(value != nullptr);
+		CHECK(*value == E.value);
+	}
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(reference.has(E.key));
+	}
+}
+
+TEST_CASE("[SwissHashMap] Reserve") {
+	SwissHashMap<int, int> map;
+	map.reserve(1000);
+	const uint32_t capacity = map.get_capacity();
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i);
+	}
+	CHECK_MESSAGE(map.get_capacity() == capacity, "Reserving should make room for the requested amount of elements.");
+
+	map.reserve(5000);
+	CHECK(map.get_capacity() > capacity);
+	for (int i = 0; i < 1000; i++) {
+		CHECK(map[i] == i);
+	}
+}
+
+TEST_CASE("[SwissHashMap] Copy constructor") {
+	SwissHashMap<int, int> map0;
+	const uint32_t count = 5;
+	for (uint32_t i = 0; i < count; i++) {
+		map0.insert(i, i);
+	}
+	SwissHashMap<int, int> map1(map0);
+	CHECK(map0.size() == map1.size());
+	CHECK(map0.get_capacity() == map1.get_capacity());
+	CHECK(*map0.getptr(0) == *map1.getptr(0));
+
+	map1.erase(0);
+	CHECK(map0.has(0));
+	CHECK(!map1.has(0));
+}
+
+TEST_CASE("[SwissHashMap] Operator =") {
+	SwissHashMap<int, int> map0;
+	SwissHashMap<int, int> map1;
+	const uint32_t count = 5;
+	map1.insert(1234, 1234);
+	for (uint32_t i = 0; i < count; i++) {
+		map0.insert(i, i);
+	}
+	map1 = map0;
+	CHECK(map0.size() == map1.size());
+	CHECK(map0.get_capacity() == map1.get_capacity());
+	CHECK(*map0.getptr(0) == *map1.getptr(0));
+	CHECK(!map1.has(1234));
+}
+
+TEST_CASE("[SwissHashMap] Array methods") {
+	SwissHashMap<int, int> map;
+	for (int i = 0; i < 100; i++) {
+		map.insert(100 - i, i);
+	}
+	for (int i = 0; i < 100; i++) {
+		CHECK(map.get_by_index(i).value == i);
+	}
+	int index = map.get_index(1);
+	CHECK(map.get_by_index(index).value == 99);
+	CHECK(map.erase_by_index(index));
+	CHECK(!map.erase_by_index(index));
+	CHECK(map.get_index(1) == -1);
+}
+
+template <typename TKey>
+static Vector<TKey> _make_benchmark_keys(int p_count);
+
+template <>
+Vector<int> _make_benchmark_keys<int>(int p_count) {
+	Vector<int> keys;
+	for (int i = 0; i < p_count; i++) {
+		keys.push_back(i * 7919);
+	}
+	return keys;
+}
+
+template <>
+Vector<String> _make_benchmark_keys<String>(int p_count) {
+	Vector<String> keys;
+	for (int i = 0; i < p_count; i++) {
+		keys.push_back("property_" + itos(i));
+	}
+	return keys;
+}
+
+template <>
+Vector<StringName> _make_benchmark_keys<StringName>(int p_count) {
+	Vector<StringName> keys;
+	for (int i = 0; i < p_count; i++) {
+		keys.push_back(StringName("method_" + itos(i)));
+	}
+	return keys;
+}
+
+template <typename TMap, typename TKey>
+static void _benchmark_map(const String &p_name, const Vector<TKey> &p_keys) {
+	TestBenchmark::run(p_name + " insert", [&]() {
+		TMap map;
+		for (int i = 0; i < p_keys.size(); i++) {
+			map.insert(p_keys[i], i);
+		}
+		TestBenchmark::do_not_optimize(map);
+	});
+
+	TMap map;
+	for (int i = 0; i < p_keys.size(); i++) {
+		map.insert(p_keys[i], i);
+	}
+
+	TestBenchmark::run(p_name + " lookup", [&]() {
+		int64_t checksum = 0;
+		for (int i = 0; i < p_keys.size(); i++) {
+			const int *value = map.getptr(p_keys[i]);
+			checksum += value ? *value : -1;
+		}
+		TestBenchmark::do_not_optimize(checksum);
+	});
+
+	TestBenchmark::run(p_name + " iterate", [&]() {
+		int64_t checksum = 0;
+		for (const KeyValue<TKey, int> &E : map) {
+			checksum += E.value;
+		}
+		TestBenchmark::do_not_optimize(checksum);
+	});
+
+	TestBenchmark::run(p_name + " insert and erase", [&]() {
+		TMap erased_map;
+		for (int i = 0; i < p_keys.size(); i++) {
+			erased_map.insert(p_keys[i], i);
+		}
+		for (int i = 0; i < p_keys.size(); i++) {
+			erased_map.erase(p_keys[i]);
+		}
+		TestBenchmark::do_not_optimize(erased_map);
+	});
+}
+
+template <typename TKey>
+static void _benchmark_maps(const char *p_key_name, int p_count) {
+	const Vector<TKey> keys = _make_benchmark_keys<TKey>(p_count);
+	const String suffix = vformat(" (%d %s keys)", p_count, p_key_name);
+	_benchmark_map<HashMap<TKey, int>>("HashMap" + suffix, keys);
+	_benchmark_map<AHashMap<TKey, int>>("AHashMap" + suffix, keys);
+	_benchmark_map<SwissHashMap<TKey, int>>("SwissHashMap" + suffix, keys);
+}
+
+TEST_CASE("[SwissHashMap][Benchmark] Insert, lookup, iterate and erase" * doctest::skip()) {
+	_benchmark_maps<int>("int", 100000);
+	_benchmark_maps<String>("String", 20000);
+	_benchmark_maps<StringName>("StringName", 20000);
+	// Small maps, like ClassDB method tables and property caches.
+	_benchmark_maps<StringName>("StringName", 32);
+}
+
+} // namespace TestSwissHashMap
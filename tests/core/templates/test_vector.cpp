@@ -33,6 +33,7 @@
 TEST_FORCE_LINK(test_vector)
 
 #include "core/templates/vector.h"
+#include "tests/test_benchmark.h"
 
 namespace TestVector {
 
@@ -704,4 +705,31 @@ TEST_CASE("[Vector] Cyclic Reference") {
 	// The vector goes out of scope and destructs, calling CyclicVectorHolder's destructor.
 }
 
+TEST_CASE("[Vector][Benchmark] Appending, copying and sorting" * doctest::skip()) {
+	constexpr int COUNT = 10000;
+
+	TestBenchmark::run("Vector<int> push_back (10000 elements)", [&]() {
+		Vector<int> vector;
+		for (int i = 0; i < COUNT; i++) {
+			vector.push_back(i);
+		}
+		TestBenchmark::do_not_optimize(vector);
+	});
+
+	Vector<int> source;
+	for (int i = 0; i < COUNT; i++) {
+		source.push_back((i * 7919) % COUNT);
+	}
+	TestBenchmark::run("Vector<int> copy on write (10000 elements)", [&]() {
+		Vector<int> copy = source;
+		copy.write[0] = 1;
+		TestBenchmark::do_not_optimize(copy);
+	});
+	TestBenchmark::run("Vector<int> sort (10000 elements)", [&]() {
+		Vector<int> copy = source;
+		copy.sort();
+		TestBenchmark::do_not_optimize(copy);
+	});
+}
+
 } // namespace TestVector
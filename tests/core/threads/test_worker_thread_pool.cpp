@@ -33,6 +33,7 @@
 TEST_FORCE_LINK(test_worker_thread_pool)
 
 #include "core/object/worker_thread_pool.h"
+#include "tests/test_benchmark.h"
 
 namespace TestWorkerThreadPool {
 
@@ -172,4 +173,289 @@ TEST_CASE("[WorkerThreadPool] Run a yielding daemon as the only hope for other t
 	CHECK_MESSAGE(all_needed_yield, "All legit tasks should have needed the daemon yielding to run.");
 }
 
+static LocalVector<WorkerThreadPool::GroupID> nested_groups;
+
+static void static_nested_group_test(void *p_arg, uint32_t p_index) {
+	counter[p_index].increment();
+}
+static void static_post_group_test(void *p_arg) {
+	// Posted from a pool thread, so the group tasks start in this thread's own queue and get stolen by the rest.
+	nested_groups[(uintptr_t)p_arg] = WorkerThreadPool::get_singleton()->add_native_group_task(static_nested_group_test, nullptr, counter.size(), -1, true);
+}
+TEST_CASE("[WorkerThreadPool] Process group tasks posted from pool threads") {
+	for (int iterations = 0; iterations < 100; iterations++) {
+		const int count = Math::pow(2.0f, Math::random(0.0f, 8.0f));
+		const int posters = Math::pow(2.0f, Math::random(0.0f, 4.0f));
+
+		counter.clear();
+		counter.resize(count);
+		nested_groups.clear();
+		nested_groups.resize(posters);
+		LocalVector<WorkerThreadPool::TaskID> tasks;
+		for (int i = 0; i < posters; i++) {
+			tasks.push_back(WorkerThreadPool::get_singleton()->add_native_task(static_post_group_test, (void *)(uintptr_t)i, true));
+		}
+		for (int i = 0; i < posters; i++) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(tasks[i]);
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(nested_groups[i]);
+		}
+
+		bool all_run = true;
+		for (int i = 0; i < count; i++) {
+			//Reduce number of check messages
+			all_run &= counter[i].get() == posters;
+		}
+		CHECK(all_run);
+	}
+}
+
+static LocalVector<SafeNumeric<int>> stage_counter;
+
+static void static_stage_task(void *p_arg) {
+	const int stage = (uintptr_t)p_arg;
+	// Every previous stage must be fully done already.
+	if (stage > 0 && stage_counter[stage - 1].get() != (int)counter.size()) {
+		counter[0].add(1000);
+	}
+	stage_counter[stage].add(counter.size());
+}
+static void static_stage_group(void *p_arg, uint32_t p_index) {
+	const int stage = (uintptr_t)p_arg;
+	if (stage > 0 && stage_counter[stage - 1].get() != (int)counter.size()) {
+		counter[0].add(1000);
+	}
+	counter[p_index].increment();
+	stage_counter[stage].increment();
+}
+static void static_callable_stage_task(int p_stage) {
+	static_stage_task((void *)(uintptr_t)p_stage);
+}
+TEST_CASE("[WorkerThreadPool] Tasks and groups with dependencies") {
+	for (int iterations = 0; iterations < 200; iterations++) {
+		const int count = Math::pow(2.0f, Math::random(0.0f, 6.0f));
+		const int stages = 8;
+		const bool low_priority = Math::rand() % 2;
+
+		counter.clear();
+		counter.resize(count);
+		stage_counter.clear();
+		stage_counter.resize(stages);
+
+		// Alternate tasks and groups, each stage depending on the previous one.
+		LocalVector<WorkerThreadPool::TaskID> ids;
+		for (int i = 0; i < stages; i++) {
+			Vector<WorkerThreadPool::TaskID> dependencies;
+			if (i > 0) {
+				dependencies.push_back(ids[i - 1]);
+			}
+			if (i == 3) {
+				ids.push_back(WorkerThreadPool::get_singleton()->add_task_with_dependencies(callable_mp_static(static_callable_stage_task).bind(i), dependencies, !low_priority));
+			} else if (i % 2) {
+				ids.push_back(WorkerThreadPool::get_singleton()->add_native_task_with_dependencies(static_stage_task, (void *)(uintptr_t)i, dependencies, !low_priority));
+			} else {
+				ids.push_back(WorkerThreadPool::get_singleton()->add_native_group_task_with_dependencies(static_stage_group, (void *)(uintptr_t)i, count, dependencies, -1, !low_priority));
+			}
+		}
+
+		// Await the last stage first, while the rest may still be pending.
+		for (int i = stages - 1; i >= 0; i--) {
+			if (i % 2) {
+				WorkerThreadPool::get_singleton()->wait_for_task_completion(ids[i]);
+			} else {
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(ids[i]);
+			}
+		}
+
+		bool all_stages_done = true;
+		for (int i = 0; i < stages; i++) {
+			all_stages_done &= stage_counter[i].get() == count;
+		}
+		CHECK(all_stages_done);
+
+		bool all_run_in_order = true;
+		for (int i = 0; i < count; i++) {
+			//Reduce number of check messages
+			all_run_in_order &= counter[i].get() == stages / 2;
+		}
+		CHECK(all_run_in_order);
+	}
+}
+
+TEST_CASE("[WorkerThreadPool] Dependencies on completed and awaited tasks") {
+	counter.clear();
+	counter.resize(1);
+
+	WorkerThreadPool::TaskID done_task = WorkerThreadPool::get_singleton()->add_native_task(static_test, nullptr, true);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(done_task);
+	WorkerThreadPool::TaskID running_task = WorkerThreadPool::get_singleton()->add_native_task(static_test, nullptr, true);
+
+	const WorkerThreadPool::TaskID dependencies[] = { done_task, running_task };
+	WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_native_task_with_dependencies(static_test, nullptr, dependencies, true);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(running_task);
+	CHECK(counter[0].get() == 3 * 3);
+
+	ERR_PRINT_OFF;
+	const WorkerThreadPool::TaskID invalid_dependencies[] = { -5, task + 1000 };
+	task = WorkerThreadPool::get_singleton()->add_native_task_with_dependencies(static_test, nullptr, invalid_dependencies, true);
+	ERR_PRINT_ON;
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+	CHECK_MESSAGE(counter[0].get() == 4 * 3, "Invalid dependencies should be ignored.");
+}
+
+static void static_notified_task(void *p_arg) {
+	counter[0].increment();
+}
+static void static_awaiting_task(void *p_arg) {
+	// While awaiting, this pool thread processes other tasks, group ones included, and is still a candidate
+	// for the other threads to notify to promote low priority tasks.
+	WorkerThreadPool::TaskID task = WorkerThreadPool::get_singleton()->add_native_task(static_notified_task, nullptr, true);
+	WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+}
+static void static_short_group(void *p_arg, uint32_t p_index) {
+	counter[1].increment();
+}
+TEST_CASE("[WorkerThreadPool] Process short group tasks while threads are being notified") {
+	const int iterations = 200;
+	const int task_count = 16;
+	const int group_count = 16;
+	const int group_elements = 8;
+	counter.clear();
+	counter.resize(2);
+
+	LocalVector<WorkerThreadPool::TaskID> tasks;
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		tasks.clear();
+		for (int i = 0; i < task_count; i++) {
+			tasks.push_back(WorkerThreadPool::get_singleton()->add_native_task(static_awaiting_task, nullptr, false));
+		}
+		// Every group task is freed right after its few elements are done, while the tasks above are notifying threads.
+		for (int i = 0; i < group_count; i++) {
+			WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_native_group_task(static_short_group, nullptr, group_elements, -1, true);
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+		}
+		for (WorkerThreadPool::TaskID task : tasks) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(task);
+		}
+	}
+
+	CHECK(counter[0].get() == iterations * task_count);
+	CHECK(counter[1].get() == iterations * group_count * group_elements);
+}
+
+static LocalVector<int> run_order;
+static void static_blocking_task(void *p_arg) {
+	((Semaphore *)p_arg)->wait();
+}
+static void static_ordered_task(void *p_arg) {
+	run_order.push_back((uintptr_t)p_arg);
+}
+static void static_ordered_group(void *p_arg, uint32_t p_index) {
+	run_order.push_back((uintptr_t)p_arg);
+}
+TEST_CASE("[WorkerThreadPool] Start tasks and groups of the same priority in order") {
+	// With a single thread, tasks run one after another in the order they are started.
+	WorkerThreadPool *pool = memnew(WorkerThreadPool(false));
+	pool->init(1);
+	run_order.clear();
+
+	Semaphore semaphore;
+	WorkerThreadPool::TaskID blocking_task = pool->add_native_task(static_blocking_task, &semaphore, true);
+
+	// Queued while the thread is busy, so they are all waiting when it's released.
+	WorkerThreadPool::TaskID first_task = pool->add_native_task(static_ordered_task, (void *)0, true);
+	WorkerThreadPool::GroupID first_group = pool->add_native_group_task(static_ordered_group, (void *)1, 1, 1, true);
+	WorkerThreadPool::TaskID second_task = pool->add_native_task(static_ordered_task, (void *)2, true);
+	WorkerThreadPool::GroupID second_group = pool->add_native_group_task(static_ordered_group, (void *)3, 1, 1, true);
+	semaphore.post();
+
+	pool->wait_for_task_completion(blocking_task);
+	pool->wait_for_task_completion(first_task);
+	pool->wait_for_group_task_completion(first_group);
+	pool->wait_for_task_completion(second_task);
+	pool->wait_for_group_task_completion(second_group);
+
+	REQUIRE(run_order.size() == 4);
+	for (int i = 0; i < 4; i++) {
+		CHECK_MESSAGE(run_order[i] == i, "Tasks and groups should start in the order they were added.");
+	}
+
+	pool->finish();
+	memdelete(pool);
+}
+
+static void static_pipeline_stage(void *p_arg, uint32_t p_index) {
+	counter[p_index % counter.size()].increment();
+}
+TEST_CASE("[WorkerThreadPool][Benchmark] Multi-stage pipeline, waiting between stages vs. dependencies" * doctest::skip()) {
+	const int pipelines = 8;
+	const int stages = 4;
+	const int elements = 256;
+	counter.clear();
+	counter.resize(64);
+
+	TestBenchmark::run(vformat("%d pipelines of %d stages, waiting between stages", pipelines, stages), [&]() {
+		for (int stage = 0; stage < stages; stage++) {
+			// Every stage is a barrier for all the pipelines.
+			WorkerThreadPool::GroupID groups[pipelines];
+			for (int i = 0; i < pipelines; i++) {
+				groups[i] = WorkerThreadPool::get_singleton()->add_native_group_task(static_pipeline_stage, nullptr, elements, 2, true);
+			}
+			for (int i = 0; i < pipelines; i++) {
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(groups[i]);
+			}
+		}
+	});
+
+	TestBenchmark::run(vformat("%d pipelines of %d stages, with dependencies", pipelines, stages), [&]() {
+		// Each pipeline advances as soon as its own previous stage is done.
+		WorkerThreadPool::GroupID groups[pipelines][stages];
+		for (int i = 0; i < pipelines; i++) {
+			for (int stage = 0; stage < stages; stage++) {
+				Span<WorkerThreadPool::TaskID> dependencies = stage > 0 ? Span(&groups[i][stage - 1], 1) : Span<WorkerThreadPool::TaskID>();
+				groups[i][stage] = WorkerThreadPool::get_singleton()->add_native_group_task_with_dependencies(static_pipeline_stage, nullptr, elements, dependencies, 2, true);
+			}
+		}
+		for (int i = 0; i < pipelines; i++) {
+			for (int stage = 0; stage < stages; stage++) {
+				WorkerThreadPool::get_singleton()->wait_for_group_task_completion(groups[i][stage]);
+			}
+		}
+	});
+}
+
+static void static_benchmark_group(void *p_arg, uint32_t p_index) {
+	counter[p_index % counter.size()].increment();
+}
+static void static_benchmark_task(void *p_arg) {
+	counter[(uintptr_t)p_arg % counter.size()].increment();
+}
+TEST_CASE("[WorkerThreadPool][Benchmark] Fine-grained tasks with increasing thread counts" * doctest::skip()) {
+	counter.clear();
+	counter.resize(64);
+
+	for (int thread_count = 1; thread_count <= OS::get_singleton()->get_processor_count(); thread_count *= 2) {
+		WorkerThreadPool *pool = memnew(WorkerThreadPool(false));
+		pool->init(thread_count);
+
+		TestBenchmark::run(vformat("Group of 1024 elements (%d threads)", thread_count), [&]() {
+			WorkerThreadPool::GroupID group = pool->add_native_group_task(static_benchmark_group, nullptr, 1024, -1, true);
+			pool->wait_for_group_task_completion(group);
+		});
+
+		WorkerThreadPool::TaskID tasks[100];
+		TestBenchmark::run(vformat("100 tasks (%d threads)", thread_count), [&]() {
+			for (uint32_t i = 0; i < std_size(tasks); i++) {
+				tasks[i] = pool->add_native_task(static_benchmark_task, (void *)(uintptr_t)i, true);
+			}
+			for (uint32_t i = 0; i < std_size(tasks); i++) {
+				pool->wait_for_task_completion(tasks[i]);
+			}
+		});
+
+		pool->finish();
+		memdelete(pool);
+	}
+}
+
 } // namespace TestWorkerThreadPool
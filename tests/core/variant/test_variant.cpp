@@ -34,6 +34,7 @@ TEST_FORCE_LINK(test_variant)
 
 #include "core/variant/variant.h"
 #include "core/variant/variant_parser.h"
+#include "tests/test_benchmark.h"
 
 namespace TestVariant {
 
@@ -2246,4 +2247,39 @@ TEST_CASE("[Variant] Operator NOT") {
 	}
 }
 
+TEST_CASE("[Variant][Benchmark] Operators, conversions and method calls" * doctest::skip()) {
+	constexpr int COUNT = 1000;
+
+	TestBenchmark::run("Variant int addition (1000 times)", [&]() {
+		Variant sum = 0;
+		const Variant one = 1;
+		for (int i = 0; i < COUNT; i++) {
+			sum = Variant::evaluate(Variant::OP_ADD, sum, one);
+		}
+		TestBenchmark::do_not_optimize(sum);
+	});
+
+	TestBenchmark::run("Variant Vector3 construction and conversion (1000 times)", [&]() {
+		real_t sum = 0;
+		for (int i = 0; i < COUNT; i++) {
+			Variant v = Vector3(i, i, i);
+			sum += Vector3(v).x;
+		}
+		TestBenchmark::do_not_optimize(sum);
+	});
+
+	Variant string = "Hello, benchmark";
+	const StringName method = "length";
+	TestBenchmark::run("Variant builtin method call (1000 times)", [&]() {
+		int64_t sum = 0;
+		for (int i = 0; i < COUNT; i++) {
+			Callable::CallError ce;
+			Variant ret;
+			string.callp(method, nullptr, 0, ret, ce);
+			sum += int64_t(ret);
+		}
+		TestBenchmark::do_not_optimize(sum);
+	});
+}
+
 } // namespace TestVariant
@@ -35,9 +35,11 @@ TEST_FORCE_LINK(test_node)
 #include "core/io/file_access.h"
 #include "core/io/resource_saver.h"
 #include "core/object/class_db.h"
+#include "core/object/message_queue.h"
 #include "scene/main/node.h"
 #include "scene/main/window.h"
 #include "scene/resources/packed_scene.h"
+#include "tests/test_benchmark.h"
 #include "tests/test_utils.h"
 
 namespace TestNode {
@@ -917,4 +919,90 @@ TEST_CASE("[SceneTree][Node] Test the process priority") {
 	memdelete(node4);
 }
 
+class DeferringNode : public Node {
+	GDCLASS(DeferringNode, Node);
+
+	void _deferred_call() {
+		deferred_calls++;
+	}
+
+protected:
+	void _notification(int p_what) {
+		switch (p_what) {
+			case NOTIFICATION_PROCESS: {
+				// Goes to the main message queue.
+				callable_mp(this, &DeferringNode::_deferred_call).call_deferred();
+				// Goes to the queue of the process group.
+				notify_deferred_thread_group(NOTIFICATION_GROUP_MESSAGE);
+			} break;
+			case NOTIFICATION_GROUP_MESSAGE: {
+				group_messages++;
+			} break;
+		}
+	}
+
+public:
+	enum {
+		NOTIFICATION_GROUP_MESSAGE = 10000,
+	};
+
+	int deferred_calls = 0;
+	int group_messages = 0;
+};
+
+TEST_CASE("[SceneTree][Node] Deferred calls from threaded process groups") {
+	const uint32_t node_count = 8;
+	LocalVector<DeferringNode *> nodes;
+	for (uint32_t i = 0; i < node_count; i++) {
+		DeferringNode *node = memnew(DeferringNode);
+		node->set_process_thread_group(Node::PROCESS_THREAD_GROUP_SUB_THREAD);
+		node->set_process(true);
+		SceneTree::get_singleton()->get_root()->add_child(node);
+		nodes.push_back(node);
+	}
+
+	MessageQueue::get_main_singleton()->flush();
+	MessageQueue::get_main_singleton()->reset_stats();
+
+	SceneTree::get_singleton()->process(0);
+
+	for (const DeferringNode *node : nodes) {
+		CHECK(node->deferred_calls == 1);
+		CHECK(node->group_messages == 1);
+	}
+
+#ifdef THREADS_ENABLED
+	// Process groups run in WorkerThreadPool tasks, so their pushes go through the queues of the pool threads.
+	CHECK(MessageQueue::get_main_singleton()->get_stats().pushed_from_threads == node_count);
+#endif // THREADS_ENABLED
+
+	for (DeferringNode *node : nodes) {
+		memdelete(node);
+	}
+}
+
+TEST_CASE("[SceneTree][Node][Benchmark] Processing the scene tree" * doctest::skip()) {
+	constexpr int COUNT = 1000;
+
+	Node *root = memnew(Node);
+	SceneTree::get_singleton()->get_root()->add_child(root);
+	for (int i = 0; i < COUNT; i++) {
+		TestNode *node = memnew(TestNode);
+		node->set_process(true);
+		node->set_physics_process(true);
+		// Some nesting, as in real scenes.
+		Node *parent = i % 4 ? root->get_child(root->get_child_count() - 1) : root;
+		parent->add_child(node);
+	}
+
+	TestBenchmark::run("SceneTree process (1000 processing nodes)", [&]() {
+		SceneTree::get_singleton()->process(0.016);
+	});
+	TestBenchmark::run("SceneTree physics_process (1000 processing nodes)", [&]() {
+		SceneTree::get_singleton()->physics_process(0.016);
+	});
+
+	memdelete(root);
+}
+
 } // namespace TestNode
@@ -0,0 +1,139 @@
+/**************************************************************************/
+/*  test_benchmark.cpp                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "test_benchmark.h"
+
+#include "core/io/file_access.h"
+#include "core/io/json.h"
+#include "core/math/math_funcs.h"
+#include "core/string/print_string.h"
+#include "core/variant/array.h"
+#include "core/variant/dictionary.h"
+#include "core/version.h"
+
+namespace TestBenchmark {
+
+static Options options;
+static LocalVector<Result> results;
+
+Options &get_options() {
+	return options;
+}
+
+bool parse_argument(const String &p_arg) {
+	if (p_arg.begins_with("--bench-warmup=")) {
+		options.warmup = MAX(0, p_arg.get_slicec('=', 1).to_int());
+	} else if (p_arg.begins_with("--bench-repetitions=")) {
+		options.repetitions = MAX(1, p_arg.get_slicec('=', 1).to_int());
+	} else if (p_arg.begins_with("--bench-sample-usec=")) {
+		options.min_sample_usec = MAX(1, p_arg.get_slicec('=', 1).to_int());
+	} else if (p_arg.begins_with("--bench-json=")) {
+		options.json_path = p_arg.substr(p_arg.find_char('=') + 1);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void add_result(const Result &p_result) {
+	results.push_back(p_result);
+	print_line(vformat("%s: %s ns/iteration (median), min %s, max %s, stddev %s, %d samples of %d iterations.",
+			p_result.name, String::num(p_result.median, 2), String::num(p_result.min, 2), String::num(p_result.max, 2), String::num(p_result.stddev, 2),
+			p_result.samples, p_result.iterations_per_sample));
+}
+
+const LocalVector<Result> &get_results() {
+	return results;
+}
+
+Result summarize(const String &p_name, uint64_t p_iterations_per_sample, LocalVector<uint64_t> &r_sample_usec) {
+	Result result;
+	result.name = p_name;
+	result.iterations_per_sample = p_iterations_per_sample;
+	result.samples = r_sample_usec.size();
+	if (r_sample_usec.is_empty() || p_iterations_per_sample == 0) {
+		return result;
+	}
+
+	r_sample_usec.sort();
+
+	LocalVector<double> ns;
+	ns.resize(r_sample_usec.size());
+	double sum = 0.0;
+	for (uint32_t i = 0; i < r_sample_usec.size(); i++) {
+		ns[i] = r_sample_usec[i] * 1000.0 / p_iterations_per_sample;
+		sum += ns[i];
+	}
+
+	result.min = ns[0];
+	result.max = ns[ns.size() - 1];
+	result.mean = sum / ns.size();
+	uint32_t middle = ns.size() / 2;
+	result.median = (ns.size() % 2) ? ns[middle] : (ns[middle - 1] + ns[middle]) * 0.5;
+
+	double variance = 0.0;
+	for (double v : ns) {
+		variance += (v - result.mean) * (v - result.mean);
+	}
+	result.stddev = ns.size() > 1 ? Math::sqrt(variance / (ns.size() - 1)) : 0.0;
+	return result;
+}
+
+Error save_json(const String &p_path) {
+	Array benchmarks;
+	for (const Result &result : results) {
+		Dictionary entry;
+		entry["name"] = result.name;
+		entry["samples"] = result.samples;
+		entry["iterations_per_sample"] = result.iterations_per_sample;
+		entry["min_ns"] = result.min;
+		entry["max_ns"] = result.max;
+		entry["mean_ns"] = result.mean;
+		entry["median_ns"] = result.median;
+		entry["stddev_ns"] = result.stddev;
+		benchmarks.push_back(entry);
+	}
+
+	Dictionary data;
+	data["version"] = GODOT_VERSION_FULL_BUILD;
+	data["hash"] = GODOT_VERSION_HASH;
+	data["warmup"] = options.warmup;
+	data["repetitions"] = options.repetitions;
+	data["min_sample_usec"] = options.min_sample_usec;
+	data["benchmarks"] = benchmarks;
+
+	Error err;
+	Ref<FileAccess> f = FileAccess::open(p_path, FileAccess::WRITE, &err);
+	ERR_FAIL_COND_V_MSG(f.is_null(), err, vformat("Cannot save benchmark results to '%s'.", p_path));
+	f->store_string(JSON::stringify(data, "\t"));
+	return OK;
+}
+
+} // namespace TestBenchmark
@@ -0,0 +1,136 @@
+/**************************************************************************/
+/*  test_benchmark.h                                                      */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#pragma once
+
+#include "core/os/os.h"
+#include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
+
+// Micro-benchmark harness, used by the `--test --bench` runner.
+//
+// Benchmarks are doctest test cases with `[Benchmark]` in their name, skipped by default
+// so they don't slow down regular test runs:
+//
+//     TEST_CASE("[HashMap][Benchmark] Insertion" * doctest::skip()) {
+//         HashMap<int, int> map;
+//         int i = 0;
+//         TestBenchmark::run("HashMap insert", [&]() {
+//             map.insert(i++, i);
+//         });
+//     }
+//
+// `--test --bench` runs all of them (a `--test-case` filter can narrow it down).
+// Each `run()` calibrates how many iterations fit in a sample, runs warmup samples,
+// then measures the samples and prints a summary. Extra arguments:
+//
+//     --bench-warmup=<n>        Samples run before measuring (default 2).
+//     --bench-repetitions=<n>   Measured samples (default 10).
+//     --bench-sample-usec=<n>   Minimum duration of a sample (default 20000).
+//     --bench-json=<path>       Save all results to a JSON file, to compare builds.
+
+namespace TestBenchmark {
+
+struct Options {
+	uint32_t warmup = 2;
+	uint32_t repetitions = 10;
+	uint64_t min_sample_usec = 20000;
+	String json_path;
+};
+
+struct Result {
+	String name;
+	uint64_t iterations_per_sample = 0;
+	uint32_t samples = 0;
+	// Nanoseconds per iteration.
+	double min = 0.0;
+	double max = 0.0;
+	double mean = 0.0;
+	double median = 0.0;
+	double stddev = 0.0;
+};
+
+Options &get_options();
+// Returns true if the argument was a benchmark option.
+bool parse_argument(const String &p_arg);
+
+void add_result(const Result &p_result);
+const LocalVector<Result> &get_results();
+Result summarize(const String &p_name, uint64_t p_iterations_per_sample, LocalVector<uint64_t> &r_sample_usec);
+Error save_json(const String &p_path);
+
+// Prevents the compiler from optimizing away the computation of a value.
+template <typename T>
+_FORCE_INLINE_ void do_not_optimize(const T &p_value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "g"(&p_value) : "memory");
+#else
+	static const void *volatile sink;
+	sink = &p_value;
+#endif
+}
+
+template <typename F>
+Result run(const String &p_name, F &&p_func) {
+	const Options &options = get_options();
+	OS *os = OS::get_singleton();
+
+	// Calibrate, doubling the iterations until a sample is long enough.
+	uint64_t iterations = 1;
+	while (true) {
+		uint64_t begin = os->get_ticks_usec();
+		for (uint64_t i = 0; i < iterations; i++) {
+			p_func();
+		}
+		uint64_t elapsed = os->get_ticks_usec() - begin;
+		if (elapsed >= options.min_sample_usec || iterations >= (1ULL << 40)) {
+			break;
+		}
+		iterations *= 2;
+	}
+
+	LocalVector<uint64_t> sample_usec;
+	for (uint32_t sample = 0; sample < options.warmup + options.repetitions; sample++) {
+		uint64_t begin = os->get_ticks_usec();
+		for (uint64_t i = 0; i < iterations; i++) {
+			p_func();
+		}
+		uint64_t elapsed = os->get_ticks_usec() - begin;
+		if (sample >= options.warmup) {
+			sample_usec.push_back(elapsed);
+		}
+	}
+
+	Result result = summarize(p_name, iterations, sample_usec);
+	add_result(result);
+	return result;
+}
+
+} // namespace TestBenchmark
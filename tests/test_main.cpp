@@ -41,6 +41,7 @@
 #include "tests/display_server_mock.h"
 #include "tests/force_link.gen.h"
 #include "tests/signal_watcher.h"
+#include "tests/test_benchmark.h"
 #include "tests/test_macros.h"
 #include "tests/test_utils.h"
 
@@ -109,10 +110,15 @@ int test_main(int argc, char *argv[]) {
 	doctest::Context test_context;
 	LocalVector<String> test_args;
 
-	// Clean arguments of "--test" from the args.
+	// Clean arguments of "--test" and benchmark options from the args.
+	bool run_benchmarks = false;
 	for (int x = 0; x < argc; x++) {
 		String arg = String(argv[x]);
-		if (arg != "--test") {
+		if (arg == "--bench") {
+			run_benchmarks = true;
+		} else if (TestBenchmark::parse_argument(arg)) {
+			continue;
+		} else if (arg != "--test") {
 			test_args.push_back(arg);
 		}
 	}
@@ -138,7 +144,31 @@ int test_main(int argc, char *argv[]) {
 		delete[] doctest_args;
 	}
 
-	return test_context.run();
+	if (run_benchmarks) {
+		// Benchmarks are skipped in regular runs.
+		test_context.setOption("no-skip", true);
+		bool has_test_case_filter = false;
+		for (const String &arg : test_args) {
+			if (arg.begins_with("--test-case=") || arg.begins_with("-tc=")) {
+				has_test_case_filter = true;
+				break;
+			}
+		}
+		if (!has_test_case_filter) {
+			test_context.addFilter("test-case", "*[Benchmark]*");
+		}
+	}
+
+	int status = test_context.run();
+
+	if (run_benchmarks && !TestBenchmark::get_options().json_path.is_empty()) {
+		Error err = TestBenchmark::save_json(TestBenchmark::get_options().json_path);
+		if (err != OK && status == 0) {
+			status = 1;
+		}
+	}
+
+	return status;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////